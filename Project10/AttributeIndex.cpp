@@ -0,0 +1,46 @@
+#include "AttributeIndex.h"
+
+// Sizes the per-slot tables for a number of slots
+void AttributeIndex::resize(int slotCount) {
+    slotValue.resize(slotCount, -1);
+    slotPosition.resize(slotCount, -1);
+}
+
+// Records that a slot holds a value id
+void AttributeIndex::add(int slot, uint32_t valueId) {
+    if (valueId >= postings.size()) {
+        postings.resize(valueId + 1);
+    }
+
+    slotValue[slot] = static_cast<int>(valueId);
+    slotPosition[slot] = static_cast<int>(postings[valueId].size());
+    postings[valueId].push_back(slot);
+}
+
+// Removes a slot from its posting list
+void AttributeIndex::remove(int slot) {
+    int valueId = slotValue[slot];
+    if (valueId == -1) return;
+
+    // Swap the last entry into the hole so removal is O(1)
+    vector<int>& list = postings[valueId];
+    int position = slotPosition[slot];
+    int moved = list.back();
+    list[position] = moved;
+    slotPosition[moved] = position;
+    list.pop_back();
+
+    slotValue[slot] = -1;
+    slotPosition[slot] = -1;
+}
+
+// Returns the slots holding a value id
+const vector<int>& AttributeIndex::slotsWith(int valueId) const {
+    static const vector<int> empty;
+    return valueId < static_cast<int>(postings.size()) ? postings[valueId] : empty;
+}
+
+// Returns true if a slot holds the given value id
+bool AttributeIndex::slotHas(int slot, int valueId) const {
+    return slotValue[slot] == valueId;
+}
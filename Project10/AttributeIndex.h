@@ -0,0 +1,32 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+using namespace std;
+
+// Inverted index over one vehicle attribute (make, model or color)
+// Every interned value id has a posting list of the slots that hold it,
+// so filters cost time proportional to the matching vehicles, not the lot size.
+class AttributeIndex {
+private:
+    vector<vector<int>> postings;         // Value id -> slots holding that value
+    vector<int> slotValue;                // Slot -> value id (-1 if the slot is not indexed)
+    vector<int> slotPosition;             // Slot -> position inside its posting list
+
+public:
+    // Sizes the per-slot tables for a number of slots
+    void resize(int slotCount);
+
+    // Records that a slot holds a value id
+    void add(int slot, uint32_t valueId);
+
+    // Removes a slot from its posting list
+    void remove(int slot);
+
+    // Returns the slots holding a value id
+    const vector<int>& slotsWith(int valueId) const;
+
+    // Returns true if a slot holds the given value id
+    bool slotHas(int slot, int valueId) const;
+};
@@ -0,0 +1,157 @@
+#include "BatchReplay.h"
+#include <chrono>
+#include <cstring>
+#include <sstream>
+
+// Splits a line into whitespace-separated tokens (without allocating a stream)
+void splitCommandTokens(const char* begin, const char* end, vector<string>& tokens) {
+    tokens.clear();
+    const char* p = begin;
+    while (p < end) {
+        // Skip separators
+        while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) ++p;
+        if (p >= end) break;
+
+        // Collect one token
+        const char* start = p;
+        while (p < end && *p != ' ' && *p != '\t' && *p != '\r') ++p;
+        tokens.emplace_back(start, p);
+    }
+}
+
+// Builds a gate event from the tokens of one line
+bool parseGateCommand(const vector<string>& tokens, GateCommand& command) {
+    if (tokens.empty()) return false;
+    if (tokens[0] == "PARK" && (tokens.size() == 7
+        || (tokens.size() == 8 && parseWaitingPriority(tokens[7], command.priority)))) {
+        command.type = CommandType::Park;
+        command.ownerName = tokens[2];
+        command.vehicleMake = tokens[3];
+        command.vehicleModel = tokens[4];
+        command.vehicleColor = tokens[5];
+        command.ownerContact = tokens[6];
+    }
+    else if (tokens[0] == "RETRIEVE" && tokens.size() == 2) {
+        command.type = CommandType::Retrieve;
+    }
+    else if (tokens[0] == "SEARCH" && tokens.size() == 2) {
+        command.type = CommandType::Search;
+    }
+    else if (tokens[0] == "CANCEL" && tokens.size() == 2) {
+        command.type = CommandType::Cancel;
+    }
+    else {
+        return false;
+    }
+    command.regNumber = tokens[1];
+    return true;
+}
+
+// Parses a command file into memory
+bool loadCommandFile(const string& path, vector<GateCommand>& commands, long long& malformedLines) {
+    ifstream file(path, ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    // Read the whole file at once to avoid per-line stream overhead
+    stringstream buffer;
+    buffer << file.rdbuf();
+    const string content = buffer.str();
+
+    vector<string> tokens;
+    const char* p = content.data();
+    const char* end = p + content.size();
+    while (p < end) {
+        const char* lineEnd = static_cast<const char*>(memchr(p, '\n', end - p));
+        if (!lineEnd) lineEnd = end;
+
+        splitCommandTokens(p, lineEnd, tokens);
+        p = lineEnd + 1;
+
+        // Skip blank lines and comments
+        if (tokens.empty() || tokens[0][0] == '#') continue;
+
+        GateCommand command;
+        if (!parseGateCommand(tokens, command)) {
+            malformedLines++;
+            continue;
+        }
+        commands.push_back(move(command));
+    }
+    return true;
+}
+
+// Executes parsed commands against the parking system
+void replayCommands(ParkingManagementSystem& system, const vector<GateCommand>& commands, ReplayReport& report) {
+    auto start = chrono::steady_clock::now();
+    Vehicle searchResult; // Reused so SEARCH events do not allocate a new record each time
+
+    for (const GateCommand& command : commands) {
+        switch (command.type) {
+        case CommandType::Park: {
+            Vehicle vehicle(command.regNumber, command.ownerName, command.vehicleMake,
+                command.vehicleModel, command.vehicleColor, command.ownerContact);
+            switch (system.parkVehicle(vehicle, command.priority)) {
+            case ParkResult::Parked: report.parked++; break;
+            case ParkResult::Queued: report.queued++; break;
+            case ParkResult::AlreadyParked:
+            case ParkResult::AlreadyWaiting: report.duplicates++; break;
+            }
+            break;
+        }
+        case CommandType::Retrieve: {
+            Cents fee = 0;
+            if (system.retrieveVehicle(command.regNumber, fee) == RetrieveResult::Retrieved) {
+                report.retrieved++;
+                report.revenue += fee;
+            }
+            else {
+                report.retrieveMisses++;
+            }
+            break;
+        }
+        case CommandType::Search:
+            if (system.findVehicle(command.regNumber, searchResult)) report.searchHits++;
+            else report.searchMisses++;
+            break;
+        case CommandType::Cancel:
+            if (system.cancelWaiting(command.regNumber)) report.cancelled++;
+            break;
+        }
+        report.events++;
+    }
+
+    report.replaySeconds += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+// Loads and replays a command file
+bool replayCommandFile(ParkingManagementSystem& system, const string& path, ReplayReport& report) {
+    auto start = chrono::steady_clock::now();
+    vector<GateCommand> commands;
+    if (!loadCommandFile(path, commands, report.malformedLines)) {
+        return false;
+    }
+    report.parseSeconds += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    replayCommands(system, commands, report);
+    return true;
+}
+
+// Prints a replay report to the console
+void printReplayReport(const ReplayReport& report) {
+    double eventsPerSecond = report.replaySeconds > 0 ? report.events / report.replaySeconds : 0;
+
+    cout << "\nReplay Summary:\n";
+    cout << "   Events replayed:    " << report.events << "\n";
+    cout << "   Parked / Queued:    " << report.parked << " / " << report.queued << "\n";
+    cout << "   Duplicate parks:    " << report.duplicates << "\n";
+    cout << "   Cancelled waits:    " << report.cancelled << "\n";
+    cout << "   Retrieved / Missed: " << report.retrieved << " / " << report.retrieveMisses << "\n";
+    cout << "   Search hits/misses: " << report.searchHits << " / " << report.searchMisses << "\n";
+    cout << "   Malformed lines:    " << report.malformedLines << "\n";
+    cout << "   Revenue collected:  $" << formatCents(report.revenue) << "\n";
+    cout << "   Parse time:         " << fixed << setprecision(3) << report.parseSeconds << " s\n";
+    cout << "   Replay time:        " << report.replaySeconds << " s\n";
+    cout << "   Throughput:         " << setprecision(0) << eventsPerSecond << " events/s\n";
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "ParkingManagementSystem.h"
+
+using namespace std;
+
+// Type of a gate event in a command file
+enum class CommandType {
+    Park,       // PARK <reg> <owner> <make> <model> <color> <contact> [standard|permit|ev|disabled]
+    Retrieve,   // RETRIEVE <reg>
+    Search,     // SEARCH <reg>
+    Cancel      // CANCEL <reg> (driver leaves the waiting queue)
+};
+
+// A single parsed gate event
+struct GateCommand {
+    CommandType type;        // Kind of event
+    string regNumber;        // Registration number the event refers to
+    string ownerName;        // Owner name (PARK only)
+    string vehicleMake;      // Vehicle make (PARK only)
+    string vehicleModel;     // Vehicle model (PARK only)
+    string vehicleColor;     // Vehicle color (PARK only)
+    string ownerContact;     // Owner contact number (PARK only)
+    WaitingPriority priority = WaitingPriority::Standard; // Waiting priority (PARK only)
+};
+
+// Summary of a replay run
+struct ReplayReport {
+    long long events = 0;          // Number of events replayed
+    long long parked = 0;          // PARK events that got a slot
+    long long queued = 0;          // PARK events that went to the waiting queue
+    long long duplicates = 0;      // PARK events rejected because the plate was already parked or waiting
+    long long cancelled = 0;       // CANCEL events that removed a waiting vehicle
+    long long retrieved = 0;       // RETRIEVE events that found the vehicle
+    long long retrieveMisses = 0;  // RETRIEVE events for unknown plates
+    long long searchHits = 0;      // SEARCH events that found the vehicle
+    long long searchMisses = 0;    // SEARCH events for unknown plates
+    long long malformedLines = 0;  // Lines that could not be parsed
+    Cents revenue = 0;             // Fees charged during the replay, in cents
+    double parseSeconds = 0;       // Time spent reading and parsing the file
+    double replaySeconds = 0;      // Time spent executing events against the engine
+};
+
+// Splits a line into whitespace-separated tokens
+void splitCommandTokens(const char* begin, const char* end, vector<string>& tokens);
+
+// Builds a gate event from the tokens of one line; returns false if they are not a valid event
+bool parseGateCommand(const vector<string>& tokens, GateCommand& command);
+
+// Parses a command file into memory; returns false if the file cannot be opened
+bool loadCommandFile(const string& path, vector<GateCommand>& commands, long long& malformedLines);
+
+// Executes parsed commands against the parking system as fast as possible
+void replayCommands(ParkingManagementSystem& system, const vector<GateCommand>& commands, ReplayReport& report);
+
+// Loads and replays a command file; returns false if the file cannot be opened
+bool replayCommandFile(ParkingManagementSystem& system, const string& path, ReplayReport& report);
+
+// Prints a replay report to the console
+void printReplayReport(const ReplayReport& report);
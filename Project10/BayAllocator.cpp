@@ -0,0 +1,238 @@
+#include "BayAllocator.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include "BitScan.h"
+
+// Returns the display name of a bay type
+const char* bayTypeName(BayType type) {
+    switch (type) {
+    case BayType::Compact: return "Compact";
+    case BayType::EV: return "EV";
+    case BayType::Disabled: return "Disabled";
+    default: return "Standard";
+    }
+}
+
+// Parses a bay type name
+bool parseBayType(const string& text, BayType& type) {
+    string name = text;
+    transform(name.begin(), name.end(), name.begin(), [](unsigned char c) { return static_cast<char>(tolower(c)); });
+    if (name == "standard" || name == "0") type = BayType::Standard;
+    else if (name == "compact" || name == "1") type = BayType::Compact;
+    else if (name == "ev" || name == "electric" || name == "2") type = BayType::EV;
+    else if (name == "disabled" || name == "3") type = BayType::Disabled;
+    else return false;
+    return true;
+}
+
+// Creates an empty bitmap with no positions
+HierarchicalBitmap::HierarchicalBitmap() : bitCount(0), setCount(0) {
+    resize(0);
+}
+
+// Sizes the bitmap for 'count' positions, all clear
+void HierarchicalBitmap::resize(int count) {
+    bitCount = count;
+    setCount = 0;
+    levels.clear();
+    size_t words = (static_cast<size_t>(count) + 63) / 64;
+    do {
+        words = max<size_t>(words, 1);
+        levels.emplace_back(words, 0);
+        words = (words + 63) / 64;
+    } while (levels.back().size() > 1);
+}
+
+// Sets a position, marking its word in the levels above if it was empty
+void HierarchicalBitmap::set(int position) {
+    if (test(position)) return;
+    setCount++;
+    for (vector<uint64_t>& level : levels) {
+        uint64_t& word = level[position >> 6];
+        bool wasEmpty = word == 0;
+        word |= 1ULL << (position & 63);
+        if (!wasEmpty) break;
+        position >>= 6;
+    }
+}
+
+// Clears a position, clearing its word's summary bit in the levels above if it became empty
+void HierarchicalBitmap::reset(int position) {
+    if (!test(position)) return;
+    setCount--;
+    for (vector<uint64_t>& level : levels) {
+        uint64_t& word = level[position >> 6];
+        word &= ~(1ULL << (position & 63));
+        if (word != 0) break;
+        position >>= 6;
+    }
+}
+
+// Returns the lowest set position at or after 'from'
+int HierarchicalBitmap::findNext(int from) const {
+    if (from < 0) from = 0;
+    if (from >= bitCount) return -1;
+
+    // Climb until a word has a set bit at or after the position, then descend to its lowest bit
+    size_t position = static_cast<size_t>(from);
+    for (size_t level = 0; level < levels.size(); ++level) {
+        size_t word = position >> 6;
+        if (word >= levels[level].size()) return -1;
+        uint64_t bits = levels[level][word] & (~0ULL << (position & 63));
+        if (bits != 0) {
+            position = (word << 6) + lowestBit(bits);
+            while (level > 0) {
+                --level;
+                position = (position << 6) + lowestBit(levels[level][position]);
+            }
+            return static_cast<int>(position);
+        }
+        position = word + 1; // The words after this one, as bits of the level above
+    }
+    return -1;
+}
+
+// Returns the highest set position at or before 'from'
+int HierarchicalBitmap::findPrevious(int from) const {
+    if (from >= bitCount) from = bitCount - 1;
+    if (from < 0) return -1;
+
+    // Climb until a word has a set bit at or before the position, then descend to its highest bit
+    size_t position = static_cast<size_t>(from);
+    for (size_t level = 0; level < levels.size(); ++level) {
+        size_t word = position >> 6;
+        size_t bit = position & 63;
+        uint64_t bits = levels[level][word] & (bit == 63 ? ~0ULL : (2ULL << bit) - 1);
+        if (bits != 0) {
+            position = (word << 6) + highestBit(bits);
+            while (level > 0) {
+                --level;
+                position = (position << 6) + highestBit(levels[level][position]);
+            }
+            return static_cast<int>(position);
+        }
+        if (word == 0) return -1;
+        position = word - 1; // The words before this one, as bits of the level above
+    }
+    return -1;
+}
+
+// Returns the approximate number of bytes used by the bitmap
+size_t HierarchicalBitmap::memoryUsage() const {
+    size_t bytes = levels.capacity() * sizeof(vector<uint64_t>);
+    for (const vector<uint64_t>& level : levels) {
+        bytes += level.capacity() * sizeof(uint64_t);
+    }
+    return bytes;
+}
+
+// Lays out the bays
+void BayAllocator::build(const vector<BayGroup>& layout) {
+    vector<BayGroup> ordered = layout;
+    stable_sort(ordered.begin(), ordered.end(), [](const BayGroup& a, const BayGroup& b) { return a.level < b.level; });
+
+    types.clear();
+    levelStarts.clear();
+    levelNumbers.clear();
+    for (const BayGroup& group : ordered) {
+        if (group.count <= 0) continue;
+        if (levelNumbers.empty() || levelNumbers.back() != group.level) {
+            levelNumbers.push_back(group.level);
+            levelStarts.push_back(static_cast<int>(types.size()));
+        }
+        types.insert(types.end(), group.count, group.type);
+    }
+    levelStarts.push_back(static_cast<int>(types.size()));
+
+    // Every bay starts free
+    for (HierarchicalBitmap& bitmap : freeBays) {
+        bitmap.resize(size());
+    }
+    for (int bay = 0; bay < size(); ++bay) {
+        freeBays[static_cast<int>(types[bay])].set(bay);
+    }
+}
+
+// Returns the index of a level in levelStarts
+int BayAllocator::levelIndex(int level) const {
+    auto it = lower_bound(levelNumbers.begin(), levelNumbers.end(), level);
+    return it != levelNumbers.end() && *it == level ? static_cast<int>(it - levelNumbers.begin()) : -1;
+}
+
+// Returns the index in levelStarts of the level a bay is on
+int BayAllocator::levelIndexOf(int bay) const {
+    return static_cast<int>(upper_bound(levelStarts.begin(), levelStarts.end(), bay) - levelStarts.begin()) - 1;
+}
+
+// Takes the lowest free bay of a type
+int BayAllocator::allocate(BayType type) {
+    HierarchicalBitmap& bitmap = freeBays[static_cast<int>(type)];
+    int bay = bitmap.findNext(0);
+    if (bay != -1) bitmap.reset(bay);
+    return bay;
+}
+
+// Takes the lowest free bay of a type on a level
+int BayAllocator::allocateOnLevel(BayType type, int level) {
+    int index = levelIndex(level);
+    if (index == -1) return -1;
+    HierarchicalBitmap& bitmap = freeBays[static_cast<int>(type)];
+    int bay = bitmap.findNext(levelStarts[index]);
+    if (bay == -1 || bay >= levelStarts[index + 1]) return -1;
+    bitmap.reset(bay);
+    return bay;
+}
+
+// Takes the free bay of a type closest to 'bay' on the same level
+int BayAllocator::allocateNear(BayType type, int bay) {
+    if (bay < 0 || bay >= size()) return -1;
+    int index = levelIndexOf(bay);
+    HierarchicalBitmap& bitmap = freeBays[static_cast<int>(type)];
+    int after = bitmap.findNext(bay);
+    int before = bitmap.findPrevious(bay);
+    if (after >= levelStarts[index + 1]) after = -1;
+    if (before < levelStarts[index]) before = -1;
+    if (after == -1 && before == -1) return -1;
+
+    int chosen = after == -1 || (before != -1 && bay - before <= after - bay) ? before : after;
+    bitmap.reset(chosen);
+    return chosen;
+}
+
+// Takes a given bay
+bool BayAllocator::take(int bay) {
+    if (bay < 0 || bay >= size() || !isFree(bay)) return false;
+    freeBays[static_cast<int>(types[bay])].reset(bay);
+    return true;
+}
+
+// Gives a bay back
+void BayAllocator::release(int bay) {
+    freeBays[static_cast<int>(types[bay])].set(bay);
+}
+
+// Returns the number of free bays of every type
+int BayAllocator::freeCount() const {
+    int count = 0;
+    for (const HierarchicalBitmap& bitmap : freeBays) {
+        count += bitmap.count();
+    }
+    return count;
+}
+
+// Appends a label such as "L2-017 (EV)" for a bay to 'out'
+void BayAllocator::appendLabel(int bay, string& out) const {
+    char label[48];
+    snprintf(label, sizeof(label), "L%d-%03d (%s)", levelOf(bay), numberOnLevel(bay), bayTypeName(types[bay]));
+    out += label;
+}
+
+// Returns the approximate number of bytes used by the allocator
+size_t BayAllocator::memoryUsage() const {
+    size_t bytes = types.capacity() * sizeof(BayType) + (levelStarts.capacity() + levelNumbers.capacity()) * sizeof(int);
+    for (const HierarchicalBitmap& bitmap : freeBays) {
+        bytes += bitmap.memoryUsage();
+    }
+    return bytes;
+}
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Vehicle.h"
+
+using namespace std;
+
+// Returns the display name of a bay type
+const char* bayTypeName(BayType type);
+
+// Parses a bay type name (standard, compact, ev, disabled); returns false if unknown
+bool parseBayType(const string& text, BayType& type);
+
+// A run of bays of one type on one level of the lot
+struct BayGroup {
+    int level;       // Level the bays are on (0 = ground)
+    BayType type;    // Kind of bay
+    int count;       // Number of bays
+};
+
+// Set of bit positions with a summary bit per 64-bit word, stacked until one word is left
+// Bit w of summary level k+1 is set if word w of level k has any bit set, so looking for
+// the next set bit at or after a position reads one word per level: about six words for
+// a million bits, whatever the fill level.
+class HierarchicalBitmap {
+private:
+    vector<vector<uint64_t>> levels;   // levels[0] holds the bits; each level above summarizes the one below
+    int bitCount;                      // Number of positions
+    int setCount;                      // Number of positions set
+
+public:
+    // Creates an empty bitmap with no positions
+    HierarchicalBitmap();
+
+    // Sizes the bitmap for 'count' positions, all clear
+    void resize(int count);
+
+    // Sets / clears a position
+    void set(int position);
+    void reset(int position);
+
+    // Returns true if a position is set
+    bool test(int position) const {
+        return (levels[0][position >> 6] >> (position & 63)) & 1;
+    }
+
+    // Returns the lowest set position at or after 'from' (-1 if none)
+    int findNext(int from) const;
+
+    // Returns the highest set position at or before 'from' (-1 if none)
+    int findPrevious(int from) const;
+
+    // Returns the number of positions set
+    int count() const { return setCount; }
+
+    // Returns the number of positions
+    int size() const { return bitCount; }
+
+    // Returns the approximate number of bytes used by the bitmap
+    size_t memoryUsage() const;
+};
+
+// Hands out the free bays of a lot with bay types and levels
+// Bays are numbered level by level, so the bays of one level form one range and a lower
+// number is nearer the entrance. Each bay type has a hierarchical bitmap of its free bays,
+// which makes the lowest free bay, the lowest on a level and the nearest to a given bay a
+// few word reads each instead of a scan that slows down as the lot fills up.
+class BayAllocator {
+private:
+    vector<BayType> types;                       // Type of each bay
+    vector<int> levelStarts;                     // First bay of each level, then the bay count
+    vector<int> levelNumbers;                    // Level number of each entry of levelStarts
+    HierarchicalBitmap freeBays[BAY_TYPE_COUNT]; // Free bays of each type
+
+    // Returns the index of a level in levelStarts (-1 if the lot has no such level)
+    int levelIndex(int level) const;
+
+    // Returns the index in levelStarts of the level a bay is on
+    int levelIndexOf(int bay) const;
+
+public:
+    // Lays out the bays; groups are numbered by level, keeping their order within a level
+    void build(const vector<BayGroup>& layout);
+
+    // Takes the lowest free bay of a type; returns -1 if none is free
+    int allocate(BayType type);
+
+    // Takes the lowest free bay of a type on a level; returns -1 if none is free there
+    int allocateOnLevel(BayType type, int level);
+
+    // Takes the free bay of a type closest to 'bay' on the same level (the lower one on a
+    // tie); returns -1 if that level has none free
+    int allocateNear(BayType type, int bay);
+
+    // Takes a given bay (e.g. the one a vehicle had before a restart); returns false if it is taken
+    bool take(int bay);
+
+    // Gives a bay back
+    void release(int bay);
+
+    // Returns true if a bay is free
+    bool isFree(int bay) const { return freeBays[static_cast<int>(types[bay])].test(bay); }
+
+    // Returns the number of free bays (of every type / of one type)
+    int freeCount() const;
+    int freeCount(BayType type) const { return freeBays[static_cast<int>(type)].count(); }
+
+    // Returns the lowest free bay of a type without taking it (-1 if none)
+    int peek(BayType type) const { return freeBays[static_cast<int>(type)].findNext(0); }
+
+    // Returns the number of bays
+    int size() const { return static_cast<int>(types.size()); }
+
+    // Returns the type / level of a bay
+    BayType typeOf(int bay) const { return types[bay]; }
+    int levelOf(int bay) const { return levelNumbers[levelIndexOf(bay)]; }
+
+    // Returns the number of a bay within its level, starting at 1
+    int numberOnLevel(int bay) const { return bay - levelStarts[levelIndexOf(bay)] + 1; }
+
+    // Appends a label such as "L2-017 (EV)" for a bay to 'out'
+    void appendLabel(int bay, string& out) const;
+
+    // Returns the approximate number of bytes used by the allocator
+    size_t memoryUsage() const;
+};
@@ -0,0 +1,454 @@
+#include "BenchmarkSuite.h"
+#include "ParkingManagementSystem.h"
+#include "ParkingStatistics.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <streambuf>
+
+static const char* SUITE_OWNERS[] = { "Ahmed", "Fatima", "Ali", "Ayesha", "Hassan", "Zainab", "Usman", "Maryam",
+    "Bilal", "Sana", "Hamza", "Hira", "Omar", "Noor", "Imran", "Sadia" };
+static const char* SUITE_MAKES[] = { "Toyota", "Honda", "Suzuki", "Hyundai", "Kia", "Nissan", "Daihatsu", "Mitsubishi" };
+static const char* SUITE_MODELS[] = { "Corolla", "Civic", "City", "Alto", "Cultus", "Swift", "Yaris", "Elantra",
+    "Sportage", "Mehran", "Wagon", "Mira", "Prius", "Vitz", "Aqua", "Picanto" };
+static const char* SUITE_COLORS[] = { "White", "Black", "Silver", "Grey", "Red", "Blue", "Green", "Maroon" };
+
+// Returns the name of a distribution
+const char* distributionName(PlateDistribution distribution) {
+    switch (distribution) {
+    case PlateDistribution::Sorted: return "sorted";
+    case PlateDistribution::Random: return "random";
+    default: return "zipfian";
+    }
+}
+
+// Returns the name of an arrival mix
+const char* mixName(ArrivalMix mix) {
+    return mix == ArrivalMix::SteadyState ? "steady-state" : "rush-hour";
+}
+
+// Scrambles an id so neighbouring ids get unrelated attributes
+static uint64_t mixBits(uint64_t value) {
+    value += 0x9E3779B97F4A7C15ULL;
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+    return value ^ (value >> 31);
+}
+
+// Prepares a Zipf generator
+ZipfianGenerator::ZipfianGenerator(uint64_t count, double skew) : n(max<uint64_t>(count, 1)), theta(skew) {
+    zetaN = 0;
+    for (uint64_t i = 1; i <= n; ++i) {
+        zetaN += 1.0 / pow(static_cast<double>(i), theta);
+    }
+    double zeta2 = 1.0 + 1.0 / pow(2.0, theta);
+    alpha = 1.0 / (1.0 - theta);
+    eta = (1.0 - pow(2.0 / n, 1.0 - theta)) / (1.0 - zeta2 / zetaN);
+    half = 1.0 + pow(0.5, theta);
+}
+
+// Draws the next rank
+uint64_t ZipfianGenerator::next(mt19937_64& rng) {
+    double u = uniform_real_distribution<double>(0.0, 1.0)(rng);
+    double uz = u * zetaN;
+    if (uz < 1.0) return 0;
+    if (uz < half) return 1;
+    uint64_t rank = static_cast<uint64_t>(n * pow(eta * u - eta + 1.0, alpha));
+    return min(rank, n - 1);
+}
+
+// Creates a generator over 'population' plate ids
+WorkloadGenerator::WorkloadGenerator(PlateDistribution kind, uint64_t count, uint64_t seed)
+    : distribution(kind), population(max<uint64_t>(count, 1)), rng(seed),
+    zipf(kind == PlateDistribution::Zipfian ? population : 1), cursor(0) {
+}
+
+// Returns the plate of an id
+string WorkloadGenerator::plateOf(uint64_t id) {
+    char plate[16];
+    snprintf(plate, sizeof(plate), "BM%08llu", static_cast<unsigned long long>(id % 100000000ULL));
+    return plate;
+}
+
+// Returns the vehicle of an id
+Vehicle WorkloadGenerator::vehicleOf(uint64_t id) {
+    uint64_t bits = mixBits(id);
+    char contact[16];
+    snprintf(contact, sizeof(contact), "0300%07llu", static_cast<unsigned long long>(bits % 10000000ULL));
+    return Vehicle(plateOf(id), SUITE_OWNERS[bits % 16], SUITE_MAKES[(bits >> 8) % 8],
+        SUITE_MODELS[(bits >> 16) % 16], SUITE_COLORS[(bits >> 24) % 8], contact);
+}
+
+// Returns the order in which the first 'count' ids arrive
+vector<uint32_t> WorkloadGenerator::arrivalOrder(uint32_t count) {
+    vector<uint32_t> order(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        order[i] = i;
+    }
+    if (distribution != PlateDistribution::Sorted) {
+        shuffle(order.begin(), order.end(), rng);
+    }
+    return order;
+}
+
+// Returns the id of the next lookup
+uint64_t WorkloadGenerator::nextId() {
+    switch (distribution) {
+    case PlateDistribution::Sorted:
+        return cursor++ % population;
+    case PlateDistribution::Random:
+        return rng() % population;
+    default:
+        // Hot ranks are scattered over the id space instead of being the lowest plates
+        return mixBits(zipf.next(rng)) % population;
+    }
+}
+
+// Returns a rank in [0, count)
+uint64_t WorkloadGenerator::nextRank(uint64_t count) {
+    if (count <= 1) return 0;
+    switch (distribution) {
+    case PlateDistribution::Sorted: return 0;
+    case PlateDistribution::Random: return rng() % count;
+    default: return zipf.next(rng) % count;
+    }
+}
+
+// Returns attribute values for advanced searches
+const char* WorkloadGenerator::makeOf(uint64_t index) { return SUITE_MAKES[index % 8]; }
+const char* WorkloadGenerator::modelOf(uint64_t index) { return SUITE_MODELS[index % 16]; }
+const char* WorkloadGenerator::colorOf(uint64_t index) { return SUITE_COLORS[index % 8]; }
+
+// Splits "a,b,c" into its items
+static vector<string> splitList(const string& text) {
+    vector<string> items;
+    stringstream stream(text);
+    string item;
+    while (getline(stream, item, ',')) {
+        if (!item.empty()) items.push_back(item);
+    }
+    return items;
+}
+
+// Parses the options that follow --bench-suite
+bool parseSuiteOptions(int argc, char* argv[], int first, SuiteOptions& options, string& error) {
+    for (int i = first; i < argc; ++i) {
+        string option = argv[i];
+        if (i + 1 >= argc) {
+            error = "Missing value for " + option;
+            return false;
+        }
+        string value = argv[++i];
+        if (option == "--capacities") {
+            options.capacities.clear();
+            for (const string& item : splitList(value)) {
+                int capacity = atoi(item.c_str());
+                if (capacity <= 0) {
+                    error = "Bad capacity " + item;
+                    return false;
+                }
+                options.capacities.push_back(capacity);
+            }
+        }
+        else if (option == "--plates") {
+            options.distributions.clear();
+            for (const string& item : splitList(value)) {
+                if (item == "sorted") options.distributions.push_back(PlateDistribution::Sorted);
+                else if (item == "random") options.distributions.push_back(PlateDistribution::Random);
+                else if (item == "zipf" || item == "zipfian") options.distributions.push_back(PlateDistribution::Zipfian);
+                else {
+                    error = "Unknown plate distribution " + item;
+                    return false;
+                }
+            }
+        }
+        else if (option == "--mix") {
+            options.mixes.clear();
+            for (const string& item : splitList(value)) {
+                if (item == "steady") options.mixes.push_back(ArrivalMix::SteadyState);
+                else if (item == "rush") options.mixes.push_back(ArrivalMix::RushHour);
+                else {
+                    error = "Unknown arrival mix " + item;
+                    return false;
+                }
+            }
+        }
+        else if (option == "--calls") {
+            options.maxCalls = strtoull(value.c_str(), nullptr, 10);
+        }
+        else if (option == "--seconds") {
+            options.secondsPerOperation = atof(value.c_str());
+        }
+        else if (option == "--json") {
+            options.jsonPath = value;
+        }
+        else {
+            error = "Unknown option " + option;
+            return false;
+        }
+    }
+    if (options.capacities.empty() || options.distributions.empty() || options.mixes.empty() || options.maxCalls == 0) {
+        error = "Nothing to run";
+        return false;
+    }
+    return true;
+}
+
+// Stream buffer that drops everything, so console output is not part of the timings
+class NullBuffer : public streambuf {
+protected:
+    int overflow(int c) override { return c; }
+    streamsize xsputn(const char*, streamsize count) override { return count; }
+};
+
+// Timings of one operation in one scenario
+struct OperationResult {
+    string operation;                 // Parking API that was called
+    int capacity = 0;                 // Lot size
+    PlateDistribution distribution = PlateDistribution::Sorted; // Plate order
+    ArrivalMix mix = ArrivalMix::SteadyState;                   // Arrival pattern
+    uint64_t calls = 0;               // Timed calls
+    uint64_t successes = 0;           // Calls that found or parked a vehicle
+    double seconds = 0;               // Time inside the timed calls
+    DurationHistogram latency;        // Latency of each call in nanoseconds
+};
+
+// Times calls of one operation until the call limit or the time budget is reached
+// 'call(i)' does the untimed preparation itself and returns the result of timeCall()
+class CallTimer {
+private:
+    OperationResult& result;       // Where timings go
+    uint64_t maxCalls;             // Call limit
+    double budget;                 // Time budget in seconds
+
+public:
+    CallTimer(OperationResult& target, uint64_t limit, double seconds) : result(target), maxCalls(limit), budget(seconds) {}
+
+    // Returns true while more calls may be made
+    bool more() const { return result.calls < maxCalls && result.seconds < budget; }
+
+    // Times one call; 'body' returns true on success
+    template <typename Body>
+    void timeCall(Body body) {
+        auto before = chrono::steady_clock::now();
+        bool ok = body();
+        auto after = chrono::steady_clock::now();
+        uint64_t nanoseconds = static_cast<uint64_t>(chrono::duration_cast<chrono::nanoseconds>(after - before).count());
+        result.latency.record(nanoseconds);
+        result.seconds += nanoseconds * 1e-9;
+        result.calls++;
+        if (ok) result.successes++;
+    }
+};
+
+// Creates an empty result for an operation of a scenario
+static OperationResult makeResult(const char* operation, int capacity, PlateDistribution distribution, ArrivalMix mix) {
+    OperationResult result;
+    result.operation = operation;
+    result.capacity = capacity;
+    result.distribution = distribution;
+    result.mix = mix;
+    return result;
+}
+
+// Runs one scenario and appends a result per measured operation
+// Both mixes time parkVehicle and retrieveVehicle; the steady-state mix then also
+// times the lookups and listings against the ~90% full lot it leaves behind.
+static void runScenario(const SuiteOptions& options, int capacity, PlateDistribution distribution, ArrivalMix mix,
+    vector<OperationResult>& results) {
+    ParkingConfig config;
+    config.logging.path = "";
+    config.journalPath = "";
+    config.archivePath = "";
+    ParkingManagementSystem lot(capacity, 10.0, config);
+
+    // Enough plate ids for the arrivals plus every timed park
+    uint64_t population = 2ULL * capacity + options.maxCalls;
+    WorkloadGenerator workload(distribution, population, 1234 + capacity);
+    vector<uint32_t> arrivals = workload.arrivalOrder(static_cast<uint32_t>(population));
+    size_t nextArrival = 0;
+
+    // Ids of parked vehicles live in arrivals[head, parkedEnd); retrieving one swaps it to
+    // 'head', so picking by rank only reorders vehicles that are really parked
+    size_t head = 0;
+    size_t parkedEnd = 0;
+
+    OperationResult park = makeResult("parkVehicle", capacity, distribution, mix);
+    OperationResult retrieve = makeResult("retrieveVehicle", capacity, distribution, mix);
+    CallTimer parkTimer(park, options.maxCalls, options.secondsPerOperation);
+    CallTimer retrieveTimer(retrieve, options.maxCalls, options.secondsPerOperation);
+
+    // Takes the next arrival through the gate
+    auto arrive = [&](CallTimer* timer) {
+        Vehicle vehicle = WorkloadGenerator::vehicleOf(arrivals[nextArrival++]);
+        if (timer) timer->timeCall([&]() { return lot.parkVehicle(vehicle) != ParkResult::AlreadyParked; });
+        else lot.parkVehicle(vehicle);
+    };
+
+    // Retrieves a parked vehicle chosen by the distribution (oldest first when sorted)
+    auto depart = [&]() {
+        size_t pick = head + static_cast<size_t>(workload.nextRank(parkedEnd - head));
+        swap(arrivals[head], arrivals[pick]);
+        string plate = WorkloadGenerator::plateOf(arrivals[head++]);
+        Cents fee = 0;
+        retrieveTimer.timeCall([&]() { return lot.retrieveVehicle(plate, fee) == RetrieveResult::Retrieved; });
+    };
+
+    if (mix == ArrivalMix::SteadyState) {
+        // Fill to 90% untimed, then alternate a departure and an arrival
+        int fill = max(1, capacity * 9 / 10);
+        while (static_cast<int>(nextArrival) < fill) arrive(nullptr);
+        parkedEnd = nextArrival;
+        while (parkTimer.more() && retrieveTimer.more() && nextArrival < arrivals.size()) {
+            depart();
+            arrive(&parkTimer);
+            parkedEnd = nextArrival;
+        }
+    }
+    else {
+        // Rush hours until the budget runs out: a quarter more arrivals than slots, then everybody
+        // leaves; the overflow waits and is admitted as slots free up
+        size_t rush = static_cast<size_t>(capacity) + max(1, capacity / 4);
+        while (parkTimer.more() && retrieveTimer.more() && nextArrival + rush <= arrivals.size()) {
+            head = nextArrival;
+            for (size_t i = 0; i < rush; ++i) arrive(&parkTimer);
+            parkedEnd = head + capacity;
+            while (head < parkedEnd) {
+                depart();
+                if (parkedEnd < nextArrival) parkedEnd++; // The next waiting vehicle was admitted
+            }
+        }
+    }
+    results.push_back(move(park));
+    results.push_back(move(retrieve));
+    if (mix != ArrivalMix::SteadyState) return;
+
+    // Lookups and listings print to the console; route it to a null buffer while timing
+    NullBuffer nothing;
+    streambuf* console = cout.rdbuf(&nothing);
+
+    OperationResult search = makeResult("searchVehicle", capacity, distribution, mix);
+    CallTimer searchTimer(search, options.maxCalls, options.secondsPerOperation);
+    size_t recent = min<size_t>(nextArrival, 2 * static_cast<size_t>(capacity));
+    while (searchTimer.more()) {
+        // Plates that arrived recently, so about half of them are still parked
+        string plate = WorkloadGenerator::plateOf(arrivals[nextArrival - 1 - workload.nextId() % recent]);
+        bool parked = lot.isParked(plate);
+        searchTimer.timeCall([&]() { lot.searchVehicle(plate); return parked; });
+    }
+
+    // Make only, make and model, or all three attributes
+    OperationResult advanced = makeResult("advancedSearch", capacity, distribution, mix);
+    CallTimer advancedTimer(advanced, options.maxCalls, options.secondsPerOperation);
+    for (uint64_t i = 0; advancedTimer.more(); ++i) {
+        string make = WorkloadGenerator::makeOf(workload.nextId());
+        string model = i % 3 >= 1 ? WorkloadGenerator::modelOf(workload.nextId()) : "";
+        string color = i % 3 == 2 ? WorkloadGenerator::colorOf(workload.nextId()) : "";
+        advancedTimer.timeCall([&]() { lot.advancedSearch(make, model, color); return true; });
+    }
+
+    OperationResult display = makeResult("displayAllParkedVehicles", capacity, distribution, mix);
+    CallTimer displayTimer(display, options.maxCalls, options.secondsPerOperation);
+    while (displayTimer.more()) {
+        displayTimer.timeCall([&]() { lot.displayAllParkedVehicles(true); return true; });
+    }
+
+    cout.rdbuf(console);
+    results.push_back(move(search));
+    results.push_back(move(advanced));
+    results.push_back(move(display));
+}
+
+// Prints one result row of the summary table
+static void printResultRow(const OperationResult& result) {
+    double rate = result.seconds > 0 ? result.calls / result.seconds : 0;
+    cout << setw(9) << result.capacity << "  " << left << setw(8) << distributionName(result.distribution)
+        << setw(13) << mixName(result.mix) << setw(25) << result.operation << right
+        << setw(13) << fixed << setprecision(0) << rate
+        << setw(10) << result.latency.percentile(50) << setw(10) << result.latency.percentile(99)
+        << setw(11) << result.latency.percentile(99.9) << setw(12) << result.latency.max() << "\n";
+}
+
+// Writes the results as JSON
+static void writeResultsJson(ostream& out, const SuiteOptions& options, const vector<OperationResult>& results,
+    time_t startedAt) {
+    tm local;
+    localtime_s(&local, &startedAt);
+#if defined(_MSC_VER)
+    string compiler = "msvc-" + to_string(_MSC_VER);
+#elif defined(__clang__)
+    string compiler = string("clang-") + __clang_version__;
+#elif defined(__GNUC__)
+    string compiler = string("gcc-") + __VERSION__;
+#else
+    string compiler = "unknown";
+#endif
+#ifdef NDEBUG
+    const char* build = "release";
+#else
+    const char* build = "debug";
+#endif
+
+    out << "{\n";
+    out << "  \"suite\": \"parking-engine\",\n";
+    out << "  \"schemaVersion\": 1,\n";
+    out << "  \"startedAt\": \"" << put_time(&local, "%Y-%m-%dT%H:%M:%S") << "\",\n";
+    out << "  \"compiler\": \"" << compiler << "\",\n";
+    out << "  \"build\": \"" << build << "\",\n";
+    out << "  \"maxCalls\": " << options.maxCalls << ",\n";
+    out << "  \"secondsPerOperation\": " << options.secondsPerOperation << ",\n";
+    out << "  \"results\": [";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const OperationResult& result = results[i];
+        double rate = result.seconds > 0 ? result.calls / result.seconds : 0;
+        out << (i == 0 ? "\n" : ",\n");
+        out << "    {\"operation\": \"" << result.operation << "\", \"capacity\": " << result.capacity
+            << ", \"plates\": \"" << distributionName(result.distribution) << "\", \"mix\": \"" << mixName(result.mix)
+            << "\", \"calls\": " << result.calls << ", \"successes\": " << result.successes
+            << ", \"seconds\": " << fixed << setprecision(6) << result.seconds
+            << ", \"opsPerSecond\": " << setprecision(1) << rate
+            << ", \"latencyNs\": {\"mean\": " << result.latency.mean()
+            << ", \"p50\": " << result.latency.percentile(50) << ", \"p90\": " << result.latency.percentile(90)
+            << ", \"p99\": " << result.latency.percentile(99) << ", \"p999\": " << result.latency.percentile(99.9)
+            << ", \"max\": " << result.latency.max() << "}}";
+    }
+    out << "\n  ]\n}\n";
+}
+
+// Runs every scenario
+bool runBenchmarkSuite(const SuiteOptions& options) {
+    time_t startedAt = time(0);
+    vector<OperationResult> results;
+
+    // With "--json -" the console only gets the JSON document
+    bool table = options.jsonPath != "-";
+    if (table) cout << "\nParking engine benchmark suite (latencies in ns)\n";
+    if (table) cout << " Capacity  Plates  Mix          Operation                        ops/s       p50       p99      p99.9         max\n";
+    for (int capacity : options.capacities) {
+        for (PlateDistribution distribution : options.distributions) {
+            for (ArrivalMix mix : options.mixes) {
+                size_t first = results.size();
+                runScenario(options, capacity, distribution, mix, results);
+                for (size_t i = first; table && i < results.size(); ++i) {
+                    printResultRow(results[i]);
+                }
+            }
+        }
+    }
+
+    if (options.jsonPath == "-") {
+        writeResultsJson(cout, options, results, startedAt);
+        return true;
+    }
+    ofstream file(options.jsonPath);
+    if (!file.is_open()) {
+        return false;
+    }
+    writeResultsJson(file, options, results, startedAt);
+    cout << "\nResults written to " << options.jsonPath << "\n";
+    return static_cast<bool>(file);
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+#include "Vehicle.h"
+
+using namespace std;
+
+// How plates are ordered when they arrive and how lookups pick them
+enum class PlateDistribution {
+    Sorted,     // Plates arrive in ascending order and are looked up in order
+    Random,     // Plates arrive shuffled and are looked up uniformly
+    Zipfian     // Plates arrive shuffled; a few hot plates get most of the lookups
+};
+
+// Arrival pattern at the gates
+enum class ArrivalMix {
+    SteadyState,   // Lot stays about 90% full, every departure is followed by an arrival
+    RushHour       // Empty lot takes 125% of its capacity at once, then everybody leaves
+};
+
+// Returns the name used for a distribution or mix in results ("sorted", "rush-hour", ...)
+const char* distributionName(PlateDistribution distribution);
+const char* mixName(ArrivalMix mix);
+
+// Draws ranks 0..n-1 following a Zipf law (rank 0 is the hottest) in O(1) per draw
+// Uses the rejection-free approximation popularized by YCSB; setup costs O(n).
+class ZipfianGenerator {
+private:
+    uint64_t n;       // Number of ranks
+    double theta;     // Skew (0.99 is the usual "hot set" setting)
+    double alpha;     // 1 / (1 - theta)
+    double zetaN;     // Sum of 1 / i^theta for i = 1..n
+    double eta;       // Correction term of the approximation
+    double half;      // 1 + 0.5^theta
+
+public:
+    // Prepares a generator over 'count' ranks
+    ZipfianGenerator(uint64_t count, double skew = 0.99);
+
+    // Draws the next rank
+    uint64_t next(mt19937_64& rng);
+};
+
+// Synthetic plates, vehicles and plate sequences for benchmarks and load tests
+// Plate ids map to fixed plates ("BM" plus eight digits), so ascending ids are also
+// ascending plates, and every id always produces the same vehicle.
+class WorkloadGenerator {
+private:
+    PlateDistribution distribution;   // How lookups pick plates
+    uint64_t population;              // Number of distinct plate ids
+    mt19937_64 rng;                   // Random source
+    ZipfianGenerator zipf;            // Rank generator for Zipfian lookups
+    uint64_t cursor;                  // Next id of sorted lookups
+
+public:
+    // Creates a generator over 'population' plate ids
+    WorkloadGenerator(PlateDistribution distribution, uint64_t population, uint64_t seed);
+
+    // Returns the plate of an id
+    static string plateOf(uint64_t id);
+
+    // Returns the vehicle of an id (owner, make, model, color and contact derive from the id)
+    static Vehicle vehicleOf(uint64_t id);
+
+    // Returns the order in which the first 'count' ids arrive
+    vector<uint32_t> arrivalOrder(uint32_t count);
+
+    // Returns the id of the next lookup
+    uint64_t nextId();
+
+    // Returns a rank in [0, count) following the distribution (0 is the oldest or hottest)
+    uint64_t nextRank(uint64_t count);
+
+    // Returns a random attribute value for advanced searches
+    static const char* makeOf(uint64_t index);
+    static const char* modelOf(uint64_t index);
+    static const char* colorOf(uint64_t index);
+};
+
+// Settings of a benchmark suite run
+struct SuiteOptions {
+    vector<int> capacities = { 10, 1000, 100000, 1000000 };   // Lot sizes to test
+    vector<PlateDistribution> distributions = { PlateDistribution::Sorted, PlateDistribution::Random, PlateDistribution::Zipfian };
+    vector<ArrivalMix> mixes = { ArrivalMix::SteadyState, ArrivalMix::RushHour };
+    uint64_t maxCalls = 200000;          // Most timed calls per operation and scenario
+    double secondsPerOperation = 1.0;    // Time budget per operation and scenario
+    string jsonPath = "benchmark_results.json"; // Where results are written ("-" prints them)
+};
+
+// Parses the options that follow --bench-suite; returns false and sets 'error' on bad input
+// Options: --capacities 10,1000,... --plates sorted,random,zipf --mix steady,rush
+//          --calls N --seconds S --json <file|->
+bool parseSuiteOptions(int argc, char* argv[], int first, SuiteOptions& options, string& error);
+
+// Runs every scenario, prints a summary table and writes the results as JSON
+// Returns false if the JSON file cannot be written.
+bool runBenchmarkSuite(const SuiteOptions& options);
@@ -0,0 +1,2574 @@
+#include "Benchmarks.h"
+#include "PlateIndex.h"
+#include "VehicleStore.h"
+#include "ParkingManagementSystem.h"
+#include "LogAnalytics.h"
+#include "ConcurrentParkingSystem.h"
+#include "ParkingFederation.h"
+#include "WaitingList.h"
+#include "Tariff.h"
+#include "ParkingStatistics.h"
+#include "Validation.h"
+#include "PlateHashMap.h"
+#include "TimerWheel.h"
+#include "TimestampFormatter.h"
+#include "ParkingExport.h"
+#include "SessionArchive.h"
+#include "Metrics.h"
+#include "FuzzyPlateIndex.h"
+#include "ParkingImport.h"
+#include "ParkingSimulator.h"
+#include "BayAllocator.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <memory>
+#include <random>
+#include <vector>
+#include <algorithm>
+#include <fstream>
+#include <thread>
+#include <cstdio>
+#include <cstring>
+#include <atomic>
+#include <mutex>
+#include <unordered_set>
+#include <unordered_map>
+#include <queue>
+#include <map>
+
+using namespace std;
+
+// Returns the seconds elapsed since a start time
+static double secondsSince(chrono::steady_clock::time_point start) {
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+// Builds 'count' distinct plates in sorted (sequential registration) order
+static vector<string> makeSequentialPlates(int count) {
+    vector<string> plates;
+    plates.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        string digits = to_string(i);
+        plates.push_back("LEA" + string(7 - min<size_t>(7, digits.size()), '0') + digits);
+    }
+    return plates;
+}
+
+// The recursive, unbalanced BST the parking system used before PlateIndex
+struct LegacyBSTNode {
+    string regNumber;                 // Registration number
+    int value;                        // Slot index
+    unique_ptr<LegacyBSTNode> left;   // Left child
+    unique_ptr<LegacyBSTNode> right;  // Right child
+};
+
+// Inserts into the legacy BST (recursive, like the old insertToBST)
+static void legacyInsert(unique_ptr<LegacyBSTNode>& root, const string& regNumber, int value) {
+    if (!root) {
+        root.reset(new LegacyBSTNode{ regNumber, value, nullptr, nullptr });
+    }
+    else if (regNumber < root->regNumber) {
+        legacyInsert(root->left, regNumber, value);
+    }
+    else {
+        legacyInsert(root->right, regNumber, value);
+    }
+}
+
+// Searches the legacy BST (recursive, like the old searchInBST)
+static LegacyBSTNode* legacySearch(LegacyBSTNode* root, const string& regNumber) {
+    if (!root || root->regNumber == regNumber) return root;
+    if (regNumber < root->regNumber) return legacySearch(root->left.get(), regNumber);
+    return legacySearch(root->right.get(), regNumber);
+}
+
+// Frees a degenerate legacy BST iteratively (the recursive destructor would overflow the stack)
+static void legacyDestroy(unique_ptr<LegacyBSTNode>& root) {
+    vector<unique_ptr<LegacyBSTNode>> pending;
+    if (root) pending.push_back(move(root));
+    while (!pending.empty()) {
+        unique_ptr<LegacyBSTNode> node = move(pending.back());
+        pending.pop_back();
+        if (node->left) pending.push_back(move(node->left));
+        if (node->right) pending.push_back(move(node->right));
+    }
+}
+
+// Compares the balanced plate index with the legacy recursive BST
+void runPlateIndexBenchmark(int plateCount) {
+    // The legacy BST recurses once per level, so sorted input deeper than this overflows the stack
+    const int legacySortedLimit = 20000;
+
+    vector<string> sorted = makeSequentialPlates(plateCount);
+    vector<string> shuffled = sorted;
+    shuffle(shuffled.begin(), shuffled.end(), mt19937(42));
+
+    cout << "\nPlate index benchmark (" << plateCount << " plates)\n";
+    cout << left << setw(10) << "Order" << setw(14) << "Structure" << right
+        << setw(14) << "Insert ns/op" << setw(14) << "Find ns/op" << setw(14) << "Erase ns/op" << setw(8) << "Height" << "\n";
+
+    for (int pass = 0; pass < 2; ++pass) {
+        const vector<string>& plates = pass == 0 ? sorted : shuffled;
+        const char* order = pass == 0 ? "sorted" : "random";
+
+        // Balanced index: insert, find in random order, erase
+        PlateIndex index;
+        auto start = chrono::steady_clock::now();
+        for (int i = 0; i < plateCount; ++i) index.insert(plates[i], i);
+        double insertSeconds = secondsSince(start);
+        int height = index.height();
+
+        long long checksum = 0;
+        start = chrono::steady_clock::now();
+        for (const string& plate : shuffled) checksum += index.find(plate);
+        double findSeconds = secondsSince(start);
+
+        start = chrono::steady_clock::now();
+        for (const string& plate : plates) index.erase(plate);
+        double eraseSeconds = secondsSince(start);
+
+        cout << left << setw(10) << order << setw(14) << "PlateIndex" << right << fixed << setprecision(1)
+            << setw(14) << insertSeconds * 1e9 / plateCount
+            << setw(14) << findSeconds * 1e9 / plateCount
+            << setw(14) << eraseSeconds * 1e9 / plateCount
+            << setw(8) << height << "\n";
+
+        // Legacy BST: only when the recursion depth is safe
+        int legacyCount = pass == 0 ? min(plateCount, legacySortedLimit) : plateCount;
+        unique_ptr<LegacyBSTNode> legacyRoot;
+        start = chrono::steady_clock::now();
+        for (int i = 0; i < legacyCount; ++i) legacyInsert(legacyRoot, plates[i], i);
+        insertSeconds = secondsSince(start);
+
+        start = chrono::steady_clock::now();
+        for (int i = 0; i < legacyCount; ++i) {
+            LegacyBSTNode* node = legacySearch(legacyRoot.get(), shuffled[i]);
+            if (node) checksum += node->value;
+        }
+        findSeconds = secondsSince(start);
+        legacyDestroy(legacyRoot);
+
+        cout << left << setw(10) << order << setw(14) << "LegacyBST" << right
+            << setw(14) << insertSeconds * 1e9 / legacyCount
+            << setw(14) << findSeconds * 1e9 / legacyCount
+            << setw(14) << "n/a" << setw(8) << "-";
+        if (legacyCount < plateCount) {
+            cout << "  (limited to " << legacyCount << " plates)";
+        }
+        cout << "\n";
+
+        if (checksum == -1) cout << "";  // Keeps the lookups from being optimized away
+    }
+}
+
+// Record layout of a vehicle before the columnar store (six strings plus BST child pointers)
+struct LegacyVehicleLayout {
+    string fields[6];                         // Registration, owner, make, model, color, contact
+    time_t entryTime;                         // Entry timestamp
+    unique_ptr<LegacyVehicleLayout> left;     // BST left child
+    unique_ptr<LegacyVehicleLayout> right;    // BST right child
+};
+
+// Heap bytes owned by a string beyond its inline (small string) buffer
+static size_t stringHeapBytes(const string& value) {
+    return value.size() > string().capacity() ? value.size() + 1 : 0;
+}
+
+// Builds a synthetic vehicle with realistic value repetition
+static Vehicle makeSyntheticVehicle(int i, mt19937& rng) {
+    static const char* owners[] = { "Ahmed", "Fatima", "Ali", "Ayesha", "Hassan", "Zainab", "Usman", "Maryam",
+        "Bilal", "Sana", "Hamza", "Hira", "Omar", "Noor", "Imran", "Sadia", "Daud", "Faria", "Aqsa", "Kamran" };
+    static const char* makes[] = { "Toyota", "Honda", "Suzuki", "Hyundai", "Kia", "Nissan", "Daihatsu", "Mitsubishi", "Changan", "MG" };
+    static const char* models[] = { "Corolla", "Civic", "City", "Alto", "Cultus", "Swift", "Yaris", "Elantra", "Sportage", "Sonata",
+        "Mehran", "Wagon", "Mira", "Prius", "Fortuner", "Hilux", "Vitz", "Aqua", "Picanto", "Stonic",
+        "Tucson", "Sunny", "Lancer", "Pajero", "Alsvin", "Karvaan", "HS", "ZS", "Cuore", "Move" };
+    static const char* colors[] = { "White", "Black", "Silver", "Grey", "Red", "Blue", "Green", "Maroon", "Beige", "Gold", "Brown", "Orange" };
+
+    string digits = to_string(i);
+    string plate = "LEA" + string(7 - min<size_t>(7, digits.size()), '0') + digits;
+    string contact = "0300" + to_string(1000000 + rng() % 9000000);
+    return Vehicle(plate, owners[rng() % 20], makes[rng() % 10], models[rng() % 30], colors[rng() % 12], contact);
+}
+
+// Reports bytes per parked vehicle before and after the columnar store
+void runMemoryReport(int vehicleCount) {
+    mt19937 rng(7);
+    VehicleStore store;
+    store.resize(vehicleCount);
+
+    // Legacy cost per vehicle: shared_ptr record, separate BST copy, hash node keyed by a string copy
+    const size_t controlBlock = 2 * sizeof(long) + sizeof(void*);            // make_shared reference counts + vtable
+    const size_t hashNode = sizeof(string) + sizeof(shared_ptr<Vehicle>) + 2 * sizeof(void*); // key, value, list links
+    const size_t hashBucket = 2 * sizeof(void*);                             // bucket entry per element at load factor 1
+    const size_t stackEntry = sizeof(shared_ptr<Vehicle>);                   // deque slot of the parking stack
+    size_t legacyBytes = 0;
+
+    for (int i = 0; i < vehicleCount; ++i) {
+        Vehicle vehicle = makeSyntheticVehicle(i, rng);
+        store.put(i, vehicle, vehicle.entryTime);
+
+        size_t stringBytes = stringHeapBytes(vehicle.regNumber) + stringHeapBytes(vehicle.ownerName)
+            + stringHeapBytes(vehicle.vehicleMake) + stringHeapBytes(vehicle.vehicleModel)
+            + stringHeapBytes(vehicle.vehicleColor) + stringHeapBytes(vehicle.ownerContact);
+        legacyBytes += controlBlock + sizeof(LegacyVehicleLayout) + stringBytes   // shared record
+            + sizeof(LegacyVehicleLayout) + stringBytes                           // BST copy
+            + hashNode + hashBucket + stringHeapBytes(vehicle.regNumber)          // hash entry
+            + stackEntry;
+    }
+    size_t storeBytes = store.memoryUsage();
+
+    cout << "\nVehicle record memory (" << vehicleCount << " vehicles, allocator overhead excluded)\n";
+    cout << fixed << setprecision(1);
+    cout << "   Before (shared_ptr + BST copy + hash node): " << double(legacyBytes) / vehicleCount << " bytes/vehicle\n";
+    cout << "   After  (columnar VehicleStore):             " << double(storeBytes) / vehicleCount << " bytes/vehicle\n";
+    cout << "   Distinct makes/models/colors: " << store.makeDictionary().size() << "/"
+        << store.modelDictionary().size() << "/" << store.colorDictionary().size() << "\n";
+}
+
+// Measures restart time from a snapshot plus a journal tail
+void runRecoveryBenchmark(int vehicleCount) {
+    const string journalPath = "bench_Journal.bin";
+    const string snapshotPath = "bench_Snapshot.bin";
+    remove(journalPath.c_str());
+    remove(snapshotPath.c_str());
+
+    ParkingConfig config;
+    config.logging.path = "";
+    config.journalPath = journalPath;
+    config.archivePath = "";
+    config.snapshotPath = snapshotPath;
+    config.journalFlushEveryEvent = false;
+    config.snapshotEveryEvents = 0;
+
+    mt19937 rng(11);
+    int tailEvents = max(1, vehicleCount / 10);
+    double checkpointSeconds;
+    {
+        // Fill the lot, checkpoint, then leave a journal tail of retrievals and new arrivals
+        ParkingManagementSystem system(vehicleCount, 10.0, config);
+        for (int i = 0; i < vehicleCount; ++i) {
+            system.parkVehicle(makeSyntheticVehicle(i, rng));
+        }
+        auto start = chrono::steady_clock::now();
+        system.checkpoint();
+        checkpointSeconds = secondsSince(start);
+
+        Cents fee;
+        for (int i = 0; i < tailEvents; ++i) {
+            Vehicle vehicle = makeSyntheticVehicle(vehicleCount + i, rng);
+            system.retrieveVehicle(makeSyntheticVehicle(i, rng).regNumber, fee);
+            system.parkVehicle(vehicle);
+        }
+    }
+
+    // Restart: the constructor loads the snapshot and replays the tail
+    auto start = chrono::steady_clock::now();
+    int recovered;
+    {
+        ParkingManagementSystem system(vehicleCount, 10.0, config);
+        recovered = system.getCurrentVehicleCount();
+        double recoverySeconds = secondsSince(start);
+
+        cout << "\nRecovery benchmark (" << vehicleCount << " live vehicles, " << 2 * tailEvents << " journal records)\n";
+        cout << fixed << setprecision(3);
+        cout << "   Checkpoint time: " << checkpointSeconds << " s\n";
+        cout << "   Recovery time:   " << recoverySeconds << " s\n";
+        cout << "   Vehicles recovered: " << recovered << "\n";
+    }
+
+    remove(journalPath.c_str());
+    remove(snapshotPath.c_str());
+}
+
+// Writes a synthetic log and measures analyzer throughput
+void runLogAnalyticsBenchmark(int megabytes) {
+    const string path = "bench_Log.txt";
+    size_t targetBytes = static_cast<size_t>(megabytes) << 20;
+
+    // Generate a month of park/retrieve lines in the logEvent format
+    {
+        ofstream file(path, ios::binary | ios::trunc);
+        string block;
+        block.reserve(1 << 20);
+        size_t written = 0;
+        mt19937 rng(3);
+        for (long long i = 0; written < targetBytes; ++i) {
+            char line[128];
+            int day = 1 + static_cast<int>((i / 40000) % 30);
+            int hour = static_cast<int>((i / 1700) % 24);
+            int length;
+            if (i % 2 == 0) {
+                length = snprintf(line, sizeof(line), "[2024-06-%02d %02d:%02d:%02d] Parked vehicle: LEA%07lld Ahmed\n",
+                    day, hour, static_cast<int>(rng() % 60), static_cast<int>(rng() % 60), i % 10000000);
+            }
+            else {
+                length = snprintf(line, sizeof(line), "[2024-06-%02d %02d:%02d:%02d] Retrieved vehicle: LEA%07lld, Fee: $%u.%02u\n",
+                    day, hour, static_cast<int>(rng() % 60), static_cast<int>(rng() % 60), (i - 1) % 10000000,
+                    static_cast<unsigned>(rng() % 50), static_cast<unsigned>(rng() % 100));
+            }
+            block.append(line, length);
+            if (block.size() >= (1 << 20)) {
+                file.write(block.data(), block.size());
+                written += block.size();
+                block.clear();
+            }
+        }
+        file.write(block.data(), block.size());
+    }
+
+    // One cold-ish pass to fault the pages in, then the measured pass
+    AnalysisOptions options;
+    options.includeRotated = false;
+    LogAnalysis warmup;
+    analyzeLogs({ path }, options, warmup);
+    LogAnalysis analysis;
+    analyzeLogs({ path }, options, analysis);
+
+    cout << "\nLog analytics benchmark (" << megabytes << " MB, "
+        << (options.threads > 0 ? options.threads : static_cast<int>(thread::hardware_concurrency())) << " threads)\n";
+    cout << fixed << setprecision(3);
+    cout << "   Lines: " << analysis.linesScanned << "\n";
+    cout << "   Time:  " << analysis.seconds << " s\n";
+    cout << "   Throughput: " << setprecision(2) << analysis.bytesScanned / analysis.seconds / 1e9 << " GB/s\n";
+
+    remove(path.c_str());
+}
+
+// Runs 'threadCount' gates against the same lot, each doing 'opsPerThread' operations
+// (40% park, 40% retrieve, 20% search on random plates); returns operations per second
+template <typename Park, typename Retrieve, typename Search>
+static double runGateMix(int threadCount, int opsPerThread, const vector<Vehicle>& vehicles,
+    Park park, Retrieve retrieve, Search search) {
+    atomic<int> ready(0);
+    atomic<bool> go(false);
+    vector<thread> gates;
+    for (int t = 0; t < threadCount; ++t) {
+        gates.emplace_back([&, t]() {
+            mt19937 rng(1000 + t);
+            uniform_int_distribution<int> pick(0, static_cast<int>(vehicles.size()) - 1);
+            ready++;
+            while (!go.load()) {
+                this_thread::yield();
+            }
+            for (int i = 0; i < opsPerThread; ++i) {
+                const Vehicle& vehicle = vehicles[pick(rng)];
+                unsigned roll = rng() % 10;
+                if (roll < 4) park(vehicle);
+                else if (roll < 8) retrieve(vehicle.regNumber);
+                else search(vehicle.regNumber);
+            }
+        });
+    }
+    while (ready.load() < threadCount) {
+        this_thread::yield();
+    }
+    auto start = chrono::steady_clock::now();
+    go = true;
+    for (thread& gate : gates) {
+        gate.join();
+    }
+    return double(threadCount) * opsPerThread / secondsSince(start);
+}
+
+// Hammers a small lot from many gates and checks the invariants afterwards
+static bool runConcurrencyStressTest(int threadCount, int opsPerThread) {
+    const int capacity = 64;
+    mt19937 rng(21);
+    vector<Vehicle> vehicles;
+    for (int i = 0; i < capacity * 4; ++i) {
+        vehicles.push_back(makeSyntheticVehicle(i, rng));
+    }
+
+    ConcurrentConfig config;
+    config.logging.path = "";
+    config.tokenBatch = 4;
+    ConcurrentParkingSystem lot(capacity, 10.0, config);
+
+    // Watch the occupancy while the gates run; it must never exceed the capacity
+    atomic<bool> running(true);
+    atomic<int> peak(0);
+    atomic<bool> oversubscribed(false);
+    atomic<bool> wrongVehicle(false);
+    thread monitor([&]() {
+        // The monitor is the only writer of 'peak'; the gates report failures through their own flags
+        while (running.load()) {
+            peak = max(peak.load(), lot.getCurrentVehicleCount());
+        }
+    });
+
+    // Every gate has its own fee and vehicle; the lot is the only shared state
+    runGateMix(threadCount, opsPerThread, vehicles,
+        [&](const Vehicle& vehicle) {
+            lot.parkVehicle(vehicle);
+            if (lot.getCurrentVehicleCount() > capacity) oversubscribed = true;
+        },
+        [&](const string& regNumber) {
+            Cents fee;
+            lot.retrieveVehicle(regNumber, fee);
+        },
+        [&](const string& regNumber) {
+            // A vehicle found by plate must carry the same plate
+            Vehicle found;
+            if (lot.findVehicle(regNumber, found) && found.regNumber != regNumber) wrongVehicle = true;
+        });
+    running = false;
+    monitor.join();
+
+    // Tokens are conserved: every slot is either occupied, in the pool or cached by a shard
+    CapacityStats stats = lot.getCapacityStats();
+    vector<Vehicle> parked;
+    lot.filterVehicles(VehicleFilter(), parked);
+    unordered_set<string> plates;
+    bool plateChecksPass = !wrongVehicle.load();
+    for (const Vehicle& vehicle : parked) {
+        if (!plates.insert(vehicle.regNumber).second || !lot.isParked(vehicle.regNumber)) plateChecksPass = false;
+    }
+
+    bool neverOversubscribed = !oversubscribed.load() && peak.load() <= capacity;
+    bool tokensConserved = stats.occupied + stats.available + stats.cached == capacity;
+    bool countsAgree = static_cast<int>(parked.size()) == stats.occupied;
+    bool queueOnlyWhenFull = lot.getWaitingCount() == 0 || stats.occupied == capacity;
+
+    cout << "\nConcurrency stress test (" << threadCount << " gates x " << opsPerThread << " ops, capacity "
+        << capacity << ", " << vehicles.size() << " plates)\n";
+    cout << "   Peak occupancy:        " << peak.load() << (neverOversubscribed ? "  OK" : "  FAILED") << "\n";
+    cout << "   Token conservation:    " << stats.occupied << " parked + " << stats.available << " pooled + "
+        << stats.cached << " cached" << (tokensConserved ? "  OK" : "  FAILED") << "\n";
+    cout << "   Shard contents:        " << parked.size() << " vehicles, unique plates"
+        << (countsAgree && plateChecksPass ? "  OK" : "  FAILED") << "\n";
+    cout << "   Waiting queue:         " << lot.getWaitingCount() << (queueOnlyWhenFull ? "  OK" : "  FAILED") << "\n";
+    return neverOversubscribed && tokensConserved && countsAgree && plateChecksPass && queueOnlyWhenFull;
+}
+
+// Stress-tests the concurrent engine and measures throughput against the number of gates
+void runConcurrencyBenchmark(int opsPerThread) {
+    int hardwareThreads = max(1, static_cast<int>(thread::hardware_concurrency()));
+    bool passed = runConcurrencyStressTest(max(8, hardwareThreads), max(10000, opsPerThread / 10));
+
+    // Half the plates are parked before each run, so parks and retrieves both mostly succeed
+    const int plateCount = 200000;
+    mt19937 rng(5);
+    vector<Vehicle> vehicles;
+    vehicles.reserve(plateCount);
+    for (int i = 0; i < plateCount; ++i) {
+        vehicles.push_back(makeSyntheticVehicle(i, rng));
+    }
+    ParkingConfig singleConfig;
+    singleConfig.logging.path = "";
+    singleConfig.journalPath = "";
+    singleConfig.archivePath = "";
+    ConcurrentConfig shardedConfig;
+    shardedConfig.logging.path = "";
+
+    cout << "\nConcurrency benchmark (" << opsPerThread << " ops per gate, 40% park / 40% retrieve / 20% search, "
+        << hardwareThreads << " hardware threads)\n";
+    cout << "   Gates   One lock (ops/s)   Sharded (ops/s)   Scaling\n";
+    double shardedBase = 0;
+    for (int threads = 1; threads <= max(8, 2 * hardwareThreads); threads *= 2) {
+        // Baseline: the single-threaded system behind one mutex, as every gate serializing through one loop
+        double lockedRate;
+        {
+            ParkingManagementSystem lot(plateCount, 10.0, singleConfig);
+            mutex lock;
+            for (int i = 0; i < plateCount; i += 2) {
+                lot.parkVehicle(vehicles[i]);
+            }
+            Cents fee;
+            Vehicle found;
+            lockedRate = runGateMix(threads, opsPerThread, vehicles,
+                [&](const Vehicle& vehicle) { lock_guard<mutex> guard(lock); lot.parkVehicle(vehicle); },
+                [&](const string& regNumber) { lock_guard<mutex> guard(lock); lot.retrieveVehicle(regNumber, fee); },
+                [&](const string& regNumber) { lock_guard<mutex> guard(lock); lot.findVehicle(regNumber, found); });
+        }
+
+        double shardedRate;
+        {
+            ConcurrentParkingSystem lot(plateCount, 10.0, shardedConfig);
+            for (int i = 0; i < plateCount; i += 2) {
+                lot.parkVehicle(vehicles[i]);
+            }
+            shardedRate = runGateMix(threads, opsPerThread, vehicles,
+                [&](const Vehicle& vehicle) { lot.parkVehicle(vehicle); },
+                [&](const string& regNumber) { Cents fee; lot.retrieveVehicle(regNumber, fee); },
+                [&](const string& regNumber) { Vehicle found; lot.findVehicle(regNumber, found); });
+        }
+        if (threads == 1) shardedBase = shardedRate;
+
+        cout << "   " << setw(5) << threads << "   " << setw(16) << fixed << setprecision(0) << lockedRate
+            << "   " << setw(15) << shardedRate << "   " << setw(6) << setprecision(2) << shardedRate / shardedBase << "x\n";
+    }
+    cout << (passed ? "\nStress test passed.\n" : "\nStress test FAILED.\n");
+}
+
+// Routes arrivals across federations of growing size and checks routing against a full scan
+void runFederationBenchmark(int maxLots) {
+    const int slotsPerLot = 20;
+    cout << "\nFederation benchmark (" << slotsPerLot << " slots per lot, arrivals aimed at 10% of the lots)\n";
+    cout << "     Lots   Park (us/op)   Route (us/op)   Find (us/op)   Routing check\n";
+
+    bool allMatch = true;
+    for (int lotCount = 100; lotCount <= maxLots; lotCount *= 10) {
+        mt19937 rng(17);
+        uniform_real_distribution<double> coordinate(0.0, 100.0);
+        LoggerOptions logging;
+        logging.path = "";
+        ParkingFederation federation(logging);
+        for (int i = 0; i < lotCount; ++i) {
+            federation.addLot(LotSite{ "Lot " + to_string(i), coordinate(rng), coordinate(rng), slotsPerLot, 10.0 });
+        }
+
+        // Fill the federation to 90% with arrivals at a few popular lots, so most of them overflow
+        int vehicleCount = lotCount * slotsPerLot * 9 / 10;
+        vector<Vehicle> vehicles;
+        vehicles.reserve(vehicleCount);
+        for (int i = 0; i < vehicleCount; ++i) {
+            vehicles.push_back(makeSyntheticVehicle(i, rng));
+        }
+        int popularLots = max(1, lotCount / 10);
+        int assigned;
+        ParkResult result;
+        auto start = chrono::steady_clock::now();
+        for (int i = 0; i < vehicleCount; ++i) {
+            federation.parkVehicle(vehicles[i], static_cast<int>(rng() % popularLots), assigned, result);
+        }
+        double parkMicros = secondsSince(start) * 1e6 / vehicleCount;
+
+        // Nearest-lot-with-space queries from random points, compared with a scan of every lot
+        const int queries = 2000;
+        vector<pair<double, double>> points;
+        for (int i = 0; i < queries; ++i) {
+            points.emplace_back(coordinate(rng), coordinate(rng));
+        }
+        vector<int> routed(queries);
+        start = chrono::steady_clock::now();
+        for (int i = 0; i < queries; ++i) {
+            routed[i] = federation.findNearestLotWithSpace(points[i].first, points[i].second);
+        }
+        double routeMicros = secondsSince(start) * 1e6 / queries;
+
+        bool match = true;
+        for (int i = 0; i < queries && match; ++i) {
+            double bestDistance = -1;
+            for (int lot = 0; lot < lotCount; ++lot) {
+                if (federation.getFreeSlots(lot) == 0) continue;
+                double dx = federation.getLotSite(lot).x - points[i].first;
+                double dy = federation.getLotSite(lot).y - points[i].second;
+                if (bestDistance < 0 || dx * dx + dy * dy < bestDistance) bestDistance = dx * dx + dy * dy;
+            }
+            const LotSite& site = federation.getLotSite(routed[i]);
+            double dx = site.x - points[i].first;
+            double dy = site.y - points[i].second;
+            match = federation.getFreeSlots(routed[i]) > 0 && dx * dx + dy * dy == bestDistance;
+        }
+        allMatch = allMatch && match;
+
+        // Directory lookups of parked plates
+        Vehicle found;
+        int lot;
+        start = chrono::steady_clock::now();
+        for (int i = 0; i < queries; ++i) {
+            federation.findVehicle(vehicles[rng() % vehicleCount].regNumber, found, lot);
+        }
+        double findMicros = secondsSince(start) * 1e6 / queries;
+
+        cout << "   " << setw(6) << lotCount << fixed << setprecision(3) << "   " << setw(12) << parkMicros
+            << "   " << setw(13) << routeMicros << "   " << setw(12) << findMicros
+            << "   " << (match ? "OK" : "FAILED") << "\n";
+    }
+    cout << (allMatch ? "\nRouting matched a full scan of every lot.\n" : "\nRouting check FAILED.\n");
+}
+
+// Simulates an event day: a full lot, 'waitingCount' queued arrivals, cancellations,
+// promotions and admissions, compared with cancelling from a plain queue by rebuilding it
+void runWaitingListBenchmark(int waitingCount) {
+    mt19937 rng(23);
+    vector<Vehicle> vehicles;
+    vehicles.reserve(waitingCount);
+    for (int i = 0; i < waitingCount; ++i) {
+        vehicles.push_back(makeSyntheticVehicle(i, rng));
+    }
+    int changes = max(1, waitingCount / 10);
+
+    // Indexed waiting list
+    WaitingList list;
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < waitingCount; ++i) {
+        unsigned roll = rng() % 20;
+        WaitingPriority priority = roll == 0 ? WaitingPriority::Disabled : roll == 1 ? WaitingPriority::Electric
+            : roll < 4 ? WaitingPriority::Permit : WaitingPriority::Standard;
+        list.push(vehicles[i], priority);
+    }
+    double enqueueSeconds = secondsSince(start);
+
+    start = chrono::steady_clock::now();
+    WaitingEntry entry;
+    for (int i = 0; i < changes; ++i) {
+        list.remove(vehicles[rng() % waitingCount].regNumber, entry);
+        list.setPriority(vehicles[rng() % waitingCount].regNumber, WaitingPriority::Permit);
+    }
+    double changeSeconds = secondsSince(start);
+
+    start = chrono::steady_clock::now();
+    size_t shown = list.firstEntries(20).size();
+    double displaySeconds = secondsSince(start);
+
+    start = chrono::steady_clock::now();
+    size_t admitted = 0;
+    while (list.pop(entry)) {
+        admitted++;
+    }
+    double admitSeconds = secondsSince(start);
+
+    // Plain queue: a cancellation has to rebuild the whole queue
+    queue<Vehicle> plain;
+    for (const Vehicle& vehicle : vehicles) {
+        plain.push(vehicle);
+    }
+    int plainCancels = min(changes, 200);
+    start = chrono::steady_clock::now();
+    for (int i = 0; i < plainCancels; ++i) {
+        const string& regNumber = vehicles[rng() % waitingCount].regNumber;
+        queue<Vehicle> rebuilt;
+        while (!plain.empty()) {
+            if (plain.front().regNumber != regNumber) rebuilt.push(move(plain.front()));
+            plain.pop();
+        }
+        plain.swap(rebuilt);
+    }
+    double plainCancelSeconds = secondsSince(start);
+
+    cout << "\nWaiting list benchmark (" << waitingCount << " queued vehicles)\n";
+    cout << fixed << setprecision(3);
+    cout << "   Enqueue:                  " << enqueueSeconds * 1e6 / waitingCount << " us/vehicle\n";
+    cout << "   Cancel + promote:         " << changeSeconds * 1e6 / changes << " us/pair\n";
+    cout << "   Show first " << shown << " waiting:     " << displaySeconds * 1e6 << " us\n";
+    cout << "   Admit:                    " << admitSeconds * 1e6 / max<size_t>(1, admitted) << " us/vehicle\n";
+    cout << "   Cancel from std::queue:   " << plainCancelSeconds * 1e6 / plainCancels << " us/cancel (rebuild)\n";
+}
+
+// Prices a stay minute by minute straight from the rate table (reference for the tariff checks)
+static Cents referenceFee(const TariffTable& table, time_t entryTime, time_t exitTime) {
+    long long seconds = static_cast<long long>(exitTime - entryTime);
+    long long minutes = (seconds + 59) / 60;
+    if (seconds <= 0 || minutes <= table.graceMinutes) return 0;
+
+    tm local;
+    localtime_s(&local, &entryTime);
+    int clockMinute = local.tm_hour * 60 + local.tm_min;
+    Cents nightRate = table.nightRate < 0 ? table.hourlyRate : table.nightRate;
+
+    // Sum each 24 hour block in sixtieths of a cent, capping every block on its own
+    long long total = 0, block = 0;
+    for (long long minute = 0; minute < minutes; ++minute) {
+        int m = static_cast<int>((clockMinute + minute) % (24 * 60));
+        bool night = table.nightStartMinute < table.nightEndMinute
+            ? m >= table.nightStartMinute && m < table.nightEndMinute
+            : table.nightStartMinute > table.nightEndMinute && (m >= table.nightStartMinute || m < table.nightEndMinute);
+        if (minute < 60 && table.firstHour >= 0) {
+            if (minute == 0) block += table.firstHour * 60;
+        }
+        else {
+            block += night ? nightRate : table.hourlyRate;
+        }
+        if ((minute + 1) % (24 * 60) == 0 || minute + 1 == minutes) {
+            total += table.dailyCap > 0 ? min<long long>(block, table.dailyCap * 60) : block;
+            block = 0;
+        }
+    }
+    return (total + 30) / 60;
+}
+
+// Checks fees against hand-computed prices and the minute-by-minute reference;
+// returns the number of mismatches
+static int runTariffChecks() {
+    int failures = 0;
+    auto expect = [&](const char* what, Cents actual, Cents expected) {
+        if (actual != expected) {
+            cout << "   MISMATCH " << what << ": got " << formatCents(actual) << ", expected " << formatCents(expected) << "\n";
+            failures++;
+        }
+    };
+
+    // Today 08:00 local time
+    time_t now = time(0);
+    tm morning;
+    localtime_s(&morning, &now);
+    morning.tm_hour = 8;
+    morning.tm_min = 0;
+    morning.tm_sec = 0;
+    morning.tm_isdst = -1;
+    time_t eight = mktime(&morning);
+
+    // $3/h by day, $1/h from 22:00 to 06:00, $5 first hour, 10 free minutes, $20 a day at most
+    TariffTable table;
+    table.hourlyRate = 300;
+    table.nightRate = 100;
+    table.firstHour = 500;
+    table.graceMinutes = 10;
+    table.dailyCap = 2000;
+    TariffEngine engine(table);
+    expect("grace period", engine.fee(eight, eight + 9 * 60 + 30), 0);
+    expect("first hour", engine.fee(eight, eight + 45 * 60), 500);
+    expect("two hours", engine.fee(eight, eight + 2 * 3600), 800);
+    expect("started minute", engine.fee(eight, eight + 2 * 3600 + 1), 805);
+    expect("night hour", engine.fee(eight + 13 * 3600, eight + 15 * 3600), 600);
+    expect("daily cap", engine.fee(eight, eight + 24 * 3600), 2000);
+    expect("three days", engine.fee(eight, eight + 74 * 3600), 6600);
+    expect("exit before entry", engine.fee(eight, eight - 60), 0);
+
+    // Plain hourly rate: $10/h billed per started minute
+    TariffTable hourly;
+    hourly.hourlyRate = 1000;
+    TariffEngine plain(hourly);
+    expect("90 minutes", plain.fee(eight, eight + 90 * 60), 1500);
+    expect("one second", plain.fee(eight, eight + 1), 17);
+
+    // Random tables and stays of up to a week against the reference
+    mt19937 rng(31);
+    for (int round = 0; round < 200; ++round) {
+        TariffTable random;
+        random.hourlyRate = rng() % 2000;
+        random.nightRate = rng() % 3 == 0 ? -1 : static_cast<Cents>(rng() % 1000);
+        random.nightStartMinute = rng() % (24 * 60);
+        random.nightEndMinute = rng() % (24 * 60);
+        random.firstHour = rng() % 2 == 0 ? -1 : static_cast<Cents>(rng() % 1500);
+        random.graceMinutes = rng() % 30;
+        random.dailyCap = rng() % 2 == 0 ? 0 : static_cast<Cents>(rng() % 10000);
+        TariffEngine randomEngine(random);
+        vector<time_t> entries(64);
+        for (time_t& entry : entries) {
+            entry = eight - static_cast<time_t>(rng() % (7 * 24 * 3600));
+        }
+        vector<Cents> fees(entries.size());
+        randomEngine.feeBatch(entries.data(), entries.size(), eight, fees.data());
+        for (size_t i = 0; i < entries.size(); ++i) {
+            expect("random stay", fees[i], referenceFee(random, entries[i], eight));
+        }
+    }
+
+    // Entries all through the year, so stays on both sides of a daylight saving change are priced
+    for (int i = 0; i < 2000; ++i) {
+        time_t entry = eight - static_cast<time_t>(rng() % (366 * 24 * 3600));
+        time_t exit = entry + static_cast<time_t>(rng() % (6 * 3600));
+        expect("stay in any season", engine.fee(entry, exit), referenceFee(table, entry, exit));
+    }
+    return failures;
+}
+
+// Checks the tariff engine for exact cents, then measures pricing 'vehicleCount'
+// parked vehicles in one batch against pricing them one at a time
+void runTariffBenchmark(int vehicleCount) {
+    cout << "\nTariff benchmark (" << vehicleCount << " parked vehicles)\n";
+    int failures = runTariffChecks();
+    cout << "   Exact-cent checks:        " << (failures == 0 ? "passed" : "FAILED") << "\n";
+
+    // Entry times spread over the last three days
+    mt19937 rng(37);
+    time_t now = time(0);
+    vector<time_t> entries(vehicleCount);
+    for (time_t& entry : entries) {
+        entry = now - static_cast<time_t>(rng() % (3 * 24 * 3600));
+    }
+    TariffTable table;
+    table.hourlyRate = 300;
+    table.nightRate = 100;
+    table.firstHour = 500;
+    table.graceMinutes = 10;
+    table.dailyCap = 2000;
+    TariffEngine engine(table);
+    vector<Cents> fees(vehicleCount);
+
+    // Floating point hourly fee, as the parking system used to compute it
+    auto start = chrono::steady_clock::now();
+    double floatTotal = 0;
+    for (time_t entry : entries) {
+        floatTotal += round(difftime(now, entry) / 3600 * 3.0 * 100) / 100;
+    }
+    double floatSeconds = secondsSince(start);
+
+    start = chrono::steady_clock::now();
+    Cents singleTotal = 0;
+    for (time_t entry : entries) {
+        singleTotal += engine.fee(entry, now);
+    }
+    double singleSeconds = secondsSince(start);
+
+    start = chrono::steady_clock::now();
+    engine.feeBatch(entries.data(), entries.size(), now, fees.data());
+    double batchSeconds = secondsSince(start);
+    Cents batchTotal = 0;
+    for (Cents fee : fees) {
+        batchTotal += fee;
+    }
+
+    // The same pass through a full parking lot
+    ParkingConfig config;
+    config.logging.path = "";
+    config.journalPath = "";
+    config.archivePath = "";
+    config.tariff = table;
+    ParkingManagementSystem lot(vehicleCount, 3.0, config);
+    for (int i = 0; i < vehicleCount; ++i) {
+        lot.parkVehicle(makeSyntheticVehicle(i, rng));
+    }
+    start = chrono::steady_clock::now();
+    Cents outstanding = lot.getOutstandingFees(now + 3600);
+    double lotSeconds = secondsSince(start);
+
+    cout << fixed << setprecision(2);
+    cout << "   Floating point hourly:    " << floatSeconds * 1e9 / vehicleCount << " ns/vehicle ($" << floatTotal << ", no tariff rules)\n";
+    cout << "   Tariff, one at a time:    " << singleSeconds * 1e9 / vehicleCount << " ns/vehicle ($" << formatCents(singleTotal) << ")\n";
+    cout << "   Tariff, batch:            " << batchSeconds * 1e9 / vehicleCount << " ns/vehicle ($" << formatCents(batchTotal) << ")\n";
+    cout << "   Whole lot in an hour:     " << lotSeconds * 1e3 << " ms ($" << formatCents(outstanding) << " outstanding)\n";
+}
+
+// Checks histogram percentiles against exact ones, measures the cost of recording gate
+// events and of snapshots, and runs gates with and without a dashboard polling every 10 ms
+void runStatisticsBenchmark(int eventCount) {
+    cout << "\nStatistics benchmark (" << eventCount << " stays)\n";
+
+    // Log-normal parking durations around two hours
+    mt19937 rng(41);
+    lognormal_distribution<double> stay(log(7200.0), 1.0);
+    vector<uint64_t> durations(eventCount);
+    for (uint64_t& duration : durations) {
+        duration = static_cast<uint64_t>(stay(rng));
+    }
+
+    // Recording: one arrival and one departure per stay, a second apart
+    ParkingStatistics statistics(eventCount);
+    time_t now = time(0) - eventCount;
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < eventCount; ++i) {
+        statistics.recordArrival(now + i, 1);
+        statistics.recordDeparture(now + i, 0, now + i - static_cast<time_t>(durations[i]), 300);
+    }
+    double recordSeconds = secondsSince(start);
+
+    // Percentiles within the histogram's 1/32 precision
+    StatisticsSnapshot stats = statistics.snapshot(now + eventCount, 0);
+    bool accurate = true;
+    const int percents[] = { 50, 95, 99 };
+    const uint64_t reported[] = { stats.dwellP50, stats.dwellP95, stats.dwellP99 };
+    for (int i = 0; i < 3; ++i) {
+        size_t rank = static_cast<size_t>(ceil(percents[i] / 100.0 * eventCount)) - 1;
+        nth_element(durations.begin(), durations.begin() + rank, durations.end());
+        uint64_t exact = durations[rank];
+        double error = exact == 0 ? 0 : fabs(double(reported[i]) - double(exact)) / exact;
+        if (error > 1.0 / 32) accurate = false;
+        cout << "   p" << percents[i] << " parking time:     " << reported[i] << " s (exact " << exact << " s, "
+            << fixed << setprecision(2) << error * 100 << "% off)\n";
+    }
+
+    int snapshots = 1000;
+    start = chrono::steady_clock::now();
+    for (int i = 0; i < snapshots; ++i) {
+        stats = statistics.snapshot(now + eventCount, 0);
+    }
+    double snapshotSeconds = secondsSince(start);
+
+    cout << "   Percentiles:           " << (accurate ? "within 1/32" : "FAILED") << "\n";
+    cout << "   Record park + leave:   " << recordSeconds * 1e9 / eventCount << " ns\n";
+    cout << "   Snapshot:              " << snapshotSeconds * 1e6 / snapshots << " us\n";
+
+    // Four gates on the sharded engine, with and without a dashboard thread reading statistics
+    const int plateCount = 100000;
+    vector<Vehicle> vehicles;
+    vehicles.reserve(plateCount);
+    for (int i = 0; i < plateCount; ++i) {
+        vehicles.push_back(makeSyntheticVehicle(i, rng));
+    }
+    ConcurrentConfig config;
+    config.logging.path = "";
+    for (int polling = 0; polling <= 1; ++polling) {
+        ConcurrentParkingSystem lot(plateCount, 10.0, config);
+        for (int i = 0; i < plateCount; i += 2) {
+            lot.parkVehicle(vehicles[i]);
+        }
+        atomic<bool> stop(false);
+        atomic<long long> polls(0);
+        thread dashboard;
+        if (polling) {
+            dashboard = thread([&]() {
+                while (!stop.load()) {
+                    lot.getStatisticsSnapshot(time(0));
+                    polls++;
+                    this_thread::sleep_for(chrono::milliseconds(10));
+                }
+            });
+        }
+        double rate = runGateMix(4, max(10000, eventCount / 10), vehicles,
+            [&](const Vehicle& vehicle) { lot.parkVehicle(vehicle); },
+            [&](const string& regNumber) { Cents fee; lot.retrieveVehicle(regNumber, fee); },
+            [&](const string& regNumber) { Vehicle found; lot.findVehicle(regNumber, found); });
+        stop = true;
+        if (dashboard.joinable()) dashboard.join();
+        cout << "   4 gates, " << (polling ? "dashboard every 10 ms: " : "no dashboard:          ")
+            << setprecision(0) << rate << " ops/s";
+        if (polling) cout << " (" << polls.load() << " snapshots)";
+        cout << "\n";
+    }
+}
+
+// Pre-table validators, kept as the reference for the validation checks
+
+// Validates the vehicle make input
+static const char* legacyVehicleMakeCheck(const string& make) {
+    if (make.empty()) {
+        return "Vehicle make cannot be empty.";
+    }
+    for (char c : make) {
+        // Check for invalid characters (only letters and spaces allowed)
+        if (!isalpha(c) && c != ' ') {
+            return "Vehicle make can only contain letters and spaces.";
+        }
+    }
+    // Ensure it doesn't start or end with spaces and doesn't exceed 50 characters
+    if (make.front() == ' ' || make.back() == ' ' || make.length() > 50) {
+        return "Vehicle make format is invalid.";
+    }
+    return nullptr;
+}
+
+// Validates the vehicle model input
+static const char* legacyVehicleModelCheck(const string& model) {
+    if (model.empty()) {
+        return "Vehicle model cannot be empty.";
+    }
+    for (char c : model) {
+        // Check for invalid characters (letters, numbers, spaces allowed)
+        if (!isalnum(c) && c != ' ') {
+            return "Vehicle model can only contain letters, numbers, and spaces.";
+        }
+    }
+    // Ensure it doesn't start or end with spaces and doesn't exceed 50 characters
+    if (model.front() == ' ' || model.back() == ' ' || model.length() > 50) {
+        return "Vehicle model format is invalid.";
+    }
+    return nullptr;
+}
+
+// Validates the vehicle color input
+static const char* legacyVehicleColorCheck(const string& color) {
+    if (color.empty()) {
+        return "Vehicle color cannot be empty.";
+    }
+    for (char c : color) {
+        // Check for invalid characters (only letters and spaces allowed)
+        if (!isalpha(c) && c != ' ') {
+            return "Vehicle color can only contain letters and spaces.";
+        }
+    }
+    // Ensure it doesn't start or end with spaces and doesn't exceed 30 characters
+    if (color.front() == ' ' || color.back() == ' ' || color.length() > 30) {
+        return "Vehicle color format is invalid.";
+    }
+    return nullptr;
+}
+
+// Validates the owner's contact number
+static const char* legacyOwnerContactCheck(const string& contact) {
+    if (contact.empty()) {
+        return "Owner contact cannot be empty.";
+    }
+    if (contact.length() < 10 || contact.length() > 15 || !all_of(contact.begin(), contact.end(), ::isdigit)) {
+        // Validate length and ensure only digits
+        return "Owner contact must be 10-15 digits.";
+    }
+    return nullptr;
+}
+
+// Error checks for registration number
+static const char* legacyRegNumberCheck(const string& regNumber) {
+    // Various validation checks for registration number format
+    if (regNumber.length() < 3) {
+        return "Registration number must be at least 3 characters long.";
+    }
+    if (regNumber.length() > 10) {
+        return "Registration number must not exceed 10 characters.";
+    }
+    if (regNumber.front() == '0') {
+        return "Registration number cannot start with '0'.";
+    }
+    for (char c : regNumber) {
+        if (!isalnum(c)) {
+            return "Registration number must be alphanumeric.";
+        }
+    }
+    if (regNumber.find(' ') != string::npos) {
+        return "Registration number cannot contain spaces.";
+    }
+    return nullptr;
+}
+
+// Error checks for owner name
+static const char* legacyOwnerNameCheck(const string& ownerName) {
+    // Various validation checks for owner name format
+    if (ownerName.empty()) {
+        return "Owner name cannot be empty.";
+    }
+    for (char c : ownerName) {
+        if (!isalpha(c) && c != ' ') {
+            return "Owner name can only contain letters and spaces.";
+        }
+    }
+    if (ownerName.front() == ' ' || ownerName.back() == ' ') {
+        return "Owner name cannot start or end with a space.";
+    }
+    for (size_t i = 1; i < ownerName.length(); ++i) {
+        if (ownerName[i] == ' ' && ownerName[i - 1] == ' ') {
+            return "Owner name cannot have consecutive spaces.";
+        }
+    }
+    if (ownerName.length() > 100) {
+        return "Owner name must not exceed 100 characters.";
+    }
+    return nullptr;
+}
+
+// Builds a random field value from letters, digits, spaces and a few other characters
+static string makeRandomField(mt19937& rng) {
+    static const char alphabet[] = "ABCxyz0123456789      -.@";
+    size_t length = rng() % 4 == 0 ? rng() % 110 : rng() % 16;
+    string value(length, ' ');
+    for (char& c : value) {
+        c = alphabet[rng() % (sizeof(alphabet) - 1)];
+    }
+    return value;
+}
+
+// Checks the table-driven validators against the old ones and compares their speed
+// on 'plateCount' plate reads, 10% of them malformed
+void runValidationBenchmark(int plateCount) {
+    cout << "\nValidation benchmark (" << plateCount << " plate reads)\n";
+
+    // Same verdict and message as the old validators on random input
+    typedef const char* (*LegacyCheck)(const string&);
+    const LegacyCheck legacyChecks[] = { legacyRegNumberCheck, legacyOwnerNameCheck, legacyVehicleMakeCheck,
+        legacyVehicleModelCheck, legacyVehicleColorCheck, legacyOwnerContactCheck };
+    mt19937 rng(43);
+    long long mismatches = 0;
+    for (int i = 0; i < 600000; ++i) {
+        VehicleField field = static_cast<VehicleField>(i % 6);
+        string value = makeRandomField(rng);
+        const char* expected = legacyChecks[i % 6](value);
+        ValidationError error = validateField(field, value);
+        const char* actual = error == ValidationError::None ? nullptr : validationMessage(field, error);
+        if ((expected == nullptr) != (actual == nullptr) || (expected && strcmp(expected, actual) != 0)) {
+            if (mismatches++ < 5) {
+                cout << "   MISMATCH field " << i % 6 << " \"" << value << "\": " << (actual ? actual : "valid")
+                    << " vs " << (expected ? expected : "valid") << "\n";
+            }
+        }
+    }
+    cout << "   Agreement with old rules: " << (mismatches == 0 ? "passed" : "FAILED") << "\n";
+
+    // Plate reads as a camera feed delivers them
+    vector<string> plates;
+    plates.reserve(plateCount);
+    for (int i = 0; i < plateCount; ++i) {
+        char plate[16];
+        unsigned roll = rng() % 10;
+        if (roll == 0) snprintf(plate, sizeof(plate), "LE-%04u", static_cast<unsigned>(rng() % 10000));
+        else snprintf(plate, sizeof(plate), "%c%c%c%04u", static_cast<int>('A' + rng() % 26), static_cast<int>('A' + rng() % 26),
+            static_cast<int>('A' + rng() % 26), static_cast<unsigned>(rng() % 10000));
+        plates.push_back(plate);
+    }
+
+    auto start = chrono::steady_clock::now();
+    size_t legacyValid = 0;
+    for (const string& plate : plates) {
+        legacyValid += legacyRegNumberCheck(plate) == nullptr;
+    }
+    double legacySeconds = secondsSince(start);
+
+    vector<ValidationError> errors;
+    start = chrono::steady_clock::now();
+    size_t batchValid = validateRegNumbers(plates, errors);
+    double batchSeconds = secondsSince(start);
+
+    // Whole records, all six fields
+    vector<Vehicle> vehicles;
+    int recordCount = min(plateCount, 200000);
+    vehicles.reserve(recordCount);
+    for (int i = 0; i < recordCount; ++i) {
+        vehicles.push_back(makeSyntheticVehicle(i, rng));
+    }
+    start = chrono::steady_clock::now();
+    size_t legacyRecords = 0;
+    for (const Vehicle& vehicle : vehicles) {
+        legacyRecords += !legacyRegNumberCheck(vehicle.regNumber) && !legacyOwnerNameCheck(vehicle.ownerName)
+            && !legacyVehicleMakeCheck(vehicle.vehicleMake) && !legacyVehicleModelCheck(vehicle.vehicleModel)
+            && !legacyVehicleColorCheck(vehicle.vehicleColor) && !legacyOwnerContactCheck(vehicle.ownerContact);
+    }
+    double legacyRecordSeconds = secondsSince(start);
+
+    vector<ValidationResult> results;
+    start = chrono::steady_clock::now();
+    size_t batchRecords = validateVehicles(vehicles, results);
+    double batchRecordSeconds = secondsSince(start);
+
+    cout << fixed << setprecision(2);
+    cout << "   Plates, old checks:       " << legacySeconds * 1e9 / plateCount << " ns/plate (" << legacyValid << " valid)\n";
+    cout << "   Plates, batch:            " << batchSeconds * 1e9 / plateCount << " ns/plate (" << batchValid << " valid)\n";
+    cout << "   Records, old checks:      " << legacyRecordSeconds * 1e9 / recordCount << " ns/record (" << legacyRecords << " valid)\n";
+    cout << "   Records, batch:           " << batchRecordSeconds * 1e9 / recordCount << " ns/record (" << batchRecords << " valid)\n";
+}
+
+// Allocator that counts the bytes a container holds (for node-based containers)
+template <typename T>
+struct CountingAllocator {
+    typedef T value_type;
+    size_t* bytes;   // Shared byte counter
+
+    CountingAllocator(size_t* counter) : bytes(counter) {}
+    template <typename U> CountingAllocator(const CountingAllocator<U>& other) : bytes(other.bytes) {}
+
+    T* allocate(size_t n) {
+        *bytes += n * sizeof(T);
+        return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+    void deallocate(T* pointer, size_t n) {
+        *bytes -= n * sizeof(T);
+        ::operator delete(pointer);
+    }
+    template <typename U> bool operator==(const CountingAllocator<U>& other) const { return bytes == other.bytes; }
+    template <typename U> bool operator!=(const CountingAllocator<U>& other) const { return bytes != other.bytes; }
+};
+
+// The map the parking system used before PlateHashMap, with its bytes counted
+typedef unordered_map<string, int, hash<string>, equal_to<string>, CountingAllocator<pair<const string, int>>> CountedStringMap;
+
+// Checks PlateKey order and PlateHashMap contents against the standard containers
+static long long runPlateHashChecks() {
+    mt19937 rng(29);
+    const char alphabet[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz-";
+    long long failures = 0;
+
+    // Keys sort like their plates and unpack to them
+    for (int i = 0; i < 200000; ++i) {
+        string a, b;
+        size_t lengthA = 1 + rng() % 10, lengthB = 1 + rng() % 10;
+        for (size_t c = 0; c < lengthA; ++c) a += alphabet[rng() % 62];
+        for (size_t c = 0; c < lengthB; ++c) b += alphabet[rng() % 62];
+        if (i % 4 == 0) b = a.substr(0, lengthB);
+        PlateKey keyA, keyB;
+        if (!PlateKey::pack(a, keyA) || !PlateKey::pack(b, keyB) || keyA.unpack() != a
+            || (keyA < keyB) != (a < b) || (keyA == keyB) != (a == b)) {
+            failures++;
+        }
+    }
+
+    // Random inserts and erases over a small plate set (some plates do not pack) keep
+    // the same contents as unordered_map, so collisions and back-shifts are exercised
+    PlateHashMap map;
+    unordered_map<string, int> reference;
+    vector<string> plates;
+    for (int i = 0; i < 5000; ++i) {
+        string plate;
+        size_t length = 1 + rng() % 12;
+        for (size_t c = 0; c < length; ++c) plate += alphabet[rng() % 63];
+        plates.push_back(plate);
+    }
+    for (int op = 0; op < 400000; ++op) {
+        const string& plate = plates[rng() % plates.size()];
+        unsigned roll = rng() % 3;
+        if (roll == 0) {
+            if (map.insert(plate, op) != reference.emplace(plate, op).second) failures++;
+        }
+        else if (roll == 1) {
+            if (map.erase(plate) != (reference.erase(plate) > 0)) failures++;
+        }
+        else {
+            auto it = reference.find(plate);
+            if (map.find(plate) != (it == reference.end() ? -1 : it->second)) failures++;
+        }
+    }
+    if (map.size() != reference.size()) failures++;
+    for (const auto& entry : reference) {
+        if (map.find(entry.first) != entry.second) failures++;
+    }
+    return failures;
+}
+
+// Compares PlateHashMap with the string-keyed unordered_map on 'plateCount' plates
+void runPlateHashBenchmark(int plateCount) {
+    cout << "\nPlate hash map benchmark (" << plateCount << " plates)\n";
+    long long failures = runPlateHashChecks();
+    cout << "   Agreement with unordered_map: " << (failures == 0 ? "passed" : "FAILED") << "\n";
+
+    // Parked plates arrive and are looked up in random order; misses use another prefix
+    vector<string> plates = makeSequentialPlates(plateCount);
+    mt19937 rng(31);
+    shuffle(plates.begin(), plates.end(), rng);
+    vector<string> lookups = plates;
+    shuffle(lookups.begin(), lookups.end(), rng);
+    vector<string> misses = lookups;
+    for (string& plate : misses) plate[2] = 'B';
+    vector<PlateKey> keys(plateCount), lookupKeys(plateCount);
+    for (int i = 0; i < plateCount; ++i) {
+        PlateKey::pack(plates[i], keys[i]);
+        PlateKey::pack(lookups[i], lookupKeys[i]);
+    }
+
+    cout << left << setw(26) << "Structure" << right << setw(12) << "Insert ns" << setw(12) << "Hit ns"
+        << setw(12) << "Miss ns" << setw(12) << "Erase ns" << setw(14) << "Bytes/entry" << "\n";
+    long long checksum = 0;
+    auto printRow = [&](const char* name, double insertSeconds, double hitSeconds, double missSeconds,
+        double eraseSeconds, size_t bytes) {
+        cout << left << setw(26) << name << right << fixed << setprecision(1)
+            << setw(12) << insertSeconds * 1e9 / plateCount << setw(12) << hitSeconds * 1e9 / plateCount
+            << setw(12) << missSeconds * 1e9 / plateCount << setw(12) << eraseSeconds * 1e9 / plateCount
+            << setw(14) << double(bytes) / plateCount << "\n";
+    };
+
+    {
+        // Sized for the lot up front, as the parking system does
+        size_t bytes = 0;
+        CountedStringMap map(0, hash<string>(), equal_to<string>(), CountingAllocator<pair<const string, int>>(&bytes));
+        map.reserve(plateCount);
+        auto start = chrono::steady_clock::now();
+        for (int i = 0; i < plateCount; ++i) map.emplace(plates[i], i);
+        double insertSeconds = secondsSince(start);
+        size_t used = bytes + sizeof(map);
+
+        start = chrono::steady_clock::now();
+        for (const string& plate : lookups) checksum += map.find(plate)->second;
+        double hitSeconds = secondsSince(start);
+        start = chrono::steady_clock::now();
+        for (const string& plate : misses) checksum += map.find(plate) == map.end();
+        double missSeconds = secondsSince(start);
+        start = chrono::steady_clock::now();
+        for (const string& plate : lookups) map.erase(plate);
+        double eraseSeconds = secondsSince(start);
+        printRow("unordered_map<string>", insertSeconds, hitSeconds, missSeconds, eraseSeconds, used);
+    }
+    {
+        PlateHashMap map;
+        map.reserve(plateCount);
+        auto start = chrono::steady_clock::now();
+        for (int i = 0; i < plateCount; ++i) map.insert(plates[i], i);
+        double insertSeconds = secondsSince(start);
+        size_t used = map.memoryUsage();
+
+        start = chrono::steady_clock::now();
+        for (const string& plate : lookups) checksum += map.find(plate);
+        double hitSeconds = secondsSince(start);
+        start = chrono::steady_clock::now();
+        for (const string& plate : misses) checksum += map.find(plate) == -1;
+        double missSeconds = secondsSince(start);
+        start = chrono::steady_clock::now();
+        for (const string& plate : lookups) map.erase(plate);
+        double eraseSeconds = secondsSince(start);
+        printRow("PlateHashMap (string)", insertSeconds, hitSeconds, missSeconds, eraseSeconds, used);
+    }
+    {
+        // Callers that already hold packed keys skip the packing step
+        PlateHashMap map;
+        map.reserve(plateCount);
+        auto start = chrono::steady_clock::now();
+        for (int i = 0; i < plateCount; ++i) map.insert(keys[i], i);
+        double insertSeconds = secondsSince(start);
+        size_t used = map.memoryUsage();
+
+        start = chrono::steady_clock::now();
+        for (const PlateKey& key : lookupKeys) checksum += map.find(key);
+        double hitSeconds = secondsSince(start);
+        PlateKey missKey;
+        start = chrono::steady_clock::now();
+        for (const PlateKey& key : lookupKeys) {
+            missKey.bits = key.bits | (1ULL << 60); // No plate packs into the top four bits
+            checksum += map.find(missKey) == -1;
+        }
+        double missSeconds = secondsSince(start);
+        start = chrono::steady_clock::now();
+        for (const PlateKey& key : lookupKeys) map.erase(key);
+        double eraseSeconds = secondsSince(start);
+        printRow("PlateHashMap (PlateKey)", insertSeconds, hitSeconds, missSeconds, eraseSeconds, used);
+    }
+    cout << "   Bytes/entry counts container allocations only (allocator headers excluded)\n";
+    if (checksum == -1) cout << "";  // Keeps the lookups from being optimized away
+}
+
+// Checks that every timer fires exactly once, at the first advance that reaches its
+// deadline, against a plain list of deadlines; returns the number of failures
+static long long runTimerWheelChecks() {
+    mt19937_64 rng(37);
+    const time_t start = 1700000000;
+    TimerWheel wheel(start);
+    unordered_map<TimerId, time_t> expected;   // Pending timers and their deadlines
+    long long failures = 0;
+    time_t clock = start;
+
+    for (int round = 0; round < 20000; ++round) {
+        // Deadlines from overdue to years ahead, so every level and the overflow list are used
+        int count = static_cast<int>(rng() % 8);
+        for (int i = 0; i < count; ++i) {
+            static const int64_t spans[] = { 10, 64, 5000, 300000, 20000000, 2000000000LL };
+            time_t deadline = clock - 5 + static_cast<time_t>(rng() % spans[rng() % 6]);
+            TimerId id = wheel.schedule(deadline, static_cast<uint32_t>(i), 0);
+            expected[id] = deadline;
+        }
+        if (!expected.empty() && rng() % 3 == 0) {
+            auto victim = expected.begin();
+            if (!wheel.cancel(victim->first)) failures++;
+            if (wheel.cancel(victim->first)) failures++;   // Second cancel must fail
+            expected.erase(victim);
+        }
+
+        // Steps from one second up to months, so empty windows get skipped
+        static const int64_t steps[] = { 1, 7, 100, 4000, 400000, 40000000 };
+        time_t previous = clock;
+        clock += static_cast<time_t>(rng() % steps[rng() % 6]);
+        time_t lastDue = 0;
+        wheel.advance(clock, [&](const TimerEvent& event) {
+            auto it = expected.find(event.id);
+            if (it == expected.end() || it->second != event.deadline || event.deadline > clock) {
+                failures++;
+                return;
+            }
+            // Overdue timers fire at once; the rest in non-decreasing deadline order
+            time_t due = max(event.deadline, previous);
+            if (due < lastDue) failures++;
+            lastDue = due;
+            expected.erase(it);
+        });
+        for (const auto& entry : expected) {
+            if (entry.second <= clock) failures++;
+        }
+        if (wheel.size() != expected.size()) failures++;
+    }
+    return failures;
+}
+
+// Deadline heap entry of the baseline (cancelled timers are skipped when they surface)
+struct HeapTimer {
+    time_t deadline;   // Time the timer fires
+    uint32_t id;       // Index into the live flags
+    bool operator>(const HeapTimer& other) const { return deadline > other.deadline; }
+};
+
+// Measures the timer wheel with 'timerCount' pending vehicle deadlines
+void runTimerWheelBenchmark(int timerCount) {
+    cout << "\nTimer wheel benchmark (" << timerCount << " pending timers)\n";
+    long long failures = runTimerWheelChecks();
+    cout << "   Firing order and cancellation check: " << (failures == 0 ? "passed" : "FAILED") << "\n";
+
+    // Every parked vehicle gets a grace, overstay or tow deadline within the next day;
+    // half of them leave early and cancel, then the clock runs through the day second by second
+    const time_t start = 1700000000;
+    const int day = 24 * 3600;
+    mt19937_64 rng(41);
+    vector<time_t> deadlines(timerCount);
+    for (int i = 0; i < timerCount; ++i) {
+        static const int limits[] = { 15 * 60, 4 * 3600, day };
+        deadlines[i] = start + 1 + static_cast<time_t>(rng() % limits[i % 3]);
+    }
+    vector<uint32_t> leaving(timerCount / 2);
+    for (size_t i = 0; i < leaving.size(); ++i) leaving[i] = static_cast<uint32_t>(rng() % timerCount);
+
+    cout << left << setw(24) << "Structure" << right << setw(14) << "Schedule ns" << setw(14) << "Cancel ns"
+        << setw(14) << "Fire ns" << setw(16) << "Day run (ms)" << setw(14) << "Bytes/timer" << "\n";
+    size_t firedTotal = 0;
+    {
+        TimerWheel wheel(start);
+        wheel.reserve(timerCount);
+        vector<TimerId> ids(timerCount);
+        auto begin = chrono::steady_clock::now();
+        for (int i = 0; i < timerCount; ++i) ids[i] = wheel.schedule(deadlines[i], static_cast<uint32_t>(i), 0);
+        double scheduleSeconds = secondsSince(begin);
+        size_t bytes = wheel.memoryUsage();
+
+        begin = chrono::steady_clock::now();
+        for (uint32_t i : leaving) wheel.cancel(ids[i]);
+        double cancelSeconds = secondsSince(begin);
+        size_t live = wheel.size();
+
+        size_t fired = 0;
+        begin = chrono::steady_clock::now();
+        for (time_t now = start; now <= start + day; ++now) {
+            fired += wheel.advance(now, [&](const TimerEvent& event) { firedTotal += event.owner; });
+        }
+        double runSeconds = secondsSince(begin);
+        if (fired != live || wheel.size() != 0) cout << "   FAILED: fired " << fired << " of " << live << "\n";
+
+        cout << left << setw(24) << "TimerWheel" << right << fixed << setprecision(1)
+            << setw(14) << scheduleSeconds * 1e9 / timerCount << setw(14) << cancelSeconds * 1e9 / leaving.size()
+            << setw(14) << runSeconds * 1e9 / max<size_t>(fired, 1) << setw(16) << runSeconds * 1e3
+            << setw(14) << double(bytes) / timerCount << "\n";
+    }
+    {
+        // Binary heap of deadlines with lazy cancellation
+        priority_queue<HeapTimer, vector<HeapTimer>, greater<HeapTimer>> heap;
+        vector<HeapTimer> storage;
+        storage.reserve(timerCount);
+        heap = priority_queue<HeapTimer, vector<HeapTimer>, greater<HeapTimer>>(greater<HeapTimer>(), move(storage));
+        vector<char> live(timerCount, 1);
+        auto begin = chrono::steady_clock::now();
+        for (int i = 0; i < timerCount; ++i) heap.push(HeapTimer{ deadlines[i], static_cast<uint32_t>(i) });
+        double scheduleSeconds = secondsSince(begin);
+
+        begin = chrono::steady_clock::now();
+        for (uint32_t i : leaving) live[i] = 0;
+        double cancelSeconds = secondsSince(begin);
+
+        size_t fired = 0;
+        begin = chrono::steady_clock::now();
+        for (time_t now = start; now <= start + day; ++now) {
+            while (!heap.empty() && heap.top().deadline <= now) {
+                uint32_t id = heap.top().id;
+                heap.pop();
+                if (live[id]) {
+                    fired++;
+                    firedTotal += id;
+                }
+            }
+        }
+        double runSeconds = secondsSince(begin);
+
+        cout << left << setw(24) << "Binary heap (lazy)" << right
+            << setw(14) << scheduleSeconds * 1e9 / timerCount << setw(14) << cancelSeconds * 1e9 / leaving.size()
+            << setw(14) << runSeconds * 1e9 / max<size_t>(fired, 1) << setw(16) << runSeconds * 1e3
+            << setw(14) << double(timerCount * sizeof(HeapTimer) + timerCount) / timerCount << "\n";
+    }
+    {
+        // Periodic scan of every parked vehicle; measured on a few passes and scaled to a day
+        const int passes = 20;
+        size_t due = 0;
+        auto begin = chrono::steady_clock::now();
+        for (int pass = 0; pass < passes; ++pass) {
+            time_t now = start + pass * 60;
+            for (int i = 0; i < timerCount; ++i) due += deadlines[i] <= now;
+        }
+        double passSeconds = secondsSince(begin) / passes;
+        firedTotal += due;
+        cout << left << setw(24) << "Scan every second" << right << setw(14) << "-" << setw(14) << "-"
+            << setw(14) << "-" << setw(16) << passSeconds * day * 1e3 << setw(14) << "-" << "  (extrapolated)\n";
+    }
+    if (firedTotal == 1) cout << "";  // Keeps the work from being optimized away
+}
+
+// Stream buffer that counts and discards everything written to it
+class DiscardingBuffer : public streambuf {
+public:
+    uint64_t bytes = 0;   // Bytes written so far
+
+protected:
+    int_type overflow(int_type c) override {
+        if (c != traits_type::eof()) bytes++;
+        return traits_type::not_eof(c);
+    }
+    streamsize xsputn(const char*, streamsize count) override {
+        bytes += static_cast<uint64_t>(count);
+        return count;
+    }
+};
+
+// Checks the timestamp formatter and times a report of 'vehicleCount' parked vehicles
+void runExportBenchmark(int vehicleCount) {
+    cout << "\nExport benchmark (" << vehicleCount << " parked vehicles)\n";
+
+    // The formatter must agree with strftime on timestamps spread over a year
+    mt19937 rng(19);
+    time_t base = time(0) - 365 * 86400;
+    vector<time_t> stamps(vehicleCount);
+    for (time_t& stamp : stamps) stamp = base + static_cast<time_t>(rng() % (30 * 86400));
+    TimestampFormatter formatter;
+    size_t mismatches = 0;
+    char expected[32];
+    char actual[TimestampFormatter::LENGTH];
+    for (int i = 0; i < 200000; ++i) {
+        time_t stamp = base + static_cast<time_t>(rng() % (365 * 86400));
+        struct tm local;
+        localtime_s(&local, &stamp);
+        strftime(expected, sizeof(expected), "%Y-%m-%d %H:%M:%S", &local);
+        formatter.format(stamp, actual);
+        if (memcmp(expected, actual, TimestampFormatter::LENGTH) != 0) mismatches++;
+    }
+    cout << "   Formatter check against strftime: " << (mismatches == 0 ? "passed" : "FAILED") << "\n";
+
+    // Formatting cost over a month of random entry times
+    size_t checksum = 0;
+    auto begin = chrono::steady_clock::now();
+    for (time_t stamp : stamps) {
+        struct tm local;
+        localtime_s(&local, &stamp);
+        checksum += strftime(expected, sizeof(expected), "%Y-%m-%d %H:%M:%S", &local);
+    }
+    double strftimeSeconds = secondsSince(begin);
+    TimestampFormatter cached;
+    begin = chrono::steady_clock::now();
+    for (time_t stamp : stamps) {
+        cached.format(stamp, actual);
+        checksum += static_cast<unsigned char>(actual[18]);
+    }
+    double cachedSeconds = secondsSince(begin);
+    cout << fixed << setprecision(1);
+    cout << "   localtime + strftime:  " << setw(8) << strftimeSeconds * 1e9 / vehicleCount << " ns/timestamp\n";
+    cout << "   TimestampFormatter:    " << setw(8) << cachedSeconds * 1e9 / vehicleCount << " ns/timestamp ("
+        << cached.getConversionCount() << " localtime calls)\n";
+
+    // A full lot to report on
+    ParkingConfig config;
+    config.logging.path = "";
+    config.journalPath = "";
+    config.archivePath = "";
+    ParkingManagementSystem lot(vehicleCount, 10.0, config);
+    for (int i = 0; i < vehicleCount; ++i) {
+        lot.parkVehicle(makeSyntheticVehicle(i, rng));
+    }
+
+    // Every report goes to a stream that discards the bytes
+    DiscardingBuffer sink;
+    ostream out(&sink);
+    cout << "\n" << left << setw(34) << "Report" << right << setw(12) << "Seconds" << setw(12) << "MB" << setw(14) << "Vehicles/s" << "\n";
+    auto printRow = [&](const char* name, double seconds, uint64_t bytes) {
+        cout << left << setw(34) << name << right << setprecision(3) << setw(12) << seconds << setprecision(1)
+            << setw(12) << bytes / 1e6 << setprecision(0) << setw(14) << vehicleCount / max(seconds, 1e-9) << "\n";
+    };
+
+    // The listing before the cursor: copy every vehicle, localtime + put_time and a flush per vehicle
+    {
+        uint64_t before = sink.bytes;
+        begin = chrono::steady_clock::now();
+        vector<Vehicle> all;
+        lot.filterVehicles(VehicleFilter(), all);
+        for (const Vehicle& vehicle : all) {
+            struct tm local;
+            localtime_s(&local, &vehicle.entryTime);
+            out << "\033[1;36mRegistration: " << vehicle.regNumber << ", Owner: " << vehicle.ownerName
+                << ", Entry Time: " << put_time(&local, "%Y-%m-%d %H:%M:%S") << "\nMake: " << vehicle.vehicleMake
+                << "\nModel: " << vehicle.vehicleModel << "\nColor: " << vehicle.vehicleColor
+                << "\nOwner Contact: " << vehicle.ownerContact << "\033[0m" << endl;
+        }
+        printRow("Copy + put_time + endl (old)", secondsSince(begin), sink.bytes - before);
+    }
+    {
+        // The console listing, with cout pointed at the sink
+        uint64_t before = sink.bytes;
+        streambuf* console = cout.rdbuf(&sink);
+        begin = chrono::steady_clock::now();
+        lot.displayAllParkedVehicles(true);
+        double seconds = secondsSince(begin);
+        cout.rdbuf(console);
+        printRow("displayAllParkedVehicles", seconds, sink.bytes - before);
+    }
+    ExportStats stats;
+    exportParkedVehicles(lot, out, ExportFormat::Csv, stats);
+    printRow("CSV export", stats.seconds, stats.bytes);
+    exportParkedVehicles(lot, out, ExportFormat::JsonLines, stats);
+    printRow("JSON Lines export", stats.seconds, stats.bytes);
+    if (checksum == 1) cout << "";  // Keeps the work from being optimized away
+}
+
+// Compact form of a synthetic session; the strings are built when it is archived
+struct SyntheticSession {
+    uint32_t plate;     // Plate number within the pool
+    uint8_t owner;      // Index into the owner names
+    uint8_t make;       // Index into the makes
+    uint8_t model;      // Index into the models
+    uint8_t color;      // Index into the colors
+    time_t entryTime;   // Entry time
+    time_t exitTime;    // Exit time
+    Cents fee;          // Fee in cents
+};
+
+// Archives sessions over three years and checks and times queries on them
+void runArchiveBenchmark(int sessionCount) {
+    static const char* owners[] = { "Ahmed", "Fatima", "Ali", "Ayesha", "Hassan", "Zainab", "Usman", "Maryam" };
+    static const char* makes[] = { "Toyota", "Honda", "Suzuki", "Hyundai", "Kia", "Nissan", "Daihatsu", "MG" };
+    static const char* models[] = { "Corolla", "Civic", "City", "Alto", "Cultus", "Swift", "Yaris", "Elantra" };
+    static const char* colors[] = { "White", "Black", "Silver", "Grey", "Red", "Blue" };
+    const string archivePath = "bench_Archive.bin";
+    const uint32_t platePool = 200000;                // Regular customers come back many times
+    const time_t span = 3 * 365 * 86400;
+    const time_t start = time(0) - span;
+    cout << "\nSession archive benchmark (" << sessionCount << " sessions over three years, "
+        << platePool << " distinct plates)\n";
+
+    // Sessions in departure order
+    mt19937 rng(20);
+    vector<SyntheticSession> sessions(sessionCount);
+    for (int i = 0; i < sessionCount; ++i) {
+        SyntheticSession& session = sessions[i];
+        session.plate = rng() % platePool;
+        session.owner = static_cast<uint8_t>(session.plate % 8);
+        session.make = static_cast<uint8_t>(session.plate / 8 % 8);
+        session.model = static_cast<uint8_t>(session.plate / 64 % 8);
+        session.color = static_cast<uint8_t>(session.plate / 512 % 6);
+        session.exitTime = start + static_cast<time_t>(static_cast<double>(i) * span / sessionCount);
+        session.entryTime = session.exitTime - 600 - static_cast<time_t>(rng() % 36000);
+        session.fee = static_cast<Cents>((session.exitTime - session.entryTime + 3599) / 3600 * 1000);
+    }
+    auto plateOf = [](uint32_t plate) {
+        char text[16];
+        snprintf(text, sizeof(text), "LEA%07u", plate);
+        return string(text);
+    };
+    auto toSession = [&](const SyntheticSession& compact) {
+        ParkingSession session;
+        session.regNumber = plateOf(compact.plate);
+        session.ownerName = owners[compact.owner];
+        session.vehicleMake = makes[compact.make];
+        session.vehicleModel = models[compact.model];
+        session.vehicleColor = colors[compact.color];
+        session.entryTime = compact.entryTime;
+        session.exitTime = compact.exitTime;
+        session.fee = compact.fee;
+        return session;
+    };
+
+    remove(archivePath.c_str());
+    remove((archivePath + ".tail").c_str());
+    double appendSeconds;
+    {
+        SessionArchive archive(archivePath, 65536, false);
+        archive.open();
+        auto begin = chrono::steady_clock::now();
+        for (const SyntheticSession& session : sessions) {
+            archive.append(toSession(session));
+        }
+        appendSeconds = secondsSince(begin);
+    }
+
+    // Reopening must find every sealed block and the open block in the tail
+    SessionArchive archive(archivePath);
+    bool reopened = archive.open();
+    ArchiveInfo info = archive.getInfo();
+    bool countsMatch = reopened && info.sealedSessions + info.openSessions == static_cast<uint64_t>(sessionCount);
+    cout << "   Reopen check: " << (countsMatch ? "passed" : "FAILED") << " (" << info.blocks << " blocks, "
+        << info.openSessions << " sessions in the tail)\n";
+    cout << fixed << setprecision(1);
+    cout << "   Append:               " << appendSeconds * 1e9 / sessionCount << " ns/session\n";
+    cout << "   Size:                 " << double(info.fileBytes) / max<uint64_t>(info.sealedSessions, 1)
+        << " bytes/session compressed, " << double(info.rawBytes) / max<uint64_t>(info.sealedSessions, 1)
+        << " plain (" << setprecision(2) << double(info.rawBytes) / max<uint64_t>(info.fileBytes, 1) << "x)\n";
+
+    // Queries, each checked against a scan of the generated sessions
+    auto runPlateQuery = [&](const char* label, uint32_t plate, time_t from, time_t to) {
+        SessionQuery query;
+        query.regNumber = plateOf(plate);
+        query.from = from;
+        query.to = to;
+        vector<ParkingSession> found;
+        ArchiveScanStats stats;
+        auto begin = chrono::steady_clock::now();
+        archive.findSessions(query, found, &stats);
+        double seconds = secondsSince(begin);
+        size_t expected = 0;
+        for (const SyntheticSession& session : sessions) {
+            if (session.plate == plate && session.entryTime <= to && session.exitTime >= from) expected++;
+        }
+        bool correct = found.size() == expected;
+        for (const ParkingSession& session : found) {
+            if (session.regNumber != query.regNumber || session.entryTime > to || session.exitTime < from) correct = false;
+        }
+        cout << "   " << left << setw(28) << label << right << setprecision(2) << setw(9) << seconds * 1e3 << " ms  "
+            << setw(4) << found.size() << " sessions, " << stats.blocksRead << "/" << stats.blocks << " blocks read ("
+            << stats.skippedByTime << " by time, " << stats.skippedByPlate << " by plate filter) "
+            << (correct ? "" : "FAILED") << "\n";
+    };
+    cout << "\n";
+    uint32_t plate = sessions[sessionCount / 2].plate;
+    time_t quarterStart = start + span / 2;
+    runPlateQuery("Plate, one quarter", plate, quarterStart, quarterStart + 91 * 86400);
+    runPlateQuery("Plate, all history", plate, numeric_limits<time_t>::min(), numeric_limits<time_t>::max());
+    runPlateQuery("Unknown plate", platePool + 1, numeric_limits<time_t>::min(), numeric_limits<time_t>::max());
+
+    // Revenue by make over the last year
+    time_t yearStart = start + span - 365 * 86400;
+    time_t yearEnd = start + span;
+    map<string, Cents> revenue;
+    ArchiveScanStats stats;
+    auto begin = chrono::steady_clock::now();
+    archive.revenueByMake(yearStart, yearEnd, revenue, &stats);
+    double revenueSeconds = secondsSince(begin);
+    map<string, Cents> expectedRevenue;
+    for (const SyntheticSession& session : sessions) {
+        if (session.exitTime >= yearStart && session.exitTime <= yearEnd) expectedRevenue[makes[session.make]] += session.fee;
+    }
+    cout << "   " << left << setw(28) << "Revenue by make, last year" << right << setw(9) << revenueSeconds * 1e3 << " ms  "
+        << stats.sessionsMatched << " sessions, " << stats.blocksRead << "/" << stats.blocks << " blocks read "
+        << (revenue == expectedRevenue ? "" : "FAILED") << "\n";
+
+    remove(archivePath.c_str());
+    remove((archivePath + ".tail").c_str());
+}
+
+// Measures the cost of the instrumentation and checks its totals
+void runMetricsBenchmark(int operationCount) {
+    const string metricsPrefix = "bench_metrics";
+    const string tracePath = "bench_trace.json";
+    cout << "\nMetrics benchmark (" << operationCount << " operations"
+        << (PARKING_METRICS ? "" : ", instrumentation compiled out") << ")\n";
+    cout << fixed << setprecision(1);
+
+    // Per-call cost of a counter and of an empty timed scope
+    auto begin = chrono::steady_clock::now();
+    for (int i = 0; i < operationCount; ++i) {
+        METRIC_COUNT(MetricCounter::HashLookups, 1);
+    }
+    double countSeconds = secondsSince(begin);
+    begin = chrono::steady_clock::now();
+    for (int i = 0; i < operationCount; ++i) {
+        METRIC_SCOPE(MetricOperation::Search);
+    }
+    double scopeSeconds = secondsSince(begin);
+    Metrics::startTrace(static_cast<size_t>(min(operationCount, 100000)));
+    begin = chrono::steady_clock::now();
+    for (int i = 0; i < operationCount; ++i) {
+        METRIC_SCOPE(MetricOperation::Search);
+    }
+    double tracedSeconds = secondsSince(begin);
+    Metrics::stopTrace();
+    cout << "   Counter:              " << countSeconds * 1e9 / operationCount << " ns/call\n";
+    cout << "   Timed scope:          " << scopeSeconds * 1e9 / operationCount << " ns/call\n";
+    cout << "   Timed scope, tracing: " << tracedSeconds * 1e9 / operationCount << " ns/call\n";
+
+    // Threads that finish must leave their counts behind
+    const int threadCount = 4;
+    uint64_t before = Metrics::counterValue(MetricCounter::AlertsRaised);
+    vector<thread> threads;
+    for (int t = 0; t < threadCount; ++t) {
+        threads.emplace_back([operationCount]() {
+            for (int i = 0; i < operationCount; ++i) {
+                Metrics::count(MetricCounter::AlertsRaised, 1);
+            }
+        });
+    }
+    for (thread& worker : threads) {
+        worker.join();
+    }
+    uint64_t added = Metrics::counterValue(MetricCounter::AlertsRaised) - before;
+    cout << "   Thread totals check:  " << (added == static_cast<uint64_t>(threadCount) * operationCount ? "passed" : "FAILED")
+        << " (" << added << " counted by " << threadCount << " finished threads)\n";
+
+    // Park / retrieve throughput with every hot path instrumented; two lots add up in the gauges
+    ParkingConfig config;
+    config.logging.path = "";
+    config.journalPath = "";
+    config.archivePath = "";
+    int vehicleCount = max(1, operationCount / 2);
+    int64_t parkedBefore = Metrics::gaugeValue(MetricGauge::ParkedVehicles);
+    mt19937 rng(21);
+    vector<Vehicle> vehicles;
+    vehicles.reserve(vehicleCount);
+    for (int i = 0; i < vehicleCount; ++i) {
+        vehicles.push_back(makeSyntheticVehicle(i, rng));
+    }
+    {
+        ParkingManagementSystem first(vehicleCount, 10.0, config);
+        ParkingManagementSystem second(vehicleCount, 10.0, config);
+        begin = chrono::steady_clock::now();
+        for (const Vehicle& vehicle : vehicles) {
+            first.parkVehicle(vehicle);
+        }
+        Cents fee;
+        for (int i = 0; i < vehicleCount; i += 2) {
+            first.retrieveVehicle(vehicles[i].regNumber, fee);
+        }
+        double lotSeconds = secondsSince(begin);
+        second.parkVehicle(vehicles[0]);
+
+        int64_t parked = Metrics::gaugeValue(MetricGauge::ParkedVehicles) - parkedBefore;
+        int64_t expected = first.getCurrentVehicleCount() + second.getCurrentVehicleCount();
+        cout << "   Park + retrieve:      " << lotSeconds * 1e9 / (vehicleCount + (vehicleCount + 1) / 2) << " ns/operation\n";
+        cout << "   Gauge check:          " << (!PARKING_METRICS || parked == expected ? "passed" : "FAILED")
+            << " (" << parked << " parked in two lots)\n";
+    }
+    int64_t parkedAfter = Metrics::gaugeValue(MetricGauge::ParkedVehicles) - parkedBefore;
+    cout << "   Gauge after close:    " << (parkedAfter == 0 ? "passed" : "FAILED") << "\n";
+
+    for (MetricOperation operation : { MetricOperation::Park, MetricOperation::Retrieve, MetricOperation::Search }) {
+        OperationSummary summary = Metrics::summarize(operation);
+        cout << "   " << left << setw(10) << metricName(operation) << right << setw(9) << summary.count << " timed, mean "
+            << summary.meanNs << " ns, p50 " << summary.p50Ns << " ns, p99 " << summary.p99Ns << " ns, max "
+            << summary.maxNs << " ns\n";
+    }
+
+    // Export formats
+    begin = chrono::steady_clock::now();
+    bool written = Metrics::writeFiles(metricsPrefix);
+    double writeSeconds = secondsSince(begin);
+    begin = chrono::steady_clock::now();
+    bool traced = Metrics::writeTrace(tracePath);
+    double traceSeconds = secondsSince(begin);
+    ifstream prom(metricsPrefix + ".prom", ios::binary | ios::ate);
+    ifstream trace(tracePath, ios::binary | ios::ate);
+    cout << setprecision(2);
+    cout << "   Metrics files:        " << (written ? "" : "FAILED ") << writeSeconds * 1e3 << " ms ("
+        << static_cast<long long>(prom.tellg()) << " bytes of Prometheus text)\n";
+    cout << "   Trace file:           " << (traced ? "" : "FAILED ") << traceSeconds * 1e3 << " ms ("
+        << static_cast<long long>(trace.tellg()) << " bytes)\n";
+    prom.close();
+    trace.close();
+    remove((metricsPrefix + ".prom").c_str());
+    remove((metricsPrefix + ".json").c_str());
+    remove(tracePath.c_str());
+}
+
+// Plain edit distance of two folded plates (reference for the bit-parallel one)
+static int foldedEditDistance(const string& a, const string& b) {
+    vector<int> row(b.size() + 1);
+    for (size_t j = 0; j <= b.size(); ++j) row[j] = static_cast<int>(j);
+    for (size_t i = 1; i <= a.size(); ++i) {
+        int diagonal = row[0];
+        row[0] = static_cast<int>(i);
+        for (size_t j = 1; j <= b.size(); ++j) {
+            int best = min(diagonal + (a[i - 1] != b[j - 1]), min(row[j], row[j - 1]) + 1);
+            diagonal = row[j];
+            row[j] = best;
+        }
+    }
+    return row[b.size()];
+}
+
+// Checks and times the approximate plate search
+void runFuzzyPlateBenchmark(int vehicleCount) {
+    static const char* confusable[][2] = { { "0", "O" }, { "O", "0" }, { "1", "I" }, { "I", "1" }, { "8", "B" },
+        { "B", "8" }, { "5", "S" }, { "S", "5" }, { "2", "Z" }, { "Z", "2" }, { "6", "G" }, { "G", "6" },
+        { "D", "0" }, { "Q", "0" }, { "L", "1" } };
+    const int queryCount = 20000;
+    const int checkedQueries = 300;
+    cout << "\nFuzzy plate search benchmark (" << vehicleCount << " parked vehicles, " << queryCount << " misreads)\n";
+
+    // Plates of two or three letters and three or four digits, as issued in different years
+    mt19937 rng(22);
+    vector<Vehicle> vehicles;
+    unordered_set<string> used;
+    while (static_cast<int>(vehicles.size()) < vehicleCount) {
+        string plate;
+        int letters = 2 + rng() % 2;
+        int digits = 3 + rng() % 2;
+        for (int i = 0; i < letters; ++i) plate += static_cast<char>('A' + rng() % 26);
+        for (int i = 0; i < digits; ++i) plate += static_cast<char>('0' + rng() % 10);
+        if (!used.insert(plate).second) continue;
+        Vehicle vehicle = makeSyntheticVehicle(static_cast<int>(vehicles.size()), rng);
+        vehicle.regNumber = plate;
+        vehicles.push_back(vehicle);
+    }
+    ParkingConfig config;
+    config.logging.path = "";
+    config.journalPath = "";
+    config.archivePath = "";
+    ParkingManagementSystem system(vehicleCount, 10.0, config);
+    for (const Vehicle& vehicle : vehicles) {
+        system.parkVehicle(vehicle);
+    }
+    FuzzyPlateIndex standalone;
+    standalone.resize(vehicleCount);
+    for (int i = 0; i < vehicleCount; ++i) {
+        standalone.add(i, vehicles[i].regNumber);
+    }
+
+    // Misreads: one or two camera confusions, and in every second one also a plain error
+    // (a wrong, missing or extra character)
+    auto confuse = [&](string& plate) {
+        for (int attempt = 0; attempt < 8; ++attempt) {
+            size_t position = rng() % plate.size();
+            for (const auto& pair : confusable) {
+                if (plate[position] == pair[0][0]) {
+                    plate[position] = pair[1][0];
+                    return;
+                }
+            }
+        }
+    };
+    vector<string> truths(queryCount), misreads(queryCount);
+    for (int q = 0; q < queryCount; ++q) {
+        truths[q] = vehicles[rng() % vehicleCount].regNumber;
+        string misread = truths[q];
+        confuse(misread);
+        if (rng() % 2) confuse(misread);
+        if (q % 2) {
+            size_t position = rng() % misread.size();
+            switch (rng() % 3) {
+            case 0: misread[position] = static_cast<char>('A' + rng() % 26); break;
+            case 1: misread.erase(position, 1); break;
+            default: misread.insert(position, 1, static_cast<char>('0' + rng() % 10)); break;
+            }
+        }
+        misreads[q] = misread;
+    }
+
+    // Every plate within two folded edits must be found, and nothing else
+    bool matchesScan = true;
+    for (int q = 0; q < checkedQueries; ++q) {
+        vector<PlateMatch> found;
+        system.findSimilarPlates(misreads[q], vehicleCount, found, 2);
+        string folded = foldPlate(misreads[q]);
+        size_t expected = 0;
+        for (const Vehicle& vehicle : vehicles) {
+            if (foldedEditDistance(folded, foldPlate(vehicle.regNumber)) <= 2) expected++;
+        }
+        if (found.size() != expected) matchesScan = false;
+        for (const PlateMatch& match : found) {
+            if (foldedEditDistance(folded, foldPlate(match.regNumber)) != match.edits) matchesScan = false;
+        }
+    }
+    cout << "   Agreement with a full scan: " << (matchesScan ? "passed" : "FAILED") << " (" << checkedQueries << " queries)\n";
+
+    // Time the top-5 lookups the exit barrier makes
+    vector<double> latencies(queryCount);
+    int confusionTop1 = 0, confusionQueries = 0, editedTop1 = 0, editedTop5 = 0;
+    vector<PlateMatch> matches;
+    for (int q = 0; q < queryCount; ++q) {
+        auto begin = chrono::steady_clock::now();
+        system.findSimilarPlates(misreads[q], 5, matches, 2);
+        latencies[q] = secondsSince(begin);
+        bool top1 = !matches.empty() && matches[0].regNumber == truths[q];
+        bool top5 = false;
+        for (const PlateMatch& match : matches) top5 |= match.regNumber == truths[q];
+        if (q % 2 == 0) {
+            confusionQueries++;
+            confusionTop1 += top1;
+        }
+        else {
+            editedTop1 += top1;
+            editedTop5 += top5;
+        }
+    }
+    sort(latencies.begin(), latencies.end());
+    double total = 0;
+    for (double seconds : latencies) total += seconds;
+
+    // The same lookups by scoring every parked plate
+    const int scanQueries = 50;
+    auto begin = chrono::steady_clock::now();
+    long long checksum = 0;
+    for (int q = 0; q < scanQueries; ++q) {
+        for (const Vehicle& vehicle : vehicles) {
+            checksum += plateMatchScore(misreads[q], vehicle.regNumber) <= 4;
+        }
+    }
+    double scanSeconds = secondsSince(begin) / scanQueries;
+
+    int editedQueries = queryCount - confusionQueries;
+    cout << fixed << setprecision(1);
+    cout << "   Confusions only:      " << 100.0 * confusionTop1 / confusionQueries << "% ranked first\n";
+    cout << "   Confusions + 1 error: " << 100.0 * editedTop1 / editedQueries << "% ranked first, "
+        << 100.0 * editedTop5 / editedQueries << "% in the top 5\n";
+    cout << setprecision(3);
+    cout << "   Lookup (top 5):       mean " << total / queryCount * 1e3 << " ms, p50 " << latencies[queryCount / 2] * 1e3
+        << " ms, p99 " << latencies[queryCount * 99 / 100] * 1e3 << " ms, max " << latencies.back() * 1e3 << " ms\n";
+    cout << "   Full scan:            " << scanSeconds * 1e3 << " ms per lookup (" << checksum << " close plates)\n";
+    cout << setprecision(1);
+    cout << "   Index size:           " << double(standalone.memoryUsage()) / vehicleCount << " bytes/plate\n";
+}
+
+// Loads 'vehicleCount' vehicles one parkVehicle call at a time and through the bulk import
+void runImportBenchmark(int vehicleCount) {
+    const string logPath = "bench_Import.log";
+    const string journalPath = "bench_Journal.bin";
+    const string snapshotPath = "bench_Snapshot.bin";
+    const string csvPath = "bench_Import.csv";
+    auto removeFiles = [&]() {
+        remove(logPath.c_str());
+        remove(journalPath.c_str());
+        remove(snapshotPath.c_str());
+        remove(csvPath.c_str());
+    };
+    removeFiles();
+    cout << "\nBulk import benchmark (" << vehicleCount << " vehicles, logging and journal on)\n";
+
+    // The central system's list: plates in no particular order, entry times over the last day
+    mt19937 rng(23);
+    time_t now = time(0);
+    vector<Vehicle> vehicles;
+    vehicles.reserve(vehicleCount);
+    for (int i = 0; i < vehicleCount; ++i) {
+        vehicles.push_back(makeSyntheticVehicle(i, rng));
+        vehicles.back().entryTime = now - static_cast<time_t>(rng() % 86400);
+    }
+    shuffle(vehicles.begin(), vehicles.end(), rng);
+
+    ParkingConfig config;
+    config.logging.path = logPath;
+    config.journalPath = journalPath;
+    config.snapshotPath = snapshotPath;
+    config.archivePath = "";
+    config.journalFlushEveryEvent = false;
+    config.snapshotEveryEvents = 0;
+
+    // Plates of a few prefixes, to compare the plate index of both lots
+    const char* prefixes[] = { "LEA00001", "LEA0005", "LEA000099", "LEB" };
+    auto collectPrefixes = [&](const ParkingManagementSystem& system) {
+        vector<string> plates;
+        vector<Vehicle> found;
+        for (const char* prefix : prefixes) {
+            system.findVehiclesByPrefix(prefix, found);
+            for (const Vehicle& vehicle : found) plates.push_back(vehicle.regNumber);
+            plates.push_back("|");
+        }
+        return plates;
+    };
+
+    // One parkVehicle call per vehicle: hash insert, tree insert, log line and journal record each
+    double parkSeconds, parkFlushSeconds;
+    uint64_t parkEvents;
+    vector<string> parkPlates;
+    {
+        auto system = make_unique<ParkingManagementSystem>(vehicleCount, 10.0, config);
+        auto start = chrono::steady_clock::now();
+        for (const Vehicle& vehicle : vehicles) {
+            system->parkVehicle(vehicle);
+        }
+        parkSeconds = secondsSince(start);
+        parkEvents = system->getLoggerStats().eventsLogged;
+        parkPlates = collectPrefixes(*system);
+        start = chrono::steady_clock::now();
+        system.reset(); // Writes out the log and journal
+        parkFlushSeconds = parkSeconds + secondsSince(start);
+    }
+    removeFiles();
+
+    // Bulk import: one pass over the input, one index build, one log line, one checkpoint
+    double importSeconds, importFlushSeconds;
+    uint64_t importEvents;
+    ImportStats stats;
+    bool indexesMatch = true;
+    {
+        auto system = make_unique<ParkingManagementSystem>(vehicleCount, 10.0, config);
+        auto start = chrono::steady_clock::now();
+        system->importVehicles(vehicles, stats);
+        importSeconds = secondsSince(start);
+        importEvents = system->getLoggerStats().eventsLogged;
+        indexesMatch = collectPrefixes(*system) == parkPlates && system->getCurrentVehicleCount() == vehicleCount;
+        Vehicle found;
+        for (int i = 0; i < 1000 && indexesMatch; ++i) {
+            const Vehicle& expected = vehicles[rng() % vehicleCount];
+            indexesMatch = system->findVehicle(expected.regNumber, found) && found.ownerName == expected.ownerName
+                && found.entryTime == expected.entryTime;
+        }
+        start = chrono::steady_clock::now();
+        system.reset();
+        importFlushSeconds = importSeconds + secondsSince(start);
+    }
+
+    // Restart from what the import left behind
+    auto start = chrono::steady_clock::now();
+    int recovered;
+    {
+        ParkingManagementSystem system(vehicleCount, 10.0, config);
+        recovered = system.getCurrentVehicleCount();
+        ExportStats exported;
+        exportParkedVehicles(system, csvPath, ExportFormat::Csv, exported);
+    }
+    double recoverySeconds = secondsSince(start);
+
+    // Round trip through CSV: every field must come back as it went in
+    ParkingConfig quiet;
+    quiet.logging.path = "";
+    quiet.journalPath = "";
+    quiet.archivePath = "";
+    ImportStats csvStats;
+    bool csvMatches;
+    {
+        ParkingManagementSystem system(vehicleCount, 10.0, quiet);
+        csvMatches = importParkedVehicles(system, csvPath, ImportFormat::Csv, csvStats)
+            && csvStats.parked == static_cast<uint64_t>(vehicleCount) && csvStats.invalid == 0;
+        Vehicle found;
+        for (const Vehicle& expected : vehicles) {
+            if (!csvMatches) break;
+            csvMatches = system.findVehicle(expected.regNumber, found) && found.ownerName == expected.ownerName
+                && found.vehicleMake == expected.vehicleMake && found.vehicleModel == expected.vehicleModel
+                && found.vehicleColor == expected.vehicleColor && found.ownerContact == expected.ownerContact
+                && found.entryTime == expected.entryTime;
+        }
+    }
+    removeFiles();
+
+    cout << "   Same plates and records as per-vehicle parking: " << (indexesMatch ? "passed" : "FAILED") << "\n";
+    cout << "   Recovered after restart: " << (recovered == vehicleCount ? "passed" : "FAILED") << " (" << recovered << " vehicles)\n";
+    cout << "   CSV round trip:          " << (csvMatches ? "passed" : "FAILED") << "\n";
+    cout << fixed << setprecision(3);
+    cout << "   parkVehicle per vehicle: " << parkSeconds << " s (" << parkFlushSeconds << " s with log and journal written, "
+        << parkEvents << " log events)\n";
+    cout << "   importVehicles:          " << importSeconds << " s (" << importFlushSeconds << " s with log written, "
+        << importEvents << " log event)\n";
+    cout << setprecision(1);
+    cout << "   Speedup:                 " << parkFlushSeconds / importFlushSeconds << "x\n";
+    cout << setprecision(3);
+    cout << "   Restart from the import: " << recoverySeconds << " s (with a CSV export)\n";
+    cout << "   CSV read + import:       " << csvStats.seconds << " s\n";
+}
+
+// Checks the simulator against queueing theory and measures simulated events per second
+void runSimulationBenchmark(int days) {
+    cout << "\nSimulation benchmark (" << days << " simulated days per throughput run)\n";
+
+    // Erlang loss system: 50 slots, 45 erlangs offered, a full lot turns vehicles away
+    // Erlang B holds for any stay distribution, so the log-normal run must agree as well.
+    const int slots = 50;
+    const double offered = 45;
+    double erlangB = 1;
+    for (int k = 1; k <= slots; ++k) {
+        erlangB = offered * erlangB / (k + offered * erlangB);
+    }
+    SimulationOptions loss;
+    loss.capacity = slots;
+    loss.days = 2 * 365;
+    loss.arrivalsPerHour = offered;
+    loss.meanDwellMinutes = 60;
+    loss.patienceMinutes = 0;
+    loss.reportMinutes = 365 * 24 * 60;
+    cout << fixed << setprecision(4);
+    for (DwellDistribution dwell : { DwellDistribution::Exponential, DwellDistribution::LogNormal }) {
+        loss.dwell = dwell;
+        SimulationReport report;
+        runSimulation(loss, report);
+        double lost = double(report.balked) / report.arrivals;
+        double carried = offered * (1 - erlangB);
+        bool agrees = fabs(lost - erlangB) < 0.1 * erlangB && fabs(report.meanOccupied - carried) < 0.02 * carried && report.consistent;
+        cout << "   Erlang B, " << (dwell == DwellDistribution::Exponential ? "exponential" : "log-normal ") << " stays: lost "
+            << lost << " vs " << erlangB << ", occupied " << setprecision(2) << report.meanOccupied << " vs " << carried
+            << setprecision(4) << " (" << (agrees ? "passed" : "FAILED") << ")\n";
+    }
+
+    // Erlang delay system: the same lot where every vehicle waits for a slot
+    double erlangC = erlangB / (1 - offered / slots * (1 - erlangB));
+    double expectedWait = erlangC * 60 / (slots - offered);   // Minutes: C / (c * mu - lambda)
+    SimulationOptions delay = loss;
+    delay.dwell = DwellDistribution::Exponential;
+    delay.patienceMinutes = -1;
+    SimulationReport delayReport;
+    runSimulation(delay, delayReport);
+    double queuedShare = double(delayReport.queued) / delayReport.arrivals;
+    double meanWait = delayReport.statistics.meanWaitSeconds / 60 * queuedShare;
+    bool delayAgrees = fabs(queuedShare - erlangC) < 0.1 * erlangC && fabs(meanWait - expectedWait) < 0.15 * expectedWait && delayReport.consistent;
+    cout << "   Erlang C: queued " << queuedShare << " vs " << erlangC << ", mean wait " << setprecision(2) << meanWait
+        << " min vs " << expectedWait << " (" << (delayAgrees ? "passed" : "FAILED") << ")\n";
+
+    // The same seed replays the same traffic
+    SimulationReport first, second;
+    loss.days = 30;
+    runSimulation(loss, first);
+    runSimulation(loss, second);
+    bool repeatable = first.events == second.events && first.revenue == second.revenue && first.balked == second.balked;
+    cout << "   Same seed, same run: " << (repeatable ? "passed" : "FAILED") << "\n";
+
+    // Throughput: a busy office lot and a very large site, both about 90% full
+    cout << "   " << left << setw(28) << "Site" << right << setw(12) << "Events" << setw(10) << "Seconds" << setw(14) << "Events/s" << "\n";
+    for (int capacity : { 1000, 100000 }) {
+        SimulationOptions busy;
+        busy.capacity = capacity;
+        busy.days = capacity > 1000 ? max(1, days / 365) : days;
+        busy.arrivalsPerHour = 0.9 * capacity * 60 / busy.meanDwellMinutes;
+        busy.patienceMinutes = 15;
+        busy.reportMinutes = 24 * 60;
+        SimulationReport report;
+        runSimulation(busy, report);
+        string site = to_string(capacity) + " slots, " + to_string(static_cast<int>(busy.days)) + " days";
+        cout << "   " << left << setw(28) << site << right << setw(12) << report.events << setprecision(3) << setw(10)
+            << report.seconds << setprecision(0) << setw(14) << report.events / report.seconds
+            << (report.consistent ? "" : "  (inconsistent)") << "\n";
+    }
+}
+
+// Bay table searched bay by bay, the way a lot without free-bay bitmaps finds a bay
+struct ScannedBays {
+    vector<BayType> types;   // Type of each bay
+    vector<int> levels;      // Level of each bay
+    vector<char> taken;      // 1 if the bay is taken
+
+    // Copies the layout of an allocator, every bay free
+    explicit ScannedBays(const BayAllocator& bays) : taken(bays.size(), 0) {
+        for (int bay = 0; bay < bays.size(); ++bay) {
+            types.push_back(bays.typeOf(bay));
+            levels.push_back(bays.levelOf(bay));
+        }
+    }
+
+    // Returns true if a bay is free and of a type
+    bool fits(int bay, BayType type) const { return !taken[bay] && types[bay] == type; }
+
+    // Takes the lowest free bay of a type, on one level if 'level' is not -1
+    int allocate(BayType type, int level = -1) {
+        for (size_t bay = 0; bay < types.size(); ++bay) {
+            if (fits(static_cast<int>(bay), type) && (level == -1 || levels[bay] == level)) {
+                taken[bay] = 1;
+                return static_cast<int>(bay);
+            }
+        }
+        return -1;
+    }
+
+    // Takes the free bay of a type closest to 'bay' on its level, walking outwards from it
+    int allocateNear(BayType type, int bay) {
+        int size = static_cast<int>(types.size());
+        for (int distance = 0;; ++distance) {
+            bool lower = bay - distance >= 0 && levels[bay - distance] == levels[bay];
+            bool higher = bay + distance < size && levels[bay + distance] == levels[bay];
+            if (!lower && !higher) return -1;
+            if (lower && fits(bay - distance, type)) {
+                taken[bay - distance] = 1;
+                return bay - distance;
+            }
+            if (higher && fits(bay + distance, type)) {
+                taken[bay + distance] = 1;
+                return bay + distance;
+            }
+        }
+    }
+};
+
+// Checks the bay allocator against a bay-by-bay search on random layouts; returns the mismatches
+static long long runBayAllocatorChecks() {
+    mt19937 rng(43);
+    long long failures = 0;
+    for (int round = 0; round < 60; ++round) {
+        // Up to five levels of mixed groups; some rounds are large enough for three bitmap levels
+        vector<BayGroup> layout;
+        int groups = 1 + static_cast<int>(rng() % 12);
+        int largest = round % 6 == 0 ? 30000 : 300;
+        for (int i = 0; i < groups; ++i) {
+            layout.push_back(BayGroup{ static_cast<int>(rng() % 5), static_cast<BayType>(rng() % BAY_TYPE_COUNT),
+                static_cast<int>(rng() % largest) });
+        }
+        BayAllocator bays;
+        bays.build(layout);
+        ScannedBays scanned(bays);
+        if (bays.size() == 0) continue;
+
+        // Four allocations per release, so the lot runs full and stays there for a while
+        vector<int> taken;
+        for (int op = 0; op < 6000; ++op) {
+            BayType type = static_cast<BayType>(rng() % BAY_TYPE_COUNT);
+            int kind = static_cast<int>(rng() % 5);
+            int expected, actual;
+            if (kind == 0) {
+                if (taken.empty()) continue;
+                size_t index = rng() % taken.size();
+                bays.release(taken[index]);
+                scanned.taken[taken[index]] = 0;
+                taken[index] = taken.back();
+                taken.pop_back();
+                continue;
+            }
+            if (kind == 1) {
+                int level = static_cast<int>(rng() % 6);
+                actual = bays.allocateOnLevel(type, level);
+                expected = scanned.allocate(type, level);
+            }
+            else if (kind == 2) {
+                int bay = static_cast<int>(rng() % bays.size());
+                actual = bays.allocateNear(type, bay);
+                expected = scanned.allocateNear(type, bay);
+            }
+            else {
+                actual = bays.allocate(type);
+                expected = scanned.allocate(type);
+            }
+            if (actual != expected) failures++;
+            if (actual != -1) taken.push_back(actual);
+        }
+        if (bays.freeCount() != bays.size() - static_cast<int>(taken.size())) failures++;
+        for (int bay : taken) {
+            if (bays.isFree(bay)) failures++;
+        }
+    }
+    return failures;
+}
+
+// Checks bay types, fallback, waiting-list admission and bays kept across restarts; returns the failures
+static long long runBayParkingChecks() {
+    const string journalPath = "bench_Bays_Journal.bin";
+    const string snapshotPath = "bench_Bays_Snapshot.bin";
+    remove(journalPath.c_str());
+    remove(snapshotPath.c_str());
+
+    // Level 0: bays 0-1 standard, 2-3 EV, 4 disabled; level 1: bays 5-8 standard
+    ParkingConfig config;
+    config.logging.path = "";
+    config.journalPath = journalPath;
+    config.snapshotPath = snapshotPath;
+    config.archivePath = "";
+    config.snapshotEveryEvents = 0;
+    config.bays = { BayGroup{ 1, BayType::Standard, 4 }, BayGroup{ 0, BayType::Standard, 2 },
+        BayGroup{ 0, BayType::EV, 2 }, BayGroup{ 0, BayType::Disabled, 1 } };
+
+    mt19937 rng(47);
+    vector<Vehicle> vehicles;
+    const BayType types[] = { BayType::EV, BayType::EV, BayType::EV, BayType::Standard, BayType::Standard,
+        BayType::Disabled, BayType::Compact, BayType::Standard, BayType::Standard, BayType::Standard, BayType::EV,
+        BayType::Compact, BayType::Standard };
+    for (int i = 0; i < 13; ++i) {
+        vehicles.push_back(makeSyntheticVehicle(i, rng));
+        vehicles.back().bayType = types[i];
+    }
+
+    long long failures = 0;
+    map<string, int> bayOf;
+    {
+        ParkingManagementSystem lot(0, 10.0, config);
+        if (lot.getBays().size() != 9 || lot.getBays().levelOf(5) != 1) failures++;
+
+        // The third EV and the compact car take standard bays; the tenth vehicle finds no bay
+        const int expected[] = { 2, 3, 0, 1, 5, 4, 6, 7, 8 };
+        for (int i = 0; i < 9; ++i) {
+            Vehicle found;
+            if (lot.parkVehicle(vehicles[i]) != ParkResult::Parked || !lot.findVehicle(vehicles[i].regNumber, found)
+                || found.bay != expected[i] || found.bayType != types[i]) {
+                failures++;
+            }
+        }
+        for (int i = 9; i < 12; ++i) {
+            if (lot.parkVehicle(vehicles[i]) != ParkResult::Queued) failures++;
+        }
+        if (lot.canPark(BayType::Standard) || lot.canPark(BayType::EV)) failures++;
+
+        // A freed EV bay goes to the waiting EV, past the standard car at the head of the list
+        Cents fee;
+        Vehicle admitted;
+        lot.retrieveVehicle(vehicles[0].regNumber, fee);
+        if (!lot.findVehicle(vehicles[10].regNumber, admitted) || admitted.bay != 2
+            || !lot.isWaiting(vehicles[9].regNumber) || !lot.isWaiting(vehicles[11].regNumber)) {
+            failures++;
+        }
+
+        // Freed standard bays go to the head of the list, which a promotion changes
+        lot.promoteWaiting(vehicles[11].regNumber, WaitingPriority::Permit);
+        lot.retrieveVehicle(vehicles[3].regNumber, fee);
+        if (!lot.findVehicle(vehicles[11].regNumber, admitted) || admitted.bay != 1 || !lot.isWaiting(vehicles[9].regNumber)) {
+            failures++;
+        }
+        lot.retrieveVehicle(vehicles[2].regNumber, fee);
+        if (!lot.findVehicle(vehicles[9].regNumber, admitted) || admitted.bay != 0 || lot.getWaitingCount() != 0) {
+            failures++;
+        }
+        if (lot.parkVehicle(vehicles[12]) != ParkResult::Queued) failures++;
+
+        for (ParkedVehicleCursor cursor = lot.openCursor(); cursor.next();) {
+            bayOf[cursor.regNumber()] = cursor.slot();
+        }
+    }
+
+    // Every vehicle is back in its bay after a restart from the journal, and after one from a snapshot
+    for (int restart = 0; restart < 2; ++restart) {
+        ParkingManagementSystem lot(0, 10.0, config);
+        for (const auto& entry : bayOf) {
+            Vehicle found;
+            if (!lot.findVehicle(entry.first, found) || found.bay != entry.second) failures++;
+        }
+        if (lot.getCurrentVehicleCount() != static_cast<int>(bayOf.size()) || !lot.isWaiting(vehicles[12].regNumber)) failures++;
+        if (restart == 0 && !lot.checkpoint()) failures++;
+    }
+    remove(journalPath.c_str());
+    remove(snapshotPath.c_str());
+    return failures;
+}
+
+// Runs release-and-allocate cycles for at most 'maxCycles' cycles or a quarter of a second
+// Returns nanoseconds per cycle; 'cycles' receives the number run.
+template <typename Cycle>
+static double timeBayCycles(int maxCycles, Cycle cycle, int& cycles) {
+    auto start = chrono::steady_clock::now();
+    cycles = 0;
+    while (cycles < maxCycles) {
+        for (int i = 0; i < 16 && cycles < maxCycles; ++i) {
+            cycle(cycles++);
+        }
+        if (secondsSince(start) > 0.25) break;
+    }
+    return secondsSince(start) * 1e9 / max(cycles, 1);
+}
+
+// Measures the bay allocator on 'bayCount' bays at rising fill levels
+void runBayAllocatorBenchmark(int bayCount) {
+    cout << "\nBay allocator benchmark (" << bayCount << " bays on 4 levels)\n";
+    long long failures = runBayAllocatorChecks();
+    cout << "   Lowest, per-level and nearest bay check against a full scan: " << (failures == 0 ? "passed" : "FAILED") << "\n";
+    failures = runBayParkingChecks();
+    cout << "   Bay types, waiting list and restart check: " << (failures == 0 ? "passed" : "FAILED") << "\n";
+
+    // Four equal levels, each 85% standard bays and 5% each of compact, EV and disabled
+    const int levelCount = 4;
+    int perLevel = max(bayCount / levelCount, 20);
+    vector<BayGroup> layout;
+    for (int level = 0; level < levelCount; ++level) {
+        int special = perLevel / 20;
+        layout.push_back(BayGroup{ level, BayType::Standard, perLevel - 3 * special });
+        layout.push_back(BayGroup{ level, BayType::Compact, special });
+        layout.push_back(BayGroup{ level, BayType::EV, special });
+        layout.push_back(BayGroup{ level, BayType::Disabled, special });
+    }
+
+    // Each cycle a random parked vehicle leaves and a vehicle needing the same kind of bay
+    // arrives, so the fill level holds; the scan and the bitmaps must hand out the same bays
+    cout << "Lowest free bay of the vehicle's type, release + allocate per cycle\n";
+    cout << left << setw(8) << "Fill" << right << setw(14) << "Bitmap ns" << setw(14) << "Scan ns"
+        << setw(16) << "Free list ns" << setw(16) << "Near bitmap ns" << setw(16) << "Near scan ns" << "\n";
+    const int maxCycles = 1000000;
+    const double fills[] = { 0.5, 0.9, 0.99, 0.999 };
+    long long mismatches = 0;
+    size_t bytes = 0;
+    for (double fill : fills) {
+        BayAllocator bays;
+        bays.build(layout);
+        bytes = bays.memoryUsage();
+        int total = bays.size();
+        vector<int> order(total);
+        for (int bay = 0; bay < total; ++bay) order[bay] = bay;
+        mt19937 rng(53);
+        shuffle(order.begin(), order.end(), rng);
+        vector<int> initial(order.begin(), order.begin() + static_cast<int>(total * fill));
+
+        // Which parked vehicle leaves and where the arriving one wants to be
+        vector<uint32_t> leaving(maxCycles), wanted(maxCycles);
+        for (int i = 0; i < maxCycles; ++i) {
+            leaving[i] = static_cast<uint32_t>(rng());
+            wanted[i] = static_cast<uint32_t>(rng() % perLevel);
+        }
+
+        // Runs one structure: 'allocate' gets the cycle and the bay that was just freed
+        // The bitmaps record the bays they hand out and the scans compare theirs.
+        enum BayRole { RECORD, COMPARE, TIME_ONLY };
+        vector<int> handedOut;
+        auto measure = [&](auto&& releaseBay, auto&& allocate, BayRole role) {
+            vector<int> taken = initial;
+            if (role == RECORD) handedOut.clear();
+            int cycles = 0;
+            double nanoseconds = timeBayCycles(maxCycles, [&](int i) {
+                size_t index = leaving[i] % taken.size();
+                int freed = taken[index];
+                releaseBay(freed);
+                int bay = allocate(i, freed);
+                if (bay == -1) {
+                    taken[index] = taken.back();
+                    taken.pop_back();
+                    return;
+                }
+                taken[index] = bay;
+                if (role == RECORD) handedOut.push_back(bay);
+                else if (role == COMPARE && (i >= static_cast<int>(handedOut.size()) || handedOut[i] != bay)) mismatches++;
+            }, cycles);
+            return nanoseconds;
+        };
+
+        for (int bay : initial) bays.take(bay);
+        BayAllocator start = bays;
+        double bitmapNs = measure([&](int bay) { bays.release(bay); },
+            [&](int, int freed) { return bays.allocate(bays.typeOf(freed)); }, RECORD);
+
+        ScannedBays scanned(bays);
+        for (int bay : initial) scanned.taken[bay] = 1;
+        ScannedBays scannedStart = scanned;
+        double scanNs = measure([&](int bay) { scanned.taken[bay] = 0; },
+            [&](int, int freed) { return scanned.allocate(scanned.types[freed]); }, COMPARE);
+
+        // The old free-slot stack: constant time, but no lowest, level or nearest bay
+        vector<int> freeLists[BAY_TYPE_COUNT];
+        for (int bay = total - 1; bay >= 0; --bay) {
+            if (scannedStart.fits(bay, scannedStart.types[bay])) freeLists[static_cast<int>(scannedStart.types[bay])].push_back(bay);
+        }
+        double freeListNs = measure([&](int bay) { freeLists[static_cast<int>(scannedStart.types[bay])].push_back(bay); },
+            [&](int, int freed) {
+                vector<int>& list = freeLists[static_cast<int>(scannedStart.types[freed])];
+                int bay = list.back();
+                list.pop_back();
+                return bay;
+            }, TIME_ONLY);
+
+        // Nearest free bay of the type to a wanted spot on the level the vehicle left from
+        bays = start;
+        double nearNs = measure([&](int bay) { bays.release(bay); },
+            [&](int i, int freed) {
+                int base = freed - freed % perLevel;
+                return bays.allocateNear(bays.typeOf(freed), min(base + static_cast<int>(wanted[i]), total - 1));
+            }, RECORD);
+        scanned = scannedStart;
+        double nearScanNs = measure([&](int bay) { scanned.taken[bay] = 0; },
+            [&](int i, int freed) {
+                int base = freed - freed % perLevel;
+                return scanned.allocateNear(scanned.types[freed], min(base + static_cast<int>(wanted[i]), total - 1));
+            }, COMPARE);
+
+        cout << left << setw(8) << (to_string(fill * 100).substr(0, 4) + "%") << right << fixed << setprecision(1)
+            << setw(14) << bitmapNs << setw(14) << scanNs << setw(16) << freeListNs
+            << setw(16) << nearNs << setw(16) << nearScanNs << "\n";
+    }
+    cout << "   Same bays from the bitmaps and the scan: " << (mismatches == 0 ? "passed" : "FAILED") << "\n";
+    cout << "   Allocator memory: " << setprecision(2) << double(bytes) / bayCount << " bytes per bay\n";
+}
+
+// Runs a benchmark by name
+bool runBenchmark(const string& name, int size) {
+    if (name == "index") {
+        runPlateIndexBenchmark(size > 0 ? size : 1000000);
+        return true;
+    }
+    if (name == "recovery") {
+        runRecoveryBenchmark(size > 0 ? size : 1000000);
+        return true;
+    }
+    if (name == "analytics") {
+        runLogAnalyticsBenchmark(size > 0 ? size : 1024);
+        return true;
+    }
+    if (name == "concurrency") {
+        runConcurrencyBenchmark(size > 0 ? size : 200000);
+        return true;
+    }
+    if (name == "federation") {
+        runFederationBenchmark(size > 0 ? size : 10000);
+        return true;
+    }
+    if (name == "waiting") {
+        runWaitingListBenchmark(size > 0 ? size : 100000);
+        return true;
+    }
+    if (name == "tariff") {
+        runTariffBenchmark(size > 0 ? size : 1000000);
+        return true;
+    }
+    if (name == "statistics") {
+        runStatisticsBenchmark(size > 0 ? size : 1000000);
+        return true;
+    }
+    if (name == "validation") {
+        runValidationBenchmark(size > 0 ? size : 1000000);
+        return true;
+    }
+    if (name == "platemap") {
+        runPlateHashBenchmark(size > 0 ? size : 1000000);
+        return true;
+    }
+    if (name == "timers") {
+        runTimerWheelBenchmark(size > 0 ? size : 4000000);
+        return true;
+    }
+    if (name == "export") {
+        runExportBenchmark(size > 0 ? size : 1000000);
+        return true;
+    }
+    if (name == "archive") {
+        runArchiveBenchmark(size > 0 ? size : 2000000);
+        return true;
+    }
+    if (name == "metrics") {
+        runMetricsBenchmark(size > 0 ? size : 1000000);
+        return true;
+    }
+    if (name == "fuzzy") {
+        runFuzzyPlateBenchmark(size > 0 ? size : 100000);
+        return true;
+    }
+    if (name == "import") {
+        runImportBenchmark(size > 0 ? size : 1000000);
+        return true;
+    }
+    if (name == "simulate") {
+        runSimulationBenchmark(size > 0 ? size : 365);
+        return true;
+    }
+    if (name == "bays") {
+        runBayAllocatorBenchmark(size > 0 ? size : 262144);
+        return true;
+    }
+    if (name == "memory") {
+        runMemoryReport(size > 0 ? size : 1000000);
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <string>
+
+using namespace std;
+
+// Compares the balanced plate index with the legacy recursive BST
+// on sorted and random insertion orders
+void runPlateIndexBenchmark(int plateCount);
+
+// Reports bytes per parked vehicle for the old pointer-based records
+// and for the columnar VehicleStore
+void runMemoryReport(int vehicleCount);
+
+// Measures how long the parking system takes to restart from a snapshot
+// plus a journal tail with 'vehicleCount' live vehicles
+void runRecoveryBenchmark(int vehicleCount);
+
+// Writes a synthetic log of about 'megabytes' MB and measures analyzer throughput
+void runLogAnalyticsBenchmark(int megabytes);
+
+// Stress-tests the sharded concurrent engine and reports throughput
+// for 1, 2, 4, ... gates doing 'opsPerThread' operations each
+void runConcurrencyBenchmark(int opsPerThread);
+
+// Measures overflow routing and plate lookups for federations of 100 up to 'maxLots' lots
+void runFederationBenchmark(int maxLots);
+
+// Measures the waiting list with 'waitingCount' vehicles queued during an event day
+void runWaitingListBenchmark(int waitingCount);
+
+// Checks tariff prices to the cent and measures batch pricing of 'vehicleCount' parked vehicles
+void runTariffBenchmark(int vehicleCount);
+
+// Checks dwell-time percentiles and measures the cost of keeping and reading statistics
+void runStatisticsBenchmark(int eventCount);
+
+// Checks the validators against the old rules and measures them on 'plateCount' plate reads
+void runValidationBenchmark(int plateCount);
+
+// Checks the packed plate hash map against unordered_map and compares lookup,
+// insert and erase times and bytes per entry on 'plateCount' plates
+void runPlateHashBenchmark(int plateCount);
+
+// Checks the timer wheel's firing order and measures it with 'timerCount' pending
+// alerts over a simulated day, next to a binary heap and a periodic scan
+void runTimerWheelBenchmark(int timerCount);
+
+// Checks the cached timestamp formatter against strftime and times a report of
+// 'vehicleCount' parked vehicles the old way, on the console listing and as CSV / JSON Lines
+void runExportBenchmark(int vehicleCount);
+
+// Archives 'sessionCount' sessions spread over three years, checks reopening and queries
+// against a brute-force scan, and reports bytes per session and query times
+void runArchiveBenchmark(int sessionCount);
+
+// Measures what the instrumentation costs per counter and per timed scope, checks that
+// counters and gauges add up across threads and lots, and writes sample metrics and trace files
+void runMetricsBenchmark(int operationCount);
+
+// Checks the approximate plate search against a full scan and measures it with
+// 'vehicleCount' parked vehicles and camera misreads of their plates
+void runFuzzyPlateBenchmark(int vehicleCount);
+
+// Loads 'vehicleCount' vehicles with one parkVehicle call each and through the bulk import,
+// checks that both leave the same lot and that it survives a restart and a CSV round trip
+void runImportBenchmark(int vehicleCount);
+
+// Checks the simulator against the Erlang B and C formulas and measures simulated events
+// per second over 'days' simulated days
+void runSimulationBenchmark(int days);
+
+// Checks the bay allocator against a bay-by-bay scan and measures allocate/free cycles on
+// 'bayCount' bays at 50% up to 99.9% full, next to the scan and the old free-slot stack
+void runBayAllocatorBenchmark(int bayCount);
+
+// Runs a benchmark by name; returns false if the name is unknown
+bool runBenchmark(const string& name, int size);
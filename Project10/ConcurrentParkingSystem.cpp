@@ -0,0 +1,272 @@
+#include "ConcurrentParkingSystem.h"
+
+// Creates the shards and fills the global capacity pool
+ConcurrentParkingSystem::ConcurrentParkingSystem(int cap, double rate, const ConcurrentConfig& config)
+    : capacity(cap), tokenBatch(max(1, config.tokenBatch)), availableTokens(cap), occupiedSlots(0), waitingVehicles(0),
+    clock(config.clock ? config.clock : systemClock()) {
+    // A power of two lets the shard be picked with a mask
+    size_t shardCount = 1;
+    while (shardCount < static_cast<size_t>(max(1, config.shardCount))) {
+        shardCount <<= 1;
+    }
+    shardMask = shardCount - 1;
+
+    // Plates spread evenly over the shards, so each shard gets twice its fair share
+    // of slots; the token pool, not the shard size, enforces the real capacity.
+    int slotLimit = static_cast<int>(min<long long>(cap, 2LL * cap / static_cast<long long>(shardCount) + 64));
+
+    // Shards keep no log or journal of their own; events go to the shared logger
+    ParkingConfig shardConfig;
+    shardConfig.logging.path = "";
+    shardConfig.journalPath = "";
+    shardConfig.archivePath = "";
+    shardConfig.clock = clock;
+    shards.reserve(shardCount);
+    for (size_t i = 0; i < shardCount; ++i) {
+        unique_ptr<ParkingShard> shard = make_unique<ParkingShard>();
+        shard->lot = make_unique<ParkingManagementSystem>(slotLimit, rate, shardConfig);
+        shard->slotLimit = slotLimit;
+        shard->cachedTokens = 0;
+        shards.push_back(move(shard));
+    }
+
+    if (!config.logging.path.empty()) {
+        logger = make_unique<EventLogger>(config.logging);
+        if (!logger->isOpen()) {
+            cout << "Error: Failed to open log file." << endl;
+        }
+    }
+}
+
+// Returns the shard that owns a registration number
+ParkingShard& ConcurrentParkingSystem::shardFor(const string& regNumber) const {
+    // Mix the hash so the shard does not reuse the bits the shard's own hash map buckets on
+    size_t h = hash<string>()(regNumber);
+    h ^= h >> 15;
+    h *= 0x2c1b3c6dU;
+    h ^= h >> 12;
+    return *shards[h & shardMask];
+}
+
+// Takes one capacity token for a shard
+bool ConcurrentParkingSystem::acquireToken(ParkingShard& shard) {
+    // Fast path: a token this shard already holds
+    int cached = shard.cachedTokens.load(memory_order_relaxed);
+    while (cached > 0) {
+        if (shard.cachedTokens.compare_exchange_weak(cached, cached - 1, memory_order_acq_rel)) return true;
+    }
+
+    // Take a batch from the global pool so the next parks on this shard stay local
+    int available = availableTokens.load(memory_order_relaxed);
+    while (available > 0) {
+        int take = min(available, tokenBatch);
+        if (availableTokens.compare_exchange_weak(available, available - take, memory_order_acq_rel)) {
+            if (take > 1) {
+                shard.cachedTokens.fetch_add(take - 1, memory_order_acq_rel);
+            }
+            return true;
+        }
+    }
+
+    // The pool is empty; the last free slots may be cached by other shards
+    for (unique_ptr<ParkingShard>& other : shards) {
+        cached = other->cachedTokens.load(memory_order_relaxed);
+        while (cached > 0) {
+            if (other->cachedTokens.compare_exchange_weak(cached, cached - 1, memory_order_acq_rel)) return true;
+        }
+    }
+    return false;
+}
+
+// Gives a capacity token back
+void ConcurrentParkingSystem::releaseToken(ParkingShard& shard) {
+    int cached = shard.cachedTokens.fetch_add(1, memory_order_acq_rel) + 1;
+
+    // Do not let one shard hoard free capacity other shards may need
+    if (cached > 2 * tokenBatch &&
+        shard.cachedTokens.compare_exchange_strong(cached, cached - tokenBatch, memory_order_acq_rel)) {
+        availableTokens.fetch_add(tokenBatch, memory_order_acq_rel);
+    }
+}
+
+// Logs an event through the shared logger, stamped with the system's clock
+void ConcurrentParkingSystem::logEvent(const string& event) {
+    if (logger) {
+        logger->log(event, clock->now());
+    }
+}
+
+// Parks a vehicle if a token is available
+ParkResult ConcurrentParkingSystem::tryPark(const Vehicle& vehicle, bool* shardFull) {
+    ParkingShard& shard = shardFor(vehicle.regNumber);
+    {
+        unique_lock<shared_mutex> guard(shard.lock);
+        if (shard.lot->isParked(vehicle.regNumber)) {
+            return ParkResult::AlreadyParked;
+        }
+        if (shard.lot->getCurrentVehicleCount() >= shard.slotLimit) {
+            if (shardFull) *shardFull = true;
+            return ParkResult::Queued;
+        }
+        if (!acquireToken(shard)) {
+            return ParkResult::Queued;
+        }
+        shard.lot->parkVehicle(vehicle);
+        occupiedSlots.fetch_add(1, memory_order_relaxed);
+    }
+    logEvent("Parked vehicle: " + vehicle.regNumber + " " + vehicle.ownerName);
+    return ParkResult::Parked;
+}
+
+// Parks a vehicle, or queues it when the lot is full
+ParkResult ConcurrentParkingSystem::parkVehicle(const Vehicle& vehicle) {
+    // Vehicles already waiting keep their place in line
+    if (waitingVehicles.load(memory_order_acquire) == 0) {
+        ParkResult result = tryPark(vehicle);
+        if (result != ParkResult::Queued) return result;
+    }
+    else {
+        {
+            lock_guard<mutex> guard(waitingLock);
+            if (waitingPlates.count(vehicle.regNumber)) {
+                return ParkResult::AlreadyWaiting;
+            }
+        }
+        if (isParked(vehicle.regNumber)) {
+            return ParkResult::AlreadyParked;
+        }
+    }
+
+    {
+        lock_guard<mutex> guard(waitingLock);
+        // Another gate may have queued the same plate since the check above
+        if (!waitingPlates.insert(vehicle.regNumber).second) {
+            return ParkResult::AlreadyWaiting;
+        }
+        waitingQueue.push_back(vehicle);
+        waitingVehicles.fetch_add(1, memory_order_release);
+    }
+    logEvent("Vehicle added to waiting queue: " + vehicle.regNumber);
+
+    // A gate may have freed a slot after tryPark failed but before the vehicle was queued
+    admitWaitingVehicles();
+    return ParkResult::Queued;
+}
+
+// Moves vehicles from the waiting queue into free capacity
+void ConcurrentParkingSystem::admitWaitingVehicles() {
+    // Lock order is always waiting queue, then shard
+    lock_guard<mutex> guard(waitingLock);
+
+    // A vehicle whose shard is at its slot limit keeps its place but does not hold back the
+    // vehicles behind it; the scan stops once the lot itself is full
+    auto it = waitingQueue.begin();
+    while (it != waitingQueue.end()) {
+        bool shardFull = false;
+        ParkResult result = tryPark(*it, &shardFull);
+        if (result == ParkResult::Queued) {
+            if (!shardFull) break;
+            ++it;
+            continue;
+        }
+
+        // Parked, or parked by a gate that got to it first
+        waitingPlates.erase(it->regNumber);
+        it = waitingQueue.erase(it);
+        waitingVehicles.fetch_sub(1, memory_order_release);
+    }
+}
+
+// Retrieves a vehicle, storing the charged fee in 'fee'
+RetrieveResult ConcurrentParkingSystem::retrieveVehicle(const string& regNumber, Cents& fee) {
+    ParkingShard& shard = shardFor(regNumber);
+    {
+        unique_lock<shared_mutex> guard(shard.lock);
+        if (shard.lot->retrieveVehicle(regNumber, fee) == RetrieveResult::NotFound) {
+            return RetrieveResult::NotFound;
+        }
+        occupiedSlots.fetch_sub(1, memory_order_relaxed);
+        releaseToken(shard);
+    }
+    logEvent("Retrieved vehicle: " + regNumber + ", Fee: $" + formatCents(fee));
+
+    if (waitingVehicles.load(memory_order_acquire) > 0) {
+        admitWaitingVehicles();
+    }
+    return RetrieveResult::Retrieved;
+}
+
+// Copies the parked vehicle with the given registration number into 'vehicle'
+bool ConcurrentParkingSystem::findVehicle(const string& regNumber, Vehicle& vehicle) const {
+    ParkingShard& shard = shardFor(regNumber);
+    shared_lock<shared_mutex> guard(shard.lock);
+    return shard.lot->findVehicle(regNumber, vehicle);
+}
+
+// Returns true if a vehicle with the given registration number is parked
+bool ConcurrentParkingSystem::isParked(const string& regNumber) const {
+    ParkingShard& shard = shardFor(regNumber);
+    shared_lock<shared_mutex> guard(shard.lock);
+    return shard.lot->isParked(regNumber);
+}
+
+// Collects parked vehicles matching a filter from every shard
+void ConcurrentParkingSystem::filterVehicles(const VehicleFilter& filter, vector<Vehicle>& results) const {
+    // Each shard appends its matches; shards are read one at a time so gates keep running
+    for (const unique_ptr<ParkingShard>& shard : shards) {
+        shared_lock<shared_mutex> guard(shard->lock);
+        shard->lot->filterVehicles(filter, results);
+    }
+}
+
+// Returns the number of parked vehicles
+int ConcurrentParkingSystem::getCurrentVehicleCount() const {
+    return occupiedSlots.load(memory_order_relaxed);
+}
+
+// Returns the number of vehicles in the waiting queue
+int ConcurrentParkingSystem::getWaitingCount() const {
+    return waitingVehicles.load(memory_order_relaxed);
+}
+
+// Returns the revenue collected by all shards
+Cents ConcurrentParkingSystem::getTotalRevenue() const {
+    Cents revenue = 0;
+    for (const unique_ptr<ParkingShard>& shard : shards) {
+        shared_lock<shared_mutex> guard(shard->lock);
+        revenue += shard->lot->getTotalRevenue();
+    }
+    return revenue;
+}
+
+// Merges the statistics of every shard into one snapshot
+StatisticsSnapshot ConcurrentParkingSystem::getStatisticsSnapshot(time_t now, int timelineMinutes) const {
+    ParkingStatistics merged;
+    Cents revenue = 0;
+    for (const unique_ptr<ParkingShard>& shard : shards) {
+        shared_lock<shared_mutex> guard(shard->lock);
+        merged.merge(shard->lot->getStatistics());
+        revenue += shard->lot->getTotalRevenue();
+    }
+    StatisticsSnapshot stats = merged.snapshot(now, getWaitingCount(), timelineMinutes);
+    stats.capacity = capacity; // Shards are oversized; the token pool holds the real capacity
+    stats.revenue = revenue;
+    return stats;
+}
+
+// Returns the state of the capacity token pool
+CapacityStats ConcurrentParkingSystem::getCapacityStats() const {
+    CapacityStats stats;
+    stats.capacity = capacity;
+    stats.available = availableTokens.load(memory_order_acquire);
+    for (const unique_ptr<ParkingShard>& shard : shards) {
+        stats.cached += shard->cachedTokens.load(memory_order_acquire);
+    }
+    stats.occupied = occupiedSlots.load(memory_order_acquire);
+    return stats;
+}
+
+// Returns the number of shards
+int ConcurrentParkingSystem::getShardCount() const {
+    return static_cast<int>(shards.size());
+}
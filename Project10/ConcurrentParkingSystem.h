@@ -0,0 +1,116 @@
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include "ParkingManagementSystem.h"
+
+using namespace std;
+
+// Settings for the concurrent (multi-gate) parking system
+struct ConcurrentConfig {
+    LoggerOptions logging;      // Shared event log for all gates (an empty path disables logging)
+    int shardCount = 16;        // Number of independently locked shards (rounded up to a power of two)
+    int tokenBatch = 32;        // Capacity tokens a shard takes from the global pool at a time
+    shared_ptr<ParkingClock> clock; // Source of the current time for every shard and the log (empty uses the wall clock)
+};
+
+// Counters describing how the capacity pool was used
+struct CapacityStats {
+    int capacity = 0;           // Total parking capacity
+    int available = 0;          // Tokens in the global pool
+    int cached = 0;             // Tokens cached by shards
+    int occupied = 0;           // Vehicles currently parked
+};
+
+// One shard of the concurrent parking system
+// Plates are assigned to a shard by hash, so a shard owns every structure for its plates.
+struct alignas(64) ParkingShard {
+    mutable shared_mutex lock;                  // Writers park/retrieve, readers search
+    unique_ptr<ParkingManagementSystem> lot;    // Slots, hash map and indexes of this shard
+    int slotLimit;                              // Slots allocated for this shard
+    atomic<int> cachedTokens;                   // Capacity tokens taken from the global pool but not yet used
+};
+
+// Thread-safe parking system for many entry/exit gates
+// The state is split into shards by plate hash, each guarded by its own lock, so gates
+// working on different plates run in parallel. Capacity is a pool of tokens: a vehicle
+// may only take a slot after taking a token, so the lot can never be oversubscribed.
+class ConcurrentParkingSystem {
+private:
+    vector<unique_ptr<ParkingShard>> shards;    // Shards indexed by plate hash
+    size_t shardMask;                           // shards.size() - 1
+    int capacity;                               // Maximum parking capacity of the whole lot
+    int tokenBatch;                             // Tokens moved between the pool and a shard at a time
+    atomic<int> availableTokens;                // Global pool of unused capacity tokens
+    atomic<int> occupiedSlots;                  // Number of vehicles parked over all shards
+    mutable mutex waitingLock;                  // Guards the waiting queue
+    deque<Vehicle> waitingQueue;                // Vehicles waiting for a slot, in arrival order
+    unordered_set<string> waitingPlates;        // Registration numbers in the waiting queue
+    atomic<int> waitingVehicles;                // Size of the waiting queue, readable without the lock
+    unique_ptr<EventLogger> logger;             // Shared asynchronous logger (thread-safe)
+    shared_ptr<ParkingClock> clock;             // Source of the current time, shared with the shards
+
+    // Returns the shard that owns a registration number
+    ParkingShard& shardFor(const string& regNumber) const;
+
+    // Takes one capacity token for a shard; returns false if the lot is full
+    bool acquireToken(ParkingShard& shard);
+
+    // Gives a capacity token back, returning surplus cached tokens to the global pool
+    void releaseToken(ParkingShard& shard);
+
+    // Parks a vehicle if a token is available; does not touch the waiting queue
+    // When it returns Queued, 'shardFull' (if given) tells whether the vehicle's shard was at its
+    // slot limit rather than the whole lot being full.
+    ParkResult tryPark(const Vehicle& vehicle, bool* shardFull = nullptr);
+
+    // Moves vehicles from the waiting queue into free capacity
+    void admitWaitingVehicles();
+
+    // Logs an event through the shared logger, stamped with the system's clock
+    void logEvent(const string& event);
+
+public:
+    // Creates a lot of 'cap' slots billed at 'rate' per hour
+    ConcurrentParkingSystem(int cap, double rate, const ConcurrentConfig& config = ConcurrentConfig());
+
+    // Parks a vehicle, or queues it when the lot is full; a plate already in the queue gets AlreadyWaiting
+    ParkResult parkVehicle(const Vehicle& vehicle);
+
+    // Retrieves a vehicle, storing the charged fee in 'fee'
+    RetrieveResult retrieveVehicle(const string& regNumber, Cents& fee);
+
+    // Copies the parked vehicle with the given registration number into 'vehicle'
+    bool findVehicle(const string& regNumber, Vehicle& vehicle) const;
+
+    // Returns true if a vehicle with the given registration number is parked
+    bool isParked(const string& regNumber) const;
+
+    // Collects parked vehicles matching a filter from every shard
+    void filterVehicles(const VehicleFilter& filter, vector<Vehicle>& results) const;
+
+    // Returns the number of parked vehicles
+    int getCurrentVehicleCount() const;
+
+    // Returns the number of vehicles in the waiting queue
+    int getWaitingCount() const;
+
+    // Returns the revenue collected by all shards
+    Cents getTotalRevenue() const;
+
+    // Merges the statistics of every shard into one snapshot at 'now'
+    // Each shard is only read-locked while its counters are added up.
+    StatisticsSnapshot getStatisticsSnapshot(time_t now, int timelineMinutes = 60) const;
+
+    // Returns the state of the capacity token pool
+    CapacityStats getCapacityStats() const;
+
+    // Returns the number of shards
+    int getShardCount() const;
+};
@@ -0,0 +1,188 @@
+#include "EventLogger.h"
+#include <chrono>
+#include <cstring>
+#include "Metrics.h"
+
+// Opens the log file and starts the writer thread
+EventLogger::EventLogger(const LoggerOptions& opts)
+    : options(opts), head(0), tail(0), flushedSequence(0), eventsSinceFlush(0), stopping(false), flushTarget(0) {
+    if (options.ringCapacity == 0) options.ringCapacity = 1;
+    if (options.flushEveryEvents < 1) options.flushEveryEvents = 1;
+    if (options.flushIntervalMs < 1) options.flushIntervalMs = 1;
+
+    file.open(options.path, ios::app | ios::binary); // Open the log file in append mode
+    if (file.is_open()) {
+        ring.resize(options.ringCapacity);
+        writer = thread(&EventLogger::writerLoop, this);
+    }
+}
+
+// Drains pending events, flushes and stops the writer thread
+EventLogger::~EventLogger() {
+    {
+        lock_guard<mutex> guard(lock);
+        stopping = true;
+    }
+    dataReady.notify_one();
+    if (writer.joinable()) {
+        writer.join();
+    }
+    if (file.is_open()) {
+        file.close();
+    }
+}
+
+// Returns true if the log file is open
+bool EventLogger::isOpen() const {
+    return file.is_open();
+}
+
+// Queues an event stamped with the current time
+void EventLogger::log(const string& event) {
+    log(event, time(0));
+}
+
+// Queues an event with an explicit timestamp
+void EventLogger::log(const string& event, time_t timestamp) {
+    if (!file.is_open()) return;
+
+    unique_lock<mutex> guard(lock);
+
+    // Backpressure: wait for the writer to free a record, or drop the event
+    if (tail - head == ring.size()) {
+        if (!options.blockWhenFull) {
+            stats.droppedEvents++;
+            return;
+        }
+        stats.producerWaits++;
+        dataReady.notify_one();
+        spaceReady.wait(guard, [this] { return tail - head < ring.size(); });
+    }
+
+    // Copy the event into its preallocated record
+    LogRecord& record = ring[tail % ring.size()];
+    size_t length = min(event.size(), sizeof(record.text));
+    record.timestamp = timestamp;
+    record.length = static_cast<uint16_t>(length);
+    memcpy(record.text, event.data(), length);
+    uint64_t sequence = tail++;
+    stats.eventsLogged++;
+    METRIC_ADD(MetricGauge::LogQueueDepth, 1);
+    stats.maxQueueDepth = max(stats.maxQueueDepth, static_cast<size_t>(tail - head));
+
+    // Wake the writer only when a batch is due, not on every event
+    if (batchReady()) {
+        dataReady.notify_one();
+    }
+
+    // Per-event durability: wait until a group flush covers this event
+    if (options.durability == LogDurability::EveryEvent) {
+        spaceReady.wait(guard, [this, sequence] { return flushedSequence > sequence; });
+    }
+}
+
+// Blocks until every queued event has been written and flushed
+void EventLogger::flush() {
+    if (!file.is_open()) return;
+
+    unique_lock<mutex> guard(lock);
+    uint64_t target = tail;
+    flushTarget = max(flushTarget, target);
+    dataReady.notify_one();
+    spaceReady.wait(guard, [this, target] { return flushedSequence >= target; });
+}
+
+// Returns a copy of the activity counters
+LoggerStats EventLogger::getStats() const {
+    lock_guard<mutex> guard(lock);
+    return stats;
+}
+
+// Returns true if pending events should be written now
+bool EventLogger::batchReady() const {
+    uint64_t pending = tail - head;
+    if (pending == 0) return false;
+    return options.durability == LogDurability::EveryEvent
+        || (options.durability == LogDurability::EveryNEvents
+            && eventsSinceFlush + pending >= static_cast<uint64_t>(options.flushEveryEvents))
+        || pending >= ring.size() / 2;
+}
+
+// Background writer loop
+void EventLogger::writerLoop() {
+    string batch;                       // Formatted text of one group write
+    batch.reserve(1 << 20);
+    time_t cachedSecond = -1;           // Second whose timestamp prefix is cached
+    char cachedPrefix[32] = { 0 };      // "[YYYY-MM-DD HH:MM:SS] "
+    size_t cachedPrefixLength = 0;
+    auto lastFlush = chrono::steady_clock::now();
+    auto interval = chrono::milliseconds(options.flushIntervalMs);
+
+    unique_lock<mutex> guard(lock);
+    while (true) {
+        // Sleep until events arrive, the flush interval elapses or shutdown is requested
+        dataReady.wait_for(guard, interval, [this] {
+            return stopping || flushTarget > flushedSequence || batchReady();
+        });
+
+        // Format every pending event outside the producers' way
+        uint64_t begin = head;
+        uint64_t end = tail;
+        batch.clear();
+        for (uint64_t sequence = begin; sequence < end; ++sequence) {
+            const LogRecord& record = ring[sequence % ring.size()];
+            if (record.timestamp != cachedSecond) {
+                struct tm localTimeStruct;
+                localtime_s(&localTimeStruct, &record.timestamp);
+                cachedPrefixLength = strftime(cachedPrefix, sizeof(cachedPrefix), "[%Y-%m-%d %H:%M:%S] ", &localTimeStruct);
+                cachedSecond = record.timestamp;
+            }
+            batch.append(cachedPrefix, cachedPrefixLength);
+            batch.append(record.text, record.length);
+            batch.push_back('\n');
+        }
+
+        // Records are copied out, so producers may reuse them while the disk write runs
+        head = end;
+        spaceReady.notify_all();
+        guard.unlock();
+        METRIC_ADD(MetricGauge::LogQueueDepth, -static_cast<int64_t>(end - begin));
+
+        if (!batch.empty()) {
+            METRIC_SCOPE(MetricOperation::LogWrite);
+            METRIC_COUNT(MetricCounter::LogBytes, batch.size());
+            file.write(batch.data(), batch.size());
+        }
+
+        guard.lock();
+        uint64_t written = end - begin;
+        if (written > 0) {
+            stats.eventsWritten += written;
+            stats.batchesWritten++;
+            stats.bytesWritten += batch.size();
+            eventsSinceFlush += written;
+        }
+
+        // Decide whether this batch ends with a flush
+        auto now = chrono::steady_clock::now();
+        bool flushNow = stopping || flushTarget > flushedSequence
+            || options.durability == LogDurability::EveryEvent
+            || (options.durability == LogDurability::Interval && now - lastFlush >= interval)
+            || (options.durability == LogDurability::EveryNEvents
+                && eventsSinceFlush >= static_cast<uint64_t>(options.flushEveryEvents));
+        if (flushNow && flushedSequence < end) {
+            guard.unlock();
+            file.flush();
+            guard.lock();
+            stats.flushes++;
+            flushedSequence = end;
+            eventsSinceFlush = 0;
+            lastFlush = now;
+            spaceReady.notify_all();
+        }
+
+        if (stopping && head == tail) {
+            break;
+        }
+    }
+}
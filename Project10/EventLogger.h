@@ -0,0 +1,97 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+#include <ctime>
+
+using namespace std;
+
+// When the background writer flushes the log file to disk
+enum class LogDurability {
+    EveryEvent,    // log() returns only after its event was flushed (group commit across callers)
+    Interval,      // Flush at most every 'flushIntervalMs' milliseconds
+    EveryNEvents   // Flush after every 'flushEveryEvents' events
+};
+
+// Settings for the event logger
+struct LoggerOptions {
+    string path = "parking_Log.txt";                  // Log file (empty disables logging)
+    LogDurability durability = LogDurability::Interval; // Flush policy
+    int flushIntervalMs = 100;                        // Flush period for Interval mode
+    int flushEveryEvents = 256;                       // Batch size for EveryNEvents mode
+    size_t ringCapacity = 65536;                      // Number of preallocated event records
+    bool blockWhenFull = true;                        // Wait for space when full (false drops the event)
+};
+
+// Counters describing logger activity and backpressure
+struct LoggerStats {
+    uint64_t eventsLogged = 0;    // Events accepted by log()
+    uint64_t eventsWritten = 0;   // Events written to the file
+    uint64_t droppedEvents = 0;   // Events discarded because the ring was full
+    uint64_t producerWaits = 0;   // Times log() had to wait for ring space
+    uint64_t batchesWritten = 0;  // Group writes performed by the writer thread
+    uint64_t flushes = 0;         // File flushes performed
+    uint64_t bytesWritten = 0;    // Bytes written to the file
+    size_t maxQueueDepth = 0;     // Highest number of pending events seen
+};
+
+// Asynchronous event logger writing "[YYYY-MM-DD HH:MM:SS] event" lines
+// Events are copied into a preallocated ring buffer and written in batches
+// by a background thread, so callers never wait on the disk (except in EveryEvent mode).
+class EventLogger {
+private:
+    // A pending event in the ring buffer
+    struct LogRecord {
+        time_t timestamp;   // When the event happened
+        uint16_t length;    // Length of the event text
+        char text[174];     // Event text (longer events are truncated)
+    };
+
+    LoggerOptions options;              // Logger settings
+    ofstream file;                      // Log file
+    vector<LogRecord> ring;             // Preallocated ring buffer
+    uint64_t head;                      // Sequence number of the next event to write
+    uint64_t tail;                      // Sequence number of the next free record
+    uint64_t flushedSequence;           // All events below this sequence are flushed
+    uint64_t eventsSinceFlush;          // Events written since the last flush
+    bool stopping;                      // Set when the writer should drain and exit
+    uint64_t flushTarget;               // flush() waits until events below this sequence are flushed
+    LoggerStats stats;                  // Activity counters
+    mutable mutex lock;                 // Protects the ring and counters
+    condition_variable dataReady;       // Signals the writer that events are pending
+    condition_variable spaceReady;      // Signals producers that records were freed or flushed
+    thread writer;                      // Background writer thread
+
+    // Returns true if pending events should be written now (lock must be held)
+    bool batchReady() const;
+
+    // Background writer loop
+    void writerLoop();
+
+public:
+    // Opens the log file and starts the writer thread
+    explicit EventLogger(const LoggerOptions& options);
+
+    // Drains pending events, flushes and stops the writer thread
+    ~EventLogger();
+
+    // Returns true if the log file is open
+    bool isOpen() const;
+
+    // Queues an event stamped with the current time
+    void log(const string& event);
+
+    // Queues an event with an explicit timestamp
+    void log(const string& event, time_t timestamp);
+
+    // Blocks until every queued event has been written and flushed
+    void flush();
+
+    // Returns a copy of the activity counters
+    LoggerStats getStats() const;
+};
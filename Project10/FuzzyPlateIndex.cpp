@@ -0,0 +1,292 @@
+#include "FuzzyPlateIndex.h"
+#include <algorithm>
+#include <cstdlib>
+
+// Number of character classes after folding (digits, then letters)
+static const int CLASS_COUNT = 36;
+
+// Character tables: folded class + 1 (0 = dropped) and exact class + 1 (upper case, no folding)
+struct PlateFoldTable {
+    uint8_t folded[256];
+    uint8_t exact[256];
+};
+
+// Builds the fold table at compile time
+static constexpr PlateFoldTable makePlateFoldTable() {
+    PlateFoldTable table{};
+    for (int c = '0'; c <= '9'; ++c) {
+        table.folded[c] = table.exact[c] = static_cast<uint8_t>(1 + c - '0');
+    }
+    for (int c = 'A'; c <= 'Z'; ++c) {
+        table.folded[c] = table.exact[c] = static_cast<uint8_t>(11 + c - 'A');
+        table.folded[c + 32] = table.exact[c + 32] = static_cast<uint8_t>(11 + c - 'A');
+    }
+
+    // Camera confusions: each letter joins the class of the digit it is read as
+    const char confusions[][2] = { { 'O', '0' }, { 'Q', '0' }, { 'D', '0' }, { 'I', '1' }, { 'L', '1' },
+        { 'B', '8' }, { 'S', '5' }, { 'Z', '2' }, { 'G', '6' } };
+    for (const auto& pair : confusions) {
+        table.folded[static_cast<int>(pair[0])] = static_cast<uint8_t>(1 + pair[1] - '0');
+        table.folded[static_cast<int>(pair[0]) + 32] = static_cast<uint8_t>(1 + pair[1] - '0');
+    }
+    return table;
+}
+
+static constexpr PlateFoldTable PLATE_FOLDS = makePlateFoldTable();
+
+// Folds a plate into class ids
+string foldPlate(const string& plate) {
+    string folded;
+    folded.reserve(plate.size());
+    for (char c : plate) {
+        uint8_t code = PLATE_FOLDS.folded[static_cast<unsigned char>(c)];
+        if (code != 0) folded += static_cast<char>(code - 1);
+    }
+    return folded;
+}
+
+// Confusion-aware distance of two plates (weighted Levenshtein)
+int plateMatchScore(const string& first, const string& second) {
+    // Exact and folded classes of both plates, separators dropped
+    uint8_t exactA[FuzzyPlateIndex::MAX_QUERY_LENGTH], foldedA[FuzzyPlateIndex::MAX_QUERY_LENGTH];
+    uint8_t exactB[FuzzyPlateIndex::MAX_QUERY_LENGTH], foldedB[FuzzyPlateIndex::MAX_QUERY_LENGTH];
+    int lengthA = 0, lengthB = 0;
+    for (char c : first) {
+        unsigned char u = static_cast<unsigned char>(c);
+        if (PLATE_FOLDS.exact[u] == 0 || lengthA == FuzzyPlateIndex::MAX_QUERY_LENGTH) continue;
+        exactA[lengthA] = PLATE_FOLDS.exact[u];
+        foldedA[lengthA++] = PLATE_FOLDS.folded[u];
+    }
+    for (char c : second) {
+        unsigned char u = static_cast<unsigned char>(c);
+        if (PLATE_FOLDS.exact[u] == 0 || lengthB == FuzzyPlateIndex::MAX_QUERY_LENGTH) continue;
+        exactB[lengthB] = PLATE_FOLDS.exact[u];
+        foldedB[lengthB++] = PLATE_FOLDS.folded[u];
+    }
+
+    // One row of the table at a time
+    int row[FuzzyPlateIndex::MAX_QUERY_LENGTH + 1];
+    for (int j = 0; j <= lengthB; ++j) row[j] = 2 * j;
+    for (int i = 1; i <= lengthA; ++i) {
+        int diagonal = row[0];
+        row[0] = 2 * i;
+        for (int j = 1; j <= lengthB; ++j) {
+            int substitution = exactA[i - 1] == exactB[j - 1] ? 0 : foldedA[i - 1] == foldedB[j - 1] ? 1 : 2;
+            int best = min(diagonal + substitution, min(row[j], row[j - 1]) + 2);
+            diagonal = row[j];
+            row[j] = best;
+        }
+    }
+    return row[lengthB];
+}
+
+// Bit-parallel edit distance against one pattern (Myers 1999, global form by Hyyro)
+// Bit i of a column vector stands for pattern position i; one text character updates
+// the whole column with a handful of word operations.
+class FoldedPattern {
+private:
+    uint64_t matchMasks[CLASS_COUNT];   // Class -> pattern positions holding it
+    uint64_t lastBit;                   // Bit of the last pattern position
+    int length;                         // Pattern length
+
+public:
+    // Prepares a folded pattern of 1..64 characters
+    explicit FoldedPattern(const string& folded) : lastBit(uint64_t(1) << (folded.size() - 1)),
+        length(static_cast<int>(folded.size())) {
+        fill(matchMasks, matchMasks + CLASS_COUNT, 0);
+        for (size_t i = 0; i < folded.size(); ++i) {
+            matchMasks[static_cast<uint8_t>(folded[i])] |= uint64_t(1) << i;
+        }
+    }
+
+    // Returns the edit distance to a folded text, or limit + 1 if it exceeds 'limit'
+    int distance(const char* text, int textLength, int limit) const {
+        if (abs(textLength - length) > limit) return limit + 1;
+        uint64_t positive = ~uint64_t(0);   // Vertical +1 deltas
+        uint64_t negative = 0;              // Vertical -1 deltas
+        int score = length;
+        for (int j = 0; j < textLength; ++j) {
+            uint64_t equal = matchMasks[static_cast<uint8_t>(text[j])];
+            uint64_t xv = equal | negative;
+            uint64_t xh = (((equal & positive) + positive) ^ positive) | equal;
+            uint64_t horizontalPositive = negative | ~(xh | positive);
+            uint64_t horizontalNegative = positive & xh;
+            score += (horizontalPositive & lastBit) != 0;
+            score -= (horizontalNegative & lastBit) != 0;
+
+            // The rest of the text can lower the score by at most one per character
+            if (score - (textLength - 1 - j) > limit) return limit + 1;
+
+            horizontalPositive = (horizontalPositive << 1) | 1;
+            horizontalNegative <<= 1;
+            positive = horizontalNegative | ~(xv | horizontalPositive);
+            negative = horizontalPositive & xv;
+        }
+        return score <= limit ? score : limit + 1;
+    }
+};
+
+// Returns the bit set of the character classes in a folded plate
+static inline uint64_t classMaskOf(const char* folded, size_t length) {
+    uint64_t mask = 0;
+    for (size_t i = 0; i < length; ++i) {
+        mask |= uint64_t(1) << static_cast<uint8_t>(folded[i]);
+    }
+    return mask;
+}
+
+// Returns the number of set bits (branch-free, so a scan over many slots does not stall)
+static inline int bitCount(uint64_t bits) {
+    bits = bits - ((bits >> 1) & 0x5555555555555555ULL);
+    bits = (bits & 0x3333333333333333ULL) + ((bits >> 2) & 0x3333333333333333ULL);
+    bits = (bits + (bits >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+    return static_cast<int>((bits * 0x0101010101010101ULL) >> 56);
+}
+
+// Returns true if two plates cannot be within 'limit' edits because one has more than
+// 'limit' character classes the other lacks (each of those needs its own edit)
+static inline bool classesRuleOut(uint64_t queryMask, uint64_t plateMask, int limit) {
+    return (bitCount(queryMask & ~plateMask) > limit) | (bitCount(plateMask & ~queryMask) > limit);
+}
+
+// Returns the pair id of two folded characters
+static inline int gramOf(char first, char second) {
+    return static_cast<uint8_t>(first) * CLASS_COUNT + static_cast<uint8_t>(second);
+}
+
+// Creates an empty index
+FuzzyPlateIndex::FuzzyPlateIndex() : postings(CLASS_COUNT * CLASS_COUNT), count(0), stamp(0) {
+}
+
+// Sizes the per-slot tables for a number of slots
+void FuzzyPlateIndex::resize(int slotCount) {
+    gramPositions.resize(static_cast<size_t>(slotCount) * GRAMS_PER_SLOT, 0);
+    foldedText.resize(static_cast<size_t>(slotCount) * MAX_INDEXED_LENGTH, 0);
+    foldedLength.resize(slotCount, NOT_INDEXED);
+    classMasks.resize(slotCount, 0);
+    seenStamp.resize(slotCount, 0);
+}
+
+// Adds the plate of a slot
+void FuzzyPlateIndex::add(int slot, const string& plate) {
+    string folded = foldPlate(plate);
+    count++;
+    if (folded.size() < 2 || folded.size() > static_cast<size_t>(MAX_INDEXED_LENGTH)) {
+        foldedLength[slot] = KEPT_APART;
+        unindexed[slot] = folded;
+        return;
+    }
+
+    foldedLength[slot] = static_cast<uint8_t>(folded.size());
+    classMasks[slot] = classMaskOf(folded.data(), folded.size());
+    copy(folded.begin(), folded.end(), foldedText.begin() + static_cast<size_t>(slot) * MAX_INDEXED_LENGTH);
+    for (size_t i = 0; i + 1 < folded.size(); ++i) {
+        vector<uint32_t>& list = postings[gramOf(folded[i], folded[i + 1])];
+        gramPositions[static_cast<size_t>(slot) * GRAMS_PER_SLOT + i] = static_cast<uint32_t>(list.size());
+        list.push_back(static_cast<uint32_t>(slot) << 4 | static_cast<uint32_t>(i));
+    }
+}
+
+// Removes the plate of a slot
+void FuzzyPlateIndex::remove(int slot) {
+    uint8_t length = foldedLength[slot];
+    if (length == NOT_INDEXED) return;
+    count--;
+    foldedLength[slot] = NOT_INDEXED;
+    if (length == KEPT_APART) {
+        unindexed.erase(slot);
+        return;
+    }
+
+    // Swap the last entry of each posting list into the hole so removal is O(pairs)
+    const char* folded = &foldedText[static_cast<size_t>(slot) * MAX_INDEXED_LENGTH];
+    for (int i = 0; i + 1 < length; ++i) {
+        vector<uint32_t>& list = postings[gramOf(folded[i], folded[i + 1])];
+        uint32_t position = gramPositions[static_cast<size_t>(slot) * GRAMS_PER_SLOT + i];
+        uint32_t moved = list.back();
+        list[position] = moved;
+        gramPositions[static_cast<size_t>(moved >> 4) * GRAMS_PER_SLOT + (moved & 15)] = position;
+        list.pop_back();
+    }
+}
+
+// Collects the slots within 'maxEdits' edits of a plate
+void FuzzyPlateIndex::findWithin(const string& plate, int maxEdits, vector<PlateMatch>& matches) const {
+    string folded = foldPlate(plate);
+    maxEdits = max(0, min(maxEdits, MAX_EDITS));
+    if (folded.empty() || folded.size() > static_cast<size_t>(MAX_QUERY_LENGTH)) return;
+    FoldedPattern pattern(folded);
+    uint64_t queryMask = classMaskOf(folded.data(), folded.size());
+
+    // A new query number marks every slot as not yet checked
+    if (++stamp == 0) {
+        fill(seenStamp.begin(), seenStamp.end(), 0);
+        stamp = 1;
+    }
+    auto check = [&](int slot, const char* text, int length) {
+        int edits = pattern.distance(text, length, maxEdits);
+        if (edits <= maxEdits) {
+            PlateMatch match;
+            match.slot = slot;
+            match.edits = edits;
+            matches.push_back(match);
+        }
+    };
+
+    // Plates without pairs are always checked
+    for (const auto& entry : unindexed) {
+        if (classesRuleOut(queryMask, classMaskOf(entry.second.data(), entry.second.size()), maxEdits)) continue;
+        check(entry.first, entry.second.data(), static_cast<int>(entry.second.size()));
+    }
+
+    int pairs = static_cast<int>(folded.size()) - 1;
+    int listsNeeded = 2 * maxEdits + 1;
+    if (pairs < listsNeeded) {
+        // Too few pairs to rule any plate out: check every indexed slot
+        for (size_t slot = 0; slot < foldedLength.size(); ++slot) {
+            uint8_t length = foldedLength[slot];
+            if (length == NOT_INDEXED || length == KEPT_APART) continue;
+            if (classesRuleOut(queryMask, classMasks[slot], maxEdits)) continue;
+            check(static_cast<int>(slot), &foldedText[slot * MAX_INDEXED_LENGTH], length);
+        }
+        return;
+    }
+
+    // Only the shortest posting lists need to be read
+    vector<const vector<uint32_t>*> lists;
+    lists.reserve(pairs);
+    for (int i = 0; i < pairs; ++i) {
+        lists.push_back(&postings[gramOf(folded[i], folded[i + 1])]);
+    }
+    sort(lists.begin(), lists.end(), [](const vector<uint32_t>* a, const vector<uint32_t>* b) {
+        return a->size() != b->size() ? a->size() < b->size() : a < b;
+    });
+    lists.erase(unique(lists.begin(), lists.end()), lists.end());
+    for (int i = 0; i < listsNeeded && i < static_cast<int>(lists.size()); ++i) {
+        for (uint32_t entry : *lists[i]) {
+            uint32_t slot = entry >> 4;
+            if (seenStamp[slot] == stamp) continue;
+            seenStamp[slot] = stamp;
+            if (classesRuleOut(queryMask, classMasks[slot], maxEdits)) continue;
+            check(static_cast<int>(slot), &foldedText[static_cast<size_t>(slot) * MAX_INDEXED_LENGTH], foldedLength[slot]);
+        }
+    }
+}
+
+// Returns the number of plates in the index
+size_t FuzzyPlateIndex::size() const {
+    return count;
+}
+
+// Returns the approximate number of bytes used by the index
+size_t FuzzyPlateIndex::memoryUsage() const {
+    size_t bytes = sizeof(*this) + gramPositions.capacity() * sizeof(uint32_t) + foldedText.capacity()
+        + foldedLength.capacity() + classMasks.capacity() * sizeof(uint64_t) + seenStamp.capacity() * sizeof(uint32_t);
+    for (const vector<uint32_t>& list : postings) {
+        bytes += sizeof(list) + list.capacity() * sizeof(uint32_t);
+    }
+    for (const auto& entry : unindexed) {
+        bytes += sizeof(entry) + entry.second.capacity() + 2 * sizeof(void*);
+    }
+    return bytes;
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+// A parked plate that resembles a misread plate
+struct PlateMatch {
+    int slot = -1;          // Slot of the parked vehicle
+    string regNumber;       // Its registration number
+    int edits = 0;          // Edits between the plates once confusable characters count as equal
+    int score = 0;          // Confusion-aware distance: 1 per confusable swap, 2 per other edit (lower is better)
+};
+
+// Folds a plate for matching: letters to upper case, separators dropped and characters that
+// number plate cameras confuse (O/Q/D/0, I/L/1, B/8, S/5, Z/2, G/6) mapped to one class
+// Returns the class ids (0-35); a plate of only separators folds to an empty string.
+string foldPlate(const string& plate);
+
+// Confusion-aware distance of two plates: 0 per equal character, 1 per confusable
+// substitution, 2 per other substitution, insertion or deletion
+int plateMatchScore(const string& first, const string& second);
+
+// Approximate plate index over the parked vehicles, one entry per slot
+// Each folded plate is split into overlapping character pairs (bigrams) with a posting list
+// of slots per pair. A plate within k edits of the query keeps all but at most 2k of the
+// query's pairs, so only the 2k + 1 shortest posting lists of the query's pairs can hold
+// a match; their slots are then checked with a bit-parallel edit distance (Myers), which
+// handles a whole plate of up to 64 characters per text character in a few word operations.
+// Short queries have too few pairs to rule plates out and check every slot instead; a
+// character-class bit set per slot rejects most of them with one AND and a popcount.
+class FuzzyPlateIndex {
+public:
+    static constexpr int MAX_INDEXED_LENGTH = 12;                 // Longer folded plates are kept apart and always checked
+    static constexpr int MAX_QUERY_LENGTH = 64;                   // Longest folded plate a query may have
+    static constexpr int MAX_EDITS = 4;                           // Largest edit limit of a query
+
+private:
+    static constexpr int GRAMS_PER_SLOT = MAX_INDEXED_LENGTH - 1; // Pairs of the longest indexed plate
+    static constexpr uint8_t NOT_INDEXED = 0;                     // foldedLength of an empty slot
+    static constexpr uint8_t KEPT_APART = 255;                    // foldedLength of a slot kept in 'unindexed'
+
+    vector<vector<uint32_t>> postings;   // Pair id -> entries (slot * 16 + pair number in the plate)
+    vector<uint32_t> gramPositions;      // Slot * GRAMS_PER_SLOT + pair number -> position in its posting list
+    vector<char> foldedText;             // Slot * MAX_INDEXED_LENGTH -> folded plate
+    vector<uint8_t> foldedLength;        // Slot -> folded length (NOT_INDEXED / KEPT_APART)
+    vector<uint64_t> classMasks;         // Slot -> bit set of the character classes in its plate
+    unordered_map<int, string> unindexed; // Slot -> folded plate, for plates too short or too long for pairs
+    size_t count;                        // Plates in the index
+    mutable vector<uint32_t> seenStamp;  // Slot -> query that last looked at it
+    mutable uint32_t stamp;              // Number of the current query
+
+public:
+    // Creates an empty index
+    FuzzyPlateIndex();
+
+    // Sizes the per-slot tables for a number of slots
+    void resize(int slotCount);
+
+    // Adds the plate of a slot
+    void add(int slot, const string& plate);
+
+    // Removes the plate of a slot
+    void remove(int slot);
+
+    // Collects the slots whose plate is within 'maxEdits' edits of 'plate' once both are folded
+    // Fills 'slot' and 'edits' of each match, in no particular order.
+    void findWithin(const string& plate, int maxEdits, vector<PlateMatch>& matches) const;
+
+    // Returns the number of plates in the index
+    size_t size() const;
+
+    // Returns the approximate number of bytes used by the index
+    size_t memoryUsage() const;
+};
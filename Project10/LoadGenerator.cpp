@@ -0,0 +1,203 @@
+#include "LoadGenerator.h"
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+// Parses the options that follow --loadgen
+bool parseLoadOptions(int argc, char* argv[], int first, LoadOptions& options, string& error) {
+    for (int i = first; i < argc; ++i) {
+        string option = argv[i];
+        if (i + 1 >= argc) {
+            error = "Missing value for " + option;
+            return false;
+        }
+        string value = argv[++i];
+        if (option == "--host") options.address.host = value;
+        else if (option == "--port") options.address.port = atoi(value.c_str());
+        else if (option == "--unix") options.address.unixPath = value;
+        else if (option == "--connections") options.connections = atoi(value.c_str());
+        else if (option == "--pipeline") options.pipeline = atoi(value.c_str());
+        else if (option == "--requests") options.requests = strtoull(value.c_str(), nullptr, 10);
+        else if (option == "--parked") options.parkedPerConnection = atoi(value.c_str());
+        else if (option == "--search-percent") options.searchPercent = atoi(value.c_str());
+        else if (option == "--plates") {
+            if (value == "sorted") options.searches = PlateDistribution::Sorted;
+            else if (value == "random") options.searches = PlateDistribution::Random;
+            else if (value == "zipf" || value == "zipfian") options.searches = PlateDistribution::Zipfian;
+            else {
+                error = "Unknown plate distribution " + value;
+                return false;
+            }
+        }
+        else {
+            error = "Unknown option " + option;
+            return false;
+        }
+    }
+    if (options.connections <= 0 || options.pipeline <= 0 || options.parkedPerConnection <= 0
+        || options.searchPercent < 0 || options.searchPercent > 100) {
+        error = "Connections, pipeline and parked must be positive; search percent 0-100";
+        return false;
+    }
+    return true;
+}
+
+// Traffic of one connection
+// Plate ids of connection c are base + c, base + c + connections, ... so connections never share a plate.
+class GateClient {
+private:
+    const LoadOptions& options;       // Test settings
+    uint64_t nextId;                  // Id of the next arriving vehicle
+    uint64_t idStep;                  // Distance between this connection's ids
+    vector<uint64_t> parked;          // Parked ids, oldest first from 'oldest'
+    size_t oldest;                    // Index of the oldest parked id
+    WorkloadGenerator picker;         // Chooses SEARCH targets
+    mt19937_64 rng;                   // Chooses the request type
+
+public:
+    GateClient(const LoadOptions& settings, uint64_t firstId, uint64_t step, uint64_t seed)
+        : options(settings), nextId(firstId), idStep(step), oldest(0),
+        picker(settings.searches, static_cast<uint64_t>(settings.parkedPerConnection), seed), rng(seed) {
+    }
+
+    // Appends the next request line to 'out'
+    void nextRequest(string& out) {
+        size_t count = parked.size() - oldest;
+        bool filling = count < static_cast<size_t>(options.parkedPerConnection);
+        if (!filling && static_cast<int>(rng() % 100) < options.searchPercent) {
+            // Recently parked plates are the hot ones for zipf, the oldest for sorted
+            size_t rank = static_cast<size_t>(picker.nextRank(count));
+            out += "SEARCH " + WorkloadGenerator::plateOf(parked[parked.size() - 1 - rank]) + "\n";
+            return;
+        }
+        if (!filling && rng() % 2 == 0) {
+            out += "RETRIEVE " + WorkloadGenerator::plateOf(parked[oldest++]) + "\n";
+            if (oldest > parked.size() / 2) {
+                parked.erase(parked.begin(), parked.begin() + static_cast<ptrdiff_t>(oldest));
+                oldest = 0;
+            }
+            return;
+        }
+        Vehicle vehicle = WorkloadGenerator::vehicleOf(nextId);
+        parked.push_back(nextId);
+        nextId += idStep;
+        out += "PARK " + vehicle.regNumber + " " + vehicle.ownerName + " " + vehicle.vehicleMake + " "
+            + vehicle.vehicleModel + " " + vehicle.vehicleColor + " " + vehicle.ownerContact + "\n";
+    }
+};
+
+// Runs gate traffic against a server
+bool runLoadGenerator(const LoadOptions& options, LoadReport& report, string& error) {
+    if (!initSockets()) {
+        error = "Cannot start the socket library";
+        return false;
+    }
+
+    // Connect everybody first so the timed run starts with a full set of gates
+    vector<SocketHandle> sockets;
+    for (int c = 0; c < options.connections; ++c) {
+        SocketHandle socket = connectTo(options.address, error);
+        if (socket == INVALID_SOCKET_HANDLE) {
+            for (SocketHandle open : sockets) closeSocket(open);
+            return false;
+        }
+        sockets.push_back(socket);
+    }
+
+    // A fresh id range per run, so plates left parked by an earlier run do not collide
+    uint64_t base = random_device()() % 50000000ULL;
+    mutex reportLock;
+    atomic<bool> failed(false);
+    vector<thread> threads;
+    auto start = chrono::steady_clock::now();
+    for (int c = 0; c < options.connections; ++c) {
+        uint64_t quota = options.requests / options.connections + (static_cast<uint64_t>(c) < options.requests % options.connections ? 1 : 0);
+        threads.emplace_back([&, c, quota]() {
+            GateClient client(options, base + c, static_cast<uint64_t>(options.connections), 1000 + c);
+            SocketHandle socket = sockets[c];
+            vector<chrono::steady_clock::time_point> sentAt(options.pipeline);
+            DurationHistogram latency;
+            uint64_t sent = 0, received = 0, ok = 0, errors = 0;
+            string out, in;
+            char buffer[65536];
+
+            while (received < quota && !failed) {
+                // Top up the window and send the new requests in one write
+                out.clear();
+                auto now = chrono::steady_clock::now();
+                while (sent - received < static_cast<uint64_t>(options.pipeline) && sent < quota) {
+                    client.nextRequest(out);
+                    sentAt[sent % options.pipeline] = now;
+                    sent++;
+                }
+                size_t offset = 0;
+                while (offset < out.size()) {
+                    long written = sendBytes(socket, out.data() + offset, out.size() - offset);
+                    if (written <= 0) {
+                        failed = true;
+                        break;
+                    }
+                    offset += static_cast<size_t>(written);
+                }
+
+                // Collect whatever responses have arrived
+                long count = receiveBytes(socket, buffer, sizeof(buffer));
+                if (count <= 0) {
+                    failed = true;
+                    break;
+                }
+                auto arrived = chrono::steady_clock::now();
+                in.append(buffer, static_cast<size_t>(count));
+                size_t lineStart = 0;
+                for (;;) {
+                    const char* newline = static_cast<const char*>(memchr(in.data() + lineStart, '\n', in.size() - lineStart));
+                    if (!newline) break;
+                    if (in.compare(lineStart, 2, "OK") == 0) ok++;
+                    else errors++;
+                    auto micros = chrono::duration_cast<chrono::microseconds>(arrived - sentAt[received % options.pipeline]).count();
+                    latency.record(static_cast<uint64_t>(micros));
+                    received++;
+                    lineStart = static_cast<size_t>(newline - in.data()) + 1;
+                }
+                in.erase(0, lineStart);
+            }
+
+            lock_guard<mutex> lock(reportLock);
+            report.requests += received;
+            report.okResponses += ok;
+            report.errorResponses += errors;
+            report.latency.merge(latency);
+        });
+    }
+    for (thread& worker : threads) {
+        worker.join();
+    }
+    report.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    for (SocketHandle socket : sockets) {
+        closeSocket(socket);
+    }
+    if (failed) {
+        error = "Connection to " + describeAddress(options.address) + " failed during the run";
+        return false;
+    }
+    return true;
+}
+
+// Prints requests per second and latency percentiles
+void printLoadReport(const LoadOptions& options, const LoadReport& report) {
+    cout << "\nLoad Test (" << describeAddress(options.address) << ", " << options.connections << " connections, pipeline "
+        << options.pipeline << ", " << options.searchPercent << "% searches):\n";
+    cout << "   Requests:          " << report.requests << " (" << report.okResponses << " OK, "
+        << report.errorResponses << " ERR)\n";
+    cout << fixed << setprecision(0);
+    cout << "   Throughput:        " << (report.seconds > 0 ? report.requests / report.seconds : 0) << " requests/s\n";
+    cout << "   Latency (us):      p50 " << report.latency.percentile(50) << ", p90 " << report.latency.percentile(90)
+        << ", p99 " << report.latency.percentile(99) << ", p99.9 " << report.latency.percentile(99.9)
+        << ", max " << report.latency.max() << "\n";
+}
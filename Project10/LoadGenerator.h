@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include "NetworkSocket.h"
+#include "BenchmarkSuite.h"
+#include "ParkingStatistics.h"
+
+using namespace std;
+
+// Settings of a load test against a running server
+struct LoadOptions {
+    SocketAddress address;                                  // Server to connect to
+    int connections = 4;                                    // Concurrent client connections (one thread each)
+    int pipeline = 16;                                      // Requests in flight per connection
+    uint64_t requests = 200000;                             // Requests across all connections
+    int parkedPerConnection = 1000;                         // Vehicles each connection keeps parked
+    int searchPercent = 50;                                 // Share of SEARCH requests; the rest park and retrieve
+    PlateDistribution searches = PlateDistribution::Random; // How SEARCH picks among the parked plates
+};
+
+// Outcome of a load test
+struct LoadReport {
+    uint64_t requests = 0;          // Responses received
+    uint64_t okResponses = 0;       // Responses starting with OK
+    uint64_t errorResponses = 0;    // Responses starting with ERR
+    double seconds = 0;             // Wall time of the run
+    DurationHistogram latency;      // Request-to-response times in microseconds
+};
+
+// Parses the options that follow --loadgen; returns false and sets 'error' on bad input
+// Options: --host H --port P --unix <path> --connections N --pipeline N --requests N
+//          --parked N --search-percent N --plates sorted|random|zipf
+bool parseLoadOptions(int argc, char* argv[], int first, LoadOptions& options, string& error);
+
+// Runs gate traffic against a server: every connection parks its own vehicles, keeps
+// 'parkedPerConnection' of them parked by retrieving the oldest one for every new
+// arrival, and searches among them. Returns false and sets 'error' if a connection fails.
+bool runLoadGenerator(const LoadOptions& options, LoadReport& report, string& error);
+
+// Prints requests per second and latency percentiles
+void printLoadReport(const LoadOptions& options, const LoadReport& report);
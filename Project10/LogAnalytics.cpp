@@ -0,0 +1,373 @@
+#include "LogAnalytics.h"
+#include "Tariff.h"
+#include <iostream>
+#include <iomanip>
+#include <cstring>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <algorithm>
+#include <unordered_map>
+#include <memory>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Constructor for an unmapped file
+MappedFile::MappedFile() : data(nullptr), length(0),
+#ifdef _WIN32
+    fileHandle(INVALID_HANDLE_VALUE), mapHandle(nullptr)
+#else
+    descriptor(-1)
+#endif
+{}
+
+// Unmaps the file
+MappedFile::~MappedFile() {
+    close();
+}
+
+// Maps a file
+bool MappedFile::open(const string& path) {
+    close();
+#ifdef _WIN32
+    fileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+        OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (fileHandle == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(fileHandle, &fileSize)) {
+        close();
+        return false;
+    }
+    length = static_cast<size_t>(fileSize.QuadPart);
+    if (length == 0) return true; // Empty files cannot be mapped, but are valid
+
+    mapHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapHandle) {
+        close();
+        return false;
+    }
+    data = static_cast<const char*>(MapViewOfFile(mapHandle, FILE_MAP_READ, 0, 0, 0));
+#else
+    descriptor = ::open(path.c_str(), O_RDONLY);
+    if (descriptor < 0) return false;
+
+    struct stat info;
+    if (fstat(descriptor, &info) != 0) {
+        close();
+        return false;
+    }
+    length = static_cast<size_t>(info.st_size);
+    if (length == 0) return true; // Empty files cannot be mapped, but are valid
+
+    void* mapped = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    data = mapped == MAP_FAILED ? nullptr : static_cast<const char*>(mapped);
+    if (data) {
+        madvise(mapped, length, MADV_SEQUENTIAL);
+    }
+#endif
+    if (!data) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+// Unmaps the file
+void MappedFile::close() {
+#ifdef _WIN32
+    if (data) UnmapViewOfFile(data);
+    if (mapHandle) CloseHandle(mapHandle);
+    if (fileHandle != INVALID_HANDLE_VALUE) CloseHandle(fileHandle);
+    mapHandle = nullptr;
+    fileHandle = INVALID_HANDLE_VALUE;
+#else
+    if (data) munmap(const_cast<char*>(data), length);
+    if (descriptor >= 0) ::close(descriptor);
+    descriptor = -1;
+#endif
+    data = nullptr;
+    length = 0;
+}
+
+// Returns the number of days since 1970-01-01 for a civil date
+int64_t daysFromCivil(int year, int month, int day) {
+    year -= month <= 2;
+    int64_t era = (year >= 0 ? year : year - 399) / 400;
+    int64_t yearOfEra = year - era * 400;
+    int64_t dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    int64_t dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + dayOfEra - 719468;
+}
+
+// Converts a day number back into "YYYY-MM-DD"
+string civilDateString(int64_t days) {
+    days += 719468;
+    int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+    int64_t dayOfEra = days - era * 146097;
+    int64_t yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    int64_t dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    int64_t monthIndex = (5 * dayOfYear + 2) / 153;
+    int day = static_cast<int>(dayOfYear - (153 * monthIndex + 2) / 5 + 1);
+    int month = static_cast<int>(monthIndex < 10 ? monthIndex + 3 : monthIndex - 9);
+    int64_t year = yearOfEra + era * 400 + (month <= 2);
+
+    char text[16];
+    snprintf(text, sizeof(text), "%04d-%02d-%02d", static_cast<int>(year), month, day);
+    return text;
+}
+
+// Lists a log file and its rotated siblings, oldest first
+vector<string> findLogFiles(const string& path, bool includeRotated) {
+    vector<string> files;
+    error_code error;
+    if (filesystem::exists(path, error)) {
+        files.push_back(path);
+    }
+    if (!includeRotated) return files;
+
+    // Rotated siblings share the file name as a prefix (parking_Log.txt.1, parking_Log.txt.2023-01 ...)
+    filesystem::path base(path);
+    filesystem::path directory = base.has_parent_path() ? base.parent_path() : filesystem::path(".");
+    string name = base.filename().string();
+    vector<filesystem::path> rotated;
+    for (filesystem::directory_iterator it(directory, error), end; !error && it != end; it.increment(error)) {
+        string candidate = it->path().filename().string();
+        if (candidate.size() > name.size() && candidate.compare(0, name.size(), name) == 0 && candidate[name.size()] == '.') {
+            rotated.push_back(it->path());
+        }
+    }
+
+    // Oldest rotation first, the live file last
+    sort(rotated.begin(), rotated.end(), [](const filesystem::path& a, const filesystem::path& b) {
+        return filesystem::last_write_time(a) < filesystem::last_write_time(b);
+    });
+    vector<string> ordered;
+    for (const filesystem::path& file : rotated) ordered.push_back(file.string());
+    ordered.insert(ordered.end(), files.begin(), files.end());
+    return ordered;
+}
+
+// Parses two ASCII digits; returns -1 if they are not digits
+static inline int twoDigits(const char* p) {
+    unsigned a = static_cast<unsigned>(p[0] - '0');
+    unsigned b = static_cast<unsigned>(p[1] - '0');
+    return (a > 9 || b > 9) ? -1 : static_cast<int>(a * 10 + b);
+}
+
+// Parses "$<int>.<frac>" into cents, rounding half up at the third decimal
+static int64_t parseFeeCents(const char* p, const char* end) {
+    int64_t whole = 0;
+    while (p < end && *p >= '0' && *p <= '9') whole = whole * 10 + (*p++ - '0');
+
+    int fraction[3] = { 0, 0, 0 };
+    if (p < end && *p == '.') {
+        ++p;
+        for (int i = 0; i < 3 && p < end && *p >= '0' && *p <= '9'; ++i) fraction[i] = *p++ - '0';
+    }
+    return whole * 100 + fraction[0] * 10 + fraction[1] + (fraction[2] >= 5 ? 1 : 0);
+}
+
+// Per-thread partial aggregates
+struct PartialAnalysis {
+    unordered_map<int64_t, HourlyActivity> hours;  // Hour key -> activity
+    uint64_t linesScanned = 0;                      // Lines looked at
+    uint64_t malformedLines = 0;                    // Lines without a valid timestamp
+};
+
+// Scans the complete lines of [begin, end) and aggregates parking events
+static void scanChunk(const char* begin, const char* end, const AnalysisOptions& options, PartialAnalysis& out) {
+    static const char PARKED[] = "Parked vehicle: ";
+    static const char RETRIEVED[] = "Retrieved vehicle: ";
+    static const char QUEUED[] = "Vehicle added to waiting queue: ";
+
+    // Cache of the last day seen, since consecutive lines share the same date
+    char cachedDate[10] = { 0 };
+    int64_t cachedDay = 0;
+    bool haveCachedDay = false;
+
+    const char* line = begin;
+    while (line < end) {
+        // memchr is SIMD-accelerated in the C runtime, which makes it the line splitter
+        const char* lineEnd = static_cast<const char*>(memchr(line, '\n', end - line));
+        if (!lineEnd) lineEnd = end;
+        const char* next = lineEnd + 1;
+        if (lineEnd > line && lineEnd[-1] == '\r') --lineEnd;
+        out.linesScanned++;
+
+        // "[YYYY-MM-DD HH:MM:SS] " prefix
+        if (lineEnd - line < 22 || line[0] != '[' || line[5] != '-' || line[8] != '-' || line[20] != ']') {
+            out.malformedLines++;
+            line = next;
+            continue;
+        }
+        if (!haveCachedDay || memcmp(cachedDate, line + 1, 10) != 0) {
+            int century = twoDigits(line + 1), yearLow = twoDigits(line + 3);
+            int month = twoDigits(line + 6), day = twoDigits(line + 9);
+            if (century < 0 || yearLow < 0 || month < 1 || month > 12 || day < 1 || day > 31) {
+                out.malformedLines++;
+                line = next;
+                continue;
+            }
+            cachedDay = daysFromCivil(century * 100 + yearLow, month, day);
+            memcpy(cachedDate, line + 1, 10);
+            haveCachedDay = true;
+        }
+        int hour = twoDigits(line + 12);
+        if (hour < 0 || hour > 23) {
+            out.malformedLines++;
+            line = next;
+            continue;
+        }
+        if (cachedDay < options.fromDay || cachedDay > options.toDay) {
+            line = next;
+            continue;
+        }
+
+        // Classify the event by its fixed prefix
+        const char* event = line + 22;
+        size_t eventLength = static_cast<size_t>(lineEnd - event);
+        int64_t hourKey = cachedDay * 24 + hour;
+        if (eventLength > sizeof(PARKED) - 1 && memcmp(event, PARKED, sizeof(PARKED) - 1) == 0) {
+            out.hours[hourKey].parked++;
+        }
+        else if (eventLength > sizeof(RETRIEVED) - 1 && memcmp(event, RETRIEVED, sizeof(RETRIEVED) - 1) == 0) {
+            HourlyActivity& activity = out.hours[hourKey];
+            activity.retrieved++;
+
+            // The fee is the last field of the line: ", Fee: $<amount>"
+            const char* dollar = lineEnd - 1;
+            while (dollar > event && *dollar != '$') --dollar;
+            if (*dollar == '$') {
+                activity.feeCents += parseFeeCents(dollar + 1, lineEnd);
+            }
+        }
+        else if (eventLength > sizeof(QUEUED) - 1 && memcmp(event, QUEUED, sizeof(QUEUED) - 1) == 0) {
+            out.hours[hourKey].queued++;
+        }
+        line = next;
+    }
+}
+
+// Memory-maps the log files and aggregates them in parallel chunks
+bool analyzeLogs(const vector<string>& files, const AnalysisOptions& options, LogAnalysis& result) {
+    auto start = chrono::steady_clock::now();
+
+    // Map every file up front
+    vector<unique_ptr<MappedFile>> mapped;
+    for (const string& path : files) {
+        mapped.push_back(make_unique<MappedFile>());
+        if (!mapped.back()->open(path)) {
+            return false;
+        }
+    }
+
+    // Split each file into chunks that start and end on line boundaries
+    struct Chunk { const char* begin; const char* end; };
+    vector<Chunk> chunks;
+    size_t chunkBytes = max<size_t>(options.chunkBytes, 1 << 16);
+    for (const auto& file : mapped) {
+        const char* p = file->begin();
+        const char* end = p + file->size();
+        while (p < end) {
+            const char* chunkEnd = p + min<size_t>(chunkBytes, static_cast<size_t>(end - p));
+            if (chunkEnd < end) {
+                const char* newline = static_cast<const char*>(memchr(chunkEnd, '\n', end - chunkEnd));
+                chunkEnd = newline ? newline + 1 : end;
+            }
+            chunks.push_back(Chunk{ p, chunkEnd });
+            result.bytesScanned += static_cast<uint64_t>(chunkEnd - p);
+            p = chunkEnd;
+        }
+    }
+
+    // Workers pull chunks from a shared counter and aggregate privately
+    int threadCount = options.threads > 0 ? options.threads : max(1u, thread::hardware_concurrency());
+    threadCount = max(1, min<int>(threadCount, static_cast<int>(chunks.size())));
+    vector<PartialAnalysis> partials(threadCount);
+    atomic<size_t> nextChunk(0);
+    auto worker = [&](int index) {
+        for (size_t i = nextChunk++; i < chunks.size(); i = nextChunk++) {
+            scanChunk(chunks[i].begin, chunks[i].end, options, partials[index]);
+        }
+    };
+    vector<thread> workers;
+    for (int i = 1; i < threadCount; ++i) workers.emplace_back(worker, i);
+    worker(0);
+    for (thread& t : workers) t.join();
+
+    // Merge the partial results
+    for (const PartialAnalysis& partial : partials) {
+        result.linesScanned += partial.linesScanned;
+        result.malformedLines += partial.malformedLines;
+        for (const auto& entry : partial.hours) {
+            HourlyActivity& total = result.hours[entry.first];
+            total.parked += entry.second.parked;
+            total.retrieved += entry.second.retrieved;
+            total.queued += entry.second.queued;
+            total.feeCents += entry.second.feeCents;
+        }
+    }
+
+    result.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    return true;
+}
+
+// Prints per-day totals and, optionally, per-hour activity
+void printLogAnalysis(const LogAnalysis& analysis, bool hourly) {
+    cout << "\nDaily Summary:\n";
+    cout << left << setw(12) << "Date" << right << setw(10) << "Parked" << setw(11) << "Retrieved"
+        << setw(10) << "Queued" << setw(14) << "Fees ($)" << "\n";
+
+    int64_t currentDay = INT64_MIN;
+    HourlyActivity day;
+    int64_t totalCents = 0;
+    auto printDay = [&]() {
+        if (currentDay == INT64_MIN) return;
+        cout << left << setw(12) << civilDateString(currentDay) << right << setw(10) << day.parked
+            << setw(11) << day.retrieved << setw(10) << day.queued << setw(14) << formatCents(day.feeCents) << "\n";
+    };
+    for (const auto& entry : analysis.hours) {
+        int64_t dayNumber = entry.first >= 0 ? entry.first / 24 : (entry.first - 23) / 24;
+        if (dayNumber != currentDay) {
+            printDay();
+            currentDay = dayNumber;
+            day = HourlyActivity();
+        }
+        day.parked += entry.second.parked;
+        day.retrieved += entry.second.retrieved;
+        day.queued += entry.second.queued;
+        day.feeCents += entry.second.feeCents;
+        totalCents += entry.second.feeCents;
+    }
+    printDay();
+
+    if (hourly) {
+        cout << "\nHourly Activity:\n";
+        cout << left << setw(17) << "Hour" << right << setw(10) << "Parked" << setw(11) << "Retrieved" << setw(14) << "Fees ($)" << "\n";
+        for (const auto& entry : analysis.hours) {
+            int64_t dayNumber = entry.first >= 0 ? entry.first / 24 : (entry.first - 23) / 24;
+            int hour = static_cast<int>(entry.first - dayNumber * 24);
+            cout << left << civilDateString(dayNumber) << " " << setw(2) << setfill('0') << right << hour
+                << ":00" << setfill(' ') << setw(10) << entry.second.parked << setw(11) << entry.second.retrieved
+                << setw(14) << formatCents(entry.second.feeCents) << "\n";
+        }
+    }
+
+    double gigabytesPerSecond = analysis.seconds > 0 ? analysis.bytesScanned / analysis.seconds / 1e9 : 0;
+    cout << "\nTotal fees: $" << formatCents(totalCents) << "\n";
+    cout << "Lines scanned: " << analysis.linesScanned << " (" << analysis.malformedLines << " malformed)\n";
+    cout << fixed << setprecision(3) << "Scanned " << analysis.bytesScanned / 1e6 << " MB in "
+        << analysis.seconds << " s (" << setprecision(2) << gigabytesPerSecond << " GB/s)\n";
+}
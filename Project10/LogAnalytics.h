@@ -0,0 +1,82 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <map>
+#include <cstdint>
+
+using namespace std;
+
+// Read-only memory mapping of a whole file
+class MappedFile {
+private:
+    const char* data;   // Start of the mapped bytes (nullptr if not mapped)
+    size_t length;      // Number of mapped bytes
+#ifdef _WIN32
+    void* fileHandle;   // Windows file handle
+    void* mapHandle;    // Windows file-mapping handle
+#else
+    int descriptor;     // POSIX file descriptor
+#endif
+
+public:
+    // Constructor for an unmapped file
+    MappedFile();
+
+    // Unmaps the file
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Maps a file; returns false if it cannot be opened or mapped
+    bool open(const string& path);
+
+    // Unmaps the file
+    void close();
+
+    // Accessors for the mapped bytes
+    const char* begin() const { return data; }
+    size_t size() const { return length; }
+};
+
+// Aggregates for one hour of log activity
+struct HourlyActivity {
+    uint64_t parked = 0;       // "Parked vehicle" events
+    uint64_t retrieved = 0;    // "Retrieved vehicle" events
+    uint64_t queued = 0;       // "Vehicle added to waiting queue" events
+    int64_t feeCents = 0;      // Fees charged by retrievals
+};
+
+// Result of analyzing one or more log files
+struct LogAnalysis {
+    map<int64_t, HourlyActivity> hours;  // Hour key (days since 1970-01-01 * 24 + hour) -> activity
+    uint64_t linesScanned = 0;           // Lines looked at
+    uint64_t malformedLines = 0;         // Lines without a valid timestamp
+    uint64_t bytesScanned = 0;           // Bytes of log data read
+    double seconds = 0;                  // Wall-clock time of the analysis
+};
+
+// Options for an analysis run
+struct AnalysisOptions {
+    int threads = 0;                 // Worker threads (0 uses every hardware thread)
+    size_t chunkBytes = 64 << 20;    // Bytes per work item
+    int64_t fromDay = INT64_MIN;     // First day to include (days since 1970-01-01)
+    int64_t toDay = INT64_MAX;       // Last day to include
+    bool includeRotated = true;      // Also read rotated siblings (e.g. parking_Log.txt.1)
+};
+
+// Returns the number of days since 1970-01-01 for a civil date
+int64_t daysFromCivil(int year, int month, int day);
+
+// Converts a day number back into "YYYY-MM-DD"
+string civilDateString(int64_t days);
+
+// Lists a log file and its rotated siblings, oldest first
+vector<string> findLogFiles(const string& path, bool includeRotated);
+
+// Memory-maps the log files and aggregates them in parallel chunks
+bool analyzeLogs(const vector<string>& files, const AnalysisOptions& options, LogAnalysis& result);
+
+// Prints per-day totals and, optionally, per-hour activity
+void printLogAnalysis(const LogAnalysis& analysis, bool hourly);
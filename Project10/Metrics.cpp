@@ -0,0 +1,525 @@
+#include "Metrics.h"
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <vector>
+
+// Latency buckets: values below 8 ns get their own bucket, larger ones are split into
+// four sub-buckets per power of two (at most 19% wide)
+static const int EXACT_BUCKETS = 8;
+static const int LATENCY_BUCKETS = EXACT_BUCKETS + 61 * 4;
+
+// Powers of two (in ns) used as Prometheus bucket bounds: 128 ns .. 4.3 s
+static const int FIRST_BOUND_BIT = 7;
+static const int LAST_BOUND_BIT = 32;
+
+static const int COUNTERS = static_cast<int>(MetricCounter::Count);
+static const int GAUGES = static_cast<int>(MetricGauge::Count);
+static const int OPERATIONS = static_cast<int>(MetricOperation::Count);
+
+// Latency histogram of one operation on one thread
+struct LatencyHistogram {
+    atomic<uint64_t> buckets[LATENCY_BUCKETS] = {};  // Operations per bucket
+    atomic<uint64_t> count{ 0 };                      // Operations timed
+    atomic<uint64_t> sumNs{ 0 };                      // Total time
+    atomic<uint64_t> maxNs{ 0 };                      // Slowest operation
+};
+
+// One recorded trace span
+struct TraceEvent {
+    uint64_t startNs;           // Start, in ns since process start
+    uint64_t durationNs;        // Length
+    MetricOperation operation;  // What was timed
+};
+
+// Counters, gauges and histograms of one thread
+// Only the owning thread writes them; other threads only read.
+struct ThreadMetrics {
+    atomic<uint64_t> counters[COUNTERS] = {};        // Counter values
+    atomic<int64_t> gauges[GAUGES] = {};             // Gauge changes
+    LatencyHistogram latencies[OPERATIONS];          // Histogram per operation
+    uint32_t threadId = 0;                           // Number shown in traces
+    unique_ptr<TraceEvent[]> trace;                  // Trace buffer (allocated under the registry lock)
+    size_t traceCapacity = 0;                        // Size of the trace buffer
+    atomic<size_t> traceCount{ 0 };                  // Spans published in the trace buffer
+    uint64_t traceGeneration = 0;                    // Trace the buffer belongs to
+};
+
+// Trace span of a thread that has already finished
+struct RetiredTraceEvent {
+    uint32_t threadId;          // Thread that recorded it
+    TraceEvent event;           // The span
+};
+
+// Registry of all thread blocks
+// Function-local statics so they exist before any thread registers.
+static mutex& registryLock() {
+    static mutex lock;
+    return lock;
+}
+static vector<ThreadMetrics*>& liveThreads() {
+    static vector<ThreadMetrics*> threads;
+    return threads;
+}
+static ThreadMetrics& retiredMetrics() {
+    static ThreadMetrics retired;
+    return retired;
+}
+static vector<RetiredTraceEvent>& retiredTrace() {
+    static vector<RetiredTraceEvent> events;
+    return events;
+}
+
+static const chrono::steady_clock::time_point processStart = chrono::steady_clock::now();
+static atomic<bool> tracing{ false };            // Whether spans are being recorded
+static atomic<uint64_t> traceGeneration{ 0 };    // Bumped by every startTrace
+static atomic<size_t> traceEventsPerThread{ 0 }; // Trace buffer size of the current trace
+static uint32_t nextThreadId = 1;                // Guarded by the registry lock
+
+// Adds to a value only the calling thread writes (no read-modify-write instruction needed)
+template <typename T>
+static inline void bump(atomic<T>& value, T amount) {
+    value.store(value.load(memory_order_relaxed) + amount, memory_order_relaxed);
+}
+
+// Adds the values of one block to another (caller holds the registry lock)
+static void mergeInto(ThreadMetrics& target, const ThreadMetrics& source) {
+    for (int i = 0; i < COUNTERS; i++) {
+        bump(target.counters[i], source.counters[i].load(memory_order_relaxed));
+    }
+    for (int i = 0; i < GAUGES; i++) {
+        bump(target.gauges[i], source.gauges[i].load(memory_order_relaxed));
+    }
+    for (int op = 0; op < OPERATIONS; op++) {
+        const LatencyHistogram& from = source.latencies[op];
+        LatencyHistogram& to = target.latencies[op];
+        for (int b = 0; b < LATENCY_BUCKETS; b++) {
+            bump(to.buckets[b], from.buckets[b].load(memory_order_relaxed));
+        }
+        bump(to.count, from.count.load(memory_order_relaxed));
+        bump(to.sumNs, from.sumNs.load(memory_order_relaxed));
+        uint64_t fromMax = from.maxNs.load(memory_order_relaxed);
+        if (fromMax > to.maxNs.load(memory_order_relaxed)) to.maxNs.store(fromMax, memory_order_relaxed);
+    }
+}
+
+// Registers a thread's block on first use and folds it into the retired block on exit
+class ThreadSlot {
+public:
+    ThreadMetrics metrics;   // The thread's block
+
+    ThreadSlot() {
+        lock_guard<mutex> guard(registryLock());
+        metrics.threadId = nextThreadId++;
+        liveThreads().push_back(&metrics);
+    }
+
+    ~ThreadSlot() {
+        lock_guard<mutex> guard(registryLock());
+        mergeInto(retiredMetrics(), metrics);
+        if (metrics.traceGeneration == traceGeneration.load(memory_order_relaxed)) {
+            size_t events = metrics.traceCount.load(memory_order_acquire);
+            for (size_t i = 0; i < events; i++) {
+                retiredTrace().push_back({ metrics.threadId, metrics.trace[i] });
+            }
+        }
+        vector<ThreadMetrics*>& threads = liveThreads();
+        for (size_t i = 0; i < threads.size(); i++) {
+            if (threads[i] == &metrics) {
+                threads[i] = threads.back();
+                threads.pop_back();
+                break;
+            }
+        }
+    }
+};
+
+// Returns the calling thread's block
+static inline ThreadMetrics& localMetrics() {
+    static thread_local ThreadSlot slot;
+    return slot.metrics;
+}
+
+// Returns the bucket of a latency
+static inline int bucketOf(uint64_t ns) {
+    if (ns < EXACT_BUCKETS) return static_cast<int>(ns);
+    // Position of the highest set bit, by halving (six steps)
+    int bit = 0;
+    for (int step = 32; step > 0; step /= 2) {
+        if (ns >> (bit + step)) bit += step;
+    }
+    int sub = static_cast<int>((ns >> (bit - 2)) & 3);
+    return EXACT_BUCKETS + (bit - 3) * 4 + sub;
+}
+
+// Returns the largest latency that falls into a bucket
+static uint64_t bucketUpperBound(int bucket) {
+    if (bucket < EXACT_BUCKETS) return static_cast<uint64_t>(bucket);
+    int bit = (bucket - EXACT_BUCKETS) / 4 + 3;
+    uint64_t sub = static_cast<uint64_t>((bucket - EXACT_BUCKETS) % 4);
+    uint64_t lower = (4 + sub) << (bit - 2);
+    return lower + (uint64_t(1) << (bit - 2)) - 1;
+}
+
+// Appends a span to the thread's trace buffer
+static void appendTrace(ThreadMetrics& metrics, MetricOperation operation, uint64_t startNs, uint64_t durationNs) {
+    uint64_t generation = traceGeneration.load(memory_order_acquire);
+    if (metrics.traceGeneration != generation) {
+        // First span of a new trace: (re)size the buffer where writeTrace cannot be reading it
+        lock_guard<mutex> guard(registryLock());
+        size_t capacity = traceEventsPerThread.load(memory_order_relaxed);
+        if (metrics.traceCapacity != capacity) {
+            metrics.trace.reset(new TraceEvent[capacity]);
+            metrics.traceCapacity = capacity;
+        }
+        metrics.traceCount.store(0, memory_order_relaxed);
+        metrics.traceGeneration = generation;
+    }
+    size_t used = metrics.traceCount.load(memory_order_relaxed);
+    if (used < metrics.traceCapacity) {
+        metrics.trace[used] = { startNs, durationNs, operation };
+        metrics.traceCount.store(used + 1, memory_order_release);
+    }
+}
+
+// Metrics of all threads added up
+struct MetricsTotals {
+    uint64_t counters[COUNTERS] = {};                           // Counter totals
+    int64_t gauges[GAUGES] = {};                                // Gauge levels
+    vector<uint64_t> buckets[OPERATIONS];                       // Histogram per operation
+    uint64_t count[OPERATIONS] = {};                            // Operations timed
+    uint64_t sumNs[OPERATIONS] = {};                            // Total time
+    uint64_t maxNs[OPERATIONS] = {};                            // Slowest operation
+};
+
+// Adds up the retired block and the blocks of running threads
+static void collectTotals(MetricsTotals& totals) {
+    lock_guard<mutex> guard(registryLock());
+    for (int op = 0; op < OPERATIONS; op++) {
+        totals.buckets[op].assign(LATENCY_BUCKETS, 0);
+    }
+    auto addBlock = [&totals](const ThreadMetrics& block) {
+        for (int i = 0; i < COUNTERS; i++) totals.counters[i] += block.counters[i].load(memory_order_relaxed);
+        for (int i = 0; i < GAUGES; i++) totals.gauges[i] += block.gauges[i].load(memory_order_relaxed);
+        for (int op = 0; op < OPERATIONS; op++) {
+            const LatencyHistogram& histogram = block.latencies[op];
+            for (int b = 0; b < LATENCY_BUCKETS; b++) {
+                totals.buckets[op][b] += histogram.buckets[b].load(memory_order_relaxed);
+            }
+            totals.count[op] += histogram.count.load(memory_order_relaxed);
+            totals.sumNs[op] += histogram.sumNs.load(memory_order_relaxed);
+            uint64_t slowest = histogram.maxNs.load(memory_order_relaxed);
+            if (slowest > totals.maxNs[op]) totals.maxNs[op] = slowest;
+        }
+    };
+    addBlock(retiredMetrics());
+    for (const ThreadMetrics* block : liveThreads()) {
+        addBlock(*block);
+    }
+}
+
+// Returns the latency below which 'fraction' of the operations fall (bucket upper bound)
+static uint64_t percentile(const MetricsTotals& totals, int op, double fraction) {
+    uint64_t count = 0;
+    for (uint64_t n : totals.buckets[op]) count += n;
+    if (count == 0) return 0;
+    uint64_t rank = static_cast<uint64_t>(fraction * static_cast<double>(count - 1)) + 1;
+    uint64_t seen = 0;
+    for (int b = 0; b < LATENCY_BUCKETS; b++) {
+        seen += totals.buckets[op][b];
+        if (seen >= rank) {
+            uint64_t bound = bucketUpperBound(b);
+            return bound < totals.maxNs[op] ? bound : totals.maxNs[op];
+        }
+    }
+    return totals.maxNs[op];
+}
+
+// Builds the summary of one operation from the totals
+static OperationSummary summaryOf(const MetricsTotals& totals, int op) {
+    OperationSummary summary;
+    summary.count = totals.count[op];
+    summary.meanNs = summary.count ? static_cast<double>(totals.sumNs[op]) / summary.count : 0;
+    summary.p50Ns = percentile(totals, op, 0.50);
+    summary.p99Ns = percentile(totals, op, 0.99);
+    summary.maxNs = totals.maxNs[op];
+    return summary;
+}
+
+// Returns the metric name of a counter
+const char* metricName(MetricCounter counter) {
+    switch (counter) {
+    case MetricCounter::HashLookups: return "hash_lookups";
+    case MetricCounter::HashProbes: return "hash_probes";
+    case MetricCounter::TreeSearches: return "tree_searches";
+    case MetricCounter::TreeNodesVisited: return "tree_nodes_visited";
+    case MetricCounter::LogBytes: return "log_bytes";
+    case MetricCounter::JournalBytes: return "journal_bytes";
+    case MetricCounter::ArchiveSessions: return "archive_sessions";
+    case MetricCounter::AlertsRaised: return "alerts_raised";
+    default: return "unknown";
+    }
+}
+
+// Returns the metric name of a gauge
+const char* metricName(MetricGauge gauge) {
+    switch (gauge) {
+    case MetricGauge::ParkedVehicles: return "parked_vehicles";
+    case MetricGauge::WaitingVehicles: return "waiting_vehicles";
+    case MetricGauge::PendingAlerts: return "pending_alerts";
+    case MetricGauge::LogQueueDepth: return "log_queue_depth";
+    default: return "unknown";
+    }
+}
+
+// Returns the metric name of an operation
+const char* metricName(MetricOperation operation) {
+    switch (operation) {
+    case MetricOperation::Park: return "park";
+    case MetricOperation::Retrieve: return "retrieve";
+    case MetricOperation::Search: return "search";
+    case MetricOperation::Filter: return "filter";
+    case MetricOperation::FuzzySearch: return "fuzzy_search";
+    case MetricOperation::CancelWaiting: return "cancel_waiting";
+    case MetricOperation::ProcessAlerts: return "process_alerts";
+    case MetricOperation::Checkpoint: return "checkpoint";
+    case MetricOperation::LogWrite: return "log_write";
+    case MetricOperation::JournalWrite: return "journal_write";
+    case MetricOperation::ArchiveSeal: return "archive_seal";
+    case MetricOperation::ServerRequest: return "server_request";
+    default: return "unknown";
+    }
+}
+
+// Adds to a counter of the calling thread
+void Metrics::count(MetricCounter counter, uint64_t amount) {
+    bump(localMetrics().counters[static_cast<int>(counter)], amount);
+}
+
+// Adds to a gauge of the calling thread
+void Metrics::add(MetricGauge gauge, int64_t delta) {
+    bump(localMetrics().gauges[static_cast<int>(gauge)], delta);
+}
+
+// Records one timed operation
+void Metrics::record(MetricOperation operation, uint64_t startNs, uint64_t durationNs) {
+    ThreadMetrics& metrics = localMetrics();
+    LatencyHistogram& histogram = metrics.latencies[static_cast<int>(operation)];
+    bump(histogram.buckets[bucketOf(durationNs)], uint64_t(1));
+    bump(histogram.count, uint64_t(1));
+    bump(histogram.sumNs, durationNs);
+    if (durationNs > histogram.maxNs.load(memory_order_relaxed)) {
+        histogram.maxNs.store(durationNs, memory_order_relaxed);
+    }
+    if (tracing.load(memory_order_relaxed)) {
+        appendTrace(metrics, operation, startNs, durationNs);
+    }
+}
+
+// Nanoseconds since the process started
+uint64_t Metrics::nowNs() {
+    return static_cast<uint64_t>(chrono::duration_cast<chrono::nanoseconds>(
+        chrono::steady_clock::now() - processStart).count());
+}
+
+// Total of a counter over all threads
+uint64_t Metrics::counterValue(MetricCounter counter) {
+    MetricsTotals totals;
+    collectTotals(totals);
+    return totals.counters[static_cast<int>(counter)];
+}
+
+// Level of a gauge (sum of all changes)
+int64_t Metrics::gaugeValue(MetricGauge gauge) {
+    MetricsTotals totals;
+    collectTotals(totals);
+    return totals.gauges[static_cast<int>(gauge)];
+}
+
+// Latency summary of one operation over all threads
+OperationSummary Metrics::summarize(MetricOperation operation) {
+    MetricsTotals totals;
+    collectTotals(totals);
+    return summaryOf(totals, static_cast<int>(operation));
+}
+
+// Metrics in the Prometheus text exposition format
+string Metrics::prometheusText() {
+    MetricsTotals totals;
+    collectTotals(totals);
+    string out;
+    char line[256];
+
+    for (int i = 0; i < COUNTERS; i++) {
+        const char* name = metricName(static_cast<MetricCounter>(i));
+        snprintf(line, sizeof(line), "# TYPE parking_%s_total counter\nparking_%s_total %llu\n",
+            name, name, static_cast<unsigned long long>(totals.counters[i]));
+        out += line;
+    }
+    for (int i = 0; i < GAUGES; i++) {
+        const char* name = metricName(static_cast<MetricGauge>(i));
+        snprintf(line, sizeof(line), "# TYPE parking_%s gauge\nparking_%s %lld\n",
+            name, name, static_cast<long long>(totals.gauges[i]));
+        out += line;
+    }
+
+    out += "# TYPE parking_operation_duration_seconds histogram\n";
+    for (int op = 0; op < OPERATIONS; op++) {
+        const char* name = metricName(static_cast<MetricOperation>(op));
+        // Buckets are cumulative; every internal bucket lies below one power-of-two bound
+        uint64_t cumulative = 0;
+        int bucket = 0;
+        for (int bit = FIRST_BOUND_BIT; bit <= LAST_BOUND_BIT; bit++) {
+            uint64_t bound = uint64_t(1) << bit;
+            while (bucket < LATENCY_BUCKETS && bucketUpperBound(bucket) < bound) {
+                cumulative += totals.buckets[op][bucket++];
+            }
+            snprintf(line, sizeof(line), "parking_operation_duration_seconds_bucket{operation=\"%s\",le=\"%.9g\"} %llu\n",
+                name, bound * 1e-9, static_cast<unsigned long long>(cumulative));
+            out += line;
+        }
+        snprintf(line, sizeof(line),
+            "parking_operation_duration_seconds_bucket{operation=\"%s\",le=\"+Inf\"} %llu\n"
+            "parking_operation_duration_seconds_sum{operation=\"%s\"} %.9f\n"
+            "parking_operation_duration_seconds_count{operation=\"%s\"} %llu\n",
+            name, static_cast<unsigned long long>(totals.count[op]),
+            name, totals.sumNs[op] * 1e-9,
+            name, static_cast<unsigned long long>(totals.count[op]));
+        out += line;
+    }
+    return out;
+}
+
+// Metrics as one JSON object
+string Metrics::jsonText() {
+    MetricsTotals totals;
+    collectTotals(totals);
+    string out;
+    char field[256];
+
+    snprintf(field, sizeof(field), "{\"timestamp\":%lld,\"uptime_seconds\":%.3f,\"counters\":{",
+        static_cast<long long>(time(nullptr)), nowNs() * 1e-9);
+    out += field;
+    for (int i = 0; i < COUNTERS; i++) {
+        snprintf(field, sizeof(field), "%s\"%s\":%llu", i ? "," : "",
+            metricName(static_cast<MetricCounter>(i)), static_cast<unsigned long long>(totals.counters[i]));
+        out += field;
+    }
+    out += "},\"gauges\":{";
+    for (int i = 0; i < GAUGES; i++) {
+        snprintf(field, sizeof(field), "%s\"%s\":%lld", i ? "," : "",
+            metricName(static_cast<MetricGauge>(i)), static_cast<long long>(totals.gauges[i]));
+        out += field;
+    }
+    out += "},\"operations\":{";
+    for (int op = 0; op < OPERATIONS; op++) {
+        OperationSummary summary = summaryOf(totals, op);
+        snprintf(field, sizeof(field),
+            "%s\"%s\":{\"count\":%llu,\"mean_ns\":%.1f,\"p50_ns\":%llu,\"p99_ns\":%llu,\"max_ns\":%llu}",
+            op ? "," : "", metricName(static_cast<MetricOperation>(op)),
+            static_cast<unsigned long long>(summary.count), summary.meanNs,
+            static_cast<unsigned long long>(summary.p50Ns), static_cast<unsigned long long>(summary.p99Ns),
+            static_cast<unsigned long long>(summary.maxNs));
+        out += field;
+    }
+    out += "}}\n";
+    return out;
+}
+
+// Writes text to a temporary file and moves it over 'path', so readers never see half a file
+static bool replaceFile(const string& path, const string& text) {
+    string tempPath = path + ".tmp";
+    {
+        ofstream file(tempPath, ios::binary | ios::trunc);
+        if (!file.is_open()) return false;
+        file.write(text.data(), text.size());
+        file.flush();
+        if (!file) return false;
+    }
+    // rename does not overwrite on Windows
+    remove(path.c_str());
+    return rename(tempPath.c_str(), path.c_str()) == 0;
+}
+
+// Writes prefix.prom and prefix.json
+bool Metrics::writeFiles(const string& prefix) {
+    bool promWritten = replaceFile(prefix + ".prom", prometheusText());
+    bool jsonWritten = replaceFile(prefix + ".json", jsonText());
+    return promWritten && jsonWritten;
+}
+
+// Starts recording trace spans
+void Metrics::startTrace(size_t eventsPerThread) {
+    lock_guard<mutex> guard(registryLock());
+    retiredTrace().clear();
+    traceEventsPerThread.store(eventsPerThread, memory_order_relaxed);
+    traceGeneration.fetch_add(1, memory_order_release);
+    tracing.store(true, memory_order_release);
+}
+
+// Stops recording trace spans
+void Metrics::stopTrace() {
+    tracing.store(false, memory_order_release);
+}
+
+// Writes the recorded spans as Chrome trace events
+bool Metrics::writeTrace(const string& path) {
+    vector<RetiredTraceEvent> events;
+    {
+        lock_guard<mutex> guard(registryLock());
+        events = retiredTrace();
+        uint64_t generation = traceGeneration.load(memory_order_relaxed);
+        for (const ThreadMetrics* block : liveThreads()) {
+            if (block->traceGeneration != generation) continue;
+            size_t used = block->traceCount.load(memory_order_acquire);
+            for (size_t i = 0; i < used; i++) {
+                events.push_back({ block->threadId, block->trace[i] });
+            }
+        }
+    }
+
+    ofstream file(path, ios::binary | ios::trunc);
+    if (!file.is_open()) return false;
+    string out = "{\"traceEvents\":[\n";
+    char event[256];
+    for (size_t i = 0; i < events.size(); i++) {
+        // Chrome trace times are microseconds
+        snprintf(event, sizeof(event),
+            "%s{\"name\":\"%s\",\"cat\":\"parking\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%u}",
+            i ? ",\n" : "", metricName(events[i].event.operation),
+            events[i].event.startNs / 1000.0, events[i].event.durationNs / 1000.0, events[i].threadId);
+        out += event;
+        if (out.size() >= (1 << 20)) {
+            file.write(out.data(), out.size());
+            out.clear();
+        }
+    }
+    out += "\n],\"displayTimeUnit\":\"ns\"}\n";
+    file.write(out.data(), out.size());
+    file.flush();
+    return static_cast<bool>(file);
+}
+
+// Starts the background writer
+MetricsWriter::MetricsWriter(const string& filePrefix, int intervalMs)
+    : prefix(filePrefix), interval(intervalMs > 0 ? intervalMs : 1000), stopping(false) {
+    worker = thread([this]() {
+        unique_lock<mutex> guard(lock);
+        while (!stopping) {
+            wakeUp.wait_for(guard, interval, [this]() { return stopping; });
+            guard.unlock();
+            Metrics::writeFiles(prefix);
+            guard.lock();
+        }
+    });
+}
+
+// Stops the writer after one last write
+MetricsWriter::~MetricsWriter() {
+    {
+        lock_guard<mutex> guard(lock);
+        stopping = true;
+    }
+    wakeUp.notify_all();
+    if (worker.joinable()) worker.join();
+}
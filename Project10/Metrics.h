@@ -0,0 +1,155 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+using namespace std;
+
+// Compile-time switch for the built-in instrumentation
+// Build with PARKING_METRICS=0 to compile every METRIC_* macro to nothing.
+#ifndef PARKING_METRICS
+#define PARKING_METRICS 1
+#endif
+
+// Event counters (only ever grow)
+enum class MetricCounter {
+    HashLookups,        // Plate hash map finds, inserts and erases
+    HashProbes,         // Table positions those looked at
+    TreeSearches,       // Plate index finds, inserts and erases
+    TreeNodesVisited,   // Tree nodes those walked through
+    LogBytes,           // Bytes written to the event log
+    JournalBytes,       // Bytes written to the journal
+    ArchiveSessions,    // Sessions appended to the session archive
+    AlertsRaised,       // Parking alerts raised
+    Count
+};
+
+// Levels that go up and down; every lot adds its own changes, so shards add up
+enum class MetricGauge {
+    ParkedVehicles,     // Vehicles parked in all lots
+    WaitingVehicles,    // Vehicles in all waiting lists
+    PendingAlerts,      // Alerts waiting to come due
+    LogQueueDepth,      // Events accepted by the logger but not yet written
+    Count
+};
+
+// Timed operations (latency histogram plus optional trace spans)
+enum class MetricOperation {
+    Park,               // parkVehicle
+    Retrieve,           // retrieveVehicle
+    Search,             // Lookups of one plate
+    Filter,             // Attribute filters
+    FuzzySearch,        // Lookups of plates similar to a misread plate
+    CancelWaiting,      // cancelWaiting
+    ProcessAlerts,      // processAlerts
+    Checkpoint,         // Snapshot writes
+    LogWrite,           // Event log batch writes
+    JournalWrite,       // Journal writes
+    ArchiveSeal,        // Session archive block seals
+    ServerRequest,      // Requests answered by the network server
+    Count
+};
+
+// Returns the metric name of a counter, gauge or operation ("hash_probes", "park", ...)
+const char* metricName(MetricCounter counter);
+const char* metricName(MetricGauge gauge);
+const char* metricName(MetricOperation operation);
+
+// Latency summary of one operation
+struct OperationSummary {
+    uint64_t count = 0;      // Operations timed
+    double meanNs = 0;       // Mean latency
+    uint64_t p50Ns = 0;      // Median latency (upper bound of its bucket)
+    uint64_t p99Ns = 0;      // 99th percentile latency
+    uint64_t maxNs = 0;      // Slowest operation
+};
+
+// Process-wide instrumentation
+// Every thread updates its own block of counters and histograms with plain relaxed
+// stores (no shared cache lines, no locks); readers add the blocks up. Blocks of
+// finished threads are folded into one retired block.
+class Metrics {
+public:
+    // Adds to a counter / gauge of the calling thread
+    static void count(MetricCounter counter, uint64_t amount = 1);
+    static void add(MetricGauge gauge, int64_t delta);
+
+    // Records one timed operation that started at 'startNs' (see nowNs)
+    static void record(MetricOperation operation, uint64_t startNs, uint64_t durationNs);
+
+    // Nanoseconds since the process started (steady clock)
+    static uint64_t nowNs();
+
+    // Totals over all threads
+    static uint64_t counterValue(MetricCounter counter);
+    static int64_t gaugeValue(MetricGauge gauge);
+    static OperationSummary summarize(MetricOperation operation);
+
+    // Metrics as Prometheus text exposition format / as one JSON object
+    static string prometheusText();
+    static string jsonText();
+
+    // Writes both formats to prefix + ".prom" and prefix + ".json" (each via a temporary file)
+    static bool writeFiles(const string& prefix);
+
+    // Starts recording trace spans, keeping up to 'eventsPerThread' per thread
+    static void startTrace(size_t eventsPerThread = 1 << 18);
+
+    // Stops recording trace spans
+    static void stopTrace();
+
+    // Writes the recorded spans in the Chrome trace event format (chrome://tracing, Perfetto)
+    static bool writeTrace(const string& path);
+};
+
+// Times an operation from construction to destruction
+class ScopedMetric {
+private:
+    MetricOperation operation;   // Operation being timed
+    uint64_t startNs;            // When it started
+
+public:
+    explicit ScopedMetric(MetricOperation timed) : operation(timed), startNs(Metrics::nowNs()) {
+    }
+    ~ScopedMetric() {
+        Metrics::record(operation, startNs, Metrics::nowNs() - startNs);
+    }
+    ScopedMetric(const ScopedMetric&) = delete;
+    ScopedMetric& operator=(const ScopedMetric&) = delete;
+};
+
+// Writes the metrics files periodically on a background thread
+class MetricsWriter {
+private:
+    string prefix;                // Files are prefix.prom and prefix.json
+    chrono::milliseconds interval; // Time between writes
+    bool stopping;                // Set when the writer should finish
+    mutex lock;                   // Guards 'stopping'
+    condition_variable wakeUp;    // Wakes the thread early on stop
+    thread worker;                // Background thread
+
+public:
+    // Starts writing every 'intervalMs' milliseconds
+    MetricsWriter(const string& prefix, int intervalMs);
+
+    // Writes one last time and stops the thread
+    ~MetricsWriter();
+};
+
+// Instrumentation macros; they compile to nothing when PARKING_METRICS is 0
+#define METRIC_CONCAT_INNER(a, b) a##b
+#define METRIC_CONCAT(a, b) METRIC_CONCAT_INNER(a, b)
+#if PARKING_METRICS
+#define METRIC_COUNT(counter, amount) Metrics::count(counter, amount)
+#define METRIC_ADD(gauge, delta) Metrics::add(gauge, delta)
+#define METRIC_SCOPE(operation) ScopedMetric METRIC_CONCAT(scopedMetric, __LINE__)(operation)
+#else
+#define METRIC_COUNT(counter, amount) ((void)0)
+#define METRIC_ADD(gauge, delta) ((void)0)
+#define METRIC_SCOPE(operation) ((void)0)
+#endif
@@ -0,0 +1,205 @@
+#include "NetworkSocket.h"
+#include <cstring>
+
+#ifdef _WIN32
+#pragma comment(lib, "Ws2_32.lib")
+#else
+#include <arpa/inet.h>
+#include <cerrno>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0 // Windows has no SIGPIPE
+#endif
+
+// Switches a socket to non-blocking mode
+static bool setNonBlocking(SocketHandle socket) {
+#ifdef _WIN32
+    u_long enabled = 1;
+    return ioctlsocket(socket, FIONBIO, &enabled) == 0;
+#else
+    int flags = fcntl(socket, F_GETFL, 0);
+    return flags != -1 && fcntl(socket, F_SETFL, flags | O_NONBLOCK) == 0;
+#endif
+}
+
+// Turns off Nagle's algorithm so small responses leave at once
+static void setNoDelay(SocketHandle socket) {
+    int enabled = 1;
+    setsockopt(socket, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&enabled), sizeof(enabled));
+}
+
+// Resolves a TCP address
+static bool resolveTcp(const SocketAddress& address, sockaddr_in& result, string& error) {
+    memset(&result, 0, sizeof(result));
+    result.sin_family = AF_INET;
+    result.sin_port = htons(static_cast<unsigned short>(address.port));
+    if (inet_pton(AF_INET, address.host.c_str(), &result.sin_addr) == 1) {
+        return true;
+    }
+    addrinfo hints{};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* found = nullptr;
+    if (getaddrinfo(address.host.c_str(), nullptr, &hints, &found) != 0 || !found) {
+        error = "Cannot resolve host " + address.host;
+        return false;
+    }
+    result.sin_addr = reinterpret_cast<sockaddr_in*>(found->ai_addr)->sin_addr;
+    freeaddrinfo(found);
+    return true;
+}
+
+// Starts the socket library
+bool initSockets() {
+#ifdef _WIN32
+    WSADATA data;
+    return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+#else
+    return true;
+#endif
+}
+
+// Opens a non-blocking listening socket
+SocketHandle listenOn(const SocketAddress& address, string& error) {
+    SocketHandle listener;
+    if (!address.unixPath.empty()) {
+#ifdef _WIN32
+        error = "Unix sockets are not supported on this platform";
+        return INVALID_SOCKET_HANDLE;
+#else
+        sockaddr_un local{};
+        local.sun_family = AF_UNIX;
+        if (address.unixPath.size() >= sizeof(local.sun_path)) {
+            error = "Unix socket path is too long";
+            return INVALID_SOCKET_HANDLE;
+        }
+        strcpy(local.sun_path, address.unixPath.c_str());
+        unlink(address.unixPath.c_str()); // A stale socket file from an earlier run blocks bind
+        listener = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (listener == INVALID_SOCKET_HANDLE || bind(listener, reinterpret_cast<sockaddr*>(&local), sizeof(local)) != 0) {
+            error = "Cannot bind " + address.unixPath;
+            if (listener != INVALID_SOCKET_HANDLE) closeSocket(listener);
+            return INVALID_SOCKET_HANDLE;
+        }
+#endif
+    }
+    else {
+        sockaddr_in remote;
+        if (!resolveTcp(address, remote, error)) {
+            return INVALID_SOCKET_HANDLE;
+        }
+        listener = socket(AF_INET, SOCK_STREAM, 0);
+        int reuse = 1;
+        if (listener != INVALID_SOCKET_HANDLE) {
+            setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&reuse), sizeof(reuse));
+        }
+        if (listener == INVALID_SOCKET_HANDLE || bind(listener, reinterpret_cast<sockaddr*>(&remote), sizeof(remote)) != 0) {
+            error = "Cannot bind " + describeAddress(address);
+            if (listener != INVALID_SOCKET_HANDLE) closeSocket(listener);
+            return INVALID_SOCKET_HANDLE;
+        }
+    }
+    if (listen(listener, SOMAXCONN) != 0 || !setNonBlocking(listener)) {
+        error = "Cannot listen on " + describeAddress(address);
+        closeSocket(listener);
+        return INVALID_SOCKET_HANDLE;
+    }
+    return listener;
+}
+
+// Accepts a pending connection as a non-blocking socket
+SocketHandle acceptConnection(SocketHandle listener) {
+    SocketHandle connection = accept(listener, nullptr, nullptr);
+    if (connection == INVALID_SOCKET_HANDLE) {
+        return INVALID_SOCKET_HANDLE;
+    }
+    if (!setNonBlocking(connection)) {
+        closeSocket(connection);
+        return INVALID_SOCKET_HANDLE;
+    }
+    setNoDelay(connection); // Fails harmlessly on Unix sockets
+    return connection;
+}
+
+// Opens a blocking connection
+SocketHandle connectTo(const SocketAddress& address, string& error) {
+    SocketHandle connection;
+    if (!address.unixPath.empty()) {
+#ifdef _WIN32
+        error = "Unix sockets are not supported on this platform";
+        return INVALID_SOCKET_HANDLE;
+#else
+        sockaddr_un local{};
+        local.sun_family = AF_UNIX;
+        if (address.unixPath.size() >= sizeof(local.sun_path)) {
+            error = "Unix socket path is too long";
+            return INVALID_SOCKET_HANDLE;
+        }
+        strcpy(local.sun_path, address.unixPath.c_str());
+        connection = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (connection == INVALID_SOCKET_HANDLE || connect(connection, reinterpret_cast<sockaddr*>(&local), sizeof(local)) != 0) {
+            error = "Cannot connect to " + describeAddress(address);
+            if (connection != INVALID_SOCKET_HANDLE) closeSocket(connection);
+            return INVALID_SOCKET_HANDLE;
+        }
+#endif
+    }
+    else {
+        sockaddr_in remote;
+        if (!resolveTcp(address, remote, error)) {
+            return INVALID_SOCKET_HANDLE;
+        }
+        connection = socket(AF_INET, SOCK_STREAM, 0);
+        if (connection == INVALID_SOCKET_HANDLE || connect(connection, reinterpret_cast<sockaddr*>(&remote), sizeof(remote)) != 0) {
+            error = "Cannot connect to " + describeAddress(address);
+            if (connection != INVALID_SOCKET_HANDLE) closeSocket(connection);
+            return INVALID_SOCKET_HANDLE;
+        }
+        setNoDelay(connection);
+    }
+    return connection;
+}
+
+// Closes a socket
+void closeSocket(SocketHandle socket) {
+#ifdef _WIN32
+    closesocket(socket);
+#else
+    close(socket);
+#endif
+}
+
+// Sends up to 'length' bytes
+long sendBytes(SocketHandle socket, const char* data, size_t length) {
+    return static_cast<long>(send(socket, data, static_cast<int>(length), MSG_NOSIGNAL));
+}
+
+// Receives up to 'length' bytes
+long receiveBytes(SocketHandle socket, char* data, size_t length) {
+    return static_cast<long>(recv(socket, data, static_cast<int>(length), 0));
+}
+
+// Returns true if the last failed call would have blocked
+bool lastCallWouldBlock() {
+#ifdef _WIN32
+    return WSAGetLastError() == WSAEWOULDBLOCK;
+#else
+    return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+#endif
+}
+
+// Returns a description of an address
+string describeAddress(const SocketAddress& address) {
+    if (!address.unixPath.empty()) {
+        return "unix:" + address.unixPath;
+    }
+    return address.host + ":" + to_string(address.port);
+}
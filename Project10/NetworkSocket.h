@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX // Keeps windows.h from defining min and max macros
+#endif
+#include <winsock2.h>
+#include <ws2tcpip.h>
+typedef SOCKET SocketHandle;
+const SocketHandle INVALID_SOCKET_HANDLE = INVALID_SOCKET;
+#else
+typedef int SocketHandle;
+const SocketHandle INVALID_SOCKET_HANDLE = -1;
+#endif
+
+using namespace std;
+
+// Where a server listens or a client connects
+struct SocketAddress {
+    string host = "127.0.0.1";   // TCP host (ignored for Unix sockets)
+    int port = 7070;             // TCP port
+    string unixPath;             // Unix socket path (used instead of TCP when not empty)
+};
+
+// Starts the socket library (needed once on Windows); returns false on failure
+bool initSockets();
+
+// Opens a non-blocking listening socket; returns INVALID_SOCKET_HANDLE and sets 'error' on failure
+SocketHandle listenOn(const SocketAddress& address, string& error);
+
+// Accepts a pending connection as a non-blocking socket; returns INVALID_SOCKET_HANDLE if none is waiting
+SocketHandle acceptConnection(SocketHandle listener);
+
+// Opens a blocking connection with Nagle's algorithm off; returns INVALID_SOCKET_HANDLE and sets 'error' on failure
+SocketHandle connectTo(const SocketAddress& address, string& error);
+
+// Closes a socket
+void closeSocket(SocketHandle socket);
+
+// Sends / receives up to 'length' bytes without raising SIGPIPE
+// Return the byte count, 0 when the peer closed (receive only), or -1 on error.
+long sendBytes(SocketHandle socket, const char* data, size_t length);
+long receiveBytes(SocketHandle socket, char* data, size_t length);
+
+// Returns true if the last failed call would have blocked
+bool lastCallWouldBlock();
+
+// Returns a description such as "127.0.0.1:7070" or "unix:/tmp/parking.sock"
+string describeAddress(const SocketAddress& address);
@@ -0,0 +1,35 @@
+#include "ParkingClock.h"
+
+// Returns the wall clock time
+time_t SystemClock::now() const {
+    return time(0);
+}
+
+// Creates a clock showing 'start'
+ManualClock::ManualClock(time_t start) : current(start) {
+}
+
+// Returns the time the clock was set to
+time_t ManualClock::now() const {
+    return current;
+}
+
+// Sets the time; it may only move forward
+void ManualClock::set(time_t when) {
+    if (when > current) {
+        current = when;
+    }
+}
+
+// Moves the time forward by 'seconds'
+void ManualClock::advance(time_t seconds) {
+    if (seconds > 0) {
+        current += seconds;
+    }
+}
+
+// Returns the shared wall clock
+shared_ptr<ParkingClock> systemClock() {
+    static shared_ptr<ParkingClock> clock = make_shared<SystemClock>();
+    return clock;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <ctime>
+#include <memory>
+
+using namespace std;
+
+// Source of the current time for the parking system
+// Every time stamp the system takes (entry and exit times, alerts, statistics, log
+// lines) comes from its clock, so a simulation can run weeks of traffic in seconds.
+class ParkingClock {
+public:
+    virtual ~ParkingClock() = default;
+
+    // Returns the current time in Unix seconds
+    virtual time_t now() const = 0;
+};
+
+// The wall clock
+class SystemClock : public ParkingClock {
+public:
+    time_t now() const override;
+};
+
+// A clock that only moves when it is told to (simulations and replays)
+class ManualClock : public ParkingClock {
+private:
+    time_t current;   // Time the clock shows
+
+public:
+    // Creates a clock showing 'start'
+    explicit ManualClock(time_t start = 0);
+
+    time_t now() const override;
+
+    // Sets the time; it may only move forward
+    void set(time_t when);
+
+    // Moves the time forward by 'seconds'
+    void advance(time_t seconds);
+};
+
+// Returns the shared wall clock
+shared_ptr<ParkingClock> systemClock();
@@ -0,0 +1,144 @@
+#include "ParkingExport.h"
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include "TimestampFormatter.h"
+
+// Bytes collected before a write
+static const size_t EXPORT_CHUNK_BYTES = 1 << 20;
+
+// Appends a CSV field, quoting it only when it holds a comma, quote or line break
+static void appendCsvField(string& out, const string& value) {
+    if (value.find_first_of(",\"\r\n") == string::npos) {
+        out += value;
+        return;
+    }
+    out += '"';
+    for (char c : value) {
+        if (c == '"') out += '"';
+        out += c;
+    }
+    out += '"';
+}
+
+// Appends a JSON string literal
+static void appendJsonString(string& out, const string& value) {
+    static const char hex[] = "0123456789abcdef";
+    out += '"';
+    for (char c : value) {
+        unsigned char u = static_cast<unsigned char>(c);
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        }
+        else if (u < 0x20) {
+            out += "\\u00";
+            out += hex[u >> 4];
+            out += hex[u & 15];
+        }
+        else {
+            out += c;
+        }
+    }
+    out += '"';
+}
+
+// Parses "csv" or "jsonl"
+bool parseExportFormat(const string& name, ExportFormat& format) {
+    if (name == "csv") {
+        format = ExportFormat::Csv;
+        return true;
+    }
+    if (name == "jsonl" || name == "json") {
+        format = ExportFormat::JsonLines;
+        return true;
+    }
+    return false;
+}
+
+// Streams every parked vehicle to 'out'
+bool exportParkedVehicles(const ParkingManagementSystem& system, ostream& out, ExportFormat format,
+    ExportStats& stats, bool lifoOrder) {
+    auto start = chrono::steady_clock::now();
+    TimestampFormatter timestamps('T');
+    string buffer;
+    string contact;   // Scratch for the contact, which may need escaping
+    buffer.reserve(EXPORT_CHUNK_BYTES + 4096);
+    stats = ExportStats();
+
+    if (format == ExportFormat::Csv) {
+        buffer += "slot,regNumber,ownerName,make,model,color,contact,entryTime,bayType\n";
+    }
+
+    ParkedVehicleCursor cursor = system.openCursor(lifoOrder);
+    while (cursor.next()) {
+        contact.clear();
+        cursor.appendOwnerContact(contact);
+        if (format == ExportFormat::Csv) {
+            buffer += to_string(cursor.slot());
+            buffer += ',';
+            appendCsvField(buffer, cursor.regNumber());
+            buffer += ',';
+            appendCsvField(buffer, cursor.ownerName());
+            buffer += ',';
+            appendCsvField(buffer, cursor.vehicleMake());
+            buffer += ',';
+            appendCsvField(buffer, cursor.vehicleModel());
+            buffer += ',';
+            appendCsvField(buffer, cursor.vehicleColor());
+            buffer += ',';
+            appendCsvField(buffer, contact);
+            buffer += ',';
+            timestamps.append(cursor.entryTime(), buffer);
+            buffer += ',';
+            buffer += bayTypeName(cursor.bayType());
+            buffer += '\n';
+        }
+        else {
+            buffer += "{\"slot\":";
+            buffer += to_string(cursor.slot());
+            buffer += ",\"regNumber\":";
+            appendJsonString(buffer, cursor.regNumber());
+            buffer += ",\"ownerName\":";
+            appendJsonString(buffer, cursor.ownerName());
+            buffer += ",\"make\":";
+            appendJsonString(buffer, cursor.vehicleMake());
+            buffer += ",\"model\":";
+            appendJsonString(buffer, cursor.vehicleModel());
+            buffer += ",\"color\":";
+            appendJsonString(buffer, cursor.vehicleColor());
+            buffer += ",\"contact\":";
+            appendJsonString(buffer, contact);
+            buffer += ",\"entryTime\":\"";
+            timestamps.append(cursor.entryTime(), buffer);
+            buffer += "\",\"bayType\":\"";
+            buffer += bayTypeName(cursor.bayType());
+            buffer += "\"}\n";
+        }
+        stats.vehicles++;
+
+        if (buffer.size() >= EXPORT_CHUNK_BYTES) {
+            out.write(buffer.data(), buffer.size());
+            stats.bytes += buffer.size();
+            buffer.clear();
+        }
+    }
+    out.write(buffer.data(), buffer.size());
+    out.flush();
+    stats.bytes += buffer.size();
+    stats.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    return static_cast<bool>(out);
+}
+
+// Streams every parked vehicle to a file ("-" writes to the console)
+bool exportParkedVehicles(const ParkingManagementSystem& system, const string& path, ExportFormat format,
+    ExportStats& stats, bool lifoOrder) {
+    if (path == "-") {
+        return exportParkedVehicles(system, cout, format, stats, lifoOrder);
+    }
+    ofstream file(path, ios::binary);
+    if (!file) {
+        return false;
+    }
+    return exportParkedVehicles(system, file, format, stats, lifoOrder);
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include "ParkingManagementSystem.h"
+
+using namespace std;
+
+// File formats of a parked vehicle export
+enum class ExportFormat {
+    Csv,        // Header line, then one comma-separated line per vehicle
+    JsonLines   // One JSON object per line
+};
+
+// Counters of an export
+struct ExportStats {
+    uint64_t vehicles = 0;   // Vehicles written
+    uint64_t bytes = 0;      // Bytes written
+    double seconds = 0;      // Wall time of the export
+};
+
+// Parses "csv" or "jsonl" (also "json"); returns false if the name is unknown
+bool parseExportFormat(const string& name, ExportFormat& format);
+
+// Streams every parked vehicle to 'out' (most recently parked first, or in slot order)
+// Vehicles are read in place through a cursor and collect in a large buffer that is written
+// in big chunks; entry times are local ISO 8601 text. Returns false if a write fails.
+bool exportParkedVehicles(const ParkingManagementSystem& system, ostream& out, ExportFormat format,
+    ExportStats& stats, bool lifoOrder = true);
+
+// Same as above, writing to a file ("-" writes to the console)
+bool exportParkedVehicles(const ParkingManagementSystem& system, const string& path, ExportFormat format,
+    ExportStats& stats, bool lifoOrder = true);
@@ -0,0 +1,290 @@
+#include "ParkingFederation.h"
+#include <limits>
+
+// Creates an empty federation
+ParkingFederation::ParkingFederation(const LoggerOptions& logging)
+    : treeDirty(false), totalCapacity(0), parkedVehicles(0), totalRevenue(0) {
+    if (!logging.path.empty()) {
+        logger = make_unique<EventLogger>(logging);
+        if (!logger->isOpen()) {
+            cout << "Error: Failed to open log file." << endl;
+        }
+    }
+}
+
+// Logs events to the shared log
+// Lines keep the single-lot format so the log analyzer reads federation logs unchanged.
+void ParkingFederation::logEvent(const string& event) {
+    if (logger) {
+        logger->log(event);
+    }
+}
+
+// Adds a lot and returns its id
+int ParkingFederation::addLot(const LotSite& site) {
+    // Lots keep no log or journal of their own
+    ParkingConfig config;
+    config.logging.path = "";
+    config.journalPath = "";
+    config.archivePath = "";
+
+    int lot = static_cast<int>(lots.size());
+    sites.push_back(site);
+    lots.push_back(make_unique<ParkingManagementSystem>(site.capacity, site.rate, config));
+    lotFree.push_back(site.capacity);
+    totalCapacity += site.capacity;
+    treeDirty = true;
+    return lot;
+}
+
+// Extends a node's bounding box to cover a child subtree
+static void growBox(LotTreeNode& node, const LotTreeNode& child) {
+    node.minX = min(node.minX, child.minX);
+    node.maxX = max(node.maxX, child.maxX);
+    node.minY = min(node.minY, child.minY);
+    node.maxY = max(node.maxY, child.maxY);
+}
+
+// Builds the kd-tree for lots[lo, hi)
+long long ParkingFederation::buildTree(vector<int>& order, int lo, int hi, int depth) {
+    if (lo >= hi) return 0;
+
+    // Split on alternating axes at the median lot
+    int axis = depth % 2;
+    int mid = (lo + hi) / 2;
+    nth_element(order.begin() + lo, order.begin() + mid, order.begin() + hi, [this, axis](int a, int b) {
+        return axis == 0 ? sites[a].x < sites[b].x : sites[a].y < sites[b].y;
+    });
+
+    LotTreeNode& node = tree[mid];
+    node.lot = order[mid];
+    node.axis = axis;
+    node.minX = node.maxX = sites[node.lot].x;
+    node.minY = node.maxY = sites[node.lot].y;
+    treePosition[node.lot] = mid;
+
+    long long freeSlots = lotFree[node.lot]
+        + buildTree(order, lo, mid, depth + 1)
+        + buildTree(order, mid + 1, hi, depth + 1);
+    tree[mid].freeSlots = freeSlots;
+
+    // Grow the bounding box to cover both children
+    if (lo < mid) growBox(tree[mid], tree[(lo + mid) / 2]);
+    if (mid + 1 < hi) growBox(tree[mid], tree[(mid + 1 + hi) / 2]);
+    return freeSlots;
+}
+
+// Rebuilds the kd-tree if lots were added
+void ParkingFederation::ensureTree() {
+    if (!treeDirty) return;
+    vector<int> order(lots.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        order[i] = static_cast<int>(i);
+    }
+    tree.assign(lots.size(), LotTreeNode());
+    treePosition.assign(lots.size(), -1);
+    buildTree(order, 0, static_cast<int>(order.size()), 0);
+    treeDirty = false;
+}
+
+// Adds 'delta' free slots to a lot and every tree node above it
+void ParkingFederation::updateFree(int lot, int delta) {
+    lotFree[lot] += delta;
+    if (treeDirty) return; // The next build recomputes every subtree
+
+    // Walk down from the root to the lot's node, adjusting each subtree on the way
+    int position = treePosition[lot];
+    int lo = 0;
+    int hi = static_cast<int>(tree.size());
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        tree[mid].freeSlots += delta;
+        if (position == mid) break;
+        if (position < mid) hi = mid;
+        else lo = mid + 1;
+    }
+}
+
+// Searches the subtree for lots[lo, hi) for a closer lot with space
+void ParkingFederation::searchNearest(int lo, int hi, double x, double y, int& best, double& bestDistance) const {
+    if (lo >= hi) return;
+    int mid = (lo + hi) / 2;
+    const LotTreeNode& node = tree[mid];
+
+    // Skip full subtrees and subtrees whose bounding box is farther than the best lot so far
+    if (node.freeSlots == 0) return;
+    double dx = x < node.minX ? node.minX - x : (x > node.maxX ? x - node.maxX : 0);
+    double dy = y < node.minY ? node.minY - y : (y > node.maxY ? y - node.maxY : 0);
+    if (dx * dx + dy * dy >= bestDistance) return;
+
+    if (lotFree[node.lot] > 0) {
+        double lx = sites[node.lot].x - x;
+        double ly = sites[node.lot].y - y;
+        double distance = lx * lx + ly * ly;
+        if (distance < bestDistance) {
+            bestDistance = distance;
+            best = node.lot;
+        }
+    }
+
+    // Visit the side of the split containing the point first
+    double split = node.axis == 0 ? sites[node.lot].x : sites[node.lot].y;
+    double coordinate = node.axis == 0 ? x : y;
+    if (coordinate < split) {
+        searchNearest(lo, mid, x, y, best, bestDistance);
+        searchNearest(mid + 1, hi, x, y, best, bestDistance);
+    }
+    else {
+        searchNearest(mid + 1, hi, x, y, best, bestDistance);
+        searchNearest(lo, mid, x, y, best, bestDistance);
+    }
+}
+
+// Returns the lot with free space closest to (x, y)
+int ParkingFederation::findNearestLotWithSpace(double x, double y) {
+    ensureTree();
+    int best = -1;
+    double bestDistance = numeric_limits<double>::infinity();
+    searchNearest(0, static_cast<int>(tree.size()), x, y, best, bestDistance);
+    return best;
+}
+
+// Parks a vehicle in a lot known to have space
+void ParkingFederation::parkInLot(const Vehicle& vehicle, int lot) {
+    lots[lot]->parkVehicle(vehicle);
+    plateDirectory.insert(vehicle.regNumber, lot);
+    updateFree(lot, -1);
+    parkedVehicles++;
+    logEvent("Parked vehicle: " + vehicle.regNumber + " " + vehicle.ownerName);
+}
+
+// Parks a vehicle arriving at 'preferredLot'
+bool ParkingFederation::parkVehicle(const Vehicle& vehicle, int preferredLot, int& assignedLot, ParkResult& result) {
+    assignedLot = -1;
+    if (preferredLot < 0 || preferredLot >= static_cast<int>(lots.size())) {
+        return false;
+    }
+    if (plateDirectory.find(vehicle.regNumber) != -1) {
+        result = ParkResult::AlreadyParked;
+        return true;
+    }
+    if (waitingPlates.find(vehicle.regNumber) != -1) {
+        result = ParkResult::AlreadyWaiting;
+        return true;
+    }
+
+    // Take the requested lot if it has space, otherwise the nearest one that does
+    int lot = preferredLot;
+    if (lotFree[lot] == 0) {
+        lot = findNearestLotWithSpace(sites[preferredLot].x, sites[preferredLot].y);
+    }
+    if (lot == -1) {
+        // Every lot is full: wait for the first slot freed anywhere
+        waitingQueue.emplace_back(vehicle, preferredLot);
+        waitingPlates.insert(vehicle.regNumber, preferredLot);
+        logEvent("Vehicle added to waiting queue: " + vehicle.regNumber);
+        result = ParkResult::Queued;
+        return true;
+    }
+
+    parkInLot(vehicle, lot);
+    assignedLot = lot;
+    result = ParkResult::Parked;
+    return true;
+}
+
+// Retrieves a vehicle from whichever lot holds it
+RetrieveResult ParkingFederation::retrieveVehicle(const string& regNumber, Cents& fee) {
+    int lot = plateDirectory.find(regNumber);
+    if (lot == -1) {
+        return RetrieveResult::NotFound;
+    }
+    plateDirectory.erase(regNumber);
+
+    lots[lot]->retrieveVehicle(regNumber, fee);
+    updateFree(lot, 1);
+    parkedVehicles--;
+    totalRevenue += fee;
+    logEvent("Retrieved vehicle: " + regNumber + ", Fee: $" + formatCents(fee));
+
+    // The first waiting vehicle takes the free slot closest to where it arrived
+    if (!waitingQueue.empty()) {
+        pair<Vehicle, int> next = move(waitingQueue.front());
+        waitingQueue.pop_front();
+        waitingPlates.erase(next.first.regNumber);
+        int target = findNearestLotWithSpace(sites[next.second].x, sites[next.second].y);
+        parkInLot(next.first, target);
+    }
+    return RetrieveResult::Retrieved;
+}
+
+// Copies a parked vehicle into 'vehicle' and its lot into 'lot'
+bool ParkingFederation::findVehicle(const string& regNumber, Vehicle& vehicle, int& lot) const {
+    lot = plateDirectory.find(regNumber);
+    if (lot == -1) {
+        return false;
+    }
+    return lots[lot]->findVehicle(regNumber, vehicle);
+}
+
+// Returns the number of lots
+int ParkingFederation::getLotCount() const {
+    return static_cast<int>(lots.size());
+}
+
+// Returns the location and settings of a lot
+const LotSite& ParkingFederation::getLotSite(int lot) const {
+    return sites[lot];
+}
+
+// Returns the number of free slots in a lot
+int ParkingFederation::getFreeSlots(int lot) const {
+    return lotFree[lot];
+}
+
+// Returns the parking system of a lot
+ParkingManagementSystem& ParkingFederation::getLot(int lot) {
+    return *lots[lot];
+}
+
+// Returns the number of slots over all lots
+long long ParkingFederation::getTotalCapacity() const {
+    return totalCapacity;
+}
+
+// Returns the number of vehicles parked over all lots
+long long ParkingFederation::getCurrentVehicleCount() const {
+    return parkedVehicles;
+}
+
+// Returns the number of vehicles waiting for any lot
+int ParkingFederation::getWaitingCount() const {
+    return static_cast<int>(waitingQueue.size());
+}
+
+// Returns the revenue collected by all lots
+Cents ParkingFederation::getTotalRevenue() const {
+    return totalRevenue;
+}
+
+// Displays totals and the busiest lots
+void ParkingFederation::displayStatus(int topLots) const {
+    cout << "Lots: " << lots.size() << "\n";
+    cout << "Vehicles Parked: " << parkedVehicles << "/" << totalCapacity << "\n";
+    cout << "Waiting Queue: " << waitingQueue.size() << "\n";
+    cout << "Total revenue collected: $" << formatCents(totalRevenue) << "\n";
+
+    // Busiest lots by occupancy
+    vector<int> order(lots.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        order[i] = static_cast<int>(i);
+    }
+    int shown = min(topLots, static_cast<int>(order.size()));
+    partial_sort(order.begin(), order.begin() + shown, order.end(), [this](int a, int b) {
+        return double(sites[a].capacity - lotFree[a]) * sites[b].capacity > double(sites[b].capacity - lotFree[b]) * sites[a].capacity;
+    });
+    for (int i = 0; i < shown; ++i) {
+        int lot = order[i];
+        cout << "   " << sites[lot].name << ": " << sites[lot].capacity - lotFree[lot] << "/" << sites[lot].capacity << "\n";
+    }
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+#include "ParkingManagementSystem.h"
+#include "PlateHashMap.h"
+
+using namespace std;
+
+// Location and size of one lot in the federation
+struct LotSite {
+    string name;        // Display name of the lot
+    double x;           // Map coordinates used for overflow routing
+    double y;
+    int capacity;       // Number of slots
+    double rate;        // Parking rate per hour
+};
+
+// A node of the lot kd-tree
+// Nodes are stored in build order: the node for lots [lo, hi) sits at (lo + hi) / 2.
+struct LotTreeNode {
+    int lot;            // Lot stored at this node
+    int axis;           // 0 = split on x, 1 = split on y
+    double minX, maxX;  // Bounding box of the lots in this subtree
+    double minY, maxY;
+    long long freeSlots; // Free slots in this subtree (0 lets routing skip it)
+};
+
+// Hosts many parking lots in one process
+// A plate directory finds a vehicle's lot in O(1), and a kd-tree over the lot
+// locations that tracks free slots per subtree routes overflow to the nearest
+// lot with space in O(log lots) on typical layouts.
+class ParkingFederation {
+private:
+    vector<LotSite> sites;                          // Lot locations and settings, indexed by lot id
+    vector<unique_ptr<ParkingManagementSystem>> lots; // One parking system per lot
+    vector<int> lotFree;                            // Free slots per lot
+    vector<LotTreeNode> tree;                       // kd-tree over the lots
+    vector<int> treePosition;                       // Position of each lot in the tree
+    bool treeDirty;                                 // True when lots were added since the last build
+    PlateHashMap plateDirectory;                    // Registration number -> lot id of parked vehicles
+    deque<pair<Vehicle, int>> waitingQueue;         // Vehicles waiting for any lot, with their preferred lot
+    PlateHashMap waitingPlates;                     // Registration number -> preferred lot of waiting vehicles
+    long long totalCapacity;                        // Slots over all lots
+    long long parkedVehicles;                       // Vehicles parked over all lots
+    Cents totalRevenue;                             // Revenue collected by all lots, in cents
+    unique_ptr<EventLogger> logger;                 // Shared event log for all lots
+
+    // Builds the kd-tree for lots[lo, hi) and returns the subtree's free slots
+    long long buildTree(vector<int>& order, int lo, int hi, int depth);
+
+    // Rebuilds the kd-tree if lots were added
+    void ensureTree();
+
+    // Adds 'delta' free slots to a lot and every tree node above it
+    void updateFree(int lot, int delta);
+
+    // Searches the subtree for lots[lo, hi) for a closer lot with space
+    void searchNearest(int lo, int hi, double x, double y, int& best, double& bestDistance) const;
+
+    // Parks a vehicle in a lot known to have space and records it in the directory
+    void parkInLot(const Vehicle& vehicle, int lot);
+
+    // Logs events to the shared log
+    void logEvent(const string& event);
+
+public:
+    // Creates an empty federation; all lots log to one shared file
+    explicit ParkingFederation(const LoggerOptions& logging = LoggerOptions());
+
+    // Adds a lot and returns its id
+    int addLot(const LotSite& site);
+
+    // Parks a vehicle arriving at 'preferredLot'; a full lot sends it to the nearest
+    // lot with space. 'result' receives the outcome and 'assignedLot' the lot used (-1 if queued,
+    // already parked or already waiting). Returns false, changing nothing, if 'preferredLot' is not a lot id.
+    bool parkVehicle(const Vehicle& vehicle, int preferredLot, int& assignedLot, ParkResult& result);
+
+    // Retrieves a vehicle from whichever lot holds it, storing the charged fee in 'fee'
+    RetrieveResult retrieveVehicle(const string& regNumber, Cents& fee);
+
+    // Copies a parked vehicle into 'vehicle' and its lot into 'lot'; returns false if not parked
+    bool findVehicle(const string& regNumber, Vehicle& vehicle, int& lot) const;
+
+    // Returns the lot with free space closest to (x, y), or -1 if every lot is full
+    int findNearestLotWithSpace(double x, double y);
+
+    // Returns the number of lots
+    int getLotCount() const;
+
+    // Returns the location and settings of a lot
+    const LotSite& getLotSite(int lot) const;
+
+    // Returns the number of free slots in a lot
+    int getFreeSlots(int lot) const;
+
+    // Returns the parking system of a lot
+    ParkingManagementSystem& getLot(int lot);
+
+    // Returns aggregates over all lots
+    long long getTotalCapacity() const;
+    long long getCurrentVehicleCount() const;
+    int getWaitingCount() const;
+    Cents getTotalRevenue() const;
+
+    // Displays totals and the busiest lots
+    void displayStatus(int topLots = 10) const;
+};
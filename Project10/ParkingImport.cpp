@@ -0,0 +1,259 @@
+#include "ParkingImport.h"
+#include <chrono>
+#include <fstream>
+
+// Columns of an import CSV, in Vehicle field order
+enum ImportColumn {
+    COLUMN_REG_NUMBER,
+    COLUMN_OWNER_NAME,
+    COLUMN_MAKE,
+    COLUMN_MODEL,
+    COLUMN_COLOR,
+    COLUMN_CONTACT,
+    COLUMN_ENTRY_TIME,
+    COLUMN_BAY_TYPE,
+    COLUMN_SLOT,
+    COLUMN_COUNT
+};
+
+// Header names of the columns (the names the export writes)
+static const char* const COLUMN_NAMES[COLUMN_COUNT] = { "regNumber", "ownerName", "make", "model", "color", "contact", "entryTime", "bayType", "slot" };
+
+// Converts entry time text to Unix seconds
+// Local time only changes its offset on an hour boundary, so mktime runs once per local
+// hour; the hours seen last are remembered in a small direct-mapped cache.
+class EntryTimeParser {
+private:
+    // Start of one local hour
+    struct HourEntry {
+        int64_t key = -1;    // YYYYMMDDHH of the hour (-1 if unused)
+        time_t start = 0;    // Its first second
+    };
+
+    static const size_t CACHE_SIZE = 256;   // Hours remembered
+    HourEntry hours[CACHE_SIZE];            // Recently converted hours
+
+    // Reads 'count' digits at 'pos'; returns false if one is not a digit
+    static bool digitsAt(const string& text, size_t pos, size_t count, int& value) {
+        value = 0;
+        for (size_t i = pos; i < pos + count; ++i) {
+            if (text[i] < '0' || text[i] > '9') return false;
+            value = value * 10 + (text[i] - '0');
+        }
+        return true;
+    }
+
+public:
+    // Parses "YYYY-MM-DDTHH:MM:SS" (or with a space for the T) local time, Unix seconds,
+    // or an empty text (0, which the import replaces by now); returns false if malformed
+    bool parse(const string& text, time_t& when) {
+        if (text.empty()) {
+            when = 0;
+            return true;
+        }
+        if (text.find_first_not_of("0123456789") == string::npos) {
+            if (text.size() > 18) return false;
+            when = static_cast<time_t>(stoll(text));
+            return true;
+        }
+
+        int year, month, day, hour, minute, second;
+        if (text.size() != 19 || text[4] != '-' || text[7] != '-' || (text[10] != 'T' && text[10] != ' ')
+            || text[13] != ':' || text[16] != ':'
+            || !digitsAt(text, 0, 4, year) || !digitsAt(text, 5, 2, month) || !digitsAt(text, 8, 2, day)
+            || !digitsAt(text, 11, 2, hour) || !digitsAt(text, 14, 2, minute) || !digitsAt(text, 17, 2, second)
+            || month < 1 || month > 12 || day < 1 || day > 31 || hour > 23 || minute > 59 || second > 59) {
+            return false;
+        }
+
+        int64_t key = ((static_cast<int64_t>(year) * 100 + month) * 100 + day) * 100 + hour;
+        HourEntry& entry = hours[key % CACHE_SIZE];
+        if (entry.key != key) {
+            struct tm local = {};
+            local.tm_year = year - 1900;
+            local.tm_mon = month - 1;
+            local.tm_mday = day;
+            local.tm_hour = hour;
+            local.tm_isdst = -1;
+            entry.start = mktime(&local);
+            entry.key = key;
+        }
+        when = entry.start + minute * 60 + second;
+        return true;
+    }
+};
+
+// Parses the bay a vehicle had (an empty field leaves it to the import to choose)
+static bool parseBay(const string& text, int& bay) {
+    if (text.empty()) {
+        return true;
+    }
+    if (text.size() > 9 || text.find_first_not_of("0123456789") != string::npos) {
+        return false;
+    }
+    bay = stoi(text);
+    return true;
+}
+
+// Reads a whole file into memory
+static bool readWholeFile(const string& path, string& text) {
+    ifstream file(path, ios::binary | ios::ate);
+    if (!file) return false;
+    streamoff size = file.tellg();
+    if (size < 0) return false;
+    text.resize(static_cast<size_t>(size));
+    file.seekg(0);
+    return static_cast<bool>(file.read(&text[0], size)) || size == 0;
+}
+
+// Splits the CSV record at 'pos' into 'fields' and moves 'pos' to the next record
+// Quoted fields may hold commas, doubled quotes and line breaks. The field strings are
+// reused from record to record; 'fieldCount' tells how many belong to this record.
+static void nextCsvRecord(const string& text, size_t& pos, vector<string>& fields, size_t& fieldCount) {
+    fieldCount = 0;
+    for (;;) {
+        if (fieldCount == fields.size()) fields.emplace_back();
+        string& field = fields[fieldCount++];
+        field.clear();
+
+        if (pos < text.size() && text[pos] == '"') {
+            ++pos;
+            for (;;) {
+                size_t quote = text.find('"', pos);
+                if (quote == string::npos) {
+                    field.append(text, pos, string::npos);
+                    pos = text.size();
+                    break;
+                }
+                field.append(text, pos, quote - pos);
+                pos = quote + 1;
+                if (pos < text.size() && text[pos] == '"') {
+                    field += '"';
+                    ++pos;
+                }
+                else {
+                    break;
+                }
+            }
+        }
+        size_t end = text.find_first_of(",\r\n", pos);
+        if (end == string::npos) end = text.size();
+        field.append(text, pos, end - pos);
+        pos = end;
+
+        if (pos < text.size() && text[pos] == ',') {
+            ++pos;
+            continue;
+        }
+        if (pos < text.size() && text[pos] == '\r') ++pos;
+        if (pos < text.size() && text[pos] == '\n') ++pos;
+        return;
+    }
+}
+
+// Parses "csv" or "snapshot"
+bool parseImportFormat(const string& name, ImportFormat& format) {
+    if (name == "csv") {
+        format = ImportFormat::Csv;
+        return true;
+    }
+    if (name == "snapshot" || name == "bin") {
+        format = ImportFormat::Snapshot;
+        return true;
+    }
+    return false;
+}
+
+// Reads vehicles from a CSV file with a header line
+bool readVehicleCsv(const string& path, vector<Vehicle>& vehicles, ImportStats& stats) {
+    string text;
+    if (!readWholeFile(path, text)) {
+        return false;
+    }
+    size_t pos = 0;
+    if (text.compare(0, 3, "\xEF\xBB\xBF") == 0) {
+        pos = 3; // UTF-8 byte order mark
+    }
+
+    // Map the header's columns to vehicle fields
+    vector<string> fields;
+    size_t fieldCount = 0;
+    nextCsvRecord(text, pos, fields, fieldCount);
+    vector<int> columnOf(fieldCount, -1);
+    bool haveRegNumber = false;
+    for (size_t i = 0; i < fieldCount; ++i) {
+        for (int column = 0; column < COLUMN_COUNT; ++column) {
+            if (fields[i] == COLUMN_NAMES[column]) {
+                columnOf[i] = column;
+                haveRegNumber = haveRegNumber || column == COLUMN_REG_NUMBER;
+            }
+        }
+    }
+    if (!haveRegNumber) {
+        return false;
+    }
+
+    vehicles.reserve(vehicles.size() + count(text.begin() + pos, text.end(), '\n') + 1);
+    EntryTimeParser entryTimes;
+    while (pos < text.size()) {
+        nextCsvRecord(text, pos, fields, fieldCount);
+        if (fieldCount == 1 && fields[0].empty()) {
+            continue; // Blank line
+        }
+
+        Vehicle vehicle;
+        bool valid = fieldCount == columnOf.size();
+        for (size_t i = 0; i < fieldCount && valid; ++i) {
+            switch (columnOf[i]) {
+            case COLUMN_REG_NUMBER: vehicle.regNumber = fields[i]; break;
+            case COLUMN_OWNER_NAME: vehicle.ownerName = fields[i]; break;
+            case COLUMN_MAKE: vehicle.vehicleMake = fields[i]; break;
+            case COLUMN_MODEL: vehicle.vehicleModel = fields[i]; break;
+            case COLUMN_COLOR: vehicle.vehicleColor = fields[i]; break;
+            case COLUMN_CONTACT: vehicle.ownerContact = fields[i]; break;
+            case COLUMN_ENTRY_TIME: valid = entryTimes.parse(fields[i], vehicle.entryTime); break;
+            case COLUMN_BAY_TYPE: valid = fields[i].empty() || parseBayType(fields[i], vehicle.bayType); break;
+            case COLUMN_SLOT: valid = parseBay(fields[i], vehicle.bay); break;
+            default: break;
+            }
+        }
+        if (!valid || validateVehicle(vehicle).error != ValidationError::None) {
+            stats.invalid++;
+            continue;
+        }
+        vehicles.push_back(move(vehicle));
+    }
+    return true;
+}
+
+// Reads the parked vehicles of a snapshot followed by its waiting vehicles
+bool readVehicleSnapshot(const string& path, vector<Vehicle>& vehicles) {
+    SnapshotHeader header;
+    vector<Vehicle> waiting;
+    bool read = readSnapshot(path, header, [&](const Vehicle& vehicle, bool isWaiting, WaitingPriority) {
+        if (isWaiting) {
+            waiting.push_back(vehicle);
+        }
+        else {
+            vehicles.push_back(vehicle);
+        }
+    });
+    if (!read) {
+        return false;
+    }
+    vehicles.insert(vehicles.end(), make_move_iterator(waiting.begin()), make_move_iterator(waiting.end()));
+    return true;
+}
+
+// Reads a file and bulk-imports its vehicles into a parking system
+bool importParkedVehicles(ParkingManagementSystem& system, const string& path, ImportFormat format, ImportStats& stats) {
+    auto start = chrono::steady_clock::now();
+    vector<Vehicle> vehicles;
+    bool read = format == ImportFormat::Csv ? readVehicleCsv(path, vehicles, stats) : readVehicleSnapshot(path, vehicles);
+    if (!read) {
+        return false;
+    }
+    stats.seconds += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    system.importVehicles(vehicles, stats);
+    return true;
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "ParkingManagementSystem.h"
+
+using namespace std;
+
+// File formats a bulk import reads
+enum class ImportFormat {
+    Csv,        // Header line naming the columns, then one comma-separated line per vehicle
+    Snapshot    // Binary state dump written by a checkpoint (parked, then waiting vehicles)
+};
+
+// Parses "csv" or "snapshot" (also "bin"); returns false if the name is unknown
+bool parseImportFormat(const string& name, ImportFormat& format);
+
+// Reads vehicles from a CSV file with a header line, such as one written by the export
+// Columns are matched by name (regNumber is required; unknown columns are ignored) and
+// fields may be quoted. entryTime is local "YYYY-MM-DDTHH:MM:SS" time or Unix seconds; an
+// empty one means now. bayType names the kind of bay and slot the bay the vehicle had,
+// which it gets back if that bay is still free. Records that fail validation are counted in
+// 'stats.invalid' and skipped. Returns false if the file cannot be read or has no regNumber column.
+bool readVehicleCsv(const string& path, vector<Vehicle>& vehicles, ImportStats& stats);
+
+// Reads the parked vehicles of a snapshot followed by its waiting vehicles
+// Returns false if the snapshot is missing or corrupt.
+bool readVehicleSnapshot(const string& path, vector<Vehicle>& vehicles);
+
+// Reads a file and bulk-imports its vehicles into a parking system (see importVehicles)
+// 'stats.seconds' covers reading and importing. Returns false if the file cannot be read.
+bool importParkedVehicles(ParkingManagementSystem& system, const string& path, ImportFormat format, ImportStats& stats);
@@ -0,0 +1,402 @@
+#include "ParkingJournal.h"
+#include <cstring>
+#include <cstdio>
+#include "Metrics.h"
+
+static const char JOURNAL_MAGIC[4] = { 'P', 'M', 'S', 'J' };
+static const char SNAPSHOT_MAGIC[4] = { 'P', 'M', 'S', 'S' };
+static const uint32_t FORMAT_VERSION = 4;      // 2: waiting priorities, Cancel/Promote records; 3: amounts in cents; 4: bays
+static const uint32_t OLDEST_VERSION = 1;      // Oldest version still read (missing priorities are standard, dollars become cents, bays are assigned)
+static const size_t JOURNAL_HEADER_SIZE = 16;   // Magic, version, generation
+static const size_t BUFFER_LIMIT = 1 << 16;     // Bytes buffered before a write
+
+// FNV-1a checksum of a byte range
+static uint32_t checksum(const char* data, size_t length) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; ++i) {
+        hash ^= static_cast<uint8_t>(data[i]);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// Appends the raw bytes of a value (native byte order)
+template <typename T>
+static void putValue(string& out, T value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+// Appends a length-prefixed string
+static void putString(string& out, const string& value) {
+    putValue<uint16_t>(out, static_cast<uint16_t>(min<size_t>(value.size(), 0xFFFF)));
+    out.append(value.data(), min<size_t>(value.size(), 0xFFFF));
+}
+
+// Appends every field of a vehicle
+static void putVehicle(string& out, const Vehicle& vehicle) {
+    putString(out, vehicle.regNumber);
+    putString(out, vehicle.ownerName);
+    putString(out, vehicle.vehicleMake);
+    putString(out, vehicle.vehicleModel);
+    putString(out, vehicle.vehicleColor);
+    putString(out, vehicle.ownerContact);
+    putValue<int64_t>(out, static_cast<int64_t>(vehicle.entryTime));
+    putValue<uint8_t>(out, static_cast<uint8_t>(vehicle.bayType));
+    putValue<int32_t>(out, vehicle.bay);
+}
+
+// Bounds-checked reader over an in-memory buffer
+struct ByteReader {
+    const char* p;     // Current position
+    const char* end;   // End of the buffer
+
+    // Reads a fixed-size value
+    template <typename T>
+    bool get(T& value) {
+        if (static_cast<size_t>(end - p) < sizeof(T)) return false;
+        memcpy(&value, p, sizeof(T));
+        p += sizeof(T);
+        return true;
+    }
+
+    // Reads a length-prefixed string
+    bool getString(string& value) {
+        uint16_t length;
+        if (!get(length) || static_cast<size_t>(end - p) < length) return false;
+        value.assign(p, length);
+        p += length;
+        return true;
+    }
+
+    // Reads an amount in cents; versions before 3 stored dollars as a double
+    bool getAmount(Cents& value, uint32_t version) {
+        if (version >= 3) return get(value);
+        double dollars;
+        if (!get(dollars)) return false;
+        value = dollarsToCents(dollars);
+        return true;
+    }
+
+    // Reads every field of a vehicle written in format 'version'
+    bool getVehicle(Vehicle& vehicle, uint32_t version) {
+        int64_t entryTime;
+        if (!getString(vehicle.regNumber) || !getString(vehicle.ownerName) || !getString(vehicle.vehicleMake)
+            || !getString(vehicle.vehicleModel) || !getString(vehicle.vehicleColor) || !getString(vehicle.ownerContact)
+            || !get(entryTime)) {
+            return false;
+        }
+        vehicle.entryTime = static_cast<time_t>(entryTime);
+
+        // Version 3 has no bays; the vehicle takes any standard bay. A bay type this build
+        // does not know marks the record as corrupt rather than indexing past the bay tables.
+        uint8_t bayType = 0;
+        int32_t bay = -1;
+        if (version >= 4 && (!get(bayType) || !get(bay) || bayType >= BAY_TYPE_COUNT)) {
+            return false;
+        }
+        vehicle.bayType = static_cast<BayType>(bayType);
+        vehicle.bay = bay;
+        return true;
+    }
+};
+
+// Reads a whole file into memory
+static bool readFile(const string& path, string& content) {
+    ifstream file(path, ios::binary | ios::ate);
+    if (!file.is_open()) return false;
+
+    // Size the buffer once and read the file in a single call
+    streamoff size = file.tellg();
+    if (size < 0) return false;
+    content.resize(static_cast<size_t>(size));
+    file.seekg(0);
+    return static_cast<bool>(file.read(&content[0], size)) || size == 0;
+}
+
+// Constructor; the file is not opened until open() or reset()
+ParkingJournal::ParkingJournal(const string& journalPath, bool flushEach)
+    : path(journalPath), flushEveryRecord(flushEach), generation(0), records(0) {
+    buffer.reserve(BUFFER_LIMIT * 2);
+}
+
+// Flushes pending records
+ParkingJournal::~ParkingJournal() {
+    flush();
+}
+
+// Opens the journal to continue appending records of a generation
+bool ParkingJournal::open(uint64_t gen, uint64_t existingRecords) {
+    generation = gen;
+    records = existingRecords;
+    file.open(path, ios::binary | ios::app);
+    return file.is_open();
+}
+
+// Starts a fresh, empty journal for a new generation
+bool ParkingJournal::reset(uint64_t gen) {
+    if (file.is_open()) {
+        file.close();
+    }
+    buffer.clear();
+    generation = gen;
+    records = 0;
+
+    file.open(path, ios::binary | ios::trunc);
+    if (!file.is_open()) return false;
+
+    string header(JOURNAL_MAGIC, 4);
+    putValue<uint32_t>(header, FORMAT_VERSION);
+    putValue<uint64_t>(header, generation);
+    file.write(header.data(), header.size());
+    file.flush();
+    return true;
+}
+
+// Appends a record
+void ParkingJournal::append(const JournalRecord& record) {
+    if (!file.is_open()) return;
+
+    // Encode the payload
+    string payload;
+    putValue<uint8_t>(payload, static_cast<uint8_t>(record.type));
+    switch (record.type) {
+    case JournalRecordType::Park:
+        putVehicle(payload, record.vehicle);
+        break;
+    case JournalRecordType::Queue:
+        putVehicle(payload, record.vehicle);
+        putValue<uint8_t>(payload, static_cast<uint8_t>(record.priority));
+        break;
+    case JournalRecordType::Cancel:
+        putString(payload, record.vehicle.regNumber);
+        break;
+    case JournalRecordType::Promote:
+        putString(payload, record.vehicle.regNumber);
+        putValue<uint8_t>(payload, static_cast<uint8_t>(record.priority));
+        break;
+    case JournalRecordType::Retrieve:
+        putString(payload, record.vehicle.regNumber);
+        putValue<int64_t>(payload, record.fee);
+        break;
+    case JournalRecordType::Admit:
+        putString(payload, record.vehicle.regNumber);
+        putValue<int64_t>(payload, static_cast<int64_t>(record.vehicle.entryTime));
+        putValue<int32_t>(payload, record.vehicle.bay);
+        break;
+    }
+
+    // Frame it with its length and checksum
+    putValue<uint32_t>(buffer, static_cast<uint32_t>(payload.size()));
+    putValue<uint32_t>(buffer, checksum(payload.data(), payload.size()));
+    buffer += payload;
+    records++;
+
+    if (flushEveryRecord) {
+        flush();
+    }
+    else if (buffer.size() >= BUFFER_LIMIT) {
+        writeBuffer();
+    }
+}
+
+// Writes buffered records to the file
+void ParkingJournal::writeBuffer() {
+    if (!buffer.empty() && file.is_open()) {
+        METRIC_SCOPE(MetricOperation::JournalWrite);
+        METRIC_COUNT(MetricCounter::JournalBytes, buffer.size());
+        file.write(buffer.data(), buffer.size());
+    }
+    buffer.clear();
+}
+
+// Writes and flushes pending records
+void ParkingJournal::flush() {
+    writeBuffer();
+    if (file.is_open()) {
+        file.flush();
+    }
+}
+
+// Returns the number of records since the last reset
+uint64_t ParkingJournal::recordCount() const {
+    return records;
+}
+
+// Returns the format version in a journal file's header
+uint32_t ParkingJournal::fileVersion(const string& path) {
+    ifstream file(path, ios::binary);
+    char header[8];
+    if (!file.read(header, sizeof(header)) || memcmp(header, JOURNAL_MAGIC, 4) != 0) return 0;
+    uint32_t version;
+    memcpy(&version, header + 4, 4);
+    return version;
+}
+
+// Returns true if files of a format version can be read
+bool ParkingJournal::canRead(uint32_t version) {
+    return version >= OLDEST_VERSION && version <= FORMAT_VERSION;
+}
+
+// Returns the format version new files are written in
+uint32_t ParkingJournal::currentVersion() {
+    return FORMAT_VERSION;
+}
+
+// Replays the records of a journal file
+uint64_t ParkingJournal::replay(const string& path, uint64_t expectedGeneration,
+    const function<void(const JournalRecord&)>& apply, uint64_t& validBytes) {
+    validBytes = 0;
+    string content;
+    if (!readFile(path, content) || content.size() < JOURNAL_HEADER_SIZE
+        || memcmp(content.data(), JOURNAL_MAGIC, 4) != 0) {
+        return 0;
+    }
+
+    ByteReader header{ content.data() + 4, content.data() + JOURNAL_HEADER_SIZE };
+    uint32_t version;
+    uint64_t generation;
+    header.get(version);
+    header.get(generation);
+    if (version < OLDEST_VERSION || version > FORMAT_VERSION || generation != expectedGeneration) {
+        return 0; // Journal predates the snapshot; its records are already included
+    }
+
+    uint64_t count = 0;
+    const char* p = content.data() + JOURNAL_HEADER_SIZE;
+    const char* end = content.data() + content.size();
+    JournalRecord record;
+    while (true) {
+        // Stop at the first torn or corrupt record
+        ByteReader frame{ p, end };
+        uint32_t length, sum;
+        if (!frame.get(length) || !frame.get(sum) || static_cast<size_t>(end - frame.p) < length
+            || checksum(frame.p, length) != sum) {
+            break;
+        }
+
+        ByteReader payload{ frame.p, frame.p + length };
+        uint8_t type = 0;
+        bool valid = payload.get(type);
+        record.type = static_cast<JournalRecordType>(type);
+        record.fee = 0;
+        record.priority = WaitingPriority::Standard;
+        uint8_t priority = 0;
+        if (valid) {
+            switch (record.type) {
+            case JournalRecordType::Park:
+                valid = payload.getVehicle(record.vehicle, version);
+                break;
+            case JournalRecordType::Queue:
+                valid = payload.getVehicle(record.vehicle, version) && (version < 2 || payload.get(priority));
+                record.priority = static_cast<WaitingPriority>(priority);
+                break;
+            case JournalRecordType::Cancel:
+                valid = payload.getString(record.vehicle.regNumber);
+                break;
+            case JournalRecordType::Promote:
+                valid = payload.getString(record.vehicle.regNumber) && payload.get(priority);
+                record.priority = static_cast<WaitingPriority>(priority);
+                break;
+            case JournalRecordType::Retrieve:
+                valid = payload.getString(record.vehicle.regNumber) && payload.getAmount(record.fee, version);
+                break;
+            case JournalRecordType::Admit: {
+                int64_t entryTime = 0;
+                int32_t bay = -1;
+                valid = payload.getString(record.vehicle.regNumber) && payload.get(entryTime)
+                    && (version < 4 || payload.get(bay));
+                record.vehicle.entryTime = static_cast<time_t>(entryTime);
+                record.vehicle.bay = bay;
+                break;
+            }
+            default:
+                valid = false;
+                break;
+            }
+        }
+        if (!valid) break;
+
+        apply(record);
+        count++;
+        p = frame.p + length;
+    }
+    validBytes = static_cast<uint64_t>(p - content.data());
+    return count;
+}
+
+// Starts a snapshot with the given header
+SnapshotWriter::SnapshotWriter(const string& snapshotPath, const SnapshotHeader& header)
+    : path(snapshotPath), tempPath(snapshotPath + ".tmp"), written(0),
+    expected(header.parkedCount + header.waitingCount) {
+    buffer.append(SNAPSHOT_MAGIC, 4);
+    putValue<uint32_t>(buffer, FORMAT_VERSION);
+    putValue<uint64_t>(buffer, header.generation);
+    putValue<int64_t>(buffer, header.totalRevenue);
+    putValue<uint64_t>(buffer, header.parkedCount);
+    putValue<uint64_t>(buffer, header.waitingCount);
+    buffer.reserve(buffer.size() + expected * 64);
+}
+
+// Adds the next parked vehicle
+void SnapshotWriter::addVehicle(const Vehicle& vehicle) {
+    putVehicle(buffer, vehicle);
+    written++;
+}
+
+// Adds the next waiting vehicle with its priority
+void SnapshotWriter::addWaitingVehicle(const Vehicle& vehicle, WaitingPriority priority) {
+    putVehicle(buffer, vehicle);
+    putValue<uint8_t>(buffer, static_cast<uint8_t>(priority));
+    written++;
+}
+
+// Writes the snapshot
+bool SnapshotWriter::commit() {
+    if (written != expected) return false;
+    putValue<uint32_t>(buffer, checksum(buffer.data(), buffer.size()));
+
+    {
+        ofstream file(tempPath, ios::binary | ios::trunc);
+        if (!file.is_open()) return false;
+        file.write(buffer.data(), buffer.size());
+        file.flush();
+        if (!file) return false;
+    }
+
+    // Replace the previous snapshot (rename does not overwrite on Windows)
+    remove(path.c_str());
+    return rename(tempPath.c_str(), path.c_str()) == 0;
+}
+
+// Reads a snapshot
+bool readSnapshot(const string& path, SnapshotHeader& header,
+    const function<void(const Vehicle&, bool waiting, WaitingPriority priority)>& apply) {
+    // Fall back to a completed temporary file if the rename was interrupted
+    string content;
+    if (!readFile(path, content) && !readFile(path + ".tmp", content)) {
+        return false;
+    }
+
+    // Verify the magic, version and trailing checksum before applying anything
+    if (content.size() < 44 || memcmp(content.data(), SNAPSHOT_MAGIC, 4) != 0) return false;
+    uint32_t storedSum;
+    memcpy(&storedSum, content.data() + content.size() - 4, 4);
+    if (checksum(content.data(), content.size() - 4) != storedSum) return false;
+
+    ByteReader reader{ content.data() + 4, content.data() + content.size() - 4 };
+    uint32_t version;
+    if (!reader.get(version) || version < OLDEST_VERSION || version > FORMAT_VERSION || !reader.get(header.generation)
+        || !reader.getAmount(header.totalRevenue, version) || !reader.get(header.parkedCount) || !reader.get(header.waitingCount)) {
+        return false;
+    }
+
+    Vehicle vehicle;
+    for (uint64_t i = 0; i < header.parkedCount + header.waitingCount; ++i) {
+        if (!reader.getVehicle(vehicle, version)) return false;
+        bool waiting = i >= header.parkedCount;
+        uint8_t priority = 0;
+        if (waiting && version >= 2 && !reader.get(priority)) return false;
+        apply(vehicle, waiting, static_cast<WaitingPriority>(priority));
+    }
+    return true;
+}
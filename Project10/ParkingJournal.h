@@ -0,0 +1,117 @@
+#pragma once
+
+#include <string>
+#include <fstream>
+#include <functional>
+#include <cstdint>
+#include "Vehicle.h"
+#include "WaitingList.h"
+#include "Tariff.h"
+
+using namespace std;
+
+// Kinds of state changes recorded in the journal
+enum class JournalRecordType : uint8_t {
+    Park = 1,       // Vehicle took a slot (vehicle, entryTime, bay)
+    Retrieve = 2,   // Vehicle left (regNumber, fee)
+    Queue = 3,      // Vehicle joined the waiting list (vehicle, priority)
+    Admit = 4,      // A waiting vehicle took a slot (regNumber, entryTime, bay)
+    Cancel = 5,     // A waiting vehicle gave up (regNumber)
+    Promote = 6     // A waiting vehicle's priority changed (regNumber, priority)
+};
+
+// One journal entry
+struct JournalRecord {
+    JournalRecordType type;  // Kind of state change
+    Vehicle vehicle;         // Vehicle data (only regNumber for Retrieve; regNumber, entryTime and bay for Admit)
+    Cents fee = 0;           // Fee charged in cents (Retrieve only)
+    WaitingPriority priority = WaitingPriority::Standard; // Waiting priority (Queue/Promote only)
+};
+
+// Append-only binary journal of parking state changes
+// File layout: "PMSJ", version, generation, then records framed as
+// [payload length][checksum][payload]. A torn or corrupt tail ends replay.
+class ParkingJournal {
+private:
+    string path;                  // Journal file path
+    ofstream file;                // Open journal file
+    string buffer;                // Encoded records not yet written
+    bool flushEveryRecord;        // Write and flush after every record
+    uint64_t generation;          // Snapshot generation this journal continues from
+    uint64_t records;             // Records appended since the journal was reset
+
+    // Writes buffered records to the file
+    void writeBuffer();
+
+public:
+    // Constructor; the file is not opened until open() or reset()
+    ParkingJournal(const string& path, bool flushEveryRecord);
+
+    // Flushes pending records
+    ~ParkingJournal();
+
+    // Opens the journal to continue appending records of a generation
+    bool open(uint64_t generation, uint64_t existingRecords);
+
+    // Starts a fresh, empty journal for a new generation
+    bool reset(uint64_t generation);
+
+    // Appends a record
+    void append(const JournalRecord& record);
+
+    // Writes and flushes pending records
+    void flush();
+
+    // Returns the number of records since the last reset
+    uint64_t recordCount() const;
+
+    // Returns the format version in a journal file's header (0 if the file is missing or not a journal)
+    static uint32_t fileVersion(const string& path);
+
+    // Returns true if journals and snapshots of a format version can be read
+    static bool canRead(uint32_t version);
+
+    // Returns the format version new journals and snapshots are written in
+    static uint32_t currentVersion();
+
+    // Replays the records of a journal file; returns the number of valid records
+    // Records are only replayed if the file belongs to 'expectedGeneration'.
+    // 'validBytes' receives the length of the intact prefix (0 if the file is unusable).
+    static uint64_t replay(const string& path, uint64_t expectedGeneration,
+        const function<void(const JournalRecord&)>& apply, uint64_t& validBytes);
+};
+
+// Full copy of the parking state at a point in time
+struct SnapshotHeader {
+    uint64_t generation = 0;     // Generation of the journal that continues this snapshot
+    Cents totalRevenue = 0;      // Revenue collected so far, in cents
+    uint64_t parkedCount = 0;    // Number of parked vehicles that follow (oldest first)
+    uint64_t waitingCount = 0;   // Number of waiting vehicles that follow (in admission order)
+};
+
+// Writes a snapshot to a temporary file and renames it into place
+class SnapshotWriter {
+private:
+    string path;          // Final snapshot path
+    string tempPath;      // Temporary file written first
+    string buffer;        // Encoded snapshot body
+    uint64_t written;     // Vehicles added so far
+    uint64_t expected;    // Vehicles announced in the header
+
+public:
+    // Starts a snapshot with the given header
+    SnapshotWriter(const string& path, const SnapshotHeader& header);
+
+    // Adds the next parked vehicle (all parked vehicles come first)
+    void addVehicle(const Vehicle& vehicle);
+
+    // Adds the next waiting vehicle with its priority
+    void addWaitingVehicle(const Vehicle& vehicle, WaitingPriority priority);
+
+    // Writes the snapshot; returns false on I/O failure
+    bool commit();
+};
+
+// Reads a snapshot; returns false if it is missing or corrupt
+bool readSnapshot(const string& path, SnapshotHeader& header,
+    const function<void(const Vehicle&, bool waiting, WaitingPriority priority)>& apply);
@@ -1,312 +1,848 @@
 #include "ParkingManagementSystem.h"
+#include <chrono>
+#include <filesystem>
+#include "Metrics.h"
 
-#define RED "\033[1;31m" // Bright Red color for error messages
-#define RESET "\033[0m"  // Reset to default color
+// Constructor for an empty vehicle record
+Vehicle::Vehicle() : entryTime(0), bayType(BayType::Standard), bay(-1) {}
 
 // Constructor for Vehicle class
 Vehicle::Vehicle(string reg, string owner, string make, string model, string color, string contact)
     : regNumber(reg), ownerName(owner), vehicleMake(make), vehicleModel(model),
-    vehicleColor(color), ownerContact(contact), entryTime(time(0)), left(nullptr), right(nullptr) {}
+    vehicleColor(color), ownerContact(contact), entryTime(0), bayType(BayType::Standard), bay(-1) {}
 
-// Constructor for ParkingManagementSystem
-ParkingManagementSystem::ParkingManagementSystem(int cap, double rate)
-    : capacity(cap), currentVehicles(0), parkingRate(rate), totalRevenue(0), vehicleBSTRoot(nullptr) {
-    logFile.open("parking_Log.txt", ios::app); // Open the log file in append mode
-    if (!logFile.is_open()) {
-        cout << "Error: Failed to open log file." << endl; // Log file error handling
+// Fills in the hourly rate of a tariff from the rate given to the constructor
+static TariffTable withHourlyRate(TariffTable table, double rate) {
+    if (table.hourlyRate < 0) {
+        table.hourlyRate = dollarsToCents(rate);
     }
+    return table;
 }
 
-// Destructor for ParkingManagementSystem
-ParkingManagementSystem::~ParkingManagementSystem() {
-    if (logFile.is_open()) {
-        logFile.close(); // Close the log file if open
+// Returns the bay layout of a lot: the configured one, or 'cap' standard bays on level 0
+static vector<BayGroup> bayLayout(int cap, const ParkingConfig& config) {
+    if (!config.bays.empty()) {
+        return config.bays;
     }
+    return vector<BayGroup>{ BayGroup{ 0, BayType::Standard, cap } };
 }
 
-// Logs events with timestamps to the log file
-void ParkingManagementSystem::logEvent(const string& event) {
-    if (logFile.is_open()) {
-        time_t rawTime;
-        time(&rawTime);
-        struct tm localTimeStruct;
-        localtime_s(&localTimeStruct, &rawTime);
-
-        // Append the event with a timestamp
-        logFile << "[" << std::put_time(&localTimeStruct, "%Y-%m-%d %H:%M:%S") << "] " << event << std::endl;
+// Returns the number of bays of a lot's layout
+static int layoutCapacity(int cap, const ParkingConfig& config) {
+    int total = 0;
+    for (const BayGroup& group : bayLayout(cap, config)) {
+        total += max(group.count, 0);
     }
+    return total;
 }
 
-// Calculates parking fee based on time parked
-double ParkingManagementSystem::calculateFee(time_t entryTime) {
-    time_t currentTime = time(0); // Current time
-    double hoursParked = difftime(currentTime, entryTime) / 3600; // Calculate hours parked
-    return round(hoursParked * parkingRate * 100) / 100; // Calculate fee and round to 2 decimals
+// Returns the display name of an alert type
+const char* parkingAlertName(ParkingAlertType type) {
+    switch (type) {
+    case ParkingAlertType::GracePeriodEnd: return "Grace period ended";
+    case ParkingAlertType::Overstay: return "Overstay";
+    case ParkingAlertType::TowWarning: return "Tow warning";
+    default: return "Permit expired";
+    }
 }
 
-// Inserts a vehicle into the Binary Search Tree (BST)
-void ParkingManagementSystem::insertToBST(unique_ptr<Vehicle>& root, const string& regNumber, const string& ownerName, string& make, string& model, string& color, string& contact) {
-    if (!root) {
-        // If root is null, create a new vehicle node
-        root = make_unique<Vehicle>(regNumber, ownerName, make, model, color, contact);
+// Constructor for ParkingManagementSystem
+ParkingManagementSystem::ParkingManagementSystem(int cap, double rate, const ParkingConfig& config)
+    : newestSlot(-1), capacity(layoutCapacity(cap, config)), currentVehicles(0), tariff(withHourlyRate(config.tariff, rate)), totalRevenue(0), statistics(layoutCapacity(cap, config)),
+    clock(config.clock ? config.clock : systemClock()), alertTimers(clock->now()), alertPolicy(config.alerts), processingAlerts(false),
+    snapshotPath(config.snapshotPath), snapshotEveryEvents(config.snapshotEveryEvents), snapshotGeneration(0), recovering(false), importing(false), deferPlateIndex(false),
+    reportedParked(0), reportedWaiting(0), reportedAlerts(0) {
+    // Allocate the slot table up front, one slot per bay; free bays are handed out lowest number first
+    bays.build(bayLayout(cap, config));
+    slots.resize(capacity, ParkingSlot{ false, -1, -1 });
+    store.resize(capacity);
+    vehicleHash.reserve(capacity);
+    plateIndex.reserve(capacity);
+    fuzzyIndex.resize(capacity);
+    makeIndex.resize(capacity);
+    modelIndex.resize(capacity);
+    colorIndex.resize(capacity);
+    slotAlerts.resize(capacity, array<TimerId, 4>{ 0, 0, 0, 0 });
+    if (alertPolicy.graceMinutes < 0) {
+        alertPolicy.graceMinutes = config.tariff.graceMinutes;
+    }
+
+    if (!config.logging.path.empty() && !config.readOnly) {
+        logger = make_unique<EventLogger>(config.logging); // Opens the log file in append mode
+        if (!logger->isOpen()) {
+            cout << "Error: Failed to open log file." << endl; // Log file error handling
+        }
     }
-    else if (regNumber < root->regNumber) {
-        // Recur to the left subtree if registration number is smaller
-        insertToBST(root->left, regNumber, ownerName, make, model, color, contact);
+
+    // Restore the state left by the previous run
+    if (!config.journalPath.empty()) {
+        recoverState(config);
+        statistics.setOccupancy(currentVehicles);
     }
-    else {
-        // Recur to the right subtree otherwise
-        insertToBST(root->right, regNumber, ownerName, make, model, color, contact);
+
+    // Completed sessions go to the archive from here on
+    if (!config.archivePath.empty() && !config.readOnly) {
+        archive = make_unique<SessionArchive>(config.archivePath, config.archiveBlockSessions, config.journalFlushEveryEvent);
+        if (!archive->open()) {
+            cout << "Error: Failed to open session archive." << endl;
+            archive.reset();
+        }
     }
+    reportGauges();
 }
 
-// Searches for a vehicle in the BST by registration number
-Vehicle* ParkingManagementSystem::searchInBST(Vehicle* root, const string& regNumber) {
-    if (!root || root->regNumber == regNumber) {
-        // Return the node if found or null if not found
-        return root;
+// Loads the latest snapshot and replays the journal tail
+void ParkingManagementSystem::recoverState(const ParkingConfig& config) {
+    recovering = true;
+
+    // Snapshot: parked vehicles oldest first, then the waiting list in admission order
+    // The plate index is built afterwards in one pass instead of per vehicle.
+    SnapshotHeader header;
+    deferPlateIndex = true;
+    bool haveSnapshot = readSnapshot(snapshotPath, header, [this](const Vehicle& vehicle, bool waiting, WaitingPriority priority) {
+        int bay = waiting ? -1 : assignBay(vehicle.bayType, vehicle.bay);
+        if (bay != -1) {
+            occupySlot(vehicle, vehicle.entryTime, bay);
+        }
+        else {
+            waitingList.push(vehicle, priority);
+        }
+    });
+    buildDeferredPlateIndex();
+    if (haveSnapshot) {
+        snapshotGeneration = header.generation;
+        totalRevenue = header.totalRevenue;
+    }
+
+    // Never reset or overwrite files this build cannot read; the lot runs without persistence instead
+    error_code ignored;
+    bool snapshotExists = filesystem::exists(snapshotPath, ignored) || filesystem::exists(snapshotPath + ".tmp", ignored);
+    uint32_t journalVersion = ParkingJournal::fileVersion(config.journalPath);
+    if ((snapshotExists && !haveSnapshot) || (journalVersion != 0 && !ParkingJournal::canRead(journalVersion))) {
+        cout << "Error: The journal or snapshot is corrupt or was written by an unsupported version; "
+            << "state was not recovered and changes will not be saved." << endl;
+        recovering = false;
+        return;
+    }
+
+    // Journal tail written after that snapshot
+    uint64_t validBytes = 0;
+    uint64_t replayed = ParkingJournal::replay(config.journalPath, snapshotGeneration,
+        [this](const JournalRecord& record) { applyJournalRecord(record); }, validBytes);
+    recovering = false;
+
+    // A read-only lot leaves the journal as it is, torn tail and old format included
+    if (config.readOnly) {
+        return;
+    }
+
+    journal = make_unique<ParkingJournal>(config.journalPath, config.journalFlushEveryEvent);
+    bool upgrade = validBytes > 0 && journalVersion != ParkingJournal::currentVersion();
+    bool opened;
+    if (validBytes > 0 && !upgrade) {
+        // Drop a torn tail so new records follow the last intact one
+        if (filesystem::file_size(config.journalPath, ignored) > validBytes) {
+            filesystem::resize_file(config.journalPath, validBytes, ignored);
+        }
+        opened = journal->open(snapshotGeneration, replayed);
     }
-    else if (regNumber < root->regNumber) {
-        // Search in the left subtree
-        return searchInBST(root->left.get(), regNumber);
+    else if (upgrade) {
+        // An older-format journal is not appended to; the recovered state goes into a new snapshot
+        opened = checkpoint();
     }
     else {
-        // Search in the right subtree
-        return searchInBST(root->right.get(), regNumber);
+        opened = journal->reset(snapshotGeneration);
+    }
+    if (!opened) {
+        cout << "Error: Failed to open journal file." << endl;
+        journal.reset();
+    }
+
+    if (haveSnapshot || replayed > 0) {
+        logEvent("Recovered state: " + to_string(currentVehicles) + " parked, "
+            + to_string(waitingList.size()) + " waiting");
     }
 }
 
-// Validates the vehicle make input
-bool isValidVehicleMake(const string& make) {
-    if (make.empty()) {
-        cout << RED << "Error: Vehicle make cannot be empty." << RESET << endl;
-        return false;
+// Builds the plate index in one pass from the plates collected during a bulk load
+void ParkingManagementSystem::buildDeferredPlateIndex() {
+    deferPlateIndex = false;
+    if (!is_sorted(deferredPlates.begin(), deferredPlates.end())) {
+        sort(deferredPlates.begin(), deferredPlates.end());
     }
-    for (char c : make) {
-        // Check for invalid characters (only letters and spaces allowed)
-        if (!isalpha(c) && c != ' ') {
-            cout << RED << "Error: Vehicle make can only contain letters and spaces." << RESET << endl;
-            return false;
+    plateIndex.buildFromSorted(deferredPlates);
+    deferredPlates.clear();
+    deferredPlates.shrink_to_fit();
+}
+
+// Applies one journal record during recovery
+void ParkingManagementSystem::applyJournalRecord(const JournalRecord& record) {
+    switch (record.type) {
+    case JournalRecordType::Park:
+        if (vehicleHash.find(record.vehicle.regNumber) == -1) {
+            int bay = assignBay(record.vehicle.bayType, record.vehicle.bay);
+            if (bay != -1) occupySlot(record.vehicle, record.vehicle.entryTime, bay);
+            else waitingList.push(record.vehicle, WaitingPriority::Standard);
         }
+        break;
+    case JournalRecordType::Queue:
+        waitingList.push(record.vehicle, record.priority);
+        break;
+    case JournalRecordType::Cancel: {
+        WaitingEntry cancelled;
+        waitingList.remove(record.vehicle.regNumber, cancelled);
+        break;
+    }
+    case JournalRecordType::Promote:
+        waitingList.setPriority(record.vehicle.regNumber, record.priority);
+        break;
+    case JournalRecordType::Retrieve: {
+        int slot = vehicleHash.find(record.vehicle.regNumber);
+        if (slot != -1) {
+            removeParkedVehicle(slot, record.fee);
+        }
+        break;
+    }
+    case JournalRecordType::Admit: {
+        // Admit exactly the recorded vehicle, into the recorded bay if it is free
+        const WaitingEntry* waiting = waitingList.find(record.vehicle.regNumber);
+        int bay = waiting ? assignBay(waiting->vehicle.bayType, record.vehicle.bay) : -1;
+        WaitingEntry admitted;
+        if (bay != -1 && waitingList.remove(record.vehicle.regNumber, admitted)) {
+            occupySlot(admitted.vehicle, record.vehicle.entryTime, bay);
+        }
+        break;
     }
-    // Ensure it doesn't start or end with spaces and doesn't exceed 50 characters
-    if (make.front() == ' ' || make.back() == ' ' || make.length() > 50) {
-        cout << RED << "Error: Vehicle make format is invalid." << RESET << endl;
-        return false;
     }
-    return true;
 }
 
-// Validates the vehicle model input
-bool isValidVehicleModel(const string& model) {
-    if (model.empty()) {
-        cout << RED << "Error: Vehicle model cannot be empty." << RESET << endl;
-        return false;
+// Appends a state change to the journal
+void ParkingManagementSystem::journalRecord(JournalRecordType type, const Vehicle& vehicle, Cents fee, WaitingPriority priority) {
+    if (!journal || recovering) return;
+
+    JournalRecord record{ type, vehicle, fee, priority };
+    journal->append(record);
+    if (snapshotEveryEvents > 0 && journal->recordCount() >= snapshotEveryEvents) {
+        checkpoint();
+    }
+}
+
+// Writes a snapshot of the full state and starts a new, empty journal
+bool ParkingManagementSystem::checkpoint() {
+    if (!journal) return false;
+    METRIC_SCOPE(MetricOperation::Checkpoint);
+    journal->flush();
+
+    SnapshotHeader header;
+    header.generation = snapshotGeneration + 1;
+    header.totalRevenue = totalRevenue;
+    header.parkedCount = currentVehicles;
+    header.waitingCount = waitingList.size();
+    SnapshotWriter writer(snapshotPath, header);
+
+    // Parked vehicles oldest first, so reloading preserves the parking order
+    vector<int> order;
+    order.reserve(currentVehicles);
+    for (int slot = newestSlot; slot != -1; slot = slots[slot].older) {
+        order.push_back(slot);
+    }
+    Vehicle vehicle;
+    for (auto it = order.rbegin(); it != order.rend(); ++it) {
+        store.get(*it, vehicle);
+        writer.addVehicle(vehicle);
+    }
+
+    // Waiting vehicles in admission order, so reloading preserves it
+    for (const WaitingEntry* entry : waitingList.firstEntries(waitingList.size())) {
+        writer.addWaitingVehicle(entry->vehicle, entry->priority);
+    }
+
+    if (!writer.commit()) {
+        return false; // Keep appending to the current journal
+    }
+    snapshotGeneration = header.generation;
+    return journal->reset(snapshotGeneration);
+}
+
+// Destructor for ParkingManagementSystem
+ParkingManagementSystem::~ParkingManagementSystem() {
+    // Take this lot's levels back out of the gauges
+    METRIC_ADD(MetricGauge::ParkedVehicles, -reportedParked);
+    METRIC_ADD(MetricGauge::WaitingVehicles, -reportedWaiting);
+    METRIC_ADD(MetricGauge::PendingAlerts, -reportedAlerts);
+    journal.reset(); // Flushes pending journal records
+    logger.reset();  // Writes out any pending events and closes the log file
+}
+
+// Queues an event for the background log writer
+void ParkingManagementSystem::logEvent(const string& event) {
+    if (isLogging()) {
+        logger->log(event, clock->now());
+    }
+}
+
+// Returns true if logged events are written right now
+bool ParkingManagementSystem::isLogging() const {
+    return logger && !recovering && !importing;
+}
+
+// Calculates parking fee based on time parked
+Cents ParkingManagementSystem::calculateFee(time_t entryTime, time_t exitTime) const {
+    return tariff.fee(entryTime, exitTime); // Exact cents from the compiled rate table
+}
+
+// Handles parking a vehicle
+ParkResult ParkingManagementSystem::parkVehicle(const Vehicle& details, WaitingPriority priority) {
+    METRIC_SCOPE(MetricOperation::Park);
+    const string& regNumber = details.regNumber;
+
+    // Check if the vehicle is already parked or waiting
+    if (vehicleHash.find(regNumber) != -1) {
+        return ParkResult::AlreadyParked;
+    }
+    if (waitingList.find(regNumber)) {
+        return ParkResult::AlreadyWaiting;
     }
-    for (char c : model) {
-        // Check for invalid characters (letters, numbers, spaces allowed)
-        if (!isalnum(c) && c != ' ') {
-            cout << RED << "Error: Vehicle model can only contain letters, numbers, and spaces." << RESET << endl;
-            return false;
+
+    time_t now = clock->now();
+    processAlerts(now);
+
+    // Waiting vehicles come first: an arrival only gets a kind of bay nobody is waiting for
+    admitFromWaitingList(now);
+    int bay = waitingList.countNeeding(details.bayType) == 0 ? assignBay(details.bayType, -1) : -1;
+    if (bay != -1) {
+        // If a suitable bay is free, park the vehicle (entry time is stamped now)
+        occupySlot(details, now, bay);
+        statistics.recordArrival(now, currentVehicles);
+        if (journal) {
+            Vehicle parked = details;
+            parked.entryTime = now;
+            parked.bay = bay;
+            journalRecord(JournalRecordType::Park, parked);
         }
+        reportGauges();
+        return ParkResult::Parked;
     }
-    // Ensure it doesn't start or end with spaces and doesn't exceed 50 characters
-    if (model.front() == ' ' || model.back() == ' ' || model.length() > 50) {
-        cout << RED << "Error: Vehicle model format is invalid." << RESET << endl;
-        return false;
+
+    // If no suitable bay is free, add to the waiting list; until admission the entry time
+    // records when the vehicle joined, which gives its waiting time later
+    Vehicle waiting = details;
+    waiting.entryTime = now;
+    waitingList.push(waiting, priority);
+    statistics.recordQueued(now);
+    if (isLogging()) {
+        logEvent("Vehicle added to waiting queue: " + regNumber);
     }
-    return true;
+    journalRecord(JournalRecordType::Queue, waiting, 0, priority);
+    reportGauges();
+    return ParkResult::Queued;
 }
 
-// Validates the vehicle color input
-bool isValidVehicleColor(const string& color) {
-    if (color.empty()) {
-        cout << RED << "Error: Vehicle color cannot be empty." << RESET << endl;
-        return false;
+// Parks a batch of vehicles in one pass
+void ParkingManagementSystem::importVehicles(const vector<Vehicle>& vehicles, ImportStats& stats) {
+    auto start = chrono::steady_clock::now();
+    time_t now = clock->now();
+    processAlerts(now);
+
+    // Vehicles already waiting come first, as in parkVehicle
+    admitFromWaitingList(now);
+    importing = true;
+
+    // The plate index is rebuilt from every plate at the end, the ones already parked included;
+    // those come from the slot table and the store, not from the index being replaced
+    deferPlateIndex = true;
+    deferredPlates.reserve(currentVehicles + min(vehicles.size(), static_cast<size_t>(capacity - currentVehicles)));
+    for (int slot = 0; slot < static_cast<int>(slots.size()); ++slot) {
+        if (slots[slot].occupied) {
+            deferredPlates.emplace_back(store.regNumber(slot), slot);
+        }
+    }
+
+    uint64_t parked = 0;
+    uint64_t queued = 0;
+    uint64_t duplicates = 0;
+    vector<pair<size_t, int>> batch; // Input position and bay (-1 if queued) of each imported vehicle
+    if (journal) {
+        batch.reserve(vehicles.size());
     }
-    for (char c : color) {
-        // Check for invalid characters (only letters and spaces allowed)
-        if (!isalpha(c) && c != ' ') {
-            cout << RED << "Error: Vehicle color can only contain letters and spaces." << RESET << endl;
-            return false;
+    for (size_t i = 0; i < vehicles.size(); ++i) {
+        const Vehicle& vehicle = vehicles[i];
+        if (vehicle.regNumber.empty()) {
+            stats.invalid++;
+            continue;
+        }
+        if (vehicleHash.find(vehicle.regNumber) != -1 || waitingList.find(vehicle.regNumber)) {
+            duplicates++;
+            continue;
+        }
+        time_t entryTime = vehicle.entryTime != 0 ? vehicle.entryTime : now;
+        int bay = waitingList.countNeeding(vehicle.bayType) == 0 ? assignBay(vehicle.bayType, vehicle.bay) : -1;
+        if (journal) {
+            batch.emplace_back(i, bay);
+        }
+        if (bay != -1) {
+            occupySlot(vehicle, entryTime, bay);
+            parked++;
+        }
+        else {
+            Vehicle waiting = vehicle;
+            waiting.entryTime = entryTime;
+            waitingList.push(waiting, WaitingPriority::Standard);
+            queued++;
         }
     }
-    // Ensure it doesn't start or end with spaces and doesn't exceed 30 characters
-    if (color.front() == ' ' || color.back() == ' ' || color.length() > 30) {
-        cout << RED << "Error: Vehicle color format is invalid." << RESET << endl;
-        return false;
+    buildDeferredPlateIndex();
+    importing = false;
+    stats.parked += parked;
+    stats.queued += queued;
+    stats.duplicates += duplicates;
+
+    statistics.setOccupancy(currentVehicles);
+    reportGauges();
+    logEvent("Imported vehicles: " + to_string(parked) + " parked, " + to_string(queued) + " queued, "
+        + to_string(duplicates) + " duplicates");
+
+    // One snapshot makes the whole batch durable instead of a journal record per vehicle;
+    // if it cannot be written, the batch goes to the journal after all
+    if (!batch.empty() && !checkpoint()) {
+        cout << "Error: Failed to write the import snapshot; the imported vehicles were journaled instead." << endl;
+        uint64_t generation = snapshotGeneration;
+        for (const pair<size_t, int>& entry : batch) {
+            if (snapshotGeneration != generation) break; // An automatic snapshot got through and holds the rest
+            Vehicle imported = vehicles[entry.first];
+            imported.entryTime = imported.entryTime != 0 ? imported.entryTime : now;
+            imported.bay = entry.second;
+            journalRecord(entry.second != -1 ? JournalRecordType::Park : JournalRecordType::Queue, imported, 0, WaitingPriority::Standard);
+        }
+        journal->flush();
     }
-    return true;
+    stats.seconds += chrono::duration<double>(chrono::steady_clock::now() - start).count();
 }
 
-// Validates the owner's contact number
-bool isValidOwnerContact(const string& contact) {
-    if (contact.empty()) {
-        cout << RED << "Error: Owner contact cannot be empty." << RESET << endl;
+// Removes a vehicle from the waiting list
+bool ParkingManagementSystem::cancelWaiting(const string& regNumber) {
+    METRIC_SCOPE(MetricOperation::CancelWaiting);
+    WaitingEntry cancelled;
+    if (!waitingList.remove(regNumber, cancelled)) {
         return false;
     }
-    if (contact.length() < 10 || contact.length() > 15 || !all_of(contact.begin(), contact.end(), ::isdigit)) {
-        // Validate length and ensure only digits
-        cout << RED << "Error: Owner contact must be 10-15 digits." << RESET << endl;
+    statistics.recordCancelled();
+    if (isLogging()) {
+        logEvent("Vehicle left waiting queue: " + regNumber);
+    }
+    journalRecord(JournalRecordType::Cancel, cancelled.vehicle);
+    admitFromWaitingList(clock->now());
+    reportGauges();
+    return true;
+}
+
+// Changes the priority of a waiting vehicle
+bool ParkingManagementSystem::promoteWaiting(const string& regNumber, WaitingPriority priority) {
+    if (!waitingList.setPriority(regNumber, priority)) {
         return false;
     }
+    Vehicle promoted;
+    promoted.regNumber = regNumber;
+    logEvent("Waiting priority changed: " + regNumber + ", " + waitingPriorityName(priority));
+    journalRecord(JournalRecordType::Promote, promoted, 0, priority);
+    admitFromWaitingList(clock->now());
+    reportGauges();
     return true;
 }
 
-// Handles parking a vehicle
-void ParkingManagementSystem::parkVehicle(const string& regNumber, const string& ownerName) {
-    string vehicleMake, vehicleModel, vehicleColor, ownerContact;
+// Returns true if a vehicle is in the waiting list
+bool ParkingManagementSystem::isWaiting(const string& regNumber) const {
+    return waitingList.find(regNumber) != nullptr;
+}
+
+// Returns the number of vehicles in the waiting list
+int ParkingManagementSystem::getWaitingCount() const {
+    return static_cast<int>(waitingList.size());
+}
+
+// Returns true if every slot is taken
+bool ParkingManagementSystem::isFull() const {
+    return currentVehicles >= capacity;
+}
+
+// Returns true if a vehicle needing a bay of 'type' would be parked rather than queued
+bool ParkingManagementSystem::canPark(BayType type) const {
+    return waitingList.countNeeding(type) == 0
+        && (bays.freeCount(type) > 0 || (type != BayType::Standard && bays.freeCount(BayType::Standard) > 0));
+}
+
+// Returns the bay layout and its free bays
+const BayAllocator& ParkingManagementSystem::getBays() const {
+    return bays;
+}
 
-    // Prompt and validate user input for vehicle details
-    cout << "Enter Vehicle Make: ";
-    cin >> vehicleMake;
-    while (!isValidVehicleMake(vehicleMake)) {
-        cout << "Invalid input. Please enter a valid Vehicle Make: ";
-        cin >> vehicleMake;
+// Picks a free bay for a vehicle and takes it
+int ParkingManagementSystem::assignBay(BayType type, int recordedBay) {
+    if (recordedBay >= 0 && recordedBay < capacity && bays.isFree(recordedBay)
+        && (bays.typeOf(recordedBay) == type || bays.typeOf(recordedBay) == BayType::Standard)) {
+        bays.take(recordedBay);
+        return recordedBay;
+    }
+    int bay = bays.allocate(type);
+    if (bay == -1 && type != BayType::Standard) {
+        bay = bays.allocate(BayType::Standard); // Any vehicle fits a standard bay
     }
+    return bay;
+}
 
-    cout << "Enter Vehicle Model: ";
-    cin >> vehicleModel;
-    while (!isValidVehicleModel(vehicleModel)) {
-        cout << "Invalid input. Please enter a valid Vehicle Model: ";
-        cin >> vehicleModel;
+// Places a vehicle into a bay taken by assignBay and updates all indexes
+void ParkingManagementSystem::occupySlot(const Vehicle& vehicle, time_t entryTime, int slot) {
+    // Link the slot at the head of the parking order
+    slots[slot] = ParkingSlot{ true, -1, newestSlot };
+    if (newestSlot != -1) {
+        slots[newestSlot].newer = slot;
     }
+    newestSlot = slot;
 
-    cout << "Enter Vehicle Color: ";
-    cin >> vehicleColor;
-    while (!isValidVehicleColor(vehicleColor)) {
-        cout << "Invalid input. Please enter a valid Vehicle Color: ";
-        cin >> vehicleColor;
+    // Store the single canonical copy of the vehicle and index its row
+    store.put(slot, vehicle, entryTime);
+    vehicleHash.insert(vehicle.regNumber, slot);
+    if (deferPlateIndex) {
+        deferredPlates.emplace_back(vehicle.regNumber, slot);
+    }
+    else {
+        plateIndex.insert(vehicle.regNumber, slot);
+    }
+    fuzzyIndex.add(slot, vehicle.regNumber);
+    makeIndex.add(slot, store.makeId(slot));
+    modelIndex.add(slot, store.modelId(slot));
+    colorIndex.add(slot, store.colorId(slot));
+    scheduleAlerts(slot, entryTime);
+    currentVehicles++;
+    if (isLogging()) {
+        logEvent("Parked vehicle: " + vehicle.regNumber + " " + vehicle.ownerName);
     }
+}
 
-    cout << "Enter Owner Contact Number: ";
-    cin >> ownerContact;
-    while (!isValidOwnerContact(ownerContact)) {
-        cout << "Invalid input. Please enter valid Owner Contact Details: ";
-        cin >> ownerContact;
+// Removes a parked vehicle from every structure and books its fee
+void ParkingManagementSystem::removeParkedVehicle(int slot, Cents fee) {
+    string regNumber = store.regNumber(slot);
+    totalRevenue += fee;
+    currentVehicles--;
+    vehicleHash.erase(regNumber);
+    plateIndex.erase(regNumber);
+    fuzzyIndex.remove(slot);
+    makeIndex.remove(slot);
+    modelIndex.remove(slot);
+    colorIndex.remove(slot);
+    cancelAlerts(slot);
+    releaseSlot(slot);
+    if (isLogging()) {
+        logEvent("Retrieved vehicle: " + regNumber + ", Fee: $" + formatCents(fee));
     }
+}
 
-    // Check if the vehicle is already parked
-    if (vehicleHash.find(regNumber) != vehicleHash.end()) {
-        cout << "\nError: Vehicle with registration number " << regNumber << " already exists in the parking lot.\n";
-        return;
+// Gives free bays to the waiting vehicles they suit, in waiting-list order
+// Every vehicle fits a standard bay, so a free one goes to the head of the list. A free
+// compact, EV or disabled bay goes to the first vehicle waiting for that kind of bay,
+// even if vehicles needing a standard bay wait ahead of it.
+void ParkingManagementSystem::admitFromWaitingList(time_t entryTime) {
+    while (!waitingList.empty()) {
+        const WaitingEntry* candidate = nullptr;
+        if (bays.freeCount(BayType::Standard) > 0) {
+            candidate = &waitingList.front();
+        }
+        else {
+            // Only walk the list if someone waits for a kind of bay that is free
+            bool anyFits = false;
+            for (int type = 1; type < BAY_TYPE_COUNT; ++type) {
+                anyFits = anyFits || (bays.freeCount(static_cast<BayType>(type)) > 0
+                    && waitingList.countNeeding(static_cast<BayType>(type)) > 0);
+            }
+            if (!anyFits) return;
+            candidate = waitingList.findFirst([this](const WaitingEntry& entry) {
+                return entry.vehicle.bayType != BayType::Standard && bays.freeCount(entry.vehicle.bayType) > 0;
+            });
+        }
+        if (!candidate) return;
+
+        int bay = assignBay(candidate->vehicle.bayType, -1);
+        string regNumber = candidate->vehicle.regNumber;
+        WaitingEntry next;
+        waitingList.remove(regNumber, next);
+        occupySlot(next.vehicle, entryTime, bay); // Parking time starts when the vehicle gets a slot
+        if (!recovering) {
+            statistics.recordAdmission(entryTime, currentVehicles, next.vehicle.entryTime);
+        }
+        if (journal) {
+            next.vehicle.entryTime = entryTime;
+            next.vehicle.bay = bay;
+            journalRecord(JournalRecordType::Admit, next.vehicle);
+        }
     }
+}
 
-    // Create a new vehicle instance
-    auto vehicle = make_shared<Vehicle>(regNumber, ownerName, vehicleMake, vehicleModel, vehicleColor, ownerContact);
+// Schedules the alerts of a vehicle that was just parked
+void ParkingManagementSystem::scheduleAlerts(int slot, time_t entryTime) {
+    const int minutes[3] = { alertPolicy.graceMinutes, alertPolicy.overstayMinutes, alertPolicy.maxStayMinutes };
+    for (int type = 0; type < 3; ++type) {
+        if (minutes[type] > 0) {
+            slotAlerts[slot][type] = alertTimers.schedule(entryTime + static_cast<time_t>(minutes[type]) * 60,
+                static_cast<uint32_t>(slot), static_cast<uint8_t>(type));
+        }
+    }
+}
 
-    if (currentVehicles < capacity) {
-        // If parking has space, park the vehicle
-        parkingStack.push(vehicle);
-        vehicleHash[regNumber] = vehicle;
-        insertToBST(vehicleBSTRoot, regNumber, ownerName, vehicleMake, vehicleModel, vehicleColor, ownerContact);
-        currentVehicles++;
-        logEvent("Parked vehicle: " + regNumber + " " + ownerName);
-        cout << "\nVehicle parked successfully.\n";
+// Cancels the alerts of a slot
+void ParkingManagementSystem::cancelAlerts(int slot) {
+    for (TimerId& timer : slotAlerts[slot]) {
+        if (timer != 0) {
+            alertTimers.cancel(timer);
+            timer = 0;
+        }
     }
-    else {
-        // If parking is full, add to the waiting queue
-        waitingQueue.push(vehicle);
-        logEvent("Vehicle added to waiting queue: " + regNumber);
-        cout << "\nParking is full. Vehicle added to waiting queue.\n";
+}
+
+// Raises the alert of a timer that came due
+void ParkingManagementSystem::raiseAlert(const TimerEvent& event) {
+    int slot = static_cast<int>(event.owner);
+    slotAlerts[slot][event.kind] = 0;
+    METRIC_COUNT(MetricCounter::AlertsRaised, 1);
+
+    ParkingAlert alert;
+    alert.type = static_cast<ParkingAlertType>(event.kind);
+    alert.regNumber = store.regNumber(slot);
+    alert.slot = slot;
+    alert.deadline = event.deadline;
+    alert.entryTime = store.entryTime(slot);
+    if (isLogging()) {
+        logEvent(string("Alert: ") + parkingAlertName(alert.type) + ", " + alert.regNumber);
+    }
+    if (alertHandler) {
+        alertHandler(alert);
+    }
+}
+
+// Raises every alert due by 'now'
+size_t ParkingManagementSystem::processAlerts(time_t now) {
+    // A handler that parks or retrieves vehicles must not start a second pass
+    if (processingAlerts) return 0;
+    METRIC_SCOPE(MetricOperation::ProcessAlerts);
+    processingAlerts = true;
+    size_t raised = alertTimers.advance(now, [this](const TimerEvent& event) { raiseAlert(event); });
+    processingAlerts = false;
+    if (raised > 0) {
+        reportGauges();
+    }
+    return raised;
+}
+
+// Adds the changes of the lot's levels since the last call to the metrics gauges
+// Each lot reports only its own changes, so several lots or shards add up to the total.
+void ParkingManagementSystem::reportGauges() {
+#if PARKING_METRICS
+    int64_t parked = currentVehicles;
+    int64_t waiting = waitingList.size();
+    int64_t alerts = static_cast<int64_t>(alertTimers.size());
+    if (parked != reportedParked) {
+        Metrics::add(MetricGauge::ParkedVehicles, parked - reportedParked);
+        reportedParked = parked;
+    }
+    if (waiting != reportedWaiting) {
+        Metrics::add(MetricGauge::WaitingVehicles, waiting - reportedWaiting);
+        reportedWaiting = waiting;
+    }
+    if (alerts != reportedAlerts) {
+        Metrics::add(MetricGauge::PendingAlerts, alerts - reportedAlerts);
+        reportedAlerts = alerts;
+    }
+#endif
+}
+
+// Sets the function called for every alert
+void ParkingManagementSystem::setAlertHandler(function<void(const ParkingAlert&)> handler) {
+    alertHandler = move(handler);
+}
+
+// Raises a permit-expiry alert for a parked vehicle
+bool ParkingManagementSystem::setPermitExpiry(const string& regNumber, time_t expiresAt) {
+    int slot = vehicleHash.find(regNumber);
+    if (slot == -1) {
+        return false;
+    }
+    TimerId& timer = slotAlerts[slot][static_cast<int>(ParkingAlertType::PermitExpiry)];
+    if (timer != 0) {
+        alertTimers.cancel(timer);
     }
+    timer = alertTimers.schedule(expiresAt, static_cast<uint32_t>(slot), static_cast<uint8_t>(ParkingAlertType::PermitExpiry));
+    reportGauges();
+    return true;
 }
 
+// Returns the number of alerts waiting to come due
+size_t ParkingManagementSystem::getPendingAlertCount() const {
+    return alertTimers.size();
+}
 
+// Frees a slot and unlinks it from the parking order
+void ParkingManagementSystem::releaseSlot(int slot) {
+    ParkingSlot& entry = slots[slot];
+    if (entry.newer != -1) {
+        slots[entry.newer].older = entry.older;
+    }
+    else {
+        newestSlot = entry.older;
+    }
+    if (entry.older != -1) {
+        slots[entry.older].newer = entry.newer;
+    }
+    entry = ParkingSlot{ false, -1, -1 };
+    store.clear(slot);
+    bays.release(slot);
+}
 
 // Function to retrieve a vehicle from the parking system
-void ParkingManagementSystem::retrieveVehicle(const string& regNumber) {
-    // Check if the vehicle exists in the hash map
-    if (vehicleHash.find(regNumber) == vehicleHash.end()) {
-        cout << "\nVehicle not found in the parking lot.\n";
-        return;
+RetrieveResult ParkingManagementSystem::retrieveVehicle(const string& regNumber, Cents& fee) {
+    METRIC_SCOPE(MetricOperation::Retrieve);
+    // Look up the slot directly through the hash map
+    int slot = vehicleHash.find(regNumber);
+    if (slot == -1) {
+        return RetrieveResult::NotFound;
     }
 
-    // Retrieve vehicle details for confirmation
-    Vehicle* vehicle = searchInBST(vehicleBSTRoot.get(), regNumber);
-
-    // Display vehicle details and request confirmation
-    cout << "\nPlease confirm the vehicle details before retrieval:\n";
-    struct tm localTimeStruct;
-    localtime_s(&localTimeStruct, &vehicle->entryTime);
-    cout << "\nVehicle found - Registration: " << vehicle->regNumber
-        << ", Owner: " << vehicle->ownerName
-        << ", Entry Time: " << std::put_time(&localTimeStruct, "%Y-%m-%d %H:%M:%S")
-        << "\nMake: " << vehicle->vehicleMake
-        << "\nModel: " << vehicle->vehicleModel
-        << "\nColor: " << vehicle->vehicleColor
-        << "\nOwner Contact: " << vehicle->ownerContact
-        << "\n\nDo you want to proceed with retrieving this vehicle? (y/n): ";
-
-    // User confirmation
-    char userConfirmation;
-    cin >> userConfirmation;
-
-    if (userConfirmation == 'y' || userConfirmation == 'Y') {
-        // Temporary stack to maintain parking stack order
-        stack<shared_ptr<Vehicle>> tempStack;
-        bool found = false;
-
-        // Search for the vehicle in the parking stack
-        while (!parkingStack.empty()) {
-            auto vehicle = parkingStack.top();
-            parkingStack.pop();
-
-            if (vehicle->regNumber == regNumber) {
-                // Calculate parking fee and update revenue
-                double fee = calculateFee(vehicle->entryTime);
-                totalRevenue += fee;
-                currentVehicles--;
-                vehicleHash.erase(regNumber);
-                logEvent("Retrieved vehicle: " + regNumber + ", Fee: $" + to_string(fee));
-                cout << "\nVehicle retrieved successfully. Parking fee: $" << fee << "\n";
-                found = true;
-                break;
-            }
+    // Calculate parking fee and update revenue
+    time_t exitTime = clock->now();
+    processAlerts(exitTime);
+    time_t entryTime = store.entryTime(slot);
+    fee = calculateFee(entryTime, exitTime);
+    if (archive) {
+        ParkingSession session;
+        session.regNumber = store.regNumber(slot);
+        session.ownerName = store.ownerName(slot);
+        session.vehicleMake = store.vehicleMake(slot);
+        session.vehicleModel = store.vehicleModel(slot);
+        session.vehicleColor = store.vehicleColor(slot);
+        session.entryTime = entryTime;
+        session.exitTime = exitTime;
+        session.fee = fee;
+        archive->append(session);
+    }
+    removeParkedVehicle(slot, fee);
+    statistics.recordDeparture(exitTime, currentVehicles, entryTime, fee);
+    if (journal) {
+        Vehicle retrieved;
+        retrieved.regNumber = regNumber;
+        journalRecord(JournalRecordType::Retrieve, retrieved, fee);
+    }
 
-            // Push non-matching vehicles into the temporary stack
-            tempStack.push(vehicle);
-        }
+    // Waiting vehicles take the freed bay without any interaction
+    admitFromWaitingList(exitTime);
+    reportGauges();
+    return RetrieveResult::Retrieved;
+}
 
-        // Restore vehicles to the original parking stack
-        while (!tempStack.empty()) {
-            parkingStack.push(tempStack.top());
-            tempStack.pop();
-        }
+// Copies the parked vehicle with the given registration number
+bool ParkingManagementSystem::findVehicle(const string& regNumber, Vehicle& vehicle) const {
+    METRIC_SCOPE(MetricOperation::Search);
+    int slot = vehicleHash.find(regNumber);
+    if (slot == -1) {
+        return false;
+    }
+    store.get(slot, vehicle);
+    return true;
+}
 
-        // Handle case where vehicle is not found
-        if (!found) {
-            cout << "\nVehicle not found in the parking lot.\n";
-        }
+// Returns true if a vehicle with the given registration number is parked
+bool ParkingManagementSystem::isParked(const string& regNumber) const {
+    return vehicleHash.find(regNumber) != -1;
+}
 
-        // Process waiting queue if a spot becomes available
-        if (!waitingQueue.empty() && currentVehicles < capacity) {
-            auto nextVehicle = waitingQueue.front();
-            waitingQueue.pop();
-            parkVehicle(nextVehicle->regNumber, nextVehicle->ownerName);
-        }
+// Collects parked vehicles whose registration number lies in [from, to]
+void ParkingManagementSystem::findVehiclesInRange(const string& from, const string& to, vector<Vehicle>& results) const {
+    plateIndex.forEachInRange(from, to, [&](const string&, int slot) {
+        results.emplace_back();
+        store.get(slot, results.back());
+        return true;
+    });
+}
+
+// Collects parked vehicles whose registration number starts with a prefix
+void ParkingManagementSystem::findVehiclesByPrefix(const string& prefix, vector<Vehicle>& results) const {
+    plateIndex.forEachWithPrefix(prefix, [&](const string&, int slot) {
+        results.emplace_back();
+        store.get(slot, results.back());
+        return true;
+    });
+}
+
+// Appends the console description of the vehicle in a slot to 'out'
+void ParkingManagementSystem::appendVehicleDetails(int slot, string& out) {
+    out += "Registration: ";
+    out += store.regNumber(slot);
+    out += ", Owner: ";
+    out += store.ownerName(slot);
+    out += ", Entry Time: ";
+    timestamps.append(store.entryTime(slot), out);
+    out += "\nBay: ";
+    bays.appendLabel(slot, out);
+    out += "\nMake: ";
+    out += store.vehicleMake(slot);
+    out += "\nModel: ";
+    out += store.vehicleModel(slot);
+    out += "\nColor: ";
+    out += store.vehicleColor(slot);
+    out += "\nOwner Contact: ";
+    store.appendOwnerContact(slot, out);
+}
+
+// Collects the parked vehicles most similar to a misread plate
+void ParkingManagementSystem::findSimilarPlates(const string& misread, size_t limit, vector<PlateMatch>& matches, int maxEdits) const {
+    METRIC_SCOPE(MetricOperation::FuzzySearch);
+    matches.clear();
+    fuzzyIndex.findWithin(misread, maxEdits, matches);
+
+    // Rank by the confusion-aware score, then by plain edits, then by plate
+    for (PlateMatch& match : matches) {
+        match.regNumber = store.regNumber(match.slot);
+        match.score = plateMatchScore(misread, match.regNumber);
+    }
+    auto better = [](const PlateMatch& a, const PlateMatch& b) {
+        if (a.score != b.score) return a.score < b.score;
+        if (a.edits != b.edits) return a.edits < b.edits;
+        return a.regNumber < b.regNumber;
+    };
+    if (matches.size() > limit) {
+        partial_sort(matches.begin(), matches.begin() + limit, matches.end(), better);
+        matches.resize(limit);
     }
     else {
-        // User cancelled the retrieval process
-        cout << "\nVehicle retrieval cancelled.\n";
+        sort(matches.begin(), matches.end(), better);
+    }
+}
+
+// Prints the parked plates most similar to a plate that was not found
+void ParkingManagementSystem::suggestSimilarPlates(const string& regNumber) const {
+    vector<PlateMatch> matches;
+    findSimilarPlates(regNumber, 5, matches);
+    if (matches.empty()) return;
+    cout << "Similar plates parked:";
+    for (const PlateMatch& match : matches) {
+        cout << " " << match.regNumber;
     }
+    cout << endl;
 }
 
 // Function to search for a vehicle by its registration number
 void ParkingManagementSystem::searchVehicle(const string& regNumber) {
-    Vehicle* vehicle = searchInBST(vehicleBSTRoot.get(), regNumber);
+    METRIC_SCOPE(MetricOperation::Search);
+    int slot = vehicleHash.find(regNumber);
 
-    if (vehicle) {
+    if (slot != -1) {
         // Display vehicle details if found
-        struct tm localTimeStruct;
-        localtime_s(&localTimeStruct, &vehicle->entryTime);
-        cout << "\nVehicle found - Registration: " << vehicle->regNumber
-            << ", Owner: " << vehicle->ownerName
-            << ", Entry Time: " << std::put_time(&localTimeStruct, "%Y-%m-%d %H:%M:%S")
-            << "\nMake: " << vehicle->vehicleMake
-            << "\nModel: " << vehicle->vehicleModel
-            << "\nColor: " << vehicle->vehicleColor
-            << "\nOwner Contact: " << vehicle->ownerContact << endl;
+        string details = "\nVehicle found - ";
+        appendVehicleDetails(slot, details);
+        cout << details << endl;
+    }
+    else if (const WaitingEntry* entry = waitingList.find(regNumber)) {
+        // Queued vehicles are found too, with their place in line
+        cout << "\nVehicle " << regNumber << " (Owner: " << entry->vehicle.ownerName << ") is waiting for a slot"
+            << "\nPosition in waiting queue: " << waitingList.positionOf(regNumber)
+            << "\nPriority: " << waitingPriorityName(entry->priority) << endl;
     }
     else {
         // Display a message if the vehicle is not found
@@ -314,16 +850,73 @@ void ParkingManagementSystem::searchVehicle(const string& regNumber) {
     }
 }
 
-// Function to perform an advanced search based on vehicle make and model
-void ParkingManagementSystem::advancedSearch(const string& make, const string& model) {
-    if (!vehicleBSTRoot) {
+// Collects parked vehicles matching every non-empty field of a filter
+void ParkingManagementSystem::filterVehicles(const VehicleFilter& filter, vector<Vehicle>& results) const {
+    vector<int> matching;
+    filterSlots(filter, matching);
+    for (int slot : matching) {
+        results.emplace_back();
+        store.get(slot, results.back());
+    }
+}
+
+// Collects the slots of parked vehicles matching every non-empty field of a filter
+void ParkingManagementSystem::filterSlots(const VehicleFilter& filter, vector<int>& results) const {
+    METRIC_SCOPE(MetricOperation::Filter);
+    // Resolve each requested value to its dictionary id and posting list
+    const AttributeIndex* indexes[3] = { &makeIndex, &modelIndex, &colorIndex };
+    const StringDictionary* dictionaries[3] = { &store.makeDictionary(), &store.modelDictionary(), &store.colorDictionary() };
+    const string* values[3] = { &filter.make, &filter.model, &filter.color };
+    const AttributeIndex* active[3];
+    int valueIds[3];
+    int activeCount = 0;
+
+    for (int i = 0; i < 3; ++i) {
+        if (values[i]->empty()) continue;
+        int valueId = dictionaries[i]->lookup(*values[i]);
+        if (valueId == -1) return; // No vehicle ever had this value
+        active[activeCount] = indexes[i];
+        valueIds[activeCount] = valueId;
+        activeCount++;
+    }
+
+    // Without predicates every parked vehicle matches
+    if (activeCount == 0) {
+        for (int slot = 0; slot < capacity; ++slot) {
+            if (slots[slot].occupied) results.push_back(slot);
+        }
+        return;
+    }
+
+    // Intersect by walking the shortest posting list and probing the others
+    int shortest = 0;
+    for (int i = 1; i < activeCount; ++i) {
+        if (active[i]->slotsWith(valueIds[i]).size() < active[shortest]->slotsWith(valueIds[shortest]).size()) {
+            shortest = i;
+        }
+    }
+    for (int slot : active[shortest]->slotsWith(valueIds[shortest])) {
+        bool match = true;
+        for (int i = 0; i < activeCount && match; ++i) {
+            if (i != shortest && !active[i]->slotHas(slot, valueIds[i])) match = false;
+        }
+        if (match) results.push_back(slot);
+    }
+}
+
+// Function to perform an advanced search based on vehicle make, model and color
+void ParkingManagementSystem::advancedSearch(const string& make, const string& model, const string& color) {
+    if (currentVehicles == 0) {
         cout << "\nNo vehicles in the system.\n";
         return;
     }
 
-    // Collect matching vehicles
-    vector<Vehicle*> results;
-    advancedSearchHelper(vehicleBSTRoot.get(), make, model, results);
+    // Collect matching slots and list them in plate order, reading the store in place
+    vector<int> results;
+    filterSlots(VehicleFilter{ make, model, color }, results);
+    sort(results.begin(), results.end(), [this](int a, int b) {
+        return store.regNumber(a) < store.regNumber(b);
+    });
 
     if (results.empty()) {
         // No matches found
@@ -331,142 +924,164 @@ void ParkingManagementSystem::advancedSearch(const string& make, const string& m
     }
     else {
         // Display matching vehicles
-        cout << "\nSearch Results:\n";
-        for (auto& vehicle : results) {
-            struct tm localTimeStruct;
-            localtime_s(&localTimeStruct, &vehicle->entryTime);
-            cout << "\nRegistration: " << vehicle->regNumber
-                << ", Owner: " << vehicle->ownerName
-                << ", Entry Time: " << std::put_time(&localTimeStruct, "%Y-%m-%d %H:%M:%S")
-                << "\nMake: " << vehicle->vehicleMake
-                << "\nModel: " << vehicle->vehicleModel
-                << "\nColor: " << vehicle->vehicleColor
-                << "\nOwner Contact: " << vehicle->ownerContact
-                << "\n";
+        string report = "\nSearch Results:\n";
+        for (int slot : results) {
+            report += "\n";
+            appendVehicleDetails(slot, report);
+            report += "\n";
         }
+        cout << report;
     }
 }
 
-// Helper function for advanced search (recursive traversal)
-void ParkingManagementSystem::advancedSearchHelper(Vehicle* root, const string& make, const string& model, vector<Vehicle*>& results) {
-    if (!root) return;
-
-    // Check if vehicle matches the filters
-    bool match = true;
-    if (!make.empty() && root->vehicleMake != make) match = false;
-    if (!model.empty() && root->vehicleModel != model) match = false;
-
-    if (match) {
-        results.push_back(root);
-    }
-
-    // Recursive traversal of left and right subtrees
-    advancedSearchHelper(root->left.get(), make, model, results);
-    advancedSearchHelper(root->right.get(), make, model, results);
-}
-
 // Function to display current parking status
 void ParkingManagementSystem::displayStatus() {
     cout << "Vehicles Parked: " << currentVehicles << "/" << capacity << "\n";
-    if (!waitingQueue.empty()) {
-        cout << "\nWaiting Queue: ";
-        queue<shared_ptr<Vehicle>> tempQueue = waitingQueue;
-        while (!tempQueue.empty()) {
-            cout << tempQueue.front()->regNumber << " ";
-            tempQueue.pop();
+    if (alertTimers.size() > 0) {
+        cout << "Pending Alerts: " << alertTimers.size() << "\n";
+    }
+    if (!waitingList.empty()) {
+        // Only the head of the list is walked, so a long event-day queue prints quickly
+        const size_t shown = 20;
+        cout << "\nWaiting Queue (" << waitingList.size() << "): ";
+        for (const WaitingEntry* entry : waitingList.firstEntries(shown)) {
+            cout << entry->vehicle.regNumber;
+            if (entry->priority != WaitingPriority::Standard) {
+                cout << " [" << waitingPriorityName(entry->priority) << "]";
+            }
+            cout << " ";
+        }
+        if (waitingList.size() > shown) {
+            cout << "... and " << waitingList.size() - shown << " more";
         }
         cout << "\n";
     }
 }
 
 // Function to display all parked vehicles
-void ParkingManagementSystem::displayAllParkedVehicles() {
-    if (parkingStack.empty()) {
+void ParkingManagementSystem::displayAllParkedVehicles(bool lifoOrder) {
+    if (currentVehicles == 0) {
         cout << "\nNo vehicles currently parked.\n";
         return;
     }
     displayStatus();
     cout << "\nList of Parked Vehicles:\n";
-    stack<shared_ptr<Vehicle>> tempStack = parkingStack;
-
-    while (!tempStack.empty()) {
-        auto vehicle = tempStack.top();
-        tempStack.pop();
 
-        struct tm localTimeStruct;
-        localtime_s(&localTimeStruct, &vehicle->entryTime);
-
-        cout << "\033[1;36mRegistration: " << vehicle->regNumber
-            << ", Owner: " << vehicle->ownerName
-            << ", Entry Time: " << std::put_time(&localTimeStruct, "%Y-%m-%d %H:%M:%S")
-            << "\nMake: " << vehicle->vehicleMake
-            << "\nModel: " << vehicle->vehicleModel
-            << "\nColor: " << vehicle->vehicleColor
-            << "\nOwner Contact: " << vehicle->ownerContact
-            << "\033[0m" << endl;
+    // Walk the parking order from the newest vehicle, or scan the slot table
+    // Lines collect in one buffer that goes out in large writes instead of a flush per vehicle.
+    const size_t flushBytes = 1 << 20;
+    string report;
+    report.reserve(flushBytes + 4096);
+    ParkedVehicleCursor cursor = openCursor(lifoOrder);
+    while (cursor.next()) {
+        report += "\033[1;36m";
+        appendVehicleDetails(cursor.slot(), report);
+        report += "\033[0m\n";
+        if (report.size() >= flushBytes) {
+            cout.write(report.data(), report.size());
+            report.clear();
+        }
     }
+    cout.write(report.data(), report.size());
+    cout.flush();
 }
 
-// Function to generate and display parking statistics
-void ParkingManagementSystem::generateStatistics() {
-    cout << "\nTotal revenue collected: $" << totalRevenue << "\n";
+// Creates a cursor positioned before the first vehicle
+ParkedVehicleCursor::ParkedVehicleCursor(const vector<ParkingSlot>& slotTable, const VehicleStore& vehicles, int first, bool lifo)
+    : slots(&slotTable), store(&vehicles), current(-1), upcoming(first), lifoOrder(lifo) {
 }
 
-// Error checks for registration number
-bool isValidRegNumber(const string& regNumber) {
-    // Various validation checks for registration number format
-    if (regNumber.length() < 3) {
-        cout << RED << "Error: Registration number must be at least 3 characters long." << RESET << endl;
-        return false;
-    }
-    if (regNumber.length() > 10) {
-        cout << RED << "Error: Registration number must not exceed 10 characters." << RESET << endl;
-        return false;
-    }
-    if (regNumber.front() == '0') {
-        cout << RED << "Error: Registration number cannot start with '0'." << RESET << endl;
-        return false;
-    }
-    for (char c : regNumber) {
-        if (!isalnum(c)) {
-            cout << RED << "Error: Registration number must be alphanumeric." << RESET << endl;
-            return false;
+// Moves to the next parked vehicle
+bool ParkedVehicleCursor::next() {
+    int slotCount = static_cast<int>(slots->size());
+    while (upcoming != -1 && upcoming < slotCount) {
+        int slot = upcoming;
+        upcoming = lifoOrder ? (*slots)[slot].older : slot + 1;
+        if ((*slots)[slot].occupied) {
+            current = slot;
+            return true;
         }
     }
-    if (regNumber.find(' ') != string::npos) {
-        cout << RED << "Error: Registration number cannot contain spaces." << RESET << endl;
-        return false;
-    }
-    return true;
+    current = -1;
+    return false;
 }
 
-// Error checks for owner name
-bool isValidOwnerName(const string& ownerName) {
-    // Various validation checks for owner name format
-    if (ownerName.empty()) {
-        cout << RED << "Error: Owner name cannot be empty." << RESET << endl;
-        return false;
-    }
-    for (char c : ownerName) {
-        if (!isalpha(c) && c != ' ') {
-            cout << RED << "Error: Owner name can only contain letters and spaces." << RESET << endl;
-            return false;
-        }
-    }
-    if (ownerName.front() == ' ' || ownerName.back() == ' ') {
-        cout << RED << "Error: Owner name cannot start or end with a space." << RESET << endl;
-        return false;
-    }
-    for (size_t i = 1; i < ownerName.length(); ++i) {
-        if (ownerName[i] == ' ' && ownerName[i - 1] == ' ') {
-            cout << RED << "Error: Owner name cannot have consecutive spaces." << RESET << endl;
-            return false;
-        }
+// Opens a cursor over the parked vehicles
+ParkedVehicleCursor ParkingManagementSystem::openCursor(bool lifoOrder) const {
+    return ParkedVehicleCursor(slots, store, lifoOrder ? newestSlot : 0, lifoOrder);
+}
+
+// Returns the current number of vehicles in the parking lot
+int ParkingManagementSystem::getCurrentVehicleCount() {
+    return currentVehicles;
+}
+
+// Returns the current time of the lot's clock
+time_t ParkingManagementSystem::currentTime() const {
+    return clock->now();
+}
+
+// Returns the total revenue collected so far
+Cents ParkingManagementSystem::getTotalRevenue() const {
+    return totalRevenue;
+}
+
+// Prices every slot as if its vehicle left at 'when'
+void ParkingManagementSystem::priceParkedVehicles(time_t when, vector<Cents>& fees) const {
+    // One pass over the whole entry time column, then blank out the free slots
+    fees.resize(capacity);
+    tariff.feeBatch(store.entryTimeColumn(), capacity, when, fees.data());
+    for (int slot = 0; slot < capacity; ++slot) {
+        if (!slots[slot].occupied) fees[slot] = 0;
     }
-    if (ownerName.length() > 100) {
-        cout << RED << "Error: Owner name must not exceed 100 characters." << RESET << endl;
-        return false;
+}
+
+// Returns what the parked vehicles would owe if they all left at 'when'
+Cents ParkingManagementSystem::getOutstandingFees(time_t when) const {
+    vector<Cents> fees;
+    priceParkedVehicles(when, fees);
+    Cents total = 0;
+    for (Cents fee : fees) {
+        total += fee;
     }
-    return true;
+    return total;
 }
 
+// Returns the tariff used to price stays
+const TariffEngine& ParkingManagementSystem::getTariff() const {
+    return tariff;
+}
+
+// Returns the running statistics
+const ParkingStatistics& ParkingManagementSystem::getStatistics() const {
+    return statistics;
+}
+
+// Computes a statistics snapshot
+StatisticsSnapshot ParkingManagementSystem::getStatisticsSnapshot(time_t now, int timelineMinutes) const {
+    StatisticsSnapshot stats = statistics.snapshot(now, getWaitingCount(), timelineMinutes);
+    stats.revenue = totalRevenue; // Includes revenue restored from the last run
+    return stats;
+}
+
+// Returns the history of completed sessions
+const SessionArchive* ParkingManagementSystem::getSessionArchive() const {
+    return archive.get();
+}
+
+// Returns the approximate number of bytes used by the vehicle store
+size_t ParkingManagementSystem::getStoreMemoryUsage() const {
+    return store.memoryUsage();
+}
+
+// Returns event logger counters
+LoggerStats ParkingManagementSystem::getLoggerStats() const {
+    return logger ? logger->getStats() : LoggerStats();
+}
+
+// Function to generate and display parking statistics
+void ParkingManagementSystem::generateStatistics() {
+    time_t now = clock->now();
+    printStatistics(getStatisticsSnapshot(now));
+    cout << "   Owed by parked cars:   $" << formatCents(getOutstandingFees(now)) << "\n";
+}
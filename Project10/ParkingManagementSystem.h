@@ -1,7 +1,6 @@
 #pragma once
 
 #include <iostream>
-#include <stack>
 #include <queue>
 #include <unordered_map>
 #include <string>
@@ -9,62 +8,301 @@
 #include <ctime>
 #include <iomanip>
 #include <fstream>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <array>
+#include <functional>
+#include "Vehicle.h"
+#include "PlateIndex.h"
+#include "PlateHashMap.h"
+#include "FuzzyPlateIndex.h"
+#include "AttributeIndex.h"
+#include "VehicleStore.h"
+#include "EventLogger.h"
+#include "ParkingJournal.h"
+#include "WaitingList.h"
+#include "Tariff.h"
+#include "ParkingStatistics.h"
+#include "Validation.h"
+#include "TimerWheel.h"
+#include "TimestampFormatter.h"
+#include "SessionArchive.h"
+#include "ParkingClock.h"
+#include "BayAllocator.h"
 
 using namespace std;
 
-// Structure to represent a vehicle node in the Binary Search Tree (BST)
-struct Vehicle {
-    string regNumber;        // Vehicle registration number
-    string ownerName;        // Name of the vehicle owner
-    string vehicleMake;      // Make of the vehicle (e.g., Toyota, Honda)
-    string vehicleModel;     // Model of the vehicle (e.g., Corolla, Civic)
-    string vehicleColor;     // Color of the vehicle
-    string ownerContact;     // Contact number of the owner
-    time_t entryTime;        // Timestamp when the vehicle was parked
-    unique_ptr<Vehicle> left; // Pointer to the left child node in the BST
-    unique_ptr<Vehicle> right; // Pointer to the right child node in the BST
-
-    // Constructor to initialize a Vehicle instance
-    Vehicle(string reg, string owner, string make, string model, string color, string contact);
+// Result codes returned by the parking API
+enum class ParkResult {
+    Parked,         // Vehicle was given a slot in the parking lot
+    Queued,         // Parking is full, vehicle was added to the waiting list
+    AlreadyParked,  // A vehicle with the same registration number is already parked
+    AlreadyWaiting  // A vehicle with the same registration number is already in the waiting list
+};
+
+// Result codes returned when retrieving a vehicle
+enum class RetrieveResult {
+    Retrieved,      // Vehicle left the parking lot and the fee was charged
+    NotFound        // No parked vehicle has the given registration number
+};
+
+// Kinds of alerts raised for parked vehicles
+enum class ParkingAlertType : uint8_t {
+    GracePeriodEnd = 0,   // The free grace period of the tariff is over
+    Overstay = 1,         // The stay passed the overstay limit
+    TowWarning = 2,       // The stay passed the maximum stay; the vehicle may be towed
+    PermitExpiry = 3      // The permit the vehicle parks on has expired
+};
+
+// Returns the display name of an alert type
+const char* parkingAlertName(ParkingAlertType type);
+
+// An alert raised for a parked vehicle
+struct ParkingAlert {
+    ParkingAlertType type;   // What happened
+    string regNumber;        // Registration number of the vehicle
+    int slot;                // Slot the vehicle is parked in
+    time_t deadline;         // Time the alert was due
+    time_t entryTime;        // Time the vehicle was parked
+};
+
+// When alerts are raised, in minutes after the vehicle was parked (0 disables an alert)
+struct AlertPolicy {
+    int graceMinutes = -1;     // End of the grace period (-1 uses the tariff's grace minutes)
+    int overstayMinutes = 0;   // Overstay limit
+    int maxStayMinutes = 0;    // Maximum stay before a tow warning
+};
+
+// Optional settings for the parking system
+struct ParkingConfig {
+    LoggerOptions logging;                          // Event log settings (an empty path disables logging)
+    string journalPath = "parking_Journal.bin";     // Binary journal of state changes (empty disables persistence)
+    string snapshotPath = "parking_Snapshot.bin";   // Full state snapshot loaded at startup
+    bool journalFlushEveryEvent = true;             // Flush the journal after every state change
+    uint64_t snapshotEveryEvents = 100000;          // Journal records between automatic snapshots (0 disables)
+    bool readOnly = false;                          // Recover the saved state but never write the log, journal, snapshot or archive
+    string archivePath = "parking_Archive.bin";     // Compressed history of completed sessions (empty disables)
+    size_t archiveBlockSessions = 65536;            // Sessions per compressed archive block
+    TariffTable tariff;                             // Rate table used to price stays
+    AlertPolicy alerts;                             // Per-vehicle deadlines that raise alerts
+    shared_ptr<ParkingClock> clock;                 // Source of the current time (empty uses the wall clock)
+    vector<BayGroup> bays;                          // Bays by level and type (empty: 'cap' standard bays on level 0; else sets the capacity)
+};
+
+// Counters of a bulk import
+struct ImportStats {
+    uint64_t parked = 0;       // Vehicles given a slot
+    uint64_t queued = 0;       // Vehicles that found the lot full and joined the waiting list
+    uint64_t duplicates = 0;   // Records whose plate was already parked, waiting or imported
+    uint64_t invalid = 0;      // Records rejected by the reader (bad fields or a broken line)
+    double seconds = 0;        // Wall time of the import
+};
+
+// Filter for searching parked vehicles; empty fields match any value
+struct VehicleFilter {
+    string make;    // Required vehicle make
+    string model;   // Required vehicle model
+    string color;   // Required vehicle color
+};
+
+// A slot in the parking lot; occupied slots are linked in parking order
+// The vehicle itself lives in the VehicleStore row with the same index.
+struct ParkingSlot {
+    bool occupied;               // True if a vehicle is parked in the slot
+    int newer;                   // Slot of the vehicle parked right after this one (-1 if none)
+    int older;                   // Slot of the vehicle parked right before this one (-1 if none)
+};
+
+// Forward-only cursor over the parked vehicles that reads the vehicle store in place
+// Nothing is copied: the fields are references into the store, valid until the lot changes.
+class ParkedVehicleCursor {
+private:
+    const vector<ParkingSlot>* slots;   // Slot table of the lot
+    const VehicleStore* store;          // Vehicle rows of the lot
+    int current;                        // Slot of the current vehicle (-1 before the first / after the last)
+    int upcoming;                       // Slot to look at next (-1 when the parking order is exhausted)
+    bool lifoOrder;                     // Walk the parking order from the newest vehicle instead of the slot table
+
+public:
+    // Creates a cursor positioned before the first vehicle
+    ParkedVehicleCursor(const vector<ParkingSlot>& slots, const VehicleStore& store, int first, bool lifoOrder);
+
+    // Moves to the next parked vehicle; returns false when there is none
+    bool next();
+
+    // Fields of the current vehicle
+    int slot() const { return current; }
+    const string& regNumber() const { return store->regNumber(current); }
+    const string& ownerName() const { return store->ownerName(current); }
+    const string& vehicleMake() const { return store->vehicleMake(current); }
+    const string& vehicleModel() const { return store->vehicleModel(current); }
+    const string& vehicleColor() const { return store->vehicleColor(current); }
+    time_t entryTime() const { return store->entryTime(current); }
+    BayType bayType() const { return static_cast<BayType>(store->bayType(current)); }
+
+    // Appends the owner contact of the current vehicle to 'out'
+    void appendOwnerContact(string& out) const { store->appendOwnerContact(current, out); }
 };
 
 // Class to manage the parking system
 class ParkingManagementSystem {
 private:
-    stack<shared_ptr<Vehicle>> parkingStack;  // Stack to represent vehicles in the parking lot
-    queue<shared_ptr<Vehicle>> waitingQueue;  // Queue to manage vehicles waiting for a parking slot
-    unordered_map<string, shared_ptr<Vehicle>> vehicleHash; // Hash map for fast lookup by registration number
-    unique_ptr<Vehicle> vehicleBSTRoot;       // Root of the BST for storing vehicle data
+    vector<ParkingSlot> slots;                // Slot table representing the parking lot
+    VehicleStore store;                       // Columnar storage of parked vehicles, one row per slot
+    BayAllocator bays;                        // Free bays of each type; bay numbers are slot indexes
+    int newestSlot;                           // Slot of the most recently parked vehicle (-1 if empty)
+    WaitingList waitingList;                  // Vehicles waiting for a slot, by priority then arrival
+    PlateHashMap vehicleHash;                 // Hash map from registration number to slot index
+    PlateIndex plateIndex;                    // Ordered index from registration number to slot index
+    FuzzyPlateIndex fuzzyIndex;               // Approximate index for misread registration numbers
+    AttributeIndex makeIndex;                 // Posting lists of slots per vehicle make
+    AttributeIndex modelIndex;                // Posting lists of slots per vehicle model
+    AttributeIndex colorIndex;                // Posting lists of slots per vehicle color
     int capacity;                             // Maximum parking capacity
     int currentVehicles;                      // Current number of vehicles in the parking lot
-    double parkingRate;                       // Parking rate per hour
-    double totalRevenue;                      // Total revenue generated
-    ofstream logFile;                         // Log file to record parking events
+    TariffEngine tariff;                      // Compiled rate table used to price stays
+    Cents totalRevenue;                       // Total revenue generated, in cents
+    ParkingStatistics statistics;             // Running occupancy, rate and duration statistics
+    shared_ptr<ParkingClock> clock;           // Source of every time stamp the lot takes
+    TimerWheel alertTimers;                   // Pending alerts of parked vehicles (timer owner = slot)
+    vector<array<TimerId, 4>> slotAlerts;     // Timer of each alert type per slot (0 if none)
+    AlertPolicy alertPolicy;                  // When alerts are raised
+    function<void(const ParkingAlert&)> alertHandler; // Called for every alert raised
+    bool processingAlerts;                    // True while alerts are being raised
+    TimestampFormatter timestamps;            // Entry time text for the console listings
+    unique_ptr<EventLogger> logger;           // Asynchronous logger recording parking events
+    unique_ptr<ParkingJournal> journal;       // Journal of state changes for crash recovery
+    unique_ptr<SessionArchive> archive;       // History of completed sessions
+    string snapshotPath;                      // Where checkpoints write the full state
+    uint64_t snapshotEveryEvents;             // Journal records between automatic snapshots
+    uint64_t snapshotGeneration;              // Generation of the latest snapshot
+    bool recovering;                          // True while replaying the snapshot and journal
+    bool importing;                           // True while a bulk import runs (no per-vehicle log lines)
+    bool deferPlateIndex;                     // True while a bulk load collects plates for a one-pass index build
+    vector<pair<string, int>> deferredPlates; // Plates collected while the plate index build is deferred
+    int64_t reportedParked;                   // Parked vehicles last added to the metrics gauge
+    int64_t reportedWaiting;                  // Waiting vehicles last added to the metrics gauge
+    int64_t reportedAlerts;                   // Pending alerts last added to the metrics gauge
 
     // Logs events to a file for tracking system activity
     void logEvent(const string& event);
 
-    // Calculates the parking fee based on the entry time
-    double calculateFee(time_t entryTime);
+    // Returns true if logged events are written right now; hot paths check it before building the text
+    bool isLogging() const;
+
+    // Calculates the parking fee of a stay from 'entryTime' until 'exitTime'
+    Cents calculateFee(time_t entryTime, time_t exitTime) const;
+
+    // Picks a free bay for a vehicle: 'recordedBay' if it is still free and suits the vehicle,
+    // else the lowest free bay of the vehicle's type, else the lowest free standard bay for
+    // a compact, EV or disabled vehicle; returns -1 (taking nothing) if none fits
+    int assignBay(BayType type, int recordedBay);
+
+    // Places a vehicle into a bay taken by assignBay and updates all indexes
+    void occupySlot(const Vehicle& vehicle, time_t entryTime, int slot);
+
+    // Frees a slot and unlinks it from the parking order
+    void releaseSlot(int slot);
+
+    // Removes a parked vehicle from every structure and books its fee
+    void removeParkedVehicle(int slot, Cents fee);
+
+    // Gives free bays to the waiting vehicles they suit, in waiting-list order
+    void admitFromWaitingList(time_t entryTime);
+
+    // Appends a state change to the journal and snapshots when it grows too long
+    void journalRecord(JournalRecordType type, const Vehicle& vehicle, Cents fee = 0,
+        WaitingPriority priority = WaitingPriority::Standard);
+
+    // Applies one journal record during recovery
+    void applyJournalRecord(const JournalRecord& record);
+
+    // Loads the latest snapshot and replays the journal tail
+    void recoverState(const ParkingConfig& config);
 
-    // Inserts a vehicle into the BST
-    void insertToBST(unique_ptr<Vehicle>& root, const string& regNumber, const string& ownerName, string& make, string& model, string& color, string& contact);
+    // Builds the plate index in one pass from the plates collected during a bulk load
+    void buildDeferredPlateIndex();
 
-    // Searches for a vehicle in the BST by its registration number
-    Vehicle* searchInBST(Vehicle* root, const string& regNumber);
+    // Schedules the alerts of a vehicle that was just parked / cancels the alerts of a slot
+    void scheduleAlerts(int slot, time_t entryTime);
+    void cancelAlerts(int slot);
+
+    // Raises the alert of a timer that came due
+    void raiseAlert(const TimerEvent& event);
+
+    // Appends the console description of the vehicle in a slot to 'out'
+    void appendVehicleDetails(int slot, string& out);
+
+    // Adds the changes of the lot's levels since the last call to the metrics gauges
+    void reportGauges();
 
 public:
-    // Constructor to initialize the parking system with capacity and rate
-    ParkingManagementSystem(int cap, double rate);
+    // Constructor to initialize the parking system with capacity and hourly rate in dollars
+    // The rate fills in the hourly rate of the config's tariff unless that one is set.
+    ParkingManagementSystem(int cap, double rate, const ParkingConfig& config = ParkingConfig());
 
     // Destructor to clean up resources
     ~ParkingManagementSystem();
 
-    // Parks a vehicle in the system
-    void parkVehicle(const string& regNumber, const string& ownerName);
+    // Parks a vehicle using the full vehicle record (no console interaction)
+    // The vehicle gets the lowest free bay of its bayType (compact, EV and disabled vehicles
+    // may also take a standard bay). When none is free, or vehicles already wait for that
+    // kind of bay, it joins the waiting list with the given priority.
+    ParkResult parkVehicle(const Vehicle& vehicle, WaitingPriority priority = WaitingPriority::Standard);
+
+    // Parks a batch of vehicles in one pass, e.g. when a lot is brought online or re-synced
+    // Vehicles keep their entry time (0 means now); those that do not fit join the waiting
+    // list. The plate index is built once from the sorted plates instead of per vehicle,
+    // one summary event is logged and a checkpoint replaces the per-vehicle journal records.
+    // Adds to the counters in 'stats'.
+    void importVehicles(const vector<Vehicle>& vehicles, ImportStats& stats);
+
+    // Removes a vehicle from the waiting list; returns false if it is not waiting
+    bool cancelWaiting(const string& regNumber);
+
+    // Changes the priority of a waiting vehicle; returns false if it is not waiting
+    bool promoteWaiting(const string& regNumber, WaitingPriority priority);
+
+    // Returns true if a vehicle with the given registration number is in the waiting list
+    bool isWaiting(const string& regNumber) const;
+
+    // Returns the number of vehicles in the waiting list
+    int getWaitingCount() const;
+
+    // Returns true if every slot is taken
+    bool isFull() const;
+
+    // Returns true if a vehicle needing a bay of 'type' would be parked rather than queued
+    bool canPark(BayType type) const;
+
+    // Returns the bay layout and its free bays
+    const BayAllocator& getBays() const;
+
+    // Retrieves a vehicle from the parking lot, storing the charged fee in 'fee' (cents)
+    RetrieveResult retrieveVehicle(const string& regNumber, Cents& fee);
+
+    // Copies the parked vehicle with the given registration number into 'vehicle'; returns false if not parked
+    bool findVehicle(const string& regNumber, Vehicle& vehicle) const;
+
+    // Returns true if a vehicle with the given registration number is parked
+    bool isParked(const string& regNumber) const;
+
+    // Collects parked vehicles whose registration number lies in [from, to], in plate order
+    void findVehiclesInRange(const string& from, const string& to, vector<Vehicle>& results) const;
+
+    // Collects parked vehicles whose registration number starts with a prefix, in plate order
+    void findVehiclesByPrefix(const string& prefix, vector<Vehicle>& results) const;
+
+    // Opens a cursor over the parked vehicles (most recently parked first, or in slot order)
+    ParkedVehicleCursor openCursor(bool lifoOrder = true) const;
 
-    // Retrieves a vehicle from the parking lot
-    void retrieveVehicle(const string& regNumber);
+    // Collects up to 'limit' parked vehicles whose plate is within 'maxEdits' edits of a
+    // misread plate, best match first (confusable characters such as O/0 count as equal)
+    void findSimilarPlates(const string& misread, size_t limit, vector<PlateMatch>& matches, int maxEdits = 2) const;
+
+    // Prints the parked plates most similar to a plate that was not found
+    void suggestSimilarPlates(const string& regNumber) const;
 
     // Searches for a vehicle by its registration number
     void searchVehicle(const string& regNumber);
@@ -72,8 +310,8 @@ public:
     // Displays the current status of the parking lot
     void displayStatus();
 
-    // Displays all parked vehicles in the system
-    void displayAllParkedVehicles();
+    // Displays all parked vehicles (most recently parked first, or in slot order)
+    void displayAllParkedVehicles(bool lifoOrder = true);
 
     // Generates statistics such as total revenue and vehicle count
     void generateStatistics();
@@ -81,15 +319,58 @@ public:
     // Returns the current number of vehicles in the parking lot
     int getCurrentVehicleCount();
 
-    // Performs an advanced search for vehicles based on make and model
-    void advancedSearch(const string& make, const string& model);
+    // Returns the current time of the lot's clock
+    time_t currentTime() const;
 
-    // Helper function for advanced search (traverses the BST)
-    void advancedSearchHelper(Vehicle* root, const string& make, const string& model, vector<Vehicle*>& results);
-};
+    // Returns the total revenue collected so far, in cents
+    Cents getTotalRevenue() const;
+
+    // Prices every slot as if its vehicle left at 'when' (free slots get 0); fees[slot] is in cents
+    void priceParkedVehicles(time_t when, vector<Cents>& fees) const;
+
+    // Returns what the parked vehicles would owe together if they all left at 'when'
+    Cents getOutstandingFees(time_t when) const;
+
+    // Returns the tariff used to price stays
+    const TariffEngine& getTariff() const;
+
+    // Returns the running statistics (for merging several lots)
+    const ParkingStatistics& getStatistics() const;
+
+    // Computes a statistics snapshot at 'now' with the last 'timelineMinutes' minutes of activity
+    StatisticsSnapshot getStatisticsSnapshot(time_t now, int timelineMinutes = 60) const;
+
+    // Raises every alert due by 'now'; returns the number raised
+    // Parking and retrieving call this as well, so a busy lot needs no separate ticker.
+    size_t processAlerts(time_t now);
+
+    // Sets the function called for every alert (alerts are always logged)
+    void setAlertHandler(function<void(const ParkingAlert&)> handler);
 
-// Validates the format of a registration number
-bool isValidRegNumber(const string& regNumber);
+    // Raises a permit-expiry alert for a parked vehicle at 'expiresAt'; returns false if it is not parked
+    bool setPermitExpiry(const string& regNumber, time_t expiresAt);
 
-// Validates the format of an owner's name
-bool isValidOwnerName(const string& ownerName);
+    // Returns the number of alerts waiting to come due
+    size_t getPendingAlertCount() const;
+
+    // Returns the history of completed sessions (nullptr when archiving is disabled)
+    const SessionArchive* getSessionArchive() const;
+
+    // Returns the approximate number of bytes used by the vehicle store
+    size_t getStoreMemoryUsage() const;
+
+    // Returns event logger counters (all zero when logging is disabled)
+    LoggerStats getLoggerStats() const;
+
+    // Writes a snapshot of the full state and starts a new, empty journal
+    bool checkpoint();
+
+    // Collects parked vehicles matching every non-empty field of a filter
+    void filterVehicles(const VehicleFilter& filter, vector<Vehicle>& results) const;
+
+    // Collects the slots of parked vehicles matching every non-empty field of a filter
+    void filterSlots(const VehicleFilter& filter, vector<int>& results) const;
+
+    // Performs an advanced search for vehicles based on make, model and color
+    void advancedSearch(const string& make, const string& model, const string& color = "");
+};
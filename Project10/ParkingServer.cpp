@@ -0,0 +1,464 @@
+#include "ParkingServer.h"
+#include "BatchReplay.h"
+#include "Metrics.h"
+#include <csignal>
+#include <cstring>
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <unistd.h>
+#elif !defined(_WIN32)
+#include <poll.h>
+#endif
+
+// Set by requestServerStop(); checked by the event loop
+static volatile sig_atomic_t stopRequested = 0;
+
+// Asks a running server to stop
+void requestServerStop() {
+    stopRequested = 1;
+}
+
+// Signal handler for Ctrl+C
+static void onStopSignal(int) {
+    requestServerStop();
+}
+
+// A socket that became ready
+struct ReadyEvent {
+    SocketHandle socket;   // Socket the event is for
+    bool readable;         // Data (or a new connection) is waiting
+    bool writable;         // Send buffer has room
+    bool failed;           // Error or hang-up
+};
+
+// Waits for readiness of many sockets (epoll on Linux, poll elsewhere)
+class EventPoller {
+private:
+#ifdef __linux__
+    int epollHandle;                           // epoll instance
+    vector<epoll_event> ready;                 // Events returned by one wait
+#else
+#ifdef _WIN32
+    typedef WSAPOLLFD PollEntry;
+#else
+    typedef pollfd PollEntry;
+#endif
+    vector<PollEntry> entries;                 // Watched sockets
+    unordered_map<SocketHandle, size_t> positions; // Socket -> index in 'entries'
+#endif
+
+public:
+    EventPoller() {
+#ifdef __linux__
+        epollHandle = epoll_create1(0);
+        ready.resize(256);
+#endif
+    }
+
+    ~EventPoller() {
+#ifdef __linux__
+        if (epollHandle != -1) close(epollHandle);
+#endif
+    }
+
+    // Returns true if the poller could be created
+    bool valid() const {
+#ifdef __linux__
+        return epollHandle != -1;
+#else
+        return true;
+#endif
+    }
+
+    // Starts watching a socket
+    void add(SocketHandle socket, bool read, bool write) {
+#ifdef __linux__
+        epoll_event event{};
+        event.events = (read ? uint32_t(EPOLLIN) : 0u) | (write ? uint32_t(EPOLLOUT) : 0u);
+        event.data.fd = socket;
+        epoll_ctl(epollHandle, EPOLL_CTL_ADD, socket, &event);
+#else
+        PollEntry entry{};
+        entry.fd = socket;
+        entry.events = static_cast<short>((read ? POLLIN : 0) | (write ? POLLOUT : 0));
+        positions[socket] = entries.size();
+        entries.push_back(entry);
+#endif
+    }
+
+    // Changes the readiness a socket is watched for
+    void modify(SocketHandle socket, bool read, bool write) {
+#ifdef __linux__
+        epoll_event event{};
+        event.events = (read ? uint32_t(EPOLLIN) : 0u) | (write ? uint32_t(EPOLLOUT) : 0u);
+        event.data.fd = socket;
+        epoll_ctl(epollHandle, EPOLL_CTL_MOD, socket, &event);
+#else
+        entries[positions[socket]].events = static_cast<short>((read ? POLLIN : 0) | (write ? POLLOUT : 0));
+#endif
+    }
+
+    // Stops watching a socket
+    void remove(SocketHandle socket) {
+#ifdef __linux__
+        epoll_ctl(epollHandle, EPOLL_CTL_DEL, socket, nullptr);
+#else
+        auto it = positions.find(socket);
+        if (it == positions.end()) return;
+        size_t index = it->second;
+        positions.erase(it);
+        if (index + 1 != entries.size()) {
+            entries[index] = entries.back();
+            positions[entries[index].fd] = index;
+        }
+        entries.pop_back();
+#endif
+    }
+
+    // Waits up to 'timeoutMs' for ready sockets
+    void wait(int timeoutMs, vector<ReadyEvent>& events) {
+        events.clear();
+#ifdef __linux__
+        int count = epoll_wait(epollHandle, ready.data(), static_cast<int>(ready.size()), timeoutMs);
+        for (int i = 0; i < count; ++i) {
+            uint32_t flags = ready[i].events;
+            events.push_back(ReadyEvent{ ready[i].data.fd, (flags & EPOLLIN) != 0, (flags & EPOLLOUT) != 0,
+                (flags & (EPOLLERR | EPOLLHUP)) != 0 });
+        }
+        if (count == static_cast<int>(ready.size())) {
+            ready.resize(ready.size() * 2); // Busy server: take more events per wait next time
+        }
+#else
+#ifdef _WIN32
+        int count = WSAPoll(entries.data(), static_cast<ULONG>(entries.size()), timeoutMs);
+#else
+        int count = poll(entries.data(), static_cast<nfds_t>(entries.size()), timeoutMs);
+#endif
+        for (size_t i = 0; i < entries.size() && count > 0; ++i) {
+            short flags = entries[i].revents;
+            if (flags == 0) continue;
+            events.push_back(ReadyEvent{ entries[i].fd, (flags & POLLIN) != 0, (flags & POLLOUT) != 0,
+                (flags & (POLLERR | POLLHUP | POLLNVAL)) != 0 });
+            count--;
+        }
+#endif
+    }
+};
+
+// Parses the options that follow --serve
+bool parseServerOptions(int argc, char* argv[], int first, ServerOptions& options, string& error) {
+    for (int i = first; i < argc; ++i) {
+        string option = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (option == "--host" && hasValue) {
+            options.address.host = argv[++i];
+        }
+        else if (option == "--port" && hasValue) {
+            options.address.port = atoi(argv[++i]);
+        }
+        else if (option == "--unix" && hasValue) {
+            options.address.unixPath = argv[++i];
+        }
+        else if (option == "--capacity" && hasValue) {
+            options.capacity = atoi(argv[++i]);
+        }
+        else if (option == "--rate" && hasValue) {
+            options.rate = atof(argv[++i]);
+        }
+        else if (option == "--no-journal") {
+            options.journal = false;
+        }
+        else if (option == "--metrics" && hasValue) {
+            options.metricsPrefix = argv[++i];
+        }
+        else if (option == "--metrics-interval" && hasValue) {
+            options.metricsIntervalMs = static_cast<int>(atof(argv[++i]) * 1000);
+        }
+        else if (option == "--trace" && hasValue) {
+            options.tracePath = argv[++i];
+        }
+        else {
+            error = "Unknown option " + option;
+            return false;
+        }
+    }
+    if (options.capacity <= 0 || options.address.port <= 0 || options.address.port > 65535) {
+        error = "Capacity and port must be positive (port at most 65535)";
+        return false;
+    }
+    if (options.metricsIntervalMs <= 0) {
+        error = "Metrics interval must be positive";
+        return false;
+    }
+    return true;
+}
+
+// Creates a server for a lot engine
+ParkingServer::ParkingServer(ParkingManagementSystem& lot, const ServerOptions& settings)
+    : system(lot), options(settings), listener(INVALID_SOCKET_HANDLE), poller(new EventPoller()) {
+}
+
+// Closes every socket
+ParkingServer::~ParkingServer() {
+    for (auto& entry : connections) {
+        closeSocket(entry.first);
+    }
+    if (listener != INVALID_SOCKET_HANDLE) {
+        closeSocket(listener);
+    }
+}
+
+// Opens the listening socket
+bool ParkingServer::start(string& error) {
+    if (!initSockets()) {
+        error = "Cannot start the socket library";
+        return false;
+    }
+    if (!poller->valid()) {
+        error = "Cannot create the event poller";
+        return false;
+    }
+    listener = listenOn(options.address, error);
+    if (listener == INVALID_SOCKET_HANDLE) {
+        return false;
+    }
+    poller->add(listener, true, false);
+    return true;
+}
+
+// Serves requests until stopped
+void ParkingServer::run() {
+    stopRequested = 0;
+    signal(SIGINT, onStopSignal);
+    signal(SIGTERM, onStopSignal);
+
+    vector<ReadyEvent> events;
+    time_t lastTick = 0;
+    while (!stopRequested) {
+        poller->wait(250, events);
+        if (!events.empty()) stats.wakeups++;
+
+        for (const ReadyEvent& event : events) {
+            if (event.socket == listener) {
+                acceptClients();
+                continue;
+            }
+            auto it = connections.find(event.socket);
+            if (it == connections.end()) continue;
+            Connection& connection = it->second;
+
+            if (event.readable || event.failed) {
+                readFrom(event.socket, connection);
+            }
+            if (!flushTo(event.socket, connection) || (connection.closing && connection.output.empty())) {
+                closeConnection(event.socket);
+                continue;
+            }
+            updateInterest(event.socket, connection);
+        }
+
+        // The server is the lot's clock while no gate is busy
+        time_t now = system.currentTime();
+        if (now != lastTick) {
+            system.processAlerts(now);
+            lastTick = now;
+        }
+    }
+}
+
+// Accepts every pending connection
+void ParkingServer::acceptClients() {
+    for (;;) {
+        SocketHandle socket = acceptConnection(listener);
+        if (socket == INVALID_SOCKET_HANDLE) break;
+        connections[socket] = Connection();
+        poller->add(socket, true, false);
+        stats.connectionsAccepted++;
+    }
+}
+
+// Reads what a client sent and answers every complete request
+void ParkingServer::readFrom(SocketHandle socket, Connection& connection) {
+    char buffer[65536];
+    while (!connection.closing && connection.output.size() - connection.outputSent < options.maxPendingOutput) {
+        long received = receiveBytes(socket, buffer, sizeof(buffer));
+        if (received <= 0) {
+            // Peer closed, or a real error: answer what already arrived, then close
+            if (received < 0 && lastCallWouldBlock()) break;
+            connection.closing = true;
+            break;
+        }
+        stats.bytesIn += static_cast<uint64_t>(received);
+        connection.input.append(buffer, static_cast<size_t>(received));
+
+        // Answer every complete line; the responses leave together in the next send
+        size_t start = 0;
+        for (;;) {
+            const char* begin = connection.input.data() + start;
+            const char* newline = static_cast<const char*>(memchr(begin, '\n', connection.input.size() - start));
+            if (!newline) break;
+            if (static_cast<size_t>(newline - begin) > options.maxRequestBytes) {
+                connection.output += "ERR REQUEST_TOO_LONG\n";
+                stats.requests++;
+                stats.errors++;
+                connection.closing = true;
+                break;
+            }
+            handleRequest(begin, newline, connection);
+            start = static_cast<size_t>(newline - connection.input.data()) + 1;
+            if (connection.closing) break;
+        }
+        connection.input.erase(0, start);
+        if (!connection.closing && connection.input.size() > options.maxRequestBytes) {
+            connection.output += "ERR REQUEST_TOO_LONG\n";
+            stats.requests++;
+            stats.errors++;
+            connection.closing = true;
+        }
+    }
+}
+
+// Sends pending responses
+bool ParkingServer::flushTo(SocketHandle socket, Connection& connection) {
+    while (connection.outputSent < connection.output.size()) {
+        long sent = sendBytes(socket, connection.output.data() + connection.outputSent,
+            connection.output.size() - connection.outputSent);
+        if (sent < 0) {
+            return lastCallWouldBlock();
+        }
+        connection.outputSent += static_cast<size_t>(sent);
+        stats.bytesOut += static_cast<uint64_t>(sent);
+    }
+    connection.output.clear();
+    connection.outputSent = 0;
+    return true;
+}
+
+// Registers the read/write interest a connection needs now
+void ParkingServer::updateInterest(SocketHandle socket, Connection& connection) {
+    // Stop reading from a client that does not collect its responses
+    bool reading = !connection.closing && connection.output.size() - connection.outputSent < options.maxPendingOutput;
+    bool writing = connection.outputSent < connection.output.size();
+    if (reading != connection.reading || writing != connection.writing) {
+        poller->modify(socket, reading, writing);
+        connection.reading = reading;
+        connection.writing = writing;
+    }
+}
+
+// Closes a connection and forgets it
+void ParkingServer::closeConnection(SocketHandle socket) {
+    poller->remove(socket);
+    closeSocket(socket);
+    connections.erase(socket);
+}
+
+// Answers one request line
+void ParkingServer::handleRequest(const char* begin, const char* end, Connection& connection) {
+    splitCommandTokens(begin, end, tokens);
+    if (tokens.empty()) return; // Blank lines get no response
+    METRIC_SCOPE(MetricOperation::ServerRequest);
+    string& out = connection.output;
+    stats.requests++;
+    size_t mark = out.size();
+
+    GateCommand command;
+    const string& verb = tokens[0];
+    if (parseGateCommand(tokens, command)) {
+        switch (command.type) {
+        case CommandType::Park: {
+            Vehicle vehicle(command.regNumber, command.ownerName, command.vehicleMake,
+                command.vehicleModel, command.vehicleColor, command.ownerContact);
+            ValidationResult check = validateVehicle(vehicle);
+            if (check.error != ValidationError::None) {
+                out += "ERR INVALID ";
+                out += validationMessage(check.field, check.error);
+                break;
+            }
+            switch (system.parkVehicle(vehicle, command.priority)) {
+            case ParkResult::Parked: out += "OK PARKED"; break;
+            case ParkResult::Queued: out += "OK QUEUED"; break;
+            case ParkResult::AlreadyParked: out += "ERR ALREADY_PARKED"; break;
+            case ParkResult::AlreadyWaiting: out += "ERR ALREADY_WAITING"; break;
+            }
+            break;
+        }
+        case CommandType::Retrieve: {
+            Cents fee = 0;
+            if (system.retrieveVehicle(command.regNumber, fee) == RetrieveResult::Retrieved) {
+                out += "OK ";
+                out += formatCents(fee);
+            }
+            else {
+                out += "ERR NOT_FOUND";
+            }
+            break;
+        }
+        case CommandType::Search: {
+            Vehicle vehicle;
+            if (system.findVehicle(command.regNumber, vehicle)) {
+                out += "OK " + vehicle.regNumber + " " + vehicle.ownerName + " " + vehicle.vehicleMake + " "
+                    + vehicle.vehicleModel + " " + vehicle.vehicleColor + " " + vehicle.ownerContact + " "
+                    + to_string(static_cast<long long>(vehicle.entryTime));
+            }
+            else {
+                out += "ERR NOT_FOUND";
+            }
+            break;
+        }
+        case CommandType::Cancel:
+            out += system.cancelWaiting(command.regNumber) ? "OK CANCELLED" : "ERR NOT_WAITING";
+            break;
+        }
+    }
+    else if (verb == "FILTER" && (tokens.size() == 4 || tokens.size() == 5)) {
+        VehicleFilter filter;
+        filter.make = tokens[1] == "*" ? "" : tokens[1];
+        filter.model = tokens[2] == "*" ? "" : tokens[2];
+        filter.color = tokens[3] == "*" ? "" : tokens[3];
+        size_t limit = tokens.size() == 5 ? static_cast<size_t>(max(0, atoi(tokens[4].c_str()))) : static_cast<size_t>(options.filterLimit);
+        matches.clear();
+        system.filterVehicles(filter, matches);
+        out += "OK " + to_string(matches.size());
+        for (size_t i = 0; i < matches.size() && i < limit; ++i) {
+            out += ' ';
+            out += matches[i].regNumber;
+        }
+    }
+    else if (verb == "MATCH" && (tokens.size() == 2 || tokens.size() == 3)) {
+        size_t limit = tokens.size() == 3 ? static_cast<size_t>(max(0, atoi(tokens[2].c_str()))) : static_cast<size_t>(options.matchLimit);
+        system.findSimilarPlates(tokens[1], limit, similarPlates);
+        out += "OK " + to_string(similarPlates.size());
+        for (const PlateMatch& match : similarPlates) {
+            out += ' ';
+            out += match.regNumber;
+        }
+    }
+    else if (verb == "STATS" && tokens.size() == 1) {
+        StatisticsSnapshot snapshot = system.getStatisticsSnapshot(system.currentTime(), 0);
+        out += "OK parked=" + to_string(snapshot.occupied) + " capacity=" + to_string(snapshot.capacity)
+            + " waiting=" + to_string(snapshot.waiting) + " arrivals=" + to_string(snapshot.arrivals)
+            + " departures=" + to_string(snapshot.departures) + " revenue=" + formatCents(snapshot.revenue)
+            + " dwell_p50=" + to_string(snapshot.dwellP50) + " dwell_p95=" + to_string(snapshot.dwellP95)
+            + " alerts_pending=" + to_string(system.getPendingAlertCount());
+    }
+    else if (verb == "PING" && tokens.size() == 1) {
+        out += "OK PONG";
+    }
+    else if (verb == "QUIT" && tokens.size() == 1) {
+        out += "OK BYE";
+        connection.closing = true;
+    }
+    else {
+        out += "ERR BAD_REQUEST";
+    }
+
+    if (out.compare(mark, 3, "ERR") == 0) stats.errors++;
+    out += '\n';
+}
+
+// Returns the counters
+const ServerStats& ParkingServer::getStats() const {
+    return stats;
+}
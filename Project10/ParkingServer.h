@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "NetworkSocket.h"
+#include "ParkingManagementSystem.h"
+
+using namespace std;
+
+// Settings of the network server
+struct ServerOptions {
+    SocketAddress address;                 // Where to listen (TCP by default)
+    int capacity = 100000;                 // Slots of the lot the server runs
+    double rate = 10.0;                    // Hourly rate in dollars
+    bool journal = true;                   // Keep the crash-recovery journal and the session archive of the lot
+    size_t maxRequestBytes = 4096;         // Longest request line; a longer one closes the connection
+    size_t maxPendingOutput = 1 << 20;     // A client with more unsent response bytes is not read from
+    int filterLimit = 100;                 // Plates listed by FILTER when the request gives no limit
+    int matchLimit = 5;                    // Plates listed by MATCH when the request gives no limit
+    string metricsPrefix;                  // Metrics files prefix.prom / prefix.json (empty disables)
+    int metricsIntervalMs = 10000;         // Time between metrics file writes
+    string tracePath;                      // Chrome trace of the run, written on stop (empty disables)
+};
+
+// Counters of a server run
+struct ServerStats {
+    uint64_t connectionsAccepted = 0;   // Connections accepted since start
+    uint64_t requests = 0;              // Requests answered
+    uint64_t errors = 0;                // Requests answered with ERR
+    uint64_t bytesIn = 0;               // Bytes received
+    uint64_t bytesOut = 0;              // Bytes sent
+    uint64_t wakeups = 0;               // Event loop iterations with at least one ready socket
+};
+
+// Parses the options that follow --serve; returns false and sets 'error' on bad input
+// Options: --host H --port P --unix <path> --capacity N --rate R --no-journal
+//          --metrics <prefix> --metrics-interval S --trace <file>
+bool parseServerOptions(int argc, char* argv[], int first, ServerOptions& options, string& error);
+
+// Waits for readiness of many sockets (epoll on Linux, poll elsewhere)
+class EventPoller;
+
+// Single-threaded, event-driven server that gives gate terminals, pay stations and the
+// back office one shared lot engine
+// Requests are text lines in the command-file format, one response line per request, in order:
+//   PARK <reg> <owner> <make> <model> <color> <contact> [priority]  -> OK PARKED | OK QUEUED | ERR ...
+//   RETRIEVE <reg>                                                   -> OK <fee> | ERR NOT_FOUND
+//   SEARCH <reg>                          -> OK <reg> <owner> <make> <model> <color> <contact> <entry> | ERR NOT_FOUND
+//   CANCEL <reg>                                                     -> OK CANCELLED | ERR NOT_WAITING
+//   MATCH <misread reg> [limit]                                      -> OK <matches> <reg> <reg> ... (best first)
+//   FILTER <make|*> <model|*> <color|*> [limit]                      -> OK <matches> <reg> <reg> ...
+//   STATS                                                            -> OK parked=... waiting=... revenue=...
+//   PING -> OK PONG          QUIT -> OK BYE (then the server closes the connection)
+// Clients may pipeline: every complete line of a read is answered and the answers
+// leave in one send, so a batch of requests costs one round trip.
+class ParkingServer {
+private:
+    // State of one client connection
+    struct Connection {
+        string input;            // Received bytes not yet answered (at most one partial line)
+        string output;           // Responses not yet sent
+        size_t outputSent = 0;   // Bytes of 'output' already sent
+        bool closing = false;    // Close once the output is sent
+        bool reading = true;     // Read interest is registered
+        bool writing = false;    // Write interest is registered
+    };
+
+    ParkingManagementSystem& system;                      // Lot engine the requests run against
+    ServerOptions options;                                // Settings
+    SocketHandle listener;                                // Listening socket
+    unique_ptr<EventPoller> poller;                       // Readiness notifications
+    unordered_map<SocketHandle, Connection> connections;  // Open connections by socket
+    vector<string> tokens;                                // Scratch tokens of the current request
+    vector<Vehicle> matches;                              // Scratch results of FILTER
+    vector<PlateMatch> similarPlates;                     // Scratch results of MATCH
+    ServerStats stats;                                    // Counters
+
+    // Accepts every pending connection
+    void acceptClients();
+
+    // Reads what a client sent and answers every complete request
+    void readFrom(SocketHandle socket, Connection& connection);
+
+    // Sends pending responses; returns false if the connection failed
+    bool flushTo(SocketHandle socket, Connection& connection);
+
+    // Registers the read/write interest a connection needs now
+    void updateInterest(SocketHandle socket, Connection& connection);
+
+    // Answers one request line, appending the response line to the connection's output
+    void handleRequest(const char* begin, const char* end, Connection& connection);
+
+    // Closes a connection and forgets it
+    void closeConnection(SocketHandle socket);
+
+public:
+    // Creates a server for a lot engine
+    ParkingServer(ParkingManagementSystem& system, const ServerOptions& options);
+
+    // Closes every socket
+    ~ParkingServer();
+
+    // Opens the listening socket; returns false and sets 'error' on failure
+    bool start(string& error);
+
+    // Serves requests until Ctrl+C or requestServerStop(); raises due alerts while idle
+    void run();
+
+    // Returns the counters
+    const ServerStats& getStats() const;
+};
+
+// Asks a running server to stop (safe to call from a signal handler)
+void requestServerStop();
@@ -0,0 +1,452 @@
+#include "ParkingSimulator.h"
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include "TimerWheel.h"
+
+// Arrival profiles by hour of the day (relative rates, scaled to a mean of 1 when used)
+static const double OFFICE_PROFILE[24] = { 0.1, 0.05, 0.05, 0.05, 0.1, 0.3, 0.8, 2.2, 3.5, 2.5, 1.2, 1.0,
+    1.3, 1.1, 0.9, 0.8, 0.7, 0.6, 0.5, 0.4, 0.3, 0.25, 0.2, 0.15 };
+static const double RETAIL_PROFILE[24] = { 0.05, 0.02, 0.02, 0.02, 0.02, 0.05, 0.1, 0.3, 0.7, 1.2, 1.6, 1.8,
+    2.0, 1.9, 1.8, 1.7, 1.8, 2.0, 2.1, 1.8, 1.3, 0.8, 0.4, 0.15 };
+
+// Kinds of timers in the simulator's wheel
+static const uint8_t TIMER_DEPARTURE = 0;   // A parked vehicle leaves
+static const uint8_t TIMER_GIVE_UP = 1;     // A waiting vehicle stops waiting
+
+// Simulated start: midnight local time on Monday 1 January 2024, so hours of the
+// profile line up with hours of the tariff's night window
+static time_t simulationStart() {
+    struct tm midnight = {};
+    midnight.tm_year = 2024 - 1900;
+    midnight.tm_mon = 0;
+    midnight.tm_mday = 1;
+    midnight.tm_isdst = -1;
+    return mktime(&midnight);
+}
+
+// Splits a comma-separated list of numbers; returns false if one does not parse
+static bool parseNumberList(const string& text, vector<double>& values) {
+    stringstream items(text);
+    string item;
+    while (getline(items, item, ',')) {
+        char* end = nullptr;
+        double value = strtod(item.c_str(), &end);
+        if (item.empty() || *end != '\0') return false;
+        values.push_back(value);
+    }
+    return !values.empty();
+}
+
+// Parses the options that follow --simulate
+bool parseSimulationOptions(int argc, char* argv[], int first, SimulationOptions& options, vector<int>& capacities, string& error) {
+    for (int i = first; i < argc; ++i) {
+        string option = argv[i];
+        if (i + 1 >= argc) {
+            error = "Missing value for " + option;
+            return false;
+        }
+        string value = argv[++i];
+        double number = atof(value.c_str());
+        if (option == "--capacity") {
+            vector<double> values;
+            if (!parseNumberList(value, values)) {
+                error = "Bad capacity list " + value;
+                return false;
+            }
+            capacities.clear();
+            for (double capacity : values) capacities.push_back(static_cast<int>(capacity));
+            options.capacity = capacities[0];
+        }
+        else if (option == "--days") options.days = number;
+        else if (option == "--arrivals-per-hour") options.arrivalsPerHour = number;
+        else if (option == "--profile") {
+            vector<double> weights;
+            if (value == "flat") options.hourlyProfile.fill(1.0);
+            else if (value == "office") copy(begin(OFFICE_PROFILE), end(OFFICE_PROFILE), options.hourlyProfile.begin());
+            else if (value == "retail") copy(begin(RETAIL_PROFILE), end(RETAIL_PROFILE), options.hourlyProfile.begin());
+            else if (parseNumberList(value, weights) && weights.size() == 24) copy(weights.begin(), weights.end(), options.hourlyProfile.begin());
+            else {
+                error = "Expected flat, office, retail or 24 hourly weights for --profile";
+                return false;
+            }
+        }
+        else if (option == "--dwell") {
+            if (value == "exponential") options.dwell = DwellDistribution::Exponential;
+            else if (value == "lognormal") options.dwell = DwellDistribution::LogNormal;
+            else if (value == "fixed") options.dwell = DwellDistribution::Fixed;
+            else {
+                error = "Unknown dwell distribution " + value;
+                return false;
+            }
+        }
+        else if (option == "--dwell-minutes") options.meanDwellMinutes = number;
+        else if (option == "--dwell-spread") options.dwellSpread = number;
+        else if (option == "--patience") options.patienceMinutes = number;
+        else if (option == "--rate") options.hourlyRate = number;
+        else if (option == "--night-rate") options.tariff.nightRate = dollarsToCents(number);
+        else if (option == "--daily-cap") options.tariff.dailyCap = dollarsToCents(number);
+        else if (option == "--grace") options.tariff.graceMinutes = atoi(value.c_str());
+        else if (option == "--report-minutes") options.reportMinutes = atoi(value.c_str());
+        else if (option == "--seed") options.seed = strtoull(value.c_str(), nullptr, 10);
+        else {
+            error = "Unknown option " + option;
+            return false;
+        }
+    }
+
+    double profileTotal = 0;
+    for (double weight : options.hourlyProfile) {
+        if (weight < 0) profileTotal = -1;
+        if (profileTotal >= 0) profileTotal += weight;
+    }
+    bool capacitiesValid = true;
+    for (int capacity : capacities) capacitiesValid = capacitiesValid && capacity > 0;
+    if (options.capacity <= 0 || !capacitiesValid || options.days <= 0 || options.arrivalsPerHour <= 0
+        || options.meanDwellMinutes <= 0 || options.dwellSpread < 0 || options.reportMinutes <= 0 || profileTotal <= 0) {
+        error = "Capacity, days, arrival rate, dwell and report minutes must be positive; profile weights not negative";
+        return false;
+    }
+    return true;
+}
+
+// One simulation run: the lot, its manual clock and the pending departures and give-ups
+class SiteSimulation {
+private:
+    const SimulationOptions& options;          // Site settings
+    SimulationReport& report;                  // Where results go
+    shared_ptr<ManualClock> clock;             // Simulated time shared with the lot
+    ParkingManagementSystem lot;               // Engine under simulation
+    TimerWheel timers;                         // Departures and give-ups by simulated time
+    function<void(const TimerEvent&)> fire;    // Handles a timer that came due
+    mt19937_64 rng;                            // Source of all randomness
+    exponential_distribution<double> unitGap;  // Exponential with mean 1
+    normal_distribution<double> unitNormal;    // Standard normal for log-normal stays
+    uniform_real_distribution<double> unit;    // Uniform on [0, 1)
+    double profile[24];                        // Arrival rate per second for each hour of the day
+    double peakRate;                           // Highest of those rates
+    double logMean;                            // Mu of the log-normal stays
+    time_t patienceSeconds;                    // Waiting time before giving up (0 = balk, -1 = forever)
+    deque<pair<uint32_t, TimerId>> waitingOrder; // Waiting vehicles in admission order and their give-up timer
+    Vehicle arriving;                          // Record reused for every arrival
+    Cents fee;                                 // Fee of the last retrieval
+
+    int parked;                                // Parked vehicles as the simulator counts them
+    int waiting;                               // Waiting vehicles as the simulator counts them
+    time_t start;                              // Simulated start
+    time_t lastChange;                         // Time up to which occupancy has been integrated
+    double occupiedArea;                       // Integral of parked vehicles over time (vehicle-seconds)
+    double waitingArea;                        // Integral of waiting vehicles over time
+    double fullSeconds;                        // Time with every slot taken
+    SimulationInterval interval;               // Interval being collected
+    time_t intervalEnd;                        // End of that interval
+    double intervalOccupied;                   // Occupancy integral within the interval
+    double intervalWaiting;                    // Waiting list integral within the interval
+    Cents intervalRevenueStart;                // Lot revenue when the interval started
+
+    // Builds the lot settings: no files, the simulation's clock and tariff
+    static ParkingConfig makeConfig(const SimulationOptions& settings, const shared_ptr<ManualClock>& clock) {
+        ParkingConfig config;
+        config.logging.path = "";
+        config.journalPath = "";
+        config.archivePath = "";
+        config.tariff = settings.tariff;
+        config.clock = clock;
+        return config;
+    }
+
+    // Writes the plate of a simulated vehicle into the reused record
+    // Ids below 10^7 get a 7-digit field ("SIM0000042"); larger ids widen it, so every id has
+    // its own plate (a wider plate is never as short as a 7-digit one).
+    void setPlate(uint32_t id) {
+        int digits = 7;
+        for (uint32_t rest = id / 10000000; rest > 0; rest /= 10) {
+            digits++;
+        }
+        string& plate = arriving.regNumber;
+        plate.assign("SIM");
+        plate.append(digits, '0');
+        for (int i = 2 + digits; id > 0; --i) {
+            plate[i] = static_cast<char>('0' + id % 10);
+            id /= 10;
+        }
+    }
+
+    // Draws the length of a stay
+    time_t drawDwell() {
+        double minutes = options.meanDwellMinutes;
+        if (options.dwell == DwellDistribution::Exponential) {
+            minutes *= unitGap(rng);
+        }
+        else if (options.dwell == DwellDistribution::LogNormal) {
+            minutes = exp(logMean + options.dwellSpread * unitNormal(rng));
+        }
+        return max<time_t>(1, llround(minutes * 60));
+    }
+
+    // Adds the occupancy since the last change, closing every report interval that ended
+    void advanceTo(time_t now) {
+        while (now >= intervalEnd) {
+            accumulate(intervalEnd);
+            closeInterval();
+        }
+        accumulate(now);
+    }
+
+    // Integrates occupancy from the last change up to 'now' (within one interval)
+    void accumulate(time_t now) {
+        double elapsed = static_cast<double>(now - lastChange);
+        occupiedArea += parked * elapsed;
+        waitingArea += waiting * elapsed;
+        intervalOccupied += parked * elapsed;
+        intervalWaiting += waiting * elapsed;
+        if (parked >= options.capacity) fullSeconds += elapsed;
+        lastChange = now;
+    }
+
+    // Finishes the current report interval and starts the next one
+    void closeInterval() {
+        double length = static_cast<double>(intervalEnd - interval.start);
+        interval.meanOccupied = intervalOccupied / length;
+        interval.meanWaiting = intervalWaiting / length;
+        interval.revenue = lot.getTotalRevenue() - intervalRevenueStart;
+        report.intervals.push_back(interval);
+
+        interval = SimulationInterval();
+        interval.start = intervalEnd;
+        interval.peakOccupied = parked;
+        intervalEnd += static_cast<time_t>(options.reportMinutes) * 60;
+        intervalOccupied = 0;
+        intervalWaiting = 0;
+        intervalRevenueStart = lot.getTotalRevenue();
+    }
+
+    // Notes one more parked vehicle
+    void noteParked() {
+        parked++;
+        interval.peakOccupied = max(interval.peakOccupied, parked);
+        report.peakOccupied = max(report.peakOccupied, parked);
+    }
+
+    // A vehicle reaches the gate
+    void arrive(time_t now, uint32_t id) {
+        report.arrivals++;
+        interval.arrivals++;
+        if (patienceSeconds == 0 && parked >= options.capacity) {
+            report.balked++;
+            interval.turnedAway++;
+            return;
+        }
+        setPlate(id);
+        ParkResult result = lot.parkVehicle(arriving);
+        if (result == ParkResult::Parked) {
+            noteParked();
+            timers.schedule(now + drawDwell(), id, TIMER_DEPARTURE);
+        }
+        else if (result == ParkResult::Queued) {
+            waiting++;
+            report.queued++;
+            interval.queued++;
+            report.peakWaiting = max(report.peakWaiting, waiting);
+            TimerId giveUp = patienceSeconds > 0 ? timers.schedule(now + patienceSeconds, id, TIMER_GIVE_UP) : 0;
+            waitingOrder.emplace_back(id, giveUp);
+        }
+        else {
+            report.consistent = false;
+        }
+    }
+
+    // A parked vehicle leaves; the lot hands its slot to the first waiting vehicle
+    void depart(time_t now, uint32_t id) {
+        int waitingBefore = lot.getWaitingCount();
+        setPlate(id);
+        if (lot.retrieveVehicle(arriving.regNumber, fee) != RetrieveResult::Retrieved) {
+            report.consistent = false;
+            return;
+        }
+        parked--;
+        report.departures++;
+        interval.departures++;
+        if (lot.getWaitingCount() == waitingBefore) {
+            return;
+        }
+
+        // Vehicles in front that gave up are already gone; the next one got the slot
+        while (!waitingOrder.empty() && waitingOrder.front().second != 0 && !timers.isPending(waitingOrder.front().second)) {
+            waitingOrder.pop_front();
+        }
+        if (waitingOrder.empty()) {
+            report.consistent = false;
+            return;
+        }
+        uint32_t admitted = waitingOrder.front().first;
+        if (waitingOrder.front().second != 0) {
+            timers.cancel(waitingOrder.front().second);
+        }
+        waitingOrder.pop_front();
+        waiting--;
+        report.admitted++;
+        noteParked();
+        timers.schedule(now + drawDwell(), admitted, TIMER_DEPARTURE);
+    }
+
+    // A waiting vehicle runs out of patience
+    void giveUp(uint32_t id) {
+        setPlate(id);
+        if (!lot.cancelWaiting(arriving.regNumber)) {
+            report.consistent = false;
+            return;
+        }
+        waiting--;
+        report.gaveUp++;
+        interval.turnedAway++;
+    }
+
+public:
+    SiteSimulation(const SimulationOptions& settings, SimulationReport& results)
+        : options(settings), report(results), clock(make_shared<ManualClock>(simulationStart())),
+        lot(settings.capacity, settings.hourlyRate, makeConfig(settings, clock)), timers(clock->now()),
+        rng(settings.seed), unitGap(1.0), unitNormal(0.0, 1.0), unit(0.0, 1.0), fee(0), parked(0), waiting(0),
+        start(clock->now()), lastChange(start), occupiedArea(0), waitingArea(0), fullSeconds(0),
+        intervalEnd(start + static_cast<time_t>(settings.reportMinutes) * 60), intervalOccupied(0), intervalWaiting(0),
+        intervalRevenueStart(0) {
+        // Arrival rate per second for every hour, keeping the daily mean at arrivalsPerHour
+        double total = 0;
+        for (double weight : options.hourlyProfile) total += weight;
+        peakRate = 0;
+        for (int hour = 0; hour < 24; ++hour) {
+            profile[hour] = options.arrivalsPerHour / 3600.0 * options.hourlyProfile[hour] * 24 / total;
+            peakRate = max(peakRate, profile[hour]);
+        }
+        logMean = log(options.meanDwellMinutes) - options.dwellSpread * options.dwellSpread / 2;
+        patienceSeconds = options.patienceMinutes < 0 ? -1 : llround(options.patienceMinutes * 60);
+        interval.start = start;
+
+        arriving.ownerName = "Simulated";
+        arriving.vehicleMake = "Toyota";
+        arriving.vehicleModel = "Corolla";
+        arriving.vehicleColor = "White";
+        arriving.ownerContact = "03000000000";
+        fire = [this](const TimerEvent& event) {
+            advanceTo(event.deadline);
+            clock->set(event.deadline);
+            report.events++;
+            if (event.kind == TIMER_DEPARTURE) depart(event.deadline, event.owner);
+            else giveUp(event.owner);
+        };
+    }
+
+    // Runs the whole simulated period
+    void run() {
+        time_t end = start + static_cast<time_t>(llround(options.days * 86400));
+        report.capacity = options.capacity;
+        report.days = options.days;
+
+        // Arrivals by thinning: candidates at the peak rate, each kept with the share of
+        // the peak that its hour's rate is
+        double candidate = static_cast<double>(start);
+        uint32_t nextId = 1;
+        for (;;) {
+            candidate += unitGap(rng) / peakRate;
+            if (candidate >= static_cast<double>(end)) break;
+            time_t now = static_cast<time_t>(candidate);
+            int hour = static_cast<int>((now - start) / 3600 % 24);
+            if (unit(rng) * peakRate >= profile[hour]) continue;
+
+            timers.advance(now, fire);
+            advanceTo(now);
+            clock->set(now);
+            report.events++;
+            arrive(now, nextId++);
+        }
+        timers.advance(end, fire);
+        advanceTo(end);
+
+        double length = static_cast<double>(end - start);
+        report.meanOccupied = occupiedArea / length;
+        report.meanWaiting = waitingArea / length;
+        report.fullFraction = fullSeconds / length;
+        report.revenue = lot.getTotalRevenue();
+        report.statistics = lot.getStatisticsSnapshot(end, 0);
+        report.consistent = report.consistent && lot.getCurrentVehicleCount() == parked && lot.getWaitingCount() == waiting;
+    }
+};
+
+// Drives a parking system through simulated traffic
+void runSimulation(const SimulationOptions& options, SimulationReport& report) {
+    report = SimulationReport();
+    auto started = chrono::steady_clock::now();
+    {
+        SiteSimulation simulation(options, report);
+        simulation.run();
+    }
+    report.seconds = chrono::duration<double>(chrono::steady_clock::now() - started).count();
+}
+
+// Returns a share as a percentage of a total (0 when the total is 0)
+static double percentOf(double part, double total) {
+    return total > 0 ? 100.0 * part / total : 0;
+}
+
+// Prints the report intervals and a summary
+void printSimulationReport(const SimulationOptions& options, const SimulationReport& report) {
+    static const char* dwellNames[] = { "exponential", "log-normal", "fixed" };
+    cout << "\nSimulation (" << report.capacity << " slots, " << report.days << " days, " << options.arrivalsPerHour
+        << " arrivals/h, " << dwellNames[static_cast<int>(options.dwell)] << " stays of " << options.meanDwellMinutes
+        << " min, patience " << options.patienceMinutes << " min):\n";
+
+    // One row per interval; the start is days and hours into the simulation
+    cout << "   " << left << setw(9) << "Start" << right << setw(10) << "Arrivals" << setw(9) << "Queued" << setw(9) << "Lost"
+        << setw(11) << "Occupied" << setw(7) << "Peak" << setw(8) << "Util %" << setw(10) << "Waiting" << setw(13) << "Revenue $" << "\n";
+    time_t start = report.intervals.empty() ? 0 : report.intervals[0].start;
+    for (const SimulationInterval& row : report.intervals) {
+        long long minutes = static_cast<long long>(row.start - start) / 60;
+        char when[32];
+        snprintf(when, sizeof(when), "d%lld+%02lld:%02lld", minutes / 1440, minutes / 60 % 24, minutes % 60);
+        cout << "   " << left << setw(9) << when << right << setw(10) << row.arrivals << setw(9) << row.queued
+            << setw(9) << row.turnedAway << fixed << setprecision(1) << setw(11) << row.meanOccupied << setw(7) << row.peakOccupied
+            << setw(8) << percentOf(row.meanOccupied, report.capacity) << setw(10) << row.meanWaiting
+            << setw(13) << formatCents(row.revenue) << "\n";
+    }
+
+    const StatisticsSnapshot& stats = report.statistics;
+    uint64_t lost = report.gaveUp + report.balked;
+    cout << fixed << setprecision(1);
+    cout << "   Arrivals:        " << report.arrivals << " (" << percentOf(report.arrivals - report.queued - report.balked, report.arrivals)
+        << "% parked at once, " << percentOf(report.queued, report.arrivals) << "% queued, "
+        << percentOf(lost, report.arrivals) << "% lost: " << report.gaveUp << " gave up, " << report.balked << " turned back)\n";
+    cout << "   Occupancy:       mean " << report.meanOccupied << " (" << percentOf(report.meanOccupied, report.capacity)
+        << "%), peak " << report.peakOccupied << ", full " << 100 * report.fullFraction << "% of the time\n";
+    cout << "   Waiting list:    mean " << report.meanWaiting << ", peak " << report.peakWaiting << "; wait before a slot mean "
+        << stats.meanWaitSeconds / 60 << " min, p50 " << stats.waitP50 / 60.0 << ", p95 " << stats.waitP95 / 60.0
+        << ", p99 " << stats.waitP99 / 60.0 << " min\n";
+    cout << "   Stays:           mean " << stats.meanDwellSeconds / 60 << " min, p50 " << stats.dwellP50 / 60.0
+        << ", p95 " << stats.dwellP95 / 60.0 << " min\n";
+    cout << "   Revenue:         $" << formatCents(report.revenue) << " ($" << formatCents(static_cast<Cents>(report.revenue / report.days))
+        << " per day, $" << setprecision(2) << report.revenue / 100.0 / report.days / report.capacity << " per slot per day)\n";
+    cout << setprecision(0);
+    cout << "   Events:          " << report.events << " in " << setprecision(3) << report.seconds << " s (" << setprecision(0)
+        << report.events / max(report.seconds, 1e-9) << " events/s)\n";
+    cout << "   Consistency:     " << (report.consistent ? "passed" : "FAILED") << "\n";
+}
+
+// Prints one summary line per simulated capacity
+void printCapacityComparison(const SimulationOptions& options, const vector<SimulationReport>& reports) {
+    cout << "\nCapacity comparison (" << options.days << " days, " << options.arrivalsPerHour << " arrivals/h, stays of "
+        << options.meanDwellMinutes << " min, patience " << options.patienceMinutes << " min):\n";
+    cout << "   " << right << setw(8) << "Slots" << setw(9) << "Util %" << setw(9) << "Full %" << setw(9) << "Lost %"
+        << setw(14) << "Wait p95 min" << setw(14) << "Revenue/day" << setw(15) << "Per slot/day" << "\n";
+    cout << fixed;
+    for (const SimulationReport& report : reports) {
+        cout << "   " << setw(8) << report.capacity << setprecision(1) << setw(9) << percentOf(report.meanOccupied, report.capacity)
+            << setw(9) << 100 * report.fullFraction << setw(9) << percentOf(report.gaveUp + report.balked, report.arrivals)
+            << setw(14) << report.statistics.waitP95 / 60.0 << setw(14) << formatCents(static_cast<Cents>(report.revenue / report.days))
+            << setprecision(2) << setw(15) << report.revenue / 100.0 / report.days / report.capacity
+            << (report.consistent ? "" : "  (inconsistent)") << "\n";
+    }
+}
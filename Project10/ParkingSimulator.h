@@ -0,0 +1,89 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "ParkingManagementSystem.h"
+
+using namespace std;
+
+// How long simulated vehicles stay
+enum class DwellDistribution {
+    Exponential,   // Memoryless stays around the mean
+    LogNormal,     // Mostly short stays with a long tail of all-day parkers
+    Fixed          // Every vehicle stays exactly the mean
+};
+
+// Settings of a simulated site
+struct SimulationOptions {
+    int capacity = 200;                          // Slots of the simulated lot
+    double days = 30;                            // Simulated time
+    double arrivalsPerHour = 40;                 // Mean arrival rate over the whole day
+    array<double, 24> hourlyProfile;             // Relative arrival rate per hour of the day (scaled to a mean of 1)
+    DwellDistribution dwell = DwellDistribution::LogNormal; // Shape of the stay lengths
+    double meanDwellMinutes = 150;               // Mean stay
+    double dwellSpread = 0.8;                    // Sigma of the log-normal stays (ignored by the others)
+    double patienceMinutes = 15;                 // Time a queued vehicle waits before leaving (0 leaves a full lot at once, < 0 waits forever)
+    int reportMinutes = 24 * 60;                 // Length of one report interval
+    double hourlyRate = 10.0;                    // Day rate in dollars per hour
+    TariffTable tariff;                          // Rest of the rate table (night rate, cap, grace)
+    uint64_t seed = 1;                           // Random seed; the same seed replays the same traffic
+
+    SimulationOptions() { hourlyProfile.fill(1.0); }
+};
+
+// Activity during one report interval
+struct SimulationInterval {
+    time_t start = 0;            // Simulated time the interval starts
+    uint64_t arrivals = 0;       // Vehicles that came to the gate
+    uint64_t queued = 0;         // Vehicles that found the lot full and joined the waiting list
+    uint64_t turnedAway = 0;     // Vehicles that left at once or gave up waiting
+    uint64_t departures = 0;     // Vehicles that paid and left
+    double meanOccupied = 0;     // Time-weighted parked vehicles
+    int peakOccupied = 0;        // Most parked vehicles at once
+    double meanWaiting = 0;      // Time-weighted vehicles in the waiting list
+    Cents revenue = 0;           // Fees charged
+};
+
+// Outcome of a simulation
+struct SimulationReport {
+    int capacity = 0;            // Slots of the simulated lot
+    double days = 0;             // Simulated time
+    uint64_t events = 0;         // Arrivals, departures and give-ups processed
+    uint64_t arrivals = 0;       // Vehicles that came to the gate
+    uint64_t queued = 0;         // Vehicles that joined the waiting list
+    uint64_t admitted = 0;       // Waiting vehicles that got a slot
+    uint64_t gaveUp = 0;         // Waiting vehicles that left before getting a slot
+    uint64_t balked = 0;         // Vehicles that left a full lot at once (patience 0)
+    uint64_t departures = 0;     // Vehicles that paid and left
+    double meanOccupied = 0;     // Time-weighted parked vehicles
+    double fullFraction = 0;     // Share of the time every slot was taken
+    int peakOccupied = 0;        // Most parked vehicles at once
+    double meanWaiting = 0;      // Time-weighted vehicles in the waiting list
+    int peakWaiting = 0;         // Longest waiting list
+    Cents revenue = 0;           // Fees charged
+    bool consistent = true;      // The lot ended with the vehicles the simulator parked
+    double seconds = 0;          // Wall time of the run
+    StatisticsSnapshot statistics;          // The lot's own statistics at the end (dwell and wait percentiles)
+    vector<SimulationInterval> intervals;   // Activity per report interval
+};
+
+// Parses the options that follow --simulate; returns false and sets 'error' on bad input
+// A comma-separated --capacity list fills 'capacities' for a sizing comparison.
+// Options: --capacity N[,N...] --days D --arrivals-per-hour R --profile flat|office|retail|w0,...,w23
+//          --dwell exponential|lognormal|fixed --dwell-minutes M --dwell-spread S --patience M
+//          --rate R --night-rate R --daily-cap R --grace M --report-minutes M --seed N
+bool parseSimulationOptions(int argc, char* argv[], int first, SimulationOptions& options, vector<int>& capacities, string& error);
+
+// Drives a parking system through simulated traffic
+// The lot runs on a manual clock that jumps from event to event, so a month of traffic
+// takes well under a second. Arrivals follow a Poisson process whose rate follows the
+// hourly profile; departures and give-ups wait in a timer wheel keyed by simulated time.
+void runSimulation(const SimulationOptions& options, SimulationReport& report);
+
+// Prints the report intervals and a summary
+void printSimulationReport(const SimulationOptions& options, const SimulationReport& report);
+
+// Prints one summary line per simulated capacity
+void printCapacityComparison(const SimulationOptions& options, const vector<SimulationReport>& reports);
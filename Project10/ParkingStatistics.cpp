@@ -0,0 +1,269 @@
+#include "ParkingStatistics.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <iomanip>
+#include "BitScan.h"
+
+// Creates an empty histogram
+DurationHistogram::DurationHistogram() : total(0), sum(0), largest(0) {
+    memset(counts, 0, sizeof(counts));
+}
+
+// Returns the bucket of a duration
+int DurationHistogram::bucketOf(uint64_t seconds) {
+    if (seconds < 2 * SUB_BUCKETS) {
+        return static_cast<int>(seconds);
+    }
+    // The top six bits pick one of 32 buckets inside the value's power of two
+    int high = min(highestBit(seconds), 31);
+    int shift = high - 5;
+    int top = static_cast<int>(min<uint64_t>(seconds >> shift, 2 * SUB_BUCKETS - 1));
+    return (high - 4) * SUB_BUCKETS + (top - SUB_BUCKETS);
+}
+
+// Returns the longest duration that falls into a bucket
+uint64_t DurationHistogram::bucketUpperBound(int bucket) {
+    if (bucket < 2 * SUB_BUCKETS) {
+        return static_cast<uint64_t>(bucket);
+    }
+    int shift = bucket / SUB_BUCKETS - 1;
+    uint64_t top = bucket % SUB_BUCKETS + SUB_BUCKETS;
+    return ((top + 1) << shift) - 1;
+}
+
+// Records one duration
+void DurationHistogram::record(uint64_t seconds) {
+    counts[bucketOf(seconds)]++;
+    total++;
+    sum += seconds;
+    if (seconds > largest) largest = seconds;
+}
+
+// Adds the counts of another histogram
+void DurationHistogram::merge(const DurationHistogram& other) {
+    for (int bucket = 0; bucket < BUCKET_COUNT; ++bucket) {
+        counts[bucket] += other.counts[bucket];
+    }
+    total += other.total;
+    sum += other.sum;
+    largest = std::max(largest, other.largest);
+}
+
+// Returns the number of recorded durations
+uint64_t DurationHistogram::count() const {
+    return total;
+}
+
+// Returns the mean duration
+double DurationHistogram::mean() const {
+    return total == 0 ? 0 : static_cast<double>(sum) / total;
+}
+
+// Returns the longest recorded duration
+uint64_t DurationHistogram::max() const {
+    return largest;
+}
+
+// Returns the duration that 'percent' percent of the recorded durations do not exceed
+uint64_t DurationHistogram::percentile(double percent) const {
+    if (total == 0) return 0;
+
+    // Walk the buckets until enough durations are covered; report the bucket's upper bound
+    uint64_t needed = static_cast<uint64_t>(ceil(percent / 100 * total));
+    needed = std::max<uint64_t>(needed, 1);
+    uint64_t seen = 0;
+    for (int bucket = 0; bucket < BUCKET_COUNT; ++bucket) {
+        seen += counts[bucket];
+        if (seen >= needed) {
+            return std::min(bucketUpperBound(bucket), largest);
+        }
+    }
+    return largest;
+}
+
+// Creates empty statistics
+ParkingStatistics::ParkingStatistics(int slots)
+    : capacity(slots), occupied(0), peakOccupied(0), arrivals(0), departures(0), queued(0),
+    admitted(0), cancelled(0), revenue(0), timeline(TIMELINE_MINUTES) {
+}
+
+// Returns the ring bucket of a time
+MinuteActivity& ParkingStatistics::minuteOf(time_t now) {
+    int64_t minute = static_cast<int64_t>(now) / 60;
+    MinuteActivity& bucket = timeline[static_cast<size_t>(minute % TIMELINE_MINUTES)];
+    if (bucket.minute != minute) {
+        bucket = MinuteActivity();
+        bucket.minute = minute;
+    }
+    return bucket;
+}
+
+// Records the occupancy after an event
+void ParkingStatistics::noteOccupancy(MinuteActivity& bucket, int occupancy) {
+    occupied = occupancy;
+    if (occupancy > peakOccupied) peakOccupied = occupancy;
+    bucket.occupied = occupancy;
+    if (occupancy > bucket.peakOccupied) bucket.peakOccupied = occupancy;
+}
+
+// A vehicle took a slot at the gate
+void ParkingStatistics::recordArrival(time_t now, int occupancy) {
+    MinuteActivity& bucket = minuteOf(now);
+    arrivals++;
+    bucket.arrivals++;
+    noteOccupancy(bucket, occupancy);
+}
+
+// A waiting vehicle took a slot
+void ParkingStatistics::recordAdmission(time_t now, int occupancy, time_t queuedAt) {
+    recordArrival(now, occupancy);
+    admitted++;
+    waitTimes.record(now > queuedAt ? static_cast<uint64_t>(now - queuedAt) : 0);
+}
+
+// A vehicle left and paid
+void ParkingStatistics::recordDeparture(time_t now, int occupancy, time_t entryTime, Cents fee) {
+    MinuteActivity& bucket = minuteOf(now);
+    departures++;
+    revenue += fee;
+    bucket.departures++;
+    bucket.revenue += fee;
+    noteOccupancy(bucket, occupancy);
+    dwellTimes.record(now > entryTime ? static_cast<uint64_t>(now - entryTime) : 0);
+}
+
+// A vehicle joined the waiting list
+void ParkingStatistics::recordQueued(time_t now) {
+    queued++;
+    minuteOf(now).queued++;
+}
+
+// A waiting vehicle gave up
+void ParkingStatistics::recordCancelled() {
+    cancelled++;
+}
+
+// Sets the occupancy without counting an event
+void ParkingStatistics::setOccupancy(int occupancy) {
+    occupied = occupancy;
+    peakOccupied = max(peakOccupied, occupancy);
+}
+
+// Adds the statistics of another lot
+void ParkingStatistics::merge(const ParkingStatistics& other) {
+    capacity += other.capacity;
+    occupied += other.occupied;
+    peakOccupied += other.peakOccupied; // Upper bound: the lots need not peak together
+    arrivals += other.arrivals;
+    departures += other.departures;
+    queued += other.queued;
+    admitted += other.admitted;
+    cancelled += other.cancelled;
+    revenue += other.revenue;
+    dwellTimes.merge(other.dwellTimes);
+    waitTimes.merge(other.waitTimes);
+
+    // Keep the newer minute of each ring bucket, adding up buckets of the same minute
+    for (int i = 0; i < TIMELINE_MINUTES; ++i) {
+        MinuteActivity& mine = timeline[i];
+        const MinuteActivity& theirs = other.timeline[i];
+        if (theirs.minute > mine.minute) {
+            mine = theirs;
+        }
+        else if (theirs.minute == mine.minute && mine.minute >= 0) {
+            mine.arrivals += theirs.arrivals;
+            mine.departures += theirs.departures;
+            mine.queued += theirs.queued;
+            mine.revenue += theirs.revenue;
+            mine.peakOccupied += theirs.peakOccupied;
+        }
+    }
+}
+
+// Computes a snapshot
+StatisticsSnapshot ParkingStatistics::snapshot(time_t now, int waiting, int timelineMinutes) const {
+    StatisticsSnapshot stats;
+    stats.takenAt = now;
+    stats.capacity = capacity;
+    stats.occupied = occupied;
+    stats.peakOccupied = peakOccupied;
+    stats.waiting = waiting;
+    stats.arrivals = arrivals;
+    stats.departures = departures;
+    stats.queued = queued;
+    stats.admitted = admitted;
+    stats.cancelled = cancelled;
+    stats.revenue = revenue;
+    stats.meanDwellSeconds = dwellTimes.mean();
+    stats.dwellP50 = dwellTimes.percentile(50);
+    stats.dwellP95 = dwellTimes.percentile(95);
+    stats.dwellP99 = dwellTimes.percentile(99);
+    stats.dwellMax = dwellTimes.max();
+    stats.meanWaitSeconds = waitTimes.mean();
+    stats.waitP50 = waitTimes.percentile(50);
+    stats.waitP95 = waitTimes.percentile(95);
+    stats.waitP99 = waitTimes.percentile(99);
+
+    // Walk the ring backwards from now; the occupancy at the end of each earlier
+    // minute follows from the current one by undoing that minute's arrivals and departures
+    timelineMinutes = max(0, min(timelineMinutes, TIMELINE_MINUTES));
+    stats.timeline.resize(timelineMinutes);
+    int64_t current = static_cast<int64_t>(now) / 60;
+    int running = occupied;
+    for (int back = 0; back < TIMELINE_MINUTES; ++back) {
+        int64_t minute = current - back;
+        if (minute < 0) break;
+        const MinuteActivity& bucket = timeline[static_cast<size_t>(minute % TIMELINE_MINUTES)];
+        bool used = bucket.minute == minute;
+
+        if (used && back < 60) {
+            stats.arrivalsPerHour += bucket.arrivals;
+            stats.departuresPerHour += bucket.departures;
+            stats.revenueLastHour += bucket.revenue;
+        }
+        if (used) {
+            stats.revenueLastDay += bucket.revenue;
+        }
+        if (back < timelineMinutes) {
+            MinuteActivity& entry = stats.timeline[timelineMinutes - 1 - back];
+            if (used) entry = bucket;
+            entry.minute = minute;
+            entry.occupied = running;
+            entry.peakOccupied = max(entry.peakOccupied, running);
+        }
+        if (used) {
+            running -= static_cast<int>(bucket.arrivals) - static_cast<int>(bucket.departures);
+        }
+    }
+    return stats;
+}
+
+// Formats a duration in seconds as "1h 02m 03s"
+static string formatDuration(uint64_t seconds) {
+    char text[48];
+    snprintf(text, sizeof(text), "%lluh %02llum %02llus", static_cast<unsigned long long>(seconds / 3600),
+        static_cast<unsigned long long>(seconds / 60 % 60), static_cast<unsigned long long>(seconds % 60));
+    return text;
+}
+
+// Prints a statistics snapshot to the console
+void printStatistics(const StatisticsSnapshot& stats) {
+    double occupancy = stats.capacity > 0 ? 100.0 * stats.occupied / stats.capacity : 0;
+    cout << "\nParking Statistics:\n";
+    cout << "   Occupancy:             " << stats.occupied << " / " << stats.capacity
+        << " (" << fixed << setprecision(1) << occupancy << "%), peak " << stats.peakOccupied << "\n";
+    cout << "   Waiting:               " << stats.waiting << " (queued " << stats.queued
+        << ", admitted " << stats.admitted << ", cancelled " << stats.cancelled << ")\n";
+    cout << "   Arrivals / departures: " << stats.arrivals << " / " << stats.departures << "\n";
+    cout << "   Last hour:             " << setprecision(0) << stats.arrivalsPerHour << " arrivals, "
+        << stats.departuresPerHour << " departures, $" << formatCents(stats.revenueLastHour) << "\n";
+    cout << "   Revenue:               $" << formatCents(stats.revenue) << " (last 24h $" << formatCents(stats.revenueLastDay) << ")\n";
+    cout << "   Parking time:          mean " << formatDuration(static_cast<uint64_t>(stats.meanDwellSeconds))
+        << ", p50 " << formatDuration(stats.dwellP50) << ", p95 " << formatDuration(stats.dwellP95)
+        << ", p99 " << formatDuration(stats.dwellP99) << ", max " << formatDuration(stats.dwellMax) << "\n";
+    cout << "   Waiting time:          mean " << formatDuration(static_cast<uint64_t>(stats.meanWaitSeconds))
+        << ", p50 " << formatDuration(stats.waitP50) << ", p95 " << formatDuration(stats.waitP95)
+        << ", p99 " << formatDuration(stats.waitP99) << "\n";
+}
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <cstdint>
+#include <ctime>
+#include <vector>
+#include "Tariff.h"
+
+using namespace std;
+
+// Histogram of durations in seconds with about 3% relative precision (HDR style)
+// Values below 64 get a bucket each; every power of two above that is split into
+// 32 equal buckets, so recording is a bit scan and an increment.
+class DurationHistogram {
+private:
+    static const int SUB_BUCKETS = 32;                        // Buckets per power of two
+    static const int BUCKET_COUNT = (32 - 4) * SUB_BUCKETS;   // Covers durations up to 2^32 seconds
+
+    uint64_t counts[BUCKET_COUNT];   // Number of durations per bucket
+    uint64_t total;                  // Number of recorded durations
+    uint64_t sum;                    // Sum of recorded durations
+    uint64_t largest;                // Longest recorded duration
+
+    // Returns the bucket of a duration
+    static int bucketOf(uint64_t seconds);
+
+    // Returns the longest duration that falls into a bucket
+    static uint64_t bucketUpperBound(int bucket);
+
+public:
+    // Creates an empty histogram
+    DurationHistogram();
+
+    // Records one duration
+    void record(uint64_t seconds);
+
+    // Adds the counts of another histogram
+    void merge(const DurationHistogram& other);
+
+    // Returns the number of recorded durations
+    uint64_t count() const;
+
+    // Returns the mean duration (0 when empty)
+    double mean() const;
+
+    // Returns the longest recorded duration
+    uint64_t max() const;
+
+    // Returns the duration that 'percent' percent of the recorded durations do not exceed
+    uint64_t percentile(double percent) const;
+};
+
+// Activity during one minute
+struct MinuteActivity {
+    int64_t minute = -1;      // Minutes since the epoch (-1 if the bucket was never used)
+    uint32_t arrivals = 0;    // Vehicles that took a slot
+    uint32_t departures = 0;  // Vehicles that left
+    uint32_t queued = 0;      // Vehicles that joined the waiting list
+    Cents revenue = 0;        // Fees charged
+    int occupied = 0;         // Parked vehicles after the minute's last event
+    int peakOccupied = 0;     // Most parked vehicles during the minute
+};
+
+// Statistics read by a dashboard; everything is computed when the snapshot is taken
+struct StatisticsSnapshot {
+    time_t takenAt = 0;                  // Time the snapshot describes
+    int capacity = 0;                    // Number of slots
+    int occupied = 0;                    // Parked vehicles
+    int peakOccupied = 0;                // Most parked vehicles at once
+    int waiting = 0;                     // Vehicles in the waiting list
+    uint64_t arrivals = 0;               // Vehicles that took a slot (directly or from the waiting list)
+    uint64_t departures = 0;             // Vehicles that left
+    uint64_t queued = 0;                 // Vehicles that joined the waiting list
+    uint64_t admitted = 0;               // Waiting vehicles that got a slot
+    uint64_t cancelled = 0;              // Waiting vehicles that gave up
+    double arrivalsPerHour = 0;          // Arrivals during the last 60 minutes
+    double departuresPerHour = 0;        // Departures during the last 60 minutes
+    Cents revenue = 0;                   // Fees charged since start
+    Cents revenueLastHour = 0;           // Fees charged during the last 60 minutes
+    Cents revenueLastDay = 0;            // Fees charged during the last 24 hours
+    double meanDwellSeconds = 0;         // Average parking duration
+    uint64_t dwellP50 = 0;               // Parking duration percentiles in seconds
+    uint64_t dwellP95 = 0;
+    uint64_t dwellP99 = 0;
+    uint64_t dwellMax = 0;
+    double meanWaitSeconds = 0;          // Average time in the waiting list before admission
+    uint64_t waitP50 = 0;                // Waiting time percentiles in seconds
+    uint64_t waitP95 = 0;
+    uint64_t waitP99 = 0;
+    vector<MinuteActivity> timeline;     // Requested number of minutes up to 'takenAt', oldest first
+};
+
+// Running statistics of a parking lot, updated in O(1) on every gate event
+// The hot path only bumps counters; percentiles, rates and the timeline are
+// worked out in snapshot(), so nothing is paid unless somebody reads them.
+// Statistics start when the process starts; recovery only restores the occupancy.
+class ParkingStatistics {
+private:
+    static const int TIMELINE_MINUTES = 24 * 60;   // Minutes kept in the activity ring
+
+    int capacity;                        // Number of slots
+    int occupied;                        // Parked vehicles
+    int peakOccupied;                    // Most parked vehicles at once
+    uint64_t arrivals;                   // Vehicles that took a slot
+    uint64_t departures;                 // Vehicles that left
+    uint64_t queued;                     // Vehicles that joined the waiting list
+    uint64_t admitted;                   // Waiting vehicles that got a slot
+    uint64_t cancelled;                  // Waiting vehicles that gave up
+    Cents revenue;                       // Fees charged
+    DurationHistogram dwellTimes;        // Parking durations
+    DurationHistogram waitTimes;         // Waiting list durations of admitted vehicles
+    vector<MinuteActivity> timeline;     // Ring of the last 24 hours, indexed by minute
+
+    // Returns the ring bucket of a time, clearing it if it still holds an older minute
+    MinuteActivity& minuteOf(time_t now);
+
+    // Records the occupancy after an event
+    void noteOccupancy(MinuteActivity& bucket, int occupancy);
+
+public:
+    // Creates empty statistics for a lot with 'capacity' slots
+    explicit ParkingStatistics(int capacity = 0);
+
+    // A vehicle took a slot at the gate
+    void recordArrival(time_t now, int occupancy);
+
+    // A waiting vehicle took a slot after joining the waiting list at 'queuedAt'
+    void recordAdmission(time_t now, int occupancy, time_t queuedAt);
+
+    // A vehicle parked since 'entryTime' left and paid 'fee'
+    void recordDeparture(time_t now, int occupancy, time_t entryTime, Cents fee);
+
+    // A vehicle joined the waiting list
+    void recordQueued(time_t now);
+
+    // A waiting vehicle gave up
+    void recordCancelled();
+
+    // Sets the occupancy without counting an event (after recovery)
+    void setOccupancy(int occupancy);
+
+    // Adds the statistics of another lot (occupancies and capacities are summed)
+    void merge(const ParkingStatistics& other);
+
+    // Computes a snapshot at 'now' with the last 'timelineMinutes' minutes of activity
+    StatisticsSnapshot snapshot(time_t now, int waiting, int timelineMinutes = 60) const;
+};
+
+// Prints a statistics snapshot to the console
+void printStatistics(const StatisticsSnapshot& stats);
@@ -0,0 +1,153 @@
+#include "PlateHashMap.h"
+#include <algorithm>
+#include "Metrics.h"
+
+// Smallest table size
+static const size_t MIN_TABLE_SIZE = 16;
+
+// Creates an empty map
+PlateHashMap::PlateHashMap() : table(MIN_TABLE_SIZE, Entry{ 0, -1 }), mask(MIN_TABLE_SIZE - 1), count(0) {
+}
+
+// Returns the home position of a key
+size_t PlateHashMap::homeOf(uint64_t key) const {
+    // Final mix of MurmurHash3; consecutive plates differ only in their low characters
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdULL;
+    key ^= key >> 33;
+    return static_cast<size_t>(key) & mask;
+}
+
+// Rebuilds the table with 'entries' positions
+void PlateHashMap::rehash(size_t entries) {
+    vector<Entry> old(entries, Entry{ 0, -1 });
+    old.swap(table);
+    mask = entries - 1;
+    for (const Entry& entry : old) {
+        if (entry.key == 0) continue;
+        size_t position = homeOf(entry.key);
+        while (table[position].key != 0) {
+            position = (position + 1) & mask;
+        }
+        table[position] = entry;
+    }
+}
+
+// Inserts a packed plate
+bool PlateHashMap::insert(PlateKey key, int value) {
+    if ((count + 1) * MAX_LOAD_DENOMINATOR > table.size() * MAX_LOAD_NUMERATOR) {
+        rehash(table.size() * 2);
+    }
+    size_t position = homeOf(key.bits);
+    uint64_t probes = 1;
+    while (table[position].key != 0) {
+        if (table[position].key == key.bits) {
+            METRIC_COUNT(MetricCounter::HashLookups, 1);
+            METRIC_COUNT(MetricCounter::HashProbes, probes);
+            return false;
+        }
+        position = (position + 1) & mask;
+        probes++;
+    }
+    METRIC_COUNT(MetricCounter::HashLookups, 1);
+    METRIC_COUNT(MetricCounter::HashProbes, probes);
+    table[position] = Entry{ key.bits, value };
+    count++;
+    return true;
+}
+
+// Inserts a plate
+bool PlateHashMap::insert(const string& plate, int value) {
+    PlateKey key;
+    if (PlateKey::pack(plate, key)) return insert(key, value);
+    return overflow.emplace(plate, value).second;
+}
+
+// Returns the value stored for a packed plate
+int PlateHashMap::find(PlateKey key) const {
+    size_t position = homeOf(key.bits);
+    uint64_t probes = 1;
+    while (table[position].key != 0 && table[position].key != key.bits) {
+        position = (position + 1) & mask;
+        probes++;
+    }
+    METRIC_COUNT(MetricCounter::HashLookups, 1);
+    METRIC_COUNT(MetricCounter::HashProbes, probes);
+    return table[position].key != 0 ? table[position].value : -1;
+}
+
+// Returns the value stored for a plate
+int PlateHashMap::find(const string& plate) const {
+    PlateKey key;
+    if (PlateKey::pack(plate, key)) return find(key);
+    if (overflow.empty()) return -1;
+    auto it = overflow.find(plate);
+    return it == overflow.end() ? -1 : it->second;
+}
+
+// Removes a packed plate
+bool PlateHashMap::erase(PlateKey key) {
+    size_t position = homeOf(key.bits);
+    uint64_t probes = 1;
+    while (table[position].key != key.bits && table[position].key != 0) {
+        position = (position + 1) & mask;
+        probes++;
+    }
+    METRIC_COUNT(MetricCounter::HashLookups, 1);
+    METRIC_COUNT(MetricCounter::HashProbes, probes);
+    if (table[position].key == 0) return false;
+
+    // Shift later entries of the probe run back into the hole, unless that
+    // would move an entry in front of its home position
+    size_t hole = position;
+    size_t next = (hole + 1) & mask;
+    while (table[next].key != 0) {
+        size_t home = homeOf(table[next].key);
+        if (((next - home) & mask) >= ((next - hole) & mask)) {
+            table[hole] = table[next];
+            hole = next;
+        }
+        next = (next + 1) & mask;
+    }
+    table[hole] = Entry{ 0, -1 };
+    count--;
+    return true;
+}
+
+// Removes a plate
+bool PlateHashMap::erase(const string& plate) {
+    PlateKey key;
+    if (PlateKey::pack(plate, key)) return erase(key);
+    return overflow.erase(plate) > 0;
+}
+
+// Makes room for 'plates' plates
+void PlateHashMap::reserve(size_t plates) {
+    size_t needed = table.size();
+    while (plates * MAX_LOAD_DENOMINATOR > needed * MAX_LOAD_NUMERATOR) {
+        needed *= 2;
+    }
+    if (needed != table.size()) {
+        rehash(needed);
+    }
+}
+
+// Removes all plates
+void PlateHashMap::clear() {
+    fill(table.begin(), table.end(), Entry{ 0, -1 });
+    count = 0;
+    overflow.clear();
+}
+
+// Returns the number of plates in the map
+size_t PlateHashMap::size() const {
+    return count + overflow.size();
+}
+
+// Returns the approximate number of bytes used by the map
+size_t PlateHashMap::memoryUsage() const {
+    // Overflow nodes: key, value and next pointer, plus one bucket pointer each
+    size_t overflowBytes = overflow.size() * (sizeof(string) + sizeof(int) + 2 * sizeof(void*))
+        + overflow.bucket_count() * sizeof(void*);
+    return sizeof(*this) + table.capacity() * sizeof(Entry) + overflowBytes;
+}
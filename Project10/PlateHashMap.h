@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "PlateKey.h"
+
+using namespace std;
+
+// Hash map from registration number to slot index
+// Plates are stored as packed PlateKeys in one flat array of (key, value) pairs with
+// linear probing, so a lookup hashes a single integer and usually touches one cache line.
+// Erasing shifts the following entries back instead of leaving tombstones, so probe
+// sequences never grow with churn. Plates that do not fit a PlateKey (longer than 10
+// characters or not alphanumeric) go to a small string-keyed overflow map.
+class PlateHashMap {
+private:
+    // A table entry; key 0 marks an empty entry
+    struct Entry {
+        uint64_t key;   // Packed plate
+        int value;      // Slot index
+    };
+
+    vector<Entry> table;                        // Open-addressing table (size is a power of two)
+    size_t mask;                                // table.size() - 1
+    size_t count;                               // Number of packed plates in the table
+    unordered_map<string, int> overflow;        // Plates that do not fit a PlateKey
+
+    // The table grows when it would become more than 3/4 full
+    static const size_t MAX_LOAD_NUMERATOR = 3;
+    static const size_t MAX_LOAD_DENOMINATOR = 4;
+
+    // Returns the home position of a key
+    size_t homeOf(uint64_t key) const;
+
+    // Rebuilds the table with 'entries' positions
+    void rehash(size_t entries);
+
+public:
+    // Creates an empty map
+    PlateHashMap();
+
+    // Inserts a plate; returns false if it is already present
+    bool insert(PlateKey key, int value);
+    bool insert(const string& plate, int value);
+
+    // Returns the value stored for a plate, or -1 if it is not present
+    int find(PlateKey key) const;
+    int find(const string& plate) const;
+
+    // Removes a plate; returns false if it was not present
+    bool erase(PlateKey key);
+    bool erase(const string& plate);
+
+    // Makes room for 'plates' plates without rehashing
+    void reserve(size_t plates);
+
+    // Removes all plates (the table keeps its size)
+    void clear();
+
+    // Returns the number of plates in the map
+    size_t size() const;
+
+    // Returns the approximate number of bytes used by the map
+    size_t memoryUsage() const;
+};
@@ -0,0 +1,290 @@
+#include "PlateIndex.h"
+#include <algorithm>
+#include "Metrics.h"
+
+// Constructor for an empty index
+PlateIndex::PlateIndex() : root(-1), count(0) {}
+
+// Returns the height of a subtree (0 for an empty one)
+int PlateIndex::heightOf(int node) const {
+    return node == -1 ? 0 : nodes[node].height;
+}
+
+// Recomputes the height of a node from its children
+void PlateIndex::updateHeight(int node) {
+    nodes[node].height = 1 + max(heightOf(nodes[node].left), heightOf(nodes[node].right));
+}
+
+// Rotates a subtree to the left
+int PlateIndex::rotateLeft(int node) {
+    int pivot = nodes[node].right;
+    nodes[node].right = nodes[pivot].left;
+    nodes[pivot].left = node;
+    updateHeight(node);
+    updateHeight(pivot);
+    return pivot;
+}
+
+// Rotates a subtree to the right
+int PlateIndex::rotateRight(int node) {
+    int pivot = nodes[node].left;
+    nodes[node].left = nodes[pivot].right;
+    nodes[pivot].right = node;
+    updateHeight(node);
+    updateHeight(pivot);
+    return pivot;
+}
+
+// Restores the AVL property at a node
+int PlateIndex::rebalance(int node) {
+    updateHeight(node);
+    int balance = heightOf(nodes[node].left) - heightOf(nodes[node].right);
+
+    if (balance > 1) {
+        // Left-heavy: rotate the left child first for the left-right case
+        if (heightOf(nodes[nodes[node].left].left) < heightOf(nodes[nodes[node].left].right)) {
+            nodes[node].left = rotateLeft(nodes[node].left);
+        }
+        return rotateRight(node);
+    }
+    if (balance < -1) {
+        // Right-heavy: rotate the right child first for the right-left case
+        if (heightOf(nodes[nodes[node].right].right) < heightOf(nodes[nodes[node].right].left)) {
+            nodes[node].right = rotateRight(nodes[node].right);
+        }
+        return rotateLeft(node);
+    }
+    return node;
+}
+
+// Rebalances every node on a search path, bottom-up
+void PlateIndex::rebalancePath(int* path, int depth) {
+    for (int i = depth - 1; i >= 0; --i) {
+        int node = path[i];
+        int newRoot = rebalance(node);
+        if (newRoot == node) continue;
+
+        // Re-link the rotated subtree to its parent
+        if (i == 0) {
+            root = newRoot;
+        }
+        else if (nodes[path[i - 1]].left == node) {
+            nodes[path[i - 1]].left = newRoot;
+        }
+        else {
+            nodes[path[i - 1]].right = newRoot;
+        }
+    }
+}
+
+// Takes a node from the pool
+int PlateIndex::allocateNode(const string& key, int value) {
+    if (!freeNodes.empty()) {
+        int node = freeNodes.back();
+        freeNodes.pop_back();
+        nodes[node] = Node{ key, value, -1, -1, 1 };
+        return node;
+    }
+    nodes.push_back(Node{ key, value, -1, -1, 1 });
+    return static_cast<int>(nodes.size()) - 1;
+}
+
+// Inserts a plate
+bool PlateIndex::insert(const string& key, int value) {
+    int path[MAX_DEPTH];
+    int depth = 0;
+
+    // Walk down to the insertion point, remembering the path
+    int node = root;
+    while (node != -1) {
+        int cmp = key.compare(nodes[node].key);
+        if (cmp == 0) {
+            METRIC_COUNT(MetricCounter::TreeSearches, 1);
+            METRIC_COUNT(MetricCounter::TreeNodesVisited, depth + 1);
+            return false;
+        }
+        path[depth++] = node;
+        node = cmp < 0 ? nodes[node].left : nodes[node].right;
+    }
+
+    METRIC_COUNT(MetricCounter::TreeSearches, 1);
+    METRIC_COUNT(MetricCounter::TreeNodesVisited, depth);
+    int created = allocateNode(key, value);
+    if (depth == 0) {
+        root = created;
+    }
+    else if (key < nodes[path[depth - 1]].key) {
+        nodes[path[depth - 1]].left = created;
+    }
+    else {
+        nodes[path[depth - 1]].right = created;
+    }
+    count++;
+
+    rebalancePath(path, depth);
+    return true;
+}
+
+// Links entries [first, last) into a perfectly balanced subtree
+int PlateIndex::buildBalanced(vector<pair<string, int>>& entries, size_t first, size_t last) {
+    if (first >= last) return -1;
+
+    // The middle entry becomes the root; recursion depth is only log2(n)
+    size_t middle = first + (last - first) / 2;
+    int left = buildBalanced(entries, first, middle);
+    int right = buildBalanced(entries, middle + 1, last);
+    nodes.push_back(Node{ move(entries[middle].first), entries[middle].second, left, right, 1 });
+    int node = static_cast<int>(nodes.size()) - 1;
+    updateHeight(node);
+    return node;
+}
+
+// Replaces the contents with entries sorted by plate in O(n)
+void PlateIndex::buildFromSorted(vector<pair<string, int>>& entries) {
+    clear();
+    nodes.reserve(entries.size());
+    root = buildBalanced(entries, 0, entries.size());
+    count = entries.size();
+}
+
+// Removes a plate
+bool PlateIndex::erase(const string& key) {
+    int path[MAX_DEPTH];
+    int depth = 0;
+
+    // Find the node, remembering the path
+    int node = root;
+    while (node != -1) {
+        int cmp = key.compare(nodes[node].key);
+        if (cmp == 0) break;
+        path[depth++] = node;
+        node = cmp < 0 ? nodes[node].left : nodes[node].right;
+    }
+    METRIC_COUNT(MetricCounter::TreeSearches, 1);
+    METRIC_COUNT(MetricCounter::TreeNodesVisited, node == -1 ? depth : depth + 1);
+    if (node == -1) {
+        return false;
+    }
+
+    // A node with two children takes its successor's key, then the successor is removed
+    if (nodes[node].left != -1 && nodes[node].right != -1) {
+        path[depth++] = node;
+        int successor = nodes[node].right;
+        while (nodes[successor].left != -1) {
+            path[depth++] = successor;
+            successor = nodes[successor].left;
+        }
+        nodes[node].key.swap(nodes[successor].key);
+        nodes[node].value = nodes[successor].value;
+        node = successor;
+    }
+
+    // Splice out the node, which now has at most one child
+    int child = nodes[node].left != -1 ? nodes[node].left : nodes[node].right;
+    if (depth == 0) {
+        root = child;
+    }
+    else if (nodes[path[depth - 1]].left == node) {
+        nodes[path[depth - 1]].left = child;
+    }
+    else {
+        nodes[path[depth - 1]].right = child;
+    }
+    nodes[node].key.clear();
+    freeNodes.push_back(node);
+    count--;
+
+    rebalancePath(path, depth);
+    return true;
+}
+
+// Returns the value stored for a plate
+int PlateIndex::find(const string& key) const {
+    int node = root;
+    uint64_t visited = 0;
+    while (node != -1) {
+        int cmp = key.compare(nodes[node].key);
+        visited++;
+        if (cmp == 0) break;
+        node = cmp < 0 ? nodes[node].left : nodes[node].right;
+    }
+    METRIC_COUNT(MetricCounter::TreeSearches, 1);
+    METRIC_COUNT(MetricCounter::TreeNodesVisited, visited);
+    return node == -1 ? -1 : nodes[node].value;
+}
+
+// Visits plates from 'from' up to and including '*to' in sorted order
+void PlateIndex::walk(const string& from, const string* to, const function<bool(const string&, int)>& visit) const {
+    int stack[MAX_DEPTH];
+    int depth = 0;
+    int node = root;
+
+    // In-order walk with an explicit stack, skipping subtrees below 'from'
+    while (node != -1 || depth > 0) {
+        while (node != -1) {
+            if (nodes[node].key < from) {
+                node = nodes[node].right;
+            }
+            else {
+                stack[depth++] = node;
+                node = nodes[node].left;
+            }
+        }
+        if (depth == 0) break;
+
+        node = stack[--depth];
+        if (to && nodes[node].key > *to) break;
+        if (!visit(nodes[node].key, nodes[node].value)) break;
+        node = nodes[node].right;
+    }
+}
+
+// Visits plates in [from, to] in sorted order
+void PlateIndex::forEachInRange(const string& from, const string& to, const function<bool(const string&, int)>& visit) const {
+    walk(from, &to, visit);
+}
+
+// Visits plates starting with a prefix in sorted order
+void PlateIndex::forEachWithPrefix(const string& prefix, const function<bool(const string&, int)>& visit) const {
+    // The first string above every plate with the prefix: drop trailing 0xFF bytes and
+    // increment the last byte left (none left means every plate from the prefix on matches)
+    string successor = prefix;
+    while (!successor.empty() && static_cast<unsigned char>(successor.back()) == 0xFF) {
+        successor.pop_back();
+    }
+    if (!successor.empty()) {
+        successor.back() = static_cast<char>(static_cast<unsigned char>(successor.back()) + 1);
+    }
+    walk(prefix, successor.empty() ? nullptr : &successor, [&](const string& key, int value) {
+        if (key.compare(0, prefix.size(), prefix) != 0) return false;
+        return visit(key, value);
+    });
+}
+
+// Visits all plates in sorted order
+void PlateIndex::forEach(const function<bool(const string&, int)>& visit) const {
+    walk(string(), nullptr, visit);
+}
+
+// Reserves pool space for a number of plates
+void PlateIndex::reserve(size_t plates) {
+    nodes.reserve(plates);
+}
+
+// Removes all plates
+void PlateIndex::clear() {
+    nodes.clear();
+    freeNodes.clear();
+    root = -1;
+    count = 0;
+}
+
+// Returns the number of plates in the index
+size_t PlateIndex::size() const {
+    return count;
+}
+
+// Returns the height of the tree
+int PlateIndex::height() const {
+    return heightOf(root);
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <functional>
+
+using namespace std;
+
+// Ordered index of registration numbers (balanced AVL tree)
+// Nodes are kept in a pool and linked by index; all operations are iterative,
+// so deep lots never recurse and the tree height stays O(log n).
+class PlateIndex {
+private:
+    // A node of the tree
+    struct Node {
+        string key;     // Registration number
+        int value;      // Value stored with the plate (slot index)
+        int left;       // Index of the left child (-1 if none)
+        int right;      // Index of the right child (-1 if none)
+        int height;     // Height of the subtree rooted at this node
+    };
+
+    vector<Node> nodes;     // Node pool
+    vector<int> freeNodes;  // Indexes of unused nodes in the pool
+    int root;               // Index of the root node (-1 if empty)
+    size_t count;           // Number of keys in the index
+
+    // Maximum tree depth; an AVL tree of 2^31 nodes is shallower than this
+    static const int MAX_DEPTH = 64;
+
+    // Returns the height of a subtree (0 for an empty one)
+    int heightOf(int node) const;
+
+    // Recomputes the height of a node from its children
+    void updateHeight(int node);
+
+    // Rotations used for rebalancing; each returns the new subtree root
+    int rotateLeft(int node);
+    int rotateRight(int node);
+
+    // Restores the AVL property at a node; returns the new subtree root
+    int rebalance(int node);
+
+    // Rebalances every node on a search path, bottom-up
+    void rebalancePath(int* path, int depth);
+
+    // Takes a node from the pool
+    int allocateNode(const string& key, int value);
+
+    // Links entries [first, last) into a perfectly balanced subtree; returns its root
+    int buildBalanced(vector<pair<string, int>>& entries, size_t first, size_t last);
+
+    // Visits plates from 'from' up to and including '*to' in sorted order (no upper bound if 'to' is null)
+    void walk(const string& from, const string* to, const function<bool(const string&, int)>& visit) const;
+
+public:
+    // Constructor for an empty index
+    PlateIndex();
+
+    // Inserts a plate; returns false if it is already present
+    bool insert(const string& key, int value);
+
+    // Replaces the contents with entries sorted by plate (no duplicates) in O(n)
+    void buildFromSorted(vector<pair<string, int>>& entries);
+
+    // Removes a plate; returns false if it was not present
+    bool erase(const string& key);
+
+    // Returns the value stored for a plate, or -1 if it is not present
+    int find(const string& key) const;
+
+    // Visits plates in [from, to] in sorted order; the visitor returns false to stop
+    void forEachInRange(const string& from, const string& to, const function<bool(const string&, int)>& visit) const;
+
+    // Visits plates starting with a prefix in sorted order; the visitor returns false to stop
+    void forEachWithPrefix(const string& prefix, const function<bool(const string&, int)>& visit) const;
+
+    // Visits all plates in sorted order; the visitor returns false to stop
+    void forEach(const function<bool(const string&, int)>& visit) const;
+
+    // Reserves pool space for a number of plates
+    void reserve(size_t plates);
+
+    // Removes all plates
+    void clear();
+
+    // Returns the number of plates in the index
+    size_t size() const;
+
+    // Returns the height of the tree
+    int height() const;
+};
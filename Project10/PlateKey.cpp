@@ -0,0 +1,59 @@
+#include "PlateKey.h"
+
+// Six-bit codes of the characters a key can hold (0 = not allowed)
+// Digits come before upper case before lower case, as in ASCII, so keys sort like plates.
+struct PlateCodeTable {
+    uint8_t codes[256];
+};
+
+// Builds the code table at compile time
+static constexpr PlateCodeTable makePlateCodeTable() {
+    PlateCodeTable table{};
+    for (int c = '0'; c <= '9'; ++c) table.codes[c] = static_cast<uint8_t>(1 + c - '0');
+    for (int c = 'A'; c <= 'Z'; ++c) table.codes[c] = static_cast<uint8_t>(11 + c - 'A');
+    for (int c = 'a'; c <= 'z'; ++c) table.codes[c] = static_cast<uint8_t>(37 + c - 'a');
+    return table;
+}
+
+static constexpr PlateCodeTable PLATE_CODES = makePlateCodeTable();
+
+// Characters of the codes 1..62
+static const char PLATE_CHARACTERS[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz";
+
+// Bits per character
+static const int CODE_BITS = 6;
+
+// Packs a plate into a key
+bool PlateKey::pack(const char* text, size_t length, PlateKey& key) {
+    if (length == 0 || length > MAX_LENGTH) return false;
+
+    uint64_t bits = 0;
+    unsigned rejected = 0;
+    for (size_t i = 0; i < length; ++i) {
+        uint8_t code = PLATE_CODES.codes[static_cast<unsigned char>(text[i])];
+        rejected |= code == 0;
+        bits = (bits << CODE_BITS) | code;
+    }
+    if (rejected) return false;
+
+    // Left-align so that shorter plates sort before their extensions
+    key.bits = bits << (CODE_BITS * (MAX_LENGTH - length));
+    return true;
+}
+
+// Packs a plate into a key
+bool PlateKey::pack(const string& plate, PlateKey& key) {
+    return pack(plate.data(), plate.size(), key);
+}
+
+// Returns the plate stored in the key
+string PlateKey::unpack() const {
+    string plate;
+    plate.reserve(MAX_LENGTH);
+    for (int shift = static_cast<int>(CODE_BITS * (MAX_LENGTH - 1)); shift >= 0; shift -= CODE_BITS) {
+        unsigned code = static_cast<unsigned>(bits >> shift) & 63;
+        if (code == 0) break;
+        plate += PLATE_CHARACTERS[code - 1];
+    }
+    return plate;
+}
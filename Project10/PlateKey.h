@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+using namespace std;
+
+// A registration number packed into one 64-bit value
+// Each character of a plate of up to 10 letters or digits takes six bits, first
+// character in the highest bits, and unused positions are zero. Comparing two keys
+// therefore gives the same order as comparing the plates, and equal plates always
+// have equal keys. The empty key (0) never belongs to a plate.
+struct PlateKey {
+    uint64_t bits = 0;   // Packed characters (0 = no plate)
+
+    // Longest plate that fits into a key
+    static const size_t MAX_LENGTH = 10;
+
+    // Packs a plate; returns false if it is empty, too long or has a character other than a letter or digit
+    static bool pack(const char* text, size_t length, PlateKey& key);
+    static bool pack(const string& plate, PlateKey& key);
+
+    // Returns the plate stored in the key
+    string unpack() const;
+
+    // Returns true if the key holds a plate
+    bool valid() const { return bits != 0; }
+
+    bool operator==(const PlateKey& other) const { return bits == other.bits; }
+    bool operator!=(const PlateKey& other) const { return bits != other.bits; }
+    bool operator<(const PlateKey& other) const { return bits < other.bits; }
+};
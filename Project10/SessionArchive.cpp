@@ -0,0 +1,735 @@
+#include "SessionArchive.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <unordered_map>
+#include "Metrics.h"
+#include "TimestampFormatter.h"
+
+static const char ARCHIVE_MAGIC[4] = { 'P', 'M', 'S', 'A' };
+static const uint32_t ARCHIVE_VERSION = 1;
+static const size_t ARCHIVE_HEADER_SIZE = 8;      // Magic, version
+static const size_t FRAME_SIZE = 8;               // Body length, checksum
+static const size_t BLOCK_FIXED_SIZE = 64;        // Block header fields before the plate filter
+static const int FILTER_HASHES = 7;               // Bloom filter probes per plate
+static const int FILTER_BITS_PER_PLATE = 10;      // About 1% false positives
+
+// Columns of a block, in file order
+enum ArchiveColumn { EXIT_COLUMN, STAY_COLUMN, FEE_COLUMN, PLATE_COLUMN, OWNER_COLUMN, MAKE_COLUMN, MODEL_COLUMN, COLOR_COLUMN, COLUMN_COUNT };
+
+// FNV-1a checksum of a byte range
+static uint32_t checksum(const char* data, size_t length) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; ++i) {
+        hash ^= static_cast<uint8_t>(data[i]);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// 64-bit FNV-1a hash of a plate for the bloom filter
+static uint64_t plateHash(const string& plate) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (char c : plate) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+// Returns true if a plate may be in a bloom filter (false means it is certainly not)
+static bool filterMayContain(const vector<uint64_t>& filter, uint64_t hash) {
+    uint64_t bits = filter.size() * 64;
+    uint64_t step = (hash >> 33) | 1;
+    for (int i = 0; i < FILTER_HASHES; ++i) {
+        uint64_t bit = (hash + i * step) % bits;
+        if (!(filter[bit / 64] >> (bit % 64) & 1)) return false;
+    }
+    return true;
+}
+
+// Appends the raw bytes of a value (native byte order)
+template <typename T>
+static void putValue(string& out, T value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+// Appends a length-prefixed string
+static void putString(string& out, const string& value) {
+    putValue<uint16_t>(out, static_cast<uint16_t>(min<size_t>(value.size(), 0xFFFF)));
+    out.append(value.data(), min<size_t>(value.size(), 0xFFFF));
+}
+
+// Appends an unsigned LEB128 varint
+static void putVarint(string& out, uint64_t value) {
+    while (value >= 0x80) {
+        out += static_cast<char>(value | 0x80);
+        value >>= 7;
+    }
+    out += static_cast<char>(value);
+}
+
+// Appends a signed value as a zigzag varint (small magnitudes stay short)
+static void putSigned(string& out, int64_t value) {
+    putVarint(out, (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+}
+
+// Bounds-checked reader over an in-memory buffer
+struct ArchiveReader {
+    const char* p;     // Current position
+    const char* end;   // End of the buffer
+
+    // Reads a fixed-size value
+    template <typename T>
+    bool get(T& value) {
+        if (static_cast<size_t>(end - p) < sizeof(T)) return false;
+        memcpy(&value, p, sizeof(T));
+        p += sizeof(T);
+        return true;
+    }
+
+    // Reads a length-prefixed string
+    bool getString(string& value) {
+        uint16_t length;
+        if (!get(length) || static_cast<size_t>(end - p) < length) return false;
+        value.assign(p, length);
+        p += length;
+        return true;
+    }
+
+    // Reads an unsigned varint
+    bool getVarint(uint64_t& value) {
+        value = 0;
+        for (int shift = 0; p < end && shift < 64; shift += 7) {
+            uint8_t byte = static_cast<uint8_t>(*p++);
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) return true;
+        }
+        return false;
+    }
+
+    // Reads a zigzag varint
+    bool getSigned(int64_t& value) {
+        uint64_t raw;
+        if (!getVarint(raw)) return false;
+        value = static_cast<int64_t>(raw >> 1) ^ -static_cast<int64_t>(raw & 1);
+        return true;
+    }
+};
+
+// Appends a string column: block dictionary in first-seen order, then one id per row
+static void putStringColumn(string& out, const vector<ParkingSession>& rows, string ParkingSession::* field) {
+    unordered_map<string, uint32_t> ids;
+    ids.reserve(rows.size());
+    vector<const string*> dictionary;
+    vector<uint32_t> rowIds;
+    rowIds.reserve(rows.size());
+    for (const ParkingSession& row : rows) {
+        auto it = ids.find(row.*field);
+        if (it == ids.end()) {
+            it = ids.emplace(row.*field, static_cast<uint32_t>(dictionary.size())).first;
+            dictionary.push_back(&it->first);
+        }
+        rowIds.push_back(it->second);
+    }
+    putVarint(out, dictionary.size());
+    for (const string* value : dictionary) {
+        putVarint(out, value->size());
+        out += *value;
+    }
+    for (uint32_t id : rowIds) {
+        putVarint(out, id);
+    }
+}
+
+// A decoded string column
+struct StringColumn {
+    vector<string> dictionary;   // Distinct values of the block
+    vector<uint32_t> ids;        // Dictionary id per row
+};
+
+// Decodes a string column of 'rows' rows
+static bool getStringColumn(ArchiveReader reader, size_t rows, StringColumn& column) {
+    uint64_t count, length, id;
+    if (!reader.getVarint(count) || count > rows) return false;
+    column.dictionary.resize(static_cast<size_t>(count));
+    for (string& value : column.dictionary) {
+        if (!reader.getVarint(length) || static_cast<uint64_t>(reader.end - reader.p) < length) return false;
+        value.assign(reader.p, static_cast<size_t>(length));
+        reader.p += length;
+    }
+    column.ids.resize(rows);
+    for (uint32_t& rowId : column.ids) {
+        if (!reader.getVarint(id) || id >= count) return false;
+        rowId = static_cast<uint32_t>(id);
+    }
+    return true;
+}
+
+// Returns the dictionary id of a value, or -1 if the block never saw it
+static int64_t dictionaryId(const StringColumn& column, const string& value) {
+    auto it = find(column.dictionary.begin(), column.dictionary.end(), value);
+    return it == column.dictionary.end() ? -1 : it - column.dictionary.begin();
+}
+
+// A block body split into its columns
+struct BlockColumns {
+    uint32_t sessions = 0;                 // Rows in the block
+    time_t minExit = 0;                    // Base of the exit time deltas
+    ArchiveReader columns[COLUMN_COUNT];   // Byte range of each column
+};
+
+// Splits a checked block body into its columns
+static bool splitBlock(const string& body, BlockColumns& block) {
+    ArchiveReader reader{ body.data(), body.data() + body.size() };
+    uint64_t firstSession, rawBytes;
+    int64_t minEntry, maxEntry, minExit, maxExit, totalFees;
+    uint32_t filterWords;
+    if (!reader.get(firstSession) || !reader.get(block.sessions) || !reader.get(minEntry) || !reader.get(maxEntry)
+        || !reader.get(minExit) || !reader.get(maxExit) || !reader.get(totalFees) || !reader.get(rawBytes)
+        || !reader.get(filterWords) || static_cast<uint64_t>(reader.end - reader.p) < filterWords * 8ULL) {
+        return false;
+    }
+    block.minExit = static_cast<time_t>(minExit);
+    reader.p += filterWords * 8ULL;
+    for (ArchiveReader& column : block.columns) {
+        uint32_t length;
+        if (!reader.get(length) || static_cast<uint32_t>(reader.end - reader.p) < length) return false;
+        column = ArchiveReader{ reader.p, reader.p + length };
+        reader.p += length;
+    }
+    return true;
+}
+
+// Decodes the exit times, and the entry times if 'entries' is given
+static bool getTimes(const BlockColumns& block, vector<time_t>& exits, vector<time_t>* entries) {
+    ArchiveReader exitReader = block.columns[EXIT_COLUMN];
+    ArchiveReader stayReader = block.columns[STAY_COLUMN];
+    exits.resize(block.sessions);
+    if (entries) entries->resize(block.sessions);
+    int64_t delta, stay;
+    time_t previous = block.minExit;
+    for (uint32_t i = 0; i < block.sessions; ++i) {
+        if (!exitReader.getSigned(delta)) return false;
+        previous += static_cast<time_t>(delta);
+        exits[i] = previous;
+        if (entries) {
+            if (!stayReader.getSigned(stay)) return false;
+            (*entries)[i] = previous - static_cast<time_t>(stay);
+        }
+    }
+    return true;
+}
+
+// Decodes the fees
+static bool getFees(const BlockColumns& block, vector<Cents>& fees) {
+    ArchiveReader reader = block.columns[FEE_COLUMN];
+    fees.resize(block.sessions);
+    int64_t fee;
+    for (Cents& value : fees) {
+        if (!reader.getSigned(fee)) return false;
+        value = static_cast<Cents>(fee);
+    }
+    return true;
+}
+
+// Returns the bytes a session takes as plain fields (the size of a tail record body)
+static uint64_t plainSize(const ParkingSession& session) {
+    return 8 + 5 * 2 + session.regNumber.size() + session.ownerName.size() + session.vehicleMake.size()
+        + session.vehicleModel.size() + session.vehicleColor.size() + 3 * 8;
+}
+
+// Creates an archive; call open() before use
+SessionArchive::SessionArchive(const string& archivePath, size_t sessionsPerBlock, bool flushEach)
+    : path(archivePath), tailPath(archivePath + ".tail"), blockSessions(max<size_t>(sessionsPerBlock, 1)),
+    flushEverySession(flushEach), readOnly(false), nextSession(0), fileBytes(0), rawBytes(0) {
+}
+
+// Writes pending tail records
+SessionArchive::~SessionArchive() {
+    flush();
+}
+
+// Opens (or creates) the archive and reloads its open block
+bool SessionArchive::open() {
+    readOnly = false;
+    if (!loadBlocks() || !loadTail()) {
+        return false;
+    }
+    archiveFile.open(path, ios::binary | ios::app);
+    tailFile.open(tailPath, ios::binary | ios::app);
+    return archiveFile.is_open() && tailFile.is_open();
+}
+
+// Opens the archive for queries only
+bool SessionArchive::openReadOnly() {
+    readOnly = true;
+    archiveFile.close();
+    tailFile.close();
+    return loadBlocks() && loadTail();
+}
+
+// Reads the block headers of the block file; cuts off a torn last block unless read-only
+bool SessionArchive::loadBlocks() {
+    blocks.clear();
+    nextSession = 0;
+    rawBytes = 0;
+    error_code ignored;
+    bool exists = filesystem::exists(path, ignored);
+    uint64_t size = exists ? filesystem::file_size(path, ignored) : 0;
+    if (readOnly && !exists) {
+        // Nothing archived yet
+        fileBytes = 0;
+        return true;
+    }
+    if (size < ARCHIVE_HEADER_SIZE) {
+        if (readOnly) {
+            return false;
+        }
+        // New archive: write the file header
+        ofstream created(path, ios::binary | ios::trunc);
+        created.write(ARCHIVE_MAGIC, 4);
+        created.write(reinterpret_cast<const char*>(&ARCHIVE_VERSION), sizeof(ARCHIVE_VERSION));
+        fileBytes = ARCHIVE_HEADER_SIZE;
+        return static_cast<bool>(created);
+    }
+
+    ifstream file(path, ios::binary);
+    char header[ARCHIVE_HEADER_SIZE];
+    uint32_t version;
+    if (!file.read(header, sizeof(header)) || memcmp(header, ARCHIVE_MAGIC, 4) != 0) {
+        return false;
+    }
+    memcpy(&version, header + 4, sizeof(version));
+    if (version != ARCHIVE_VERSION) {
+        return false;
+    }
+
+    // Only the frame and the block header are read; the columns are skipped
+    uint64_t offset = ARCHIVE_HEADER_SIZE;
+    string fixed(BLOCK_FIXED_SIZE, '\0');
+    while (offset + FRAME_SIZE + BLOCK_FIXED_SIZE <= size) {
+        uint32_t frame[2];
+        file.seekg(static_cast<streamoff>(offset));
+        if (!file.read(reinterpret_cast<char*>(frame), sizeof(frame)) || frame[0] < BLOCK_FIXED_SIZE
+            || offset + FRAME_SIZE + frame[0] > size || !file.read(&fixed[0], BLOCK_FIXED_SIZE)) {
+            break;
+        }
+        BlockInfo block;
+        ArchiveReader reader{ fixed.data(), fixed.data() + fixed.size() };
+        int64_t minEntry = 0, maxEntry = 0, minExit = 0, maxExit = 0, totalFees = 0;
+        uint32_t filterWords = 0;
+        reader.get(block.firstSession);
+        reader.get(block.sessions);
+        reader.get(minEntry);
+        reader.get(maxEntry);
+        reader.get(minExit);
+        reader.get(maxExit);
+        reader.get(totalFees);
+        reader.get(block.rawBytes);
+        reader.get(filterWords);
+        if (block.firstSession != nextSession || filterWords == 0 || BLOCK_FIXED_SIZE + filterWords * 8ULL > frame[0]) {
+            break;
+        }
+        block.plateFilter.resize(filterWords);
+        if (!file.read(reinterpret_cast<char*>(block.plateFilter.data()), filterWords * 8)) {
+            break;
+        }
+        block.offset = offset + FRAME_SIZE;
+        block.length = frame[0];
+        block.checksum = frame[1];
+        block.minEntry = static_cast<time_t>(minEntry);
+        block.maxEntry = static_cast<time_t>(maxEntry);
+        block.minExit = static_cast<time_t>(minExit);
+        block.maxExit = static_cast<time_t>(maxExit);
+        block.totalFees = static_cast<Cents>(totalFees);
+        nextSession = block.firstSession + block.sessions;
+        rawBytes += block.rawBytes;
+        blocks.push_back(move(block));
+        offset += FRAME_SIZE + frame[0];
+    }
+    file.close();
+
+    // A block torn by a crash is dropped; its sessions are still in the tail
+    if (offset < size && !readOnly) {
+        filesystem::resize_file(path, offset, ignored);
+    }
+    fileBytes = offset;
+    return true;
+}
+
+// Reloads the sessions of the open block from the tail; cuts off a torn record unless read-only
+bool SessionArchive::loadTail() {
+    openRows.clear();
+    ifstream file(tailPath, ios::binary | ios::ate);
+    if (!file.is_open()) {
+        return true;
+    }
+    streamoff size = file.tellg();
+    string content(static_cast<size_t>(max<streamoff>(size, 0)), '\0');
+    file.seekg(0);
+    if (size > 0 && !file.read(&content[0], size)) {
+        return false;
+    }
+    file.close();
+
+    // Records of sessions already sealed are skipped; a torn record ends the tail
+    ArchiveReader reader{ content.data(), content.data() + content.size() };
+    size_t validBytes = 0;
+    while (true) {
+        uint32_t length, sum;
+        if (!reader.get(length) || !reader.get(sum) || static_cast<uint32_t>(reader.end - reader.p) < length
+            || checksum(reader.p, length) != sum) {
+            break;
+        }
+        ArchiveReader body{ reader.p, reader.p + length };
+        reader.p += length;
+        uint64_t number;
+        int64_t entryTime, exitTime, fee;
+        ParkingSession session;
+        if (!body.get(number) || !body.getString(session.regNumber) || !body.getString(session.ownerName)
+            || !body.getString(session.vehicleMake) || !body.getString(session.vehicleModel)
+            || !body.getString(session.vehicleColor) || !body.get(entryTime) || !body.get(exitTime) || !body.get(fee)
+            || number > nextSession + openRows.size()) {
+            break;
+        }
+        validBytes = static_cast<size_t>(reader.p - content.data());
+        if (number < nextSession + openRows.size()) continue;
+        session.entryTime = static_cast<time_t>(entryTime);
+        session.exitTime = static_cast<time_t>(exitTime);
+        session.fee = static_cast<Cents>(fee);
+        openRows.push_back(move(session));
+    }
+    nextSession += openRows.size();
+    if (validBytes < content.size() && !readOnly) {
+        error_code ignored;
+        filesystem::resize_file(tailPath, validBytes, ignored);
+    }
+    return true;
+}
+
+// Appends a completed session
+void SessionArchive::append(const ParkingSession& session) {
+    if (readOnly) {
+        return;
+    }
+    METRIC_COUNT(MetricCounter::ArchiveSessions, 1);
+
+    // Row journal first, so the session survives a crash before its block is sealed
+    buffer.clear();
+    putValue<uint64_t>(buffer, nextSession);
+    putString(buffer, session.regNumber);
+    putString(buffer, session.ownerName);
+    putString(buffer, session.vehicleMake);
+    putString(buffer, session.vehicleModel);
+    putString(buffer, session.vehicleColor);
+    putValue<int64_t>(buffer, static_cast<int64_t>(session.entryTime));
+    putValue<int64_t>(buffer, static_cast<int64_t>(session.exitTime));
+    putValue<int64_t>(buffer, static_cast<int64_t>(session.fee));
+    uint32_t frame[2] = { static_cast<uint32_t>(buffer.size()), checksum(buffer.data(), buffer.size()) };
+    tailFile.write(reinterpret_cast<const char*>(frame), sizeof(frame));
+    tailFile.write(buffer.data(), buffer.size());
+    if (flushEverySession) {
+        tailFile.flush();
+    }
+
+    openRows.push_back(session);
+    nextSession++;
+    if (openRows.size() >= blockSessions) {
+        sealOpenBlock();
+    }
+}
+
+// Writes pending tail records to disk
+void SessionArchive::flush() {
+    if (tailFile.is_open()) {
+        tailFile.flush();
+    }
+}
+
+// Encodes the open rows as a block and appends it to the block file
+bool SessionArchive::sealOpenBlock() {
+    if (openRows.empty()) {
+        return true;
+    }
+    if (readOnly) {
+        return false;
+    }
+    METRIC_SCOPE(MetricOperation::ArchiveSeal);
+
+    // Header fields and the plate filter
+    BlockInfo block;
+    block.firstSession = nextSession - openRows.size();
+    block.sessions = static_cast<uint32_t>(openRows.size());
+    block.minEntry = block.maxEntry = openRows[0].entryTime;
+    block.minExit = block.maxExit = openRows[0].exitTime;
+    for (const ParkingSession& row : openRows) {
+        block.minEntry = min(block.minEntry, row.entryTime);
+        block.maxEntry = max(block.maxEntry, row.entryTime);
+        block.minExit = min(block.minExit, row.exitTime);
+        block.maxExit = max(block.maxExit, row.exitTime);
+        block.totalFees += row.fee;
+        block.rawBytes += plainSize(row);
+    }
+    vector<uint64_t> plateHashes;
+    plateHashes.reserve(openRows.size());
+    for (const ParkingSession& row : openRows) {
+        plateHashes.push_back(plateHash(row.regNumber));
+    }
+    sort(plateHashes.begin(), plateHashes.end());
+    plateHashes.erase(unique(plateHashes.begin(), plateHashes.end()), plateHashes.end());
+    block.plateFilter.assign((plateHashes.size() * FILTER_BITS_PER_PLATE + 63) / 64, 0);
+    uint64_t filterBits = block.plateFilter.size() * 64;
+    for (uint64_t hash : plateHashes) {
+        uint64_t step = (hash >> 33) | 1;
+        for (int i = 0; i < FILTER_HASHES; ++i) {
+            uint64_t bit = (hash + i * step) % filterBits;
+            block.plateFilter[bit / 64] |= 1ULL << (bit % 64);
+        }
+    }
+
+    buffer.clear();
+    putValue<uint64_t>(buffer, block.firstSession);
+    putValue<uint32_t>(buffer, block.sessions);
+    putValue<int64_t>(buffer, static_cast<int64_t>(block.minEntry));
+    putValue<int64_t>(buffer, static_cast<int64_t>(block.maxEntry));
+    putValue<int64_t>(buffer, static_cast<int64_t>(block.minExit));
+    putValue<int64_t>(buffer, static_cast<int64_t>(block.maxExit));
+    putValue<int64_t>(buffer, static_cast<int64_t>(block.totalFees));
+    putValue<uint64_t>(buffer, block.rawBytes);
+    putValue<uint32_t>(buffer, static_cast<uint32_t>(block.plateFilter.size()));
+    buffer.append(reinterpret_cast<const char*>(block.plateFilter.data()), block.plateFilter.size() * 8);
+
+    // Columns, each prefixed with its length so readers can skip the ones they do not need
+    string column;
+    for (int c = 0; c < COLUMN_COUNT; ++c) {
+        column.clear();
+        switch (c) {
+        case EXIT_COLUMN: {
+            time_t previous = block.minExit;
+            for (const ParkingSession& row : openRows) {
+                putSigned(column, static_cast<int64_t>(row.exitTime - previous));
+                previous = row.exitTime;
+            }
+            break;
+        }
+        case STAY_COLUMN:
+            for (const ParkingSession& row : openRows) putSigned(column, static_cast<int64_t>(row.exitTime - row.entryTime));
+            break;
+        case FEE_COLUMN:
+            for (const ParkingSession& row : openRows) putSigned(column, static_cast<int64_t>(row.fee));
+            break;
+        case PLATE_COLUMN: putStringColumn(column, openRows, &ParkingSession::regNumber); break;
+        case OWNER_COLUMN: putStringColumn(column, openRows, &ParkingSession::ownerName); break;
+        case MAKE_COLUMN: putStringColumn(column, openRows, &ParkingSession::vehicleMake); break;
+        case MODEL_COLUMN: putStringColumn(column, openRows, &ParkingSession::vehicleModel); break;
+        case COLOR_COLUMN: putStringColumn(column, openRows, &ParkingSession::vehicleColor); break;
+        }
+        putValue<uint32_t>(buffer, static_cast<uint32_t>(column.size()));
+        buffer += column;
+    }
+
+    // Append the block, then start an empty tail
+    block.offset = fileBytes + FRAME_SIZE;
+    block.length = static_cast<uint32_t>(buffer.size());
+    block.checksum = checksum(buffer.data(), buffer.size());
+    uint32_t frame[2] = { block.length, block.checksum };
+    archiveFile.write(reinterpret_cast<const char*>(frame), sizeof(frame));
+    archiveFile.write(buffer.data(), buffer.size());
+    archiveFile.flush();
+    if (!archiveFile) {
+        // Cut the partial block off so the next seal starts on a block boundary; if the file
+        // cannot be cut it stays closed, and every later seal fails instead of writing after it
+        archiveFile.close();
+        error_code error;
+        filesystem::resize_file(path, fileBytes, error);
+        if (!error) {
+            archiveFile.open(path, ios::binary | ios::app);
+        }
+        return false;
+    }
+    fileBytes += FRAME_SIZE + buffer.size();
+    rawBytes += block.rawBytes;
+    blocks.push_back(move(block));
+    openRows.clear();
+    tailFile.close();
+    tailFile.open(tailPath, ios::binary | ios::trunc);
+    return tailFile.is_open();
+}
+
+// Reads and checks the body of a block
+bool SessionArchive::readBlock(ifstream& file, const BlockInfo& block, string& body) const {
+    body.resize(block.length);
+    file.clear();
+    file.seekg(static_cast<streamoff>(block.offset));
+    return file.read(&body[0], block.length) && checksum(body.data(), body.size()) == block.checksum;
+}
+
+// Collects the sessions that match a query, oldest first
+size_t SessionArchive::findSessions(const SessionQuery& query, vector<ParkingSession>& results, ArchiveScanStats* stats) const {
+    ArchiveScanStats scan;
+    size_t before = results.size();
+    uint64_t hash = plateHash(query.regNumber);
+    ifstream file(path, ios::binary);
+    string body;
+    BlockColumns columns;
+    vector<time_t> exits, entries;
+    vector<Cents> fees;
+    StringColumn plates, owners, makes, models, colors;
+
+    for (const BlockInfo& block : blocks) {
+        // Block headers rule out most of the history without touching the disk
+        scan.blocks++;
+        if (block.minEntry > query.to || block.maxExit < query.from) {
+            scan.skippedByTime++;
+            continue;
+        }
+        if (!query.regNumber.empty() && !filterMayContain(block.plateFilter, hash)) {
+            scan.skippedByPlate++;
+            continue;
+        }
+        if (!readBlock(file, block, body) || !splitBlock(body, columns)) continue;
+        scan.blocksRead++;
+
+        // Filter on the plate and make columns before decoding anything else
+        int64_t plateId = -1, makeId = -1;
+        if (!getStringColumn(columns.columns[PLATE_COLUMN], block.sessions, plates)) continue;
+        if (!query.regNumber.empty() && (plateId = dictionaryId(plates, query.regNumber)) == -1) continue;
+        if (!getStringColumn(columns.columns[MAKE_COLUMN], block.sessions, makes)) continue;
+        if (!query.vehicleMake.empty() && (makeId = dictionaryId(makes, query.vehicleMake)) == -1) continue;
+        if (!getTimes(columns, exits, &entries) || !getFees(columns, fees)
+            || !getStringColumn(columns.columns[OWNER_COLUMN], block.sessions, owners)
+            || !getStringColumn(columns.columns[MODEL_COLUMN], block.sessions, models)
+            || !getStringColumn(columns.columns[COLOR_COLUMN], block.sessions, colors)) {
+            continue;
+        }
+        for (uint32_t i = 0; i < block.sessions; ++i) {
+            if ((plateId != -1 && plates.ids[i] != plateId) || (makeId != -1 && makes.ids[i] != makeId)
+                || entries[i] > query.to || exits[i] < query.from) {
+                continue;
+            }
+            ParkingSession session;
+            session.regNumber = plates.dictionary[plates.ids[i]];
+            session.ownerName = owners.dictionary[owners.ids[i]];
+            session.vehicleMake = makes.dictionary[makes.ids[i]];
+            session.vehicleModel = models.dictionary[models.ids[i]];
+            session.vehicleColor = colors.dictionary[colors.ids[i]];
+            session.entryTime = entries[i];
+            session.exitTime = exits[i];
+            session.fee = fees[i];
+            results.push_back(move(session));
+        }
+    }
+
+    // Sessions of the open block are still plain rows
+    for (const ParkingSession& row : openRows) {
+        if ((query.regNumber.empty() || row.regNumber == query.regNumber)
+            && (query.vehicleMake.empty() || row.vehicleMake == query.vehicleMake)
+            && row.entryTime <= query.to && row.exitTime >= query.from) {
+            results.push_back(row);
+        }
+    }
+    scan.sessionsMatched = results.size() - before;
+    if (stats) *stats = scan;
+    return results.size() - before;
+}
+
+// Sums the fees of sessions that ended in [from, to] per vehicle make
+void SessionArchive::revenueByMake(time_t from, time_t to, map<string, Cents>& revenue, ArchiveScanStats* stats) const {
+    ArchiveScanStats scan;
+    ifstream file(path, ios::binary);
+    string body;
+    BlockColumns columns;
+    vector<time_t> exits;
+    vector<Cents> fees;
+    StringColumn makes;
+    vector<Cents> perMake;
+
+    for (const BlockInfo& block : blocks) {
+        scan.blocks++;
+        if (block.minExit > to || block.maxExit < from) {
+            scan.skippedByTime++;
+            continue;
+        }
+        if (!readBlock(file, block, body) || !splitBlock(body, columns)) continue;
+        scan.blocksRead++;
+
+        // Only the exit, fee and make columns are decoded; sums go by dictionary id
+        if (!getTimes(columns, exits, nullptr) || !getFees(columns, fees)
+            || !getStringColumn(columns.columns[MAKE_COLUMN], block.sessions, makes)) {
+            continue;
+        }
+        perMake.assign(makes.dictionary.size(), 0);
+        for (uint32_t i = 0; i < block.sessions; ++i) {
+            if (exits[i] < from || exits[i] > to) continue;
+            perMake[makes.ids[i]] += fees[i];
+            scan.sessionsMatched++;
+        }
+        for (size_t id = 0; id < perMake.size(); ++id) {
+            if (perMake[id] != 0) revenue[makes.dictionary[id]] += perMake[id];
+        }
+    }
+    for (const ParkingSession& row : openRows) {
+        if (row.exitTime >= from && row.exitTime <= to) {
+            revenue[row.vehicleMake] += row.fee;
+            scan.sessionsMatched++;
+        }
+    }
+    if (stats) *stats = scan;
+}
+
+// Returns the size of the archive
+ArchiveInfo SessionArchive::getInfo() const {
+    ArchiveInfo info;
+    info.blocks = blocks.size();
+    info.sealedSessions = nextSession - openRows.size();
+    info.openSessions = openRows.size();
+    info.fileBytes = fileBytes;
+    info.rawBytes = rawBytes;
+    return info;
+}
+
+// Prints sessions as a table with local entry and exit times
+void printSessions(const vector<ParkingSession>& sessions) {
+    if (sessions.empty()) {
+        cout << "\nNo sessions found.\n";
+        return;
+    }
+    TimestampFormatter timestamps;
+    string report = "\nRegistration  Entry                Exit                 Fee        Vehicle\n";
+    char line[160];
+    char entry[TimestampFormatter::LENGTH + 1] = { 0 };
+    char exit[TimestampFormatter::LENGTH + 1] = { 0 };
+    for (const ParkingSession& session : sessions) {
+        timestamps.format(session.entryTime, entry);
+        timestamps.format(session.exitTime, exit);
+        snprintf(line, sizeof(line), "%-13s %s  %s  $%-9s ", session.regNumber.c_str(), entry, exit,
+            formatCents(session.fee).c_str());
+        report += line;
+        report += session.vehicleColor + " " + session.vehicleMake + " " + session.vehicleModel + " (" + session.ownerName + ")\n";
+    }
+    cout << report << sessions.size() << " session(s)\n";
+}
+
+// Prints revenue per make, largest first
+void printRevenueByMake(const map<string, Cents>& revenue) {
+    vector<pair<string, Cents>> rows(revenue.begin(), revenue.end());
+    sort(rows.begin(), rows.end(), [](const pair<string, Cents>& a, const pair<string, Cents>& b) {
+        return a.second > b.second;
+    });
+    Cents total = 0;
+    cout << "\nRevenue by Make:\n";
+    for (const auto& row : rows) {
+        cout << "   " << left << setw(16) << row.first << right << setw(14) << "$" + formatCents(row.second) << "\n";
+        total += row.second;
+    }
+    cout << "   " << left << setw(16) << "Total" << right << setw(14) << "$" + formatCents(total) << "\n";
+}
+
+// Prints how many blocks a query read and skipped
+void printScanStats(const ArchiveScanStats& stats) {
+    cout << "Blocks read: " << stats.blocksRead << " of " << stats.blocks << " (skipped " << stats.skippedByTime
+        << " by time range, " << stats.skippedByPlate << " by plate filter)\n";
+}
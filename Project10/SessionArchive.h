@@ -0,0 +1,146 @@
+#pragma once
+
+#include <cstdint>
+#include <ctime>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <string>
+#include <vector>
+#include "Tariff.h"
+
+using namespace std;
+
+// One completed parking session
+struct ParkingSession {
+    string regNumber;      // Vehicle registration number
+    string ownerName;      // Owner name
+    string vehicleMake;    // Vehicle make
+    string vehicleModel;   // Vehicle model
+    string vehicleColor;   // Vehicle color
+    time_t entryTime = 0;  // When the vehicle took its slot
+    time_t exitTime = 0;   // When the vehicle left
+    Cents fee = 0;         // Fee charged, in cents
+};
+
+// Sessions to look up; empty fields match any value
+struct SessionQuery {
+    string regNumber;                                // Only sessions of this plate
+    string vehicleMake;                              // Only sessions of this make
+    time_t from = numeric_limits<time_t>::min();     // Only stays that overlap [from, to]
+    time_t to = numeric_limits<time_t>::max();
+};
+
+// How much of the archive a query had to read
+struct ArchiveScanStats {
+    uint64_t blocks = 0;              // Sealed blocks in the archive
+    uint64_t skippedByTime = 0;       // Blocks whose time range missed the query
+    uint64_t skippedByPlate = 0;      // Blocks whose plate filter ruled the plate out
+    uint64_t blocksRead = 0;          // Blocks read and decoded
+    uint64_t sessionsMatched = 0;     // Sessions that matched
+};
+
+// Size of the archive
+struct ArchiveInfo {
+    uint64_t blocks = 0;              // Sealed blocks
+    uint64_t sealedSessions = 0;      // Sessions in sealed blocks
+    uint64_t openSessions = 0;        // Sessions waiting for the next block (kept in the tail file)
+    uint64_t fileBytes = 0;           // Bytes of the block file
+    uint64_t rawBytes = 0;            // Bytes the sealed sessions take as plain fields
+};
+
+// Append-only history of completed sessions in compressed columnar blocks
+// Sessions first go to a small row journal (the "tail", path + ".tail") so none is lost
+// on a crash. Every 'blockSessions' sessions they are sealed into one block of the
+// archive file and the tail starts over.
+// File layout: "PMSA", version, then blocks framed as [body length][checksum][body].
+// A block body starts with its first session number, session count, entry/exit time
+// range, fee total and a plate bloom filter, followed by eight columns, each
+// [length][bytes]: exit time deltas, stay lengths and fees as varints, then plate, owner,
+// make, model and color as a block dictionary plus varint ids. Queries read only the
+// small block headers (kept in memory) to skip blocks outside the time range or without
+// the plate, and decode only the columns they need.
+class SessionArchive {
+private:
+    // What the archive keeps in memory about a sealed block
+    struct BlockInfo {
+        uint64_t offset = 0;          // File offset of the block body
+        uint32_t length = 0;          // Body length in bytes
+        uint32_t checksum = 0;        // Checksum of the body
+        uint64_t firstSession = 0;    // Number of the block's first session
+        uint32_t sessions = 0;        // Sessions in the block
+        time_t minEntry = 0;          // Earliest entry time
+        time_t maxEntry = 0;          // Latest entry time
+        time_t minExit = 0;           // Earliest exit time
+        time_t maxExit = 0;           // Latest exit time
+        Cents totalFees = 0;          // Fees of all sessions in the block
+        uint64_t rawBytes = 0;        // Bytes the block's sessions take as plain fields
+        vector<uint64_t> plateFilter; // Bloom filter of the block's plates
+    };
+
+    string path;                      // Block file path
+    string tailPath;                  // Row journal of the open block
+    size_t blockSessions;             // Sessions per sealed block
+    bool flushEverySession;           // Flush the tail after every session
+    bool readOnly;                    // Opened with openReadOnly(): never create, cut or append to the files
+    vector<BlockInfo> blocks;         // Sealed blocks in file order
+    vector<ParkingSession> openRows;  // Sessions not yet sealed
+    uint64_t nextSession;             // Number of the next session appended
+    uint64_t fileBytes;               // Current length of the block file
+    uint64_t rawBytes;                // Plain size of the sealed sessions
+    ofstream archiveFile;             // Block file, open for appending
+    ofstream tailFile;                // Tail file, open for appending
+    string buffer;                    // Scratch for encoding
+
+    // Reads the block headers of the block file; cuts off a torn last block unless read-only
+    bool loadBlocks();
+
+    // Reloads the sessions of the open block from the tail; cuts off a torn record unless read-only
+    bool loadTail();
+
+    // Reads and checks the body of a block
+    bool readBlock(ifstream& file, const BlockInfo& block, string& body) const;
+
+public:
+    // Creates an archive; call open() before use
+    SessionArchive(const string& path, size_t blockSessions = 65536, bool flushEverySession = true);
+
+    // Writes pending tail records
+    ~SessionArchive();
+
+    // Opens (or creates) the archive and reloads its open block; returns false on I/O failure
+    bool open();
+
+    // Opens the archive for queries only: a missing archive reads as empty, and torn blocks or
+    // tail records are skipped without touching the files. append() is ignored and sealOpenBlock() fails.
+    bool openReadOnly();
+
+    // Appends a completed session
+    void append(const ParkingSession& session);
+
+    // Writes pending tail records to disk
+    void flush();
+
+    // Encodes the open rows as a block and appends it to the block file
+    // append() seals full blocks by itself; call this to seal a partial one. If the write
+    // fails, the partial block is cut off the file and the rows stay in the open block.
+    bool sealOpenBlock();
+
+    // Collects the sessions that match a query, oldest first
+    size_t findSessions(const SessionQuery& query, vector<ParkingSession>& results, ArchiveScanStats* stats = nullptr) const;
+
+    // Sums the fees of sessions that ended in [from, to] per vehicle make
+    void revenueByMake(time_t from, time_t to, map<string, Cents>& revenue, ArchiveScanStats* stats = nullptr) const;
+
+    // Returns the size of the archive
+    ArchiveInfo getInfo() const;
+};
+
+// Prints sessions as a table with local entry and exit times
+void printSessions(const vector<ParkingSession>& sessions);
+
+// Prints revenue per make, largest first
+void printRevenueByMake(const map<string, Cents>& revenue);
+
+// Prints how many blocks a query read and skipped
+void printScanStats(const ArchiveScanStats& stats);
@@ -10,6 +10,16 @@
 #include <limits>
 #include <string>
 #include "ParkingManagementSystem.h"
+#include "BatchReplay.h"
+#include "Benchmarks.h"
+#include "BenchmarkSuite.h"
+#include "LogAnalytics.h"
+#include "LoadGenerator.h"
+#include "Metrics.h"
+#include "ParkingServer.h"
+#include "ParkingExport.h"
+#include "ParkingImport.h"
+#include "ParkingSimulator.h"
 
 using namespace std;
 
@@ -61,17 +71,298 @@ void displayMenuWithCar() {
     cout << BACKGROUND_COLOR << TEXT_COLOR << "                                  4. Apply Filter                                                 " << RESET_TEXT << endl;
     cout << BACKGROUND_COLOR << TEXT_COLOR << "                                  5. Display Parking Lot                                          " << RESET_TEXT << endl;
     cout << BACKGROUND_COLOR << TEXT_COLOR << "                                  6. Generate Statistics                                          " << RESET_TEXT << endl;
-    cout << BACKGROUND_COLOR << TEXT_COLOR << "                                  7. Exit                                                         " << RESET_TEXT << endl;
+    cout << BACKGROUND_COLOR << TEXT_COLOR << "                                  7. Manage Waiting Queue                                         " << RESET_TEXT << endl;
+    cout << BACKGROUND_COLOR << TEXT_COLOR << "                                  8. Exit                                                         " << RESET_TEXT << endl;
 
     // Bottom border for the menu
     cout << BACKGROUND_COLOR << BORDER_COLOR;
     cout << "**************************************************************************************************" << RESET_COLOR << endl;
 
     // Prompt the user for input
-    cout << BACKGROUND_COLOR << TEXT_COLOR << "                             Enter your choice (1-7): " << RESET_COLOR;
+    cout << BACKGROUND_COLOR << TEXT_COLOR << "                             Enter your choice (1-8): " << RESET_COLOR;
 }
 
-int main() {
+int main(int argc, char* argv[]) {
+    // Non-interactive mode: replay a command file of gate events
+    // Usage: Project10.exe --replay <commandFile> [capacity] [rate]
+    if (argc >= 3 && string(argv[1]) == "--replay") {
+        int capacity = argc >= 4 ? atoi(argv[3]) : 5;
+        double rate = argc >= 5 ? atof(argv[4]) : 10.0;
+        ParkingConfig replayConfig;
+        replayConfig.journalPath = ""; // Replays must not touch the live lot's journal
+        replayConfig.archivePath = "";
+        ParkingManagementSystem replaySystem(capacity, rate, replayConfig);
+        ReplayReport report;
+        if (!replayCommandFile(replaySystem, argv[2], report)) {
+            cout << RED_TEXT << "Error: Failed to open command file " << argv[2] << RESET_TEXT << endl;
+            return 1;
+        }
+        printReplayReport(report);
+        return 0;
+    }
+
+    // Offline analytics over the event log and its rotated siblings
+    // Usage: Project10.exe --analyze <logFile> [--threads N] [--from YYYY-MM-DD] [--to YYYY-MM-DD] [--hourly] [--no-rotated]
+    if (argc >= 3 && string(argv[1]) == "--analyze") {
+        AnalysisOptions options;
+        bool hourly = false;
+        for (int i = 3; i < argc; ++i) {
+            string option = argv[i];
+            int year, month, day;
+            if (option == "--threads" && i + 1 < argc) {
+                options.threads = atoi(argv[++i]);
+            }
+            else if ((option == "--from" || option == "--to") && i + 1 < argc
+                && sscanf_s(argv[i + 1], "%d-%d-%d", &year, &month, &day) == 3) {
+                (option == "--from" ? options.fromDay : options.toDay) = daysFromCivil(year, month, day);
+                ++i;
+            }
+            else if (option == "--hourly") {
+                hourly = true;
+            }
+            else if (option == "--no-rotated") {
+                options.includeRotated = false;
+            }
+            else {
+                cout << RED_TEXT << "Error: Unknown option " << option << RESET_TEXT << endl;
+                return 1;
+            }
+        }
+
+        LogAnalysis analysis;
+        vector<string> files = findLogFiles(argv[2], options.includeRotated);
+        if (files.empty() || !analyzeLogs(files, options, analysis)) {
+            cout << RED_TEXT << "Error: Failed to read log file " << argv[2] << RESET_TEXT << endl;
+            return 1;
+        }
+        printLogAnalysis(analysis, hourly);
+        return 0;
+    }
+
+    // Benchmark mode
+    // Usage: Project10.exe --bench <name> [size]
+    if (argc >= 3 && string(argv[1]) == "--bench") {
+        int size = argc >= 4 ? atoi(argv[3]) : 0;
+        if (!runBenchmark(argv[2], size)) {
+            cout << RED_TEXT << "Error: Unknown benchmark " << argv[2] << RESET_TEXT << endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    // Benchmark suite mode: every operation over several lot sizes and workloads, results as JSON
+    // Usage: Project10.exe --bench-suite [--capacities 10,1000,...] [--plates sorted,random,zipf]
+    //        [--mix steady,rush] [--calls N] [--seconds S] [--json <file|->]
+    if (argc >= 2 && string(argv[1]) == "--bench-suite") {
+        SuiteOptions options;
+        string error;
+        if (!parseSuiteOptions(argc, argv, 2, options, error)) {
+            cout << RED_TEXT << "Error: " << error << RESET_TEXT << endl;
+            return 1;
+        }
+        if (!runBenchmarkSuite(options)) {
+            cout << RED_TEXT << "Error: Failed to write " << options.jsonPath << RESET_TEXT << endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    // Server mode: one lot engine shared by gate terminals over the network
+    // Usage: Project10.exe --serve [--host H] [--port P] [--unix <path>] [--capacity N] [--rate R] [--no-journal]
+    //        [--metrics <prefix>] [--metrics-interval S] [--trace <file>]
+    if (argc >= 2 && string(argv[1]) == "--serve") {
+        ServerOptions options;
+        string error;
+        if (!parseServerOptions(argc, argv, 2, options, error)) {
+            cout << RED_TEXT << "Error: " << error << RESET_TEXT << endl;
+            return 1;
+        }
+        ParkingConfig config;
+        if (!options.journal) {
+            config.journalPath = "";
+            config.archivePath = "";
+        }
+        ParkingManagementSystem serverSystem(options.capacity, options.rate, config);
+        ParkingServer server(serverSystem, options);
+        if (!server.start(error)) {
+            cout << RED_TEXT << "Error: " << error << RESET_TEXT << endl;
+            return 1;
+        }
+        cout << "Serving " << options.capacity << " slots on " << describeAddress(options.address) << " (Ctrl+C to stop)" << endl;
+
+        // Metrics files are rewritten periodically and once more on stop
+        unique_ptr<MetricsWriter> metricsWriter;
+        if (!options.metricsPrefix.empty()) {
+            metricsWriter = make_unique<MetricsWriter>(options.metricsPrefix, options.metricsIntervalMs);
+        }
+        if (!options.tracePath.empty()) {
+            Metrics::startTrace();
+        }
+        server.run();
+        metricsWriter.reset();
+        if (!options.tracePath.empty()) {
+            Metrics::stopTrace();
+            if (!Metrics::writeTrace(options.tracePath)) {
+                cout << RED_TEXT << "Error: Failed to write " << options.tracePath << RESET_TEXT << endl;
+            }
+        }
+
+        const ServerStats& stats = server.getStats();
+        cout << "\nServer stopped: " << stats.connectionsAccepted << " connections, " << stats.requests << " requests ("
+            << stats.errors << " errors), " << stats.bytesIn << " bytes in, " << stats.bytesOut << " bytes out" << endl;
+        return 0;
+    }
+
+    // Load generator mode: simulated gate traffic against a running server
+    // Usage: Project10.exe --loadgen [--host H] [--port P] [--unix <path>] [--connections N] [--pipeline N]
+    //        [--requests N] [--parked N] [--search-percent N] [--plates sorted|random|zipf]
+    if (argc >= 2 && string(argv[1]) == "--loadgen") {
+        LoadOptions options;
+        LoadReport report;
+        string error;
+        if (!parseLoadOptions(argc, argv, 2, options, error) || !runLoadGenerator(options, report, error)) {
+            cout << RED_TEXT << "Error: " << error << RESET_TEXT << endl;
+            return 1;
+        }
+        printLoadReport(options, report);
+        return 0;
+    }
+
+    // Simulation mode: drives a lot through simulated traffic for capacity and tariff planning
+    // Usage: Project10.exe --simulate [--capacity N[,N...]] [--days D] [--arrivals-per-hour R]
+    //        [--profile flat|office|retail|w0,...,w23] [--dwell exponential|lognormal|fixed] [--dwell-minutes M]
+    //        [--dwell-spread S] [--patience M] [--rate R] [--night-rate R] [--daily-cap R] [--grace M]
+    //        [--report-minutes M] [--seed N]
+    if (argc >= 2 && string(argv[1]) == "--simulate") {
+        SimulationOptions options;
+        vector<int> capacities;
+        string error;
+        if (!parseSimulationOptions(argc, argv, 2, options, capacities, error)) {
+            cout << RED_TEXT << "Error: " << error << RESET_TEXT << endl;
+            return 1;
+        }
+        if (capacities.size() <= 1) {
+            SimulationReport report;
+            runSimulation(options, report);
+            printSimulationReport(options, report);
+            return 0;
+        }
+        vector<SimulationReport> reports(capacities.size());
+        for (size_t i = 0; i < capacities.size(); ++i) {
+            options.capacity = capacities[i];
+            runSimulation(options, reports[i]);
+        }
+        printCapacityComparison(options, reports);
+        return 0;
+    }
+
+    // Export mode: streams the parked vehicles of the saved lot as CSV or JSON Lines
+    // Usage: Project10.exe --export <csv|jsonl> <file|-> [capacity]
+    if (argc >= 4 && string(argv[1]) == "--export") {
+        ExportFormat format;
+        if (!parseExportFormat(argv[2], format)) {
+            cout << RED_TEXT << "Error: Unknown export format " << argv[2] << RESET_TEXT << endl;
+            return 1;
+        }
+        int capacity = argc >= 5 ? atoi(argv[4]) : 5;
+        ParkingConfig exportConfig;
+        exportConfig.readOnly = true; // Only reads the snapshot and journal of the saved lot
+        ParkingManagementSystem exportSystem(capacity, 10.0, exportConfig);
+        ExportStats stats;
+        if (!exportParkedVehicles(exportSystem, argv[3], format, stats)) {
+            cout << RED_TEXT << "Error: Failed to write " << argv[3] << RESET_TEXT << endl;
+            return 1;
+        }
+        if (string(argv[3]) != "-") {
+            cout << "Exported " << stats.vehicles << " vehicles (" << stats.bytes << " bytes) in " << stats.seconds << " s" << endl;
+        }
+        return 0;
+    }
+
+    // Import mode: bulk-loads vehicles from a CSV file or a snapshot into the saved lot
+    // Usage: Project10.exe --import <csv|snapshot> <file> [capacity]
+    if (argc >= 4 && string(argv[1]) == "--import") {
+        ImportFormat format;
+        if (!parseImportFormat(argv[2], format)) {
+            cout << RED_TEXT << "Error: Unknown import format " << argv[2] << RESET_TEXT << endl;
+            return 1;
+        }
+        int capacity = argc >= 5 ? atoi(argv[4]) : 5;
+        ParkingManagementSystem importSystem(capacity, 10.0);
+        ImportStats stats;
+        if (!importParkedVehicles(importSystem, argv[3], format, stats)) {
+            cout << RED_TEXT << "Error: Failed to read " << argv[3] << RESET_TEXT << endl;
+            return 1;
+        }
+        cout << "Imported " << stats.parked << " parked and " << stats.queued << " queued vehicles in " << stats.seconds << " s ("
+            << stats.duplicates << " duplicates, " << stats.invalid << " invalid records skipped)" << endl;
+        return 0;
+    }
+
+    // History mode: completed sessions from the session archive
+    // Usage: Project10.exe --history <plate <reg>|revenue> [--from YYYY-MM-DD] [--to YYYY-MM-DD] [--archive <file>]
+    if (argc >= 3 && string(argv[1]) == "--history") {
+        string query = argv[2];
+        string plate;
+        int first = 3;
+        if (query == "plate" && argc >= 4) {
+            plate = argv[3];
+            first = 4;
+        }
+        else if (query != "revenue") {
+            cout << RED_TEXT << "Error: Expected 'plate <reg>' or 'revenue'" << RESET_TEXT << endl;
+            return 1;
+        }
+        time_t from = numeric_limits<time_t>::min();
+        time_t to = numeric_limits<time_t>::max();
+        string archivePath = "parking_Archive.bin";
+        for (int i = first; i < argc; ++i) {
+            string option = argv[i];
+            struct tm day = {};
+            if ((option == "--from" || option == "--to") && i + 1 < argc
+                && sscanf_s(argv[i + 1], "%d-%d-%d", &day.tm_year, &day.tm_mon, &day.tm_mday) == 3) {
+                // Local midnight; --to includes its whole day
+                day.tm_year -= 1900;
+                day.tm_mon -= 1;
+                day.tm_isdst = -1;
+                time_t midnight = mktime(&day);
+                if (option == "--from") from = midnight;
+                else to = midnight + 86399;
+                ++i;
+            }
+            else if (option == "--archive" && i + 1 < argc) {
+                archivePath = argv[++i];
+            }
+            else {
+                cout << RED_TEXT << "Error: Unknown option " << option << RESET_TEXT << endl;
+                return 1;
+            }
+        }
+
+        SessionArchive archive(archivePath);
+        if (!archive.openReadOnly()) {
+            cout << RED_TEXT << "Error: Failed to open session archive " << archivePath << RESET_TEXT << endl;
+            return 1;
+        }
+        ArchiveScanStats stats;
+        if (query == "plate") {
+            SessionQuery sessionQuery;
+            sessionQuery.regNumber = plate;
+            sessionQuery.from = from;
+            sessionQuery.to = to;
+            vector<ParkingSession> sessions;
+            archive.findSessions(sessionQuery, sessions, &stats);
+            printSessions(sessions);
+        }
+        else {
+            map<string, Cents> revenue;
+            archive.revenueByMake(from, to, revenue, &stats);
+            printRevenueByMake(revenue);
+        }
+        printScanStats(stats);
+        return 0;
+    }
+
     // Initialize the Parking Management System with capacity and rate
     ParkingManagementSystem pms(5, 10.0); // Capacity: 5, Rate: $10/hour
 
@@ -82,10 +373,10 @@ int main() {
         displayMenuWithCar(); // Display the main menu
 
         // Input validation for menu choice
-        while (!(cin >> choice) || choice < 1 || choice > 7) {
+        while (!(cin >> choice) || choice < 1 || choice > 8) {
             cin.clear(); // Clear error state
             cin.ignore(numeric_limits<streamsize>::max(), '\n'); // Discard invalid input
-            cout << RED_TEXT << "Invalid choice. Please enter a number between 1 and 7: " << RESET_TEXT;
+            cout << RED_TEXT << "Invalid choice. Please enter a number between 1 and 8: " << RESET_TEXT;
         }
 
         // Handle user's menu choice
@@ -112,8 +403,65 @@ int main() {
                 cin >> ownerName;
             }
 
+            string vehicleMake, vehicleModel, vehicleColor, ownerContact;
+
+            // Prompt and validate user input for vehicle details
+            cout << "Enter Vehicle Make: ";
+            cin >> vehicleMake;
+            while (!isValidVehicleMake(vehicleMake)) {
+                cout << "Invalid input. Please enter a valid Vehicle Make: ";
+                cin >> vehicleMake;
+            }
+
+            cout << "Enter Vehicle Model: ";
+            cin >> vehicleModel;
+            while (!isValidVehicleModel(vehicleModel)) {
+                cout << "Invalid input. Please enter a valid Vehicle Model: ";
+                cin >> vehicleModel;
+            }
+
+            cout << "Enter Vehicle Color: ";
+            cin >> vehicleColor;
+            while (!isValidVehicleColor(vehicleColor)) {
+                cout << "Invalid input. Please enter a valid Vehicle Color: ";
+                cin >> vehicleColor;
+            }
+
+            cout << "Enter Owner Contact Number: ";
+            cin >> ownerContact;
+            while (!isValidOwnerContact(ownerContact)) {
+                cout << "Invalid input. Please enter valid Owner Contact Details: ";
+                cin >> ownerContact;
+            }
+
+            // The priority only matters if the vehicle has to wait
+            WaitingPriority priority = WaitingPriority::Standard;
+            if (pms.isFull()) {
+                string priorityText;
+                cout << "Parking is full. Waiting priority (standard/permit/ev/disabled): ";
+                cin >> priorityText;
+                while (!parseWaitingPriority(priorityText, priority)) {
+                    cout << RED_TEXT << "Invalid priority. Please enter standard, permit, ev or disabled: " << RESET_TEXT;
+                    cin >> priorityText;
+                }
+            }
+
             // Park the vehicle
-            pms.parkVehicle(regNumber, ownerName);
+            Vehicle vehicle(regNumber, ownerName, vehicleMake, vehicleModel, vehicleColor, ownerContact);
+            switch (pms.parkVehicle(vehicle, priority)) {
+            case ParkResult::Parked:
+                cout << "\nVehicle parked successfully.\n";
+                break;
+            case ParkResult::Queued:
+                cout << "\nParking is full. Vehicle added to waiting queue.\n";
+                break;
+            case ParkResult::AlreadyParked:
+                cout << "\nError: Vehicle with registration number " << regNumber << " already exists in the parking lot.\n";
+                break;
+            case ParkResult::AlreadyWaiting:
+                cout << "\nError: Vehicle with registration number " << regNumber << " is already in the waiting queue.\n";
+                break;
+            }
             break;
         }
         case 2: { // Option to retrieve a vehicle
@@ -127,8 +475,34 @@ int main() {
                 cin >> regNumber;
             }
 
-            // Retrieve the vehicle
-            pms.retrieveVehicle(regNumber);
+            if (!pms.isParked(regNumber)) {
+                cout << "\nVehicle not found in the parking lot.\n";
+                pms.suggestSimilarPlates(regNumber);
+                break;
+            }
+
+            // Display vehicle details and request confirmation
+            cout << "\nPlease confirm the vehicle details before retrieval:\n";
+            pms.searchVehicle(regNumber);
+            cout << "\nDo you want to proceed with retrieving this vehicle? (y/n): ";
+
+            char userConfirmation;
+            cin >> userConfirmation;
+
+            if (userConfirmation == 'y' || userConfirmation == 'Y') {
+                // Retrieve the vehicle
+                Cents fee = 0;
+                if (pms.retrieveVehicle(regNumber, fee) == RetrieveResult::Retrieved) {
+                    cout << "\nVehicle retrieved successfully. Parking fee: $" << formatCents(fee) << "\n";
+                }
+                else {
+                    cout << "\nVehicle not found in the parking lot.\n";
+                }
+            }
+            else {
+                // User cancelled the retrieval process
+                cout << "\nVehicle retrieval cancelled.\n";
+            }
             break;
         }
         case 3: { // Option to search for a specific vehicle
@@ -142,12 +516,15 @@ int main() {
                 cin >> regNumber;
             }
 
-            // Search for the vehicle
+            // Search for the vehicle, and offer close plates for a misread one
             pms.searchVehicle(regNumber);
+            if (!pms.isParked(regNumber) && !pms.isWaiting(regNumber)) {
+                pms.suggestSimilarPlates(regNumber);
+            }
             break;
         }
         case 4: { // Option to apply a filter (advanced search)
-            string make, model;
+            string make, model, color;
 
             cout << "\nEnter vehicle make (or press Enter to skip): ";
             cin.ignore(); // Clear newline from previous input
@@ -156,10 +533,12 @@ int main() {
             cout << "Enter vehicle model (or press Enter to skip): ";
             getline(cin, model);
 
-            // Check if both make and model are empty
-            if (!make.empty() || !model.empty()) {
-               
-                pms.advancedSearch(make, model);
+            cout << "Enter vehicle color (or press Enter to skip): ";
+            getline(cin, color);
+
+            // Check if all filters are empty
+            if (!make.empty() || !model.empty() || !color.empty()) {
+                pms.advancedSearch(make, model, color);
             }
             else {
                 cout << "No inputs provided. Skipping advanced search." << endl;
@@ -175,7 +554,39 @@ int main() {
             pms.generateStatistics();
             break;
 
-        case 7: // Option to exit the program
+        case 7: { // Option to cancel or re-prioritize a waiting vehicle
+            pms.displayStatus();
+            if (pms.getWaitingCount() == 0) {
+                break;
+            }
+
+            string regNumber;
+            cout << "\nEnter the Registration Number of the waiting Vehicle: ";
+            cin >> regNumber;
+            if (!pms.isWaiting(regNumber)) {
+                cout << "\nVehicle " << regNumber << " is not in the waiting queue.\n";
+                break;
+            }
+
+            string action;
+            cout << "Cancel the wait or change its priority? (cancel/standard/permit/ev/disabled): ";
+            cin >> action;
+            WaitingPriority priority;
+            if (action == "cancel") {
+                pms.cancelWaiting(regNumber);
+                cout << "\nVehicle " << regNumber << " removed from the waiting queue.\n";
+            }
+            else if (parseWaitingPriority(action, priority)) {
+                pms.promoteWaiting(regNumber, priority);
+                cout << "\nVehicle " << regNumber << " now waits with " << waitingPriorityName(priority) << " priority.\n";
+            }
+            else {
+                cout << RED_TEXT << "\nUnknown action. Nothing was changed.\n" << RESET_TEXT;
+            }
+            break;
+        }
+
+        case 8: // Option to exit the program
             cout << "\nExiting... Thank you for using the Parking Management System!\n";
             break;
 
@@ -188,7 +599,7 @@ int main() {
         cout << "\nPress any key to continue...";
         cin.ignore();
         cin.get();
-    } while (choice != 7); // Loop until the user chooses to exit
+    } while (choice != 8); // Loop until the user chooses to exit
 
     return 0;
 }
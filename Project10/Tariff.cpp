@@ -0,0 +1,142 @@
+#include "Tariff.h"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+// Formats cents as dollars with two decimals
+string formatCents(Cents cents) {
+    char text[32];
+    snprintf(text, sizeof(text), "%s%lld.%02lld", cents < 0 ? "-" : "",
+        static_cast<long long>(llabs(cents) / 100), static_cast<long long>(llabs(cents) % 100));
+    return text;
+}
+
+// Converts a dollar amount to cents
+Cents dollarsToCents(double dollars) {
+    return static_cast<Cents>(llround(dollars * 100));
+}
+
+// Offset cache entries: quarter hour number above OFFSET_BITS, offset + OFFSET_BIAS below
+static const int OFFSET_BITS = 20;
+static const uint64_t OFFSET_MASK = (1ULL << OFFSET_BITS) - 1;
+static const int64_t OFFSET_BIAS = 1LL << (OFFSET_BITS - 1);
+static const uint64_t NO_OFFSET = OFFSET_MASK; // Offset field of an unused entry (no real offset is that large)
+
+// Returns the offset of local time from UTC in seconds at 'when'
+static int64_t localUtcOffset(time_t when) {
+    tm local, utc;
+    localtime_s(&local, &when);
+    gmtime_s(&utc, &when);
+
+    // The two calendar days differ by at most one around midnight
+    int64_t dayShift = 0;
+    if (local.tm_year != utc.tm_year) dayShift = local.tm_year > utc.tm_year ? 1 : -1;
+    else dayShift = local.tm_yday - utc.tm_yday;
+    return dayShift * 86400 + (local.tm_hour - utc.tm_hour) * 3600 + (local.tm_min - utc.tm_min) * 60;
+}
+
+// Compiles a rate table
+TariffEngine::TariffEngine(const TariffTable& rates) : table(rates) {
+    for (atomic<uint64_t>& entry : offsetCache) {
+        entry.store(NO_OFFSET, memory_order_relaxed);
+    }
+    Cents dayRate = max<Cents>(table.hourlyRate, 0);
+    Cents nightRate = table.nightRate < 0 ? dayRate : table.nightRate;
+    int nightStart = table.nightStartMinute % MINUTES_PER_DAY;
+    int nightEnd = table.nightEndMinute % MINUTES_PER_DAY;
+
+    // A rate in cents per hour is exactly that many sixtieths of a cent per minute
+    prefix.assign(2 * MINUTES_PER_DAY + 1, 0);
+    for (int i = 0; i < 2 * MINUTES_PER_DAY; ++i) {
+        int minute = i % MINUTES_PER_DAY;
+        bool night = nightStart < nightEnd ? (minute >= nightStart && minute < nightEnd)
+            : nightStart > nightEnd && (minute >= nightStart || minute < nightEnd);
+        prefix[i + 1] = prefix[i] + (night ? nightRate : dayRate);
+    }
+    dayCost = prefix[MINUTES_PER_DAY];
+    capCost = table.dailyCap > 0 ? table.dailyCap * 60 : INT64_MAX;
+    firstHourCost = table.firstHour >= 0 ? table.firstHour * 60 : -1;
+}
+
+// Returns the rate table the engine was compiled from
+const TariffTable& TariffEngine::getTable() const {
+    return table;
+}
+
+// Returns the local time zone offset at 'when'
+// Offsets only change on a quarter hour, so each quarter hour is converted once and kept in a
+// direct-mapped cache. An entry is one atomic word, so readers pricing the same lot at the
+// same time never see half of one.
+int64_t TariffEngine::offsetAt(time_t when) const {
+    int64_t seconds = static_cast<int64_t>(when);
+    int64_t quarter = seconds / 900 - (seconds % 900 < 0 ? 1 : 0);
+    uint64_t tag = static_cast<uint64_t>(quarter) << OFFSET_BITS;
+    atomic<uint64_t>& slot = offsetCache[static_cast<uint64_t>(quarter) % OFFSET_CACHE_SIZE];
+    uint64_t entry = slot.load(memory_order_relaxed);
+    if ((entry & ~OFFSET_MASK) != tag || (entry & OFFSET_MASK) == NO_OFFSET) {
+        entry = tag | static_cast<uint64_t>(localUtcOffset(static_cast<time_t>(quarter * 900)) + OFFSET_BIAS);
+        slot.store(entry, memory_order_relaxed);
+    }
+    return static_cast<int64_t>(entry & OFFSET_MASK) - OFFSET_BIAS;
+}
+
+// Returns the cost of the first block of a stay, before the cap
+int64_t TariffEngine::firstBlockCost(int startMinute, int64_t minutes) const {
+    if (firstHourCost < 0) {
+        return prefix[startMinute + minutes] - prefix[startMinute];
+    }
+    // The flat first hour replaces the per-minute cost of its minutes
+    int64_t flat = min<int64_t>(minutes, 60);
+    return firstHourCost + prefix[startMinute + minutes] - prefix[startMinute + flat];
+}
+
+// Returns the fee for a stay
+Cents TariffEngine::fee(time_t entryTime, time_t exitTime) const {
+    Cents result;
+    feeBatch(&entryTime, 1, exitTime, &result);
+    return result;
+}
+
+// Prices many stays ending at the same instant
+void TariffEngine::feeBatch(const time_t* entryTimes, size_t count, time_t now, Cents* fees) const {
+    // Copy the loop invariants into locals so the compiler keeps them in registers
+    // (the output array could otherwise alias the engine's own fields)
+    const int64_t* sums = prefix.data();
+    const int64_t cap = capCost;
+    const int64_t fullDay = min(dayCost, capCost);
+    const int64_t grace = table.graceMinutes;
+    const int64_t end = static_cast<int64_t>(now);
+
+    for (size_t i = 0; i < count; ++i) {
+        int64_t entry = static_cast<int64_t>(entryTimes[i]);
+        int64_t seconds = end - entry;
+
+        // Every started minute is billed; short stays inside the grace period are free
+        int64_t minutes = (seconds + 59) / 60;
+        if (seconds <= 0 || minutes <= grace) {
+            fees[i] = 0;
+            continue;
+        }
+
+        // Local minute of the day the stay started
+        int64_t local = entry + offsetAt(entryTimes[i]);
+        int64_t minuteOfDay = (local / 60 - (local % 60 < 0 ? 1 : 0)) % MINUTES_PER_DAY;
+        if (minuteOfDay < 0) minuteOfDay += MINUTES_PER_DAY;
+        int start = static_cast<int>(minuteOfDay);
+
+        // First day (with the flat first hour), then whole days, then the remainder
+        // Whole days always cover every clock minute once, so they all cost the same.
+        int64_t first = min<int64_t>(minutes, MINUTES_PER_DAY);
+        int64_t total = min(firstBlockCost(start, first), cap);
+        int64_t rest = minutes - first;
+        if (rest > 0) {
+            int64_t tail = rest % MINUTES_PER_DAY;
+            total += (rest / MINUTES_PER_DAY) * fullDay + min(sums[start + tail] - sums[start], cap);
+        }
+
+        // Round the sixtieths to the nearest cent
+        fees[i] = (total + 30) / 60;
+    }
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Money amount in whole cents
+typedef int64_t Cents;
+
+// Formats cents as dollars with two decimals (e.g. 1234 -> "12.34")
+string formatCents(Cents cents);
+
+// Converts a dollar amount to cents, rounding to the nearest cent
+Cents dollarsToCents(double dollars);
+
+// Rate table of the parking lot; every amount is in cents
+// Parking is billed per started minute at the rate of the clock minute it falls in.
+struct TariffTable {
+    Cents hourlyRate = -1;            // Day rate per hour (-1 uses the rate given to the parking system)
+    Cents nightRate = -1;             // Rate per hour inside the night window (-1 charges the day rate)
+    int nightStartMinute = 22 * 60;   // Local minute of the day the night window starts
+    int nightEndMinute = 6 * 60;      // Local minute of the day the night window ends (may wrap past midnight)
+    Cents firstHour = -1;             // Flat price of the first hour (-1 bills it like any other hour)
+    int graceMinutes = 0;             // Stays up to this many minutes are free
+    Cents dailyCap = 0;               // Most charged for each 24 hours from entry (0 means no cap)
+};
+
+// Rate table compiled into per-minute prefix sums, so any stay is priced in O(1)
+// Amounts are kept in sixtieths of a cent (one minute of an hourly rate in cents) until
+// the final rounding, so prices are exact and never drift with the length of the stay.
+// The local time zone offset is looked up for each entry time, so stays on either side of
+// a daylight saving change see the night window at the right hour.
+class TariffEngine {
+private:
+    static const int MINUTES_PER_DAY = 24 * 60;
+    static const int OFFSET_CACHE_SIZE = 512;  // Quarter hours whose offset is remembered (over five days)
+
+    TariffTable table;             // Rate table the engine was compiled from
+    vector<int64_t> prefix;        // Cost of minutes [0, i) of two back-to-back days, in 1/60 cents
+    int64_t dayCost;               // Cost of a full 24 hours, in 1/60 cents
+    int64_t capCost;               // Daily cap in 1/60 cents (INT64_MAX when uncapped)
+    int64_t firstHourCost;         // Flat first hour in 1/60 cents (-1 when billed by the minute)
+    mutable atomic<uint64_t> offsetCache[OFFSET_CACHE_SIZE]; // Quarter hour and its offset, packed in one word
+
+    // Returns the local time zone offset in seconds at 'when'
+    int64_t offsetAt(time_t when) const;
+
+    // Returns the cost of the first block of a stay (at most one day), before the cap
+    int64_t firstBlockCost(int startMinute, int64_t minutes) const;
+
+public:
+    // Compiles a rate table
+    explicit TariffEngine(const TariffTable& table = TariffTable());
+
+    // Returns the rate table the engine was compiled from
+    const TariffTable& getTable() const;
+
+    // Returns the fee for a stay from 'entryTime' to 'exitTime'
+    Cents fee(time_t entryTime, time_t exitTime) const;
+
+    // Prices 'count' stays that all end at 'now' in one pass; fees[i] belongs to entryTimes[i]
+    void feeBatch(const time_t* entryTimes, size_t count, time_t now, Cents* fees) const;
+};
@@ -0,0 +1,215 @@
+#include "TimerWheel.h"
+#include "BitScan.h"
+
+// Creates a wheel whose clock starts at 'start'
+TimerWheel::TimerWheel(time_t start) : current(start), pending(0) {
+    for (int level = 0; level < LEVELS; ++level) occupied[level] = 0;
+}
+
+// Appends a timer to a list
+void TimerWheel::link(int timer, time_t deadline, int list) {
+    Timer& entry = timers[timer];
+    entry.list = static_cast<int16_t>(list);
+    entry.position = static_cast<uint32_t>(lists[list].size());
+    lists[list].push_back(SlotEntry{ deadline, timer });
+    if (list < OVERFLOW_LIST) {
+        occupied[list / SLOTS] |= 1ULL << (list % SLOTS);
+    }
+}
+
+// Removes a timer from its list (the last entry takes its place)
+void TimerWheel::unlink(int timer) {
+    Timer& entry = timers[timer];
+    vector<SlotEntry>& list = lists[entry.list];
+    SlotEntry last = list.back();
+    list[entry.position] = last;
+    timers[last.timer].position = entry.position;
+    list.pop_back();
+    if (list.empty() && entry.list < OVERFLOW_LIST) {
+        occupied[entry.list / SLOTS] &= ~(1ULL << (entry.list % SLOTS));
+    }
+    entry.list = -1;
+}
+
+// Adds a timer to the list that matches its deadline
+void TimerWheel::place(int timer, time_t deadline) {
+    if (deadline < current) {
+        link(timer, deadline, OVERDUE_LIST);
+        return;
+    }
+    uint64_t due = static_cast<uint64_t>(deadline);
+    uint64_t differing = due ^ static_cast<uint64_t>(current);
+    int level = differing == 0 ? 0 : highestBit(differing) / SLOT_BITS;
+    if (level >= LEVELS) {
+        link(timer, deadline, OVERFLOW_LIST);
+        return;
+    }
+    int slot = static_cast<int>(due >> (SLOT_BITS * level)) & (SLOTS - 1);
+    link(timer, deadline, level * SLOTS + slot);
+}
+
+// Moves every timer of a list to the list that now matches its deadline
+void TimerWheel::cascade(int list) {
+    // Take the whole list first: overflow timers may go straight back to the overflow list
+    moving.clear();
+    moving.swap(lists[list]);
+    if (list < OVERFLOW_LIST) {
+        occupied[list / SLOTS] &= ~(1ULL << (list % SLOTS));
+    }
+    for (const SlotEntry& entry : moving) {
+        place(entry.timer, entry.deadline);
+    }
+}
+
+// Fires every timer of a list
+size_t TimerWheel::fireList(int list, const function<void(const TimerEvent&)>& fire) {
+    if (lists[list].empty()) return 0;
+
+    // Take the list aside so callbacks can schedule and cancel freely
+    moving.clear();
+    moving.swap(lists[list]);
+    if (list < OVERFLOW_LIST) {
+        occupied[list / SLOTS] &= ~(1ULL << (list % SLOTS));
+    }
+    for (const SlotEntry& entry : moving) {
+        timers[entry.timer].list = FIRING;
+    }
+
+    size_t fired = 0;
+    for (size_t i = 0; i < moving.size(); ++i) {
+        int timer = moving[i].timer;
+        if (timers[timer].list != FIRING) continue; // Cancelled by an earlier callback
+        const Timer& entry = timers[timer];
+        TimerEvent event{ (static_cast<uint64_t>(entry.generation) << 32) | static_cast<uint32_t>(timer + 1),
+            entry.deadline, entry.owner, entry.kind };
+        release(timer);
+        fired++;
+        fire(event);
+    }
+    return fired;
+}
+
+// Returns a fired or cancelled timer to the pool
+void TimerWheel::release(int timer) {
+    timers[timer].list = -1;
+    timers[timer].generation++;
+    freeTimers.push_back(timer);
+    pending--;
+}
+
+// Schedules a timer
+TimerId TimerWheel::schedule(time_t deadline, uint32_t owner, uint8_t kind) {
+    int timer;
+    if (!freeTimers.empty()) {
+        timer = freeTimers.back();
+        freeTimers.pop_back();
+    }
+    else {
+        timer = static_cast<int>(timers.size());
+        timers.push_back(Timer{ 0, 0, 1, 0, -1, 0 });
+    }
+    Timer& entry = timers[timer];
+    entry.deadline = deadline;
+    entry.owner = owner;
+    entry.kind = kind;
+    place(timer, deadline);
+    pending++;
+    return (static_cast<uint64_t>(entry.generation) << 32) | static_cast<uint32_t>(timer + 1);
+}
+
+// Cancels a timer
+bool TimerWheel::cancel(TimerId id) {
+    if (!isPending(id)) return false;
+    int timer = static_cast<int>(id & 0xFFFFFFFFu) - 1;
+    if (timers[timer].list != FIRING) {
+        unlink(timer);
+    }
+    release(timer);
+    return true;
+}
+
+// Returns true if a timer is still waiting to fire
+bool TimerWheel::isPending(TimerId id) const {
+    uint64_t index = id & 0xFFFFFFFFu;
+    if (index == 0 || index > timers.size()) return false;
+    const Timer& entry = timers[static_cast<size_t>(index - 1)];
+    return entry.list != -1 && entry.generation == static_cast<uint32_t>(id >> 32);
+}
+
+// Moves the clock to 'now' and fires every timer due by then
+size_t TimerWheel::advance(time_t now, const function<void(const TimerEvent&)>& fire) {
+    size_t fired = 0;
+    for (;;) {
+        // Timers scheduled for a second the clock already passed fire first
+        fired += fireList(OVERDUE_LIST, fire);
+        if (current > now) break;
+        if (pending == 0) {
+            current = now + 1;
+            break;
+        }
+        uint64_t second = static_cast<uint64_t>(current);
+
+        // At the start of a window, bring down the timers whose group the clock
+        // just reached, top level first so they can fall through several levels
+        if ((second & (SLOTS - 1)) == 0) {
+            if ((second & ((1ULL << (SLOT_BITS * LEVELS)) - 1)) == 0 && !lists[OVERFLOW_LIST].empty()) {
+                cascade(OVERFLOW_LIST);
+            }
+            for (int level = LEVELS - 1; level >= 1; --level) {
+                if ((second & ((1ULL << (SLOT_BITS * level)) - 1)) != 0) continue;
+                int slot = static_cast<int>(second >> (SLOT_BITS * level)) & (SLOTS - 1);
+                if (occupied[level] & (1ULL << slot)) {
+                    cascade(level * SLOTS + slot);
+                }
+            }
+        }
+
+        // Jump to the next second of this window that has timers
+        uint64_t ahead = occupied[0] & (~0ULL << (second & (SLOTS - 1)));
+        uint64_t windowEnd = (second | (SLOTS - 1)) + 1;
+        if (ahead == 0) {
+            current = static_cast<time_t>(windowEnd) < now + 1 ? static_cast<time_t>(windowEnd) : now + 1;
+            continue;
+        }
+        int slot = lowestBit(ahead);
+        time_t due = static_cast<time_t>((second & ~static_cast<uint64_t>(SLOTS - 1)) | static_cast<uint64_t>(slot));
+        if (due > now) {
+            current = now + 1;
+            continue;
+        }
+        current = due;
+        fired += fireList(slot, fire);
+
+        // Timers scheduled for this second by the callbacks fire on the next pass
+        if (lists[slot].empty()) {
+            current = due + 1;
+        }
+    }
+    return fired;
+}
+
+// Returns the next second the clock will process
+time_t TimerWheel::now() const {
+    return current;
+}
+
+// Returns the number of scheduled timers
+size_t TimerWheel::size() const {
+    return pending;
+}
+
+// Reserves pool space for a number of timers
+void TimerWheel::reserve(size_t count) {
+    timers.reserve(count);
+    freeTimers.reserve(count);
+}
+
+// Returns the approximate number of bytes used by the wheel
+size_t TimerWheel::memoryUsage() const {
+    size_t bytes = sizeof(*this) + timers.capacity() * sizeof(Timer) + freeTimers.capacity() * sizeof(int)
+        + moving.capacity() * sizeof(SlotEntry);
+    for (const vector<SlotEntry>& list : lists) {
+        bytes += list.capacity() * sizeof(SlotEntry);
+    }
+    return bytes;
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <functional>
+#include <vector>
+
+using namespace std;
+
+// Handle of a scheduled timer (0 = no timer)
+typedef uint64_t TimerId;
+
+// A timer that came due
+struct TimerEvent {
+    TimerId id;          // Handle returned when the timer was scheduled
+    time_t deadline;     // Time the timer was set for
+    uint32_t owner;      // Owner given when scheduling (e.g. a slot index)
+    uint8_t kind;        // Kind given when scheduling (e.g. an alert type)
+};
+
+// Hierarchical timing wheel with one-second resolution
+// Five levels of 64 slots cover 2^30 seconds (about 34 years) ahead; a timer sits in the
+// level of the highest six-bit group in which its deadline differs from the current time
+// and moves one level down each time the clock reaches that group. Scheduling and
+// cancelling are O(1), and every timer is moved at most once per level before it fires.
+// A 64-bit occupancy mask per level lets the clock jump over empty seconds.
+// Slots are arrays of (deadline, timer) pairs, so moving a slot down a level streams
+// through contiguous memory and only touches each timer to record its new place.
+class TimerWheel {
+private:
+    // A timer in the pool
+    struct Timer {
+        time_t deadline;       // Time the timer fires
+        uint32_t owner;        // Owner given when scheduling
+        uint32_t generation;   // Bumped every time the pool entry is reused
+        uint32_t position;     // Index of the timer's entry in its list
+        int16_t list;          // List the timer is in (-1 if free)
+        uint8_t kind;          // Kind given when scheduling
+    };
+
+    // An entry of a slot list
+    struct SlotEntry {
+        time_t deadline;       // Copy of the timer's deadline, so cascading reads no timers
+        int timer;             // Index into the timer pool
+    };
+
+    static const int LEVELS = 5;                          // Wheel levels
+    static const int SLOT_BITS = 6;                       // log2 of slots per level
+    static const int SLOTS = 1 << SLOT_BITS;              // Slots per level
+    static const int OVERFLOW_LIST = LEVELS * SLOTS;      // Timers beyond the top level
+    static const int OVERDUE_LIST = OVERFLOW_LIST + 1;    // Timers scheduled for a second already processed
+    static const int LIST_COUNT = OVERDUE_LIST + 1;
+    static const int FIRING = LIST_COUNT;                 // List mark of timers being fired
+
+    vector<Timer> timers;                 // Timer pool
+    vector<int> freeTimers;               // Unused pool entries
+    vector<SlotEntry> lists[LIST_COUNT];  // Wheel slots, then the overflow and overdue lists
+    vector<SlotEntry> moving;             // Scratch list of a slot being cascaded or fired
+    uint64_t occupied[LEVELS];            // Bit s of level l is set if slot s of level l is not empty
+    time_t current;                       // Next second to process; deadlines before it have fired
+    size_t pending;                       // Number of scheduled timers
+
+    // Appends a timer to a list / removes it from its list
+    void link(int timer, time_t deadline, int list);
+    void unlink(int timer);
+
+    // Adds a timer to the list that matches its deadline
+    void place(int timer, time_t deadline);
+
+    // Moves every timer of a slot to the list that now matches its deadline
+    void cascade(int list);
+
+    // Fires every timer of a list; returns the number fired
+    size_t fireList(int list, const function<void(const TimerEvent&)>& fire);
+
+    // Returns a fired or cancelled timer to the pool
+    void release(int timer);
+
+public:
+    // Creates a wheel whose clock starts at 'start'
+    explicit TimerWheel(time_t start = 0);
+
+    // Schedules a timer; overdue timers fire on the next advance
+    TimerId schedule(time_t deadline, uint32_t owner, uint8_t kind);
+
+    // Cancels a timer; returns false if it already fired or was cancelled
+    bool cancel(TimerId id);
+
+    // Returns true if a timer is still waiting to fire
+    bool isPending(TimerId id) const;
+
+    // Moves the clock to 'now' and fires every timer due by then, second by second
+    // The callback may schedule and cancel timers but must not call advance again.
+    // Returns the number of timers fired.
+    size_t advance(time_t now, const function<void(const TimerEvent&)>& fire);
+
+    // Returns the next second the clock will process
+    time_t now() const;
+
+    // Returns the number of scheduled timers
+    size_t size() const;
+
+    // Reserves pool space for a number of timers
+    void reserve(size_t count);
+
+    // Returns the approximate number of bytes used by the wheel
+    size_t memoryUsage() const;
+};
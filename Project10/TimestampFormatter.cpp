@@ -0,0 +1,56 @@
+#include "TimestampFormatter.h"
+#include <cstdio>
+#include <cstring>
+
+// Two-digit text of 00..59
+static const char* twoDigits(int value) {
+    static const char table[] =
+        "00010203040506070809101112131415161718192021222324252627282930"
+        "313233343536373839404142434445464748495051525354555657585960";
+    return table + 2 * value;
+}
+
+// Creates a formatter
+TimestampFormatter::TimestampFormatter(char dateTimeSeparator)
+    : hours(CACHE_SIZE), hourShift(0), separator(dateTimeSeparator), conversions(0) {
+}
+
+// Writes LENGTH characters (no terminator) to 'out'
+void TimestampFormatter::format(time_t when, char* out) {
+    HourEntry& entry = hours[static_cast<uint64_t>(when + hourShift) / 3600 % CACHE_SIZE];
+    if (entry.start == -1 || when < entry.start || when >= entry.start + 3600) {
+        // Convert once and remember the hour this second belongs to
+        struct tm local;
+        if (localtime_s(&local, &when) != 0) {
+            memcpy(out, "0000-00-00 00:00:00", LENGTH);
+            out[10] = separator;
+            return;
+        }
+        conversions++;
+        char text[32];
+        snprintf(text, sizeof(text), "%04d-%02d-%02d%c%02d:", local.tm_year + 1900, local.tm_mon + 1, local.tm_mday,
+            separator, local.tm_hour);
+        memcpy(entry.prefix, text, sizeof(entry.prefix));
+        entry.start = when - local.tm_min * 60 - local.tm_sec;
+        hourShift = (3600 - entry.start % 3600) % 3600;
+    }
+
+    // Minutes and seconds are plain arithmetic inside the hour
+    int offset = static_cast<int>(when - entry.start);
+    memcpy(out, entry.prefix, sizeof(entry.prefix));
+    memcpy(out + 14, twoDigits(offset / 60), 2);
+    out[16] = ':';
+    memcpy(out + 17, twoDigits(offset % 60), 2);
+}
+
+// Appends the formatted timestamp to 'out'
+void TimestampFormatter::append(time_t when, string& out) {
+    size_t size = out.size();
+    out.resize(size + LENGTH);
+    format(when, &out[size]);
+}
+
+// Returns the number of localtime calls made so far
+uint64_t TimestampFormatter::getConversionCount() const {
+    return conversions;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Formats Unix timestamps as local "YYYY-MM-DD HH:MM:SS" without a localtime call per value
+// Local time only changes its offset on an hour boundary, so the formatter remembers the
+// "YYYY-MM-DD HH:" text of recently seen local hours and fills in minutes and seconds
+// arithmetically. A report over many vehicles converts each distinct hour once.
+class TimestampFormatter {
+public:
+    static const size_t LENGTH = 19;   // Characters written per timestamp
+
+private:
+    // Text of one local hour
+    struct HourEntry {
+        time_t start = -1;   // First second of the hour (-1 if unused)
+        char prefix[14];     // "YYYY-MM-DD HH:" of the hour
+    };
+
+    static const size_t CACHE_SIZE = 1024; // Hours remembered, about six weeks (direct-mapped by local hour)
+
+    vector<HourEntry> hours;               // Recently formatted hours
+    time_t hourShift;                      // Seconds that align local hours on the cache index (for half-hour zones)
+    char separator;                        // Between date and time (' ', or 'T' for ISO 8601)
+    uint64_t conversions;                  // localtime calls made
+
+public:
+    // Creates a formatter; pass 'T' as the separator for ISO 8601 output
+    explicit TimestampFormatter(char separator = ' ');
+
+    // Writes LENGTH characters (no terminator) to 'out'
+    void format(time_t when, char* out);
+
+    // Appends the formatted timestamp to 'out'
+    void append(time_t when, string& out);
+
+    // Returns the number of localtime calls made so far
+    uint64_t getConversionCount() const;
+};
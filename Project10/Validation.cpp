@@ -0,0 +1,239 @@
+#include "Validation.h"
+#include <iostream>
+
+#define RED "\033[1;31m" // Bright Red color for error messages
+#define RESET "\033[0m"  // Reset to default color
+
+// Character classes of the lookup table
+enum CharClass : uint8_t {
+    CHAR_ALPHA = 1,   // ASCII letter
+    CHAR_DIGIT = 2,   // ASCII digit
+    CHAR_SPACE = 4    // Space
+};
+
+// Class flags of every byte value
+struct CharClassTable {
+    uint8_t flags[256];
+};
+
+// Builds the table at compile time (same answers as isalpha/isdigit in the "C" locale)
+static constexpr CharClassTable makeCharClassTable() {
+    CharClassTable table{};
+    for (int c = 0; c < 256; ++c) {
+        uint8_t flags = 0;
+        if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z')) flags |= CHAR_ALPHA;
+        if (c >= '0' && c <= '9') flags |= CHAR_DIGIT;
+        if (c == ' ') flags |= CHAR_SPACE;
+        table.flags[c] = flags;
+    }
+    return table;
+}
+
+static constexpr CharClassTable CHAR_CLASSES = makeCharClassTable();
+
+// Returns the class flags of a character
+static inline uint8_t classOf(char c) {
+    return CHAR_CLASSES.flags[static_cast<unsigned char>(c)];
+}
+
+// Returns true if every character has one of the 'allowed' classes
+// The loop has no early exit, so it runs branch-free over short fields.
+static inline bool allInClass(const char* text, size_t length, uint8_t allowed) {
+    unsigned rejected = 0;
+    for (size_t i = 0; i < length; ++i) {
+        rejected |= (classOf(text[i]) & allowed) == 0;
+    }
+    return rejected == 0;
+}
+
+// Returns true if the text starts or ends with a space (it must not be empty)
+static inline bool hasEdgeSpace(const char* text, size_t length) {
+    return text[0] == ' ' || text[length - 1] == ' ';
+}
+
+// Checks a registration number: 3-10 letters or digits, not starting with '0'
+ValidationError validateRegNumber(const char* text, size_t length) {
+    if (length < 3) return ValidationError::TooShort;
+    if (length > 10) return ValidationError::TooLong;
+    if (text[0] == '0') return ValidationError::LeadingZero;
+    if (!allInClass(text, length, CHAR_ALPHA | CHAR_DIGIT)) return ValidationError::InvalidCharacter;
+    return ValidationError::None;
+}
+
+// Checks an owner name: letters and single inner spaces, at most 100 characters
+ValidationError validateOwnerName(const char* text, size_t length) {
+    if (length == 0) return ValidationError::Empty;
+    if (!allInClass(text, length, CHAR_ALPHA | CHAR_SPACE)) return ValidationError::InvalidCharacter;
+    if (hasEdgeSpace(text, length)) return ValidationError::EdgeSpace;
+    unsigned doubled = 0;
+    for (size_t i = 1; i < length; ++i) {
+        doubled |= (text[i] == ' ') & (text[i - 1] == ' ');
+    }
+    if (doubled) return ValidationError::ConsecutiveSpaces;
+    if (length > 100) return ValidationError::TooLong;
+    return ValidationError::None;
+}
+
+// Checks a vehicle make: letters and spaces, at most 50 characters
+ValidationError validateVehicleMake(const char* text, size_t length) {
+    if (length == 0) return ValidationError::Empty;
+    if (!allInClass(text, length, CHAR_ALPHA | CHAR_SPACE)) return ValidationError::InvalidCharacter;
+    if (hasEdgeSpace(text, length)) return ValidationError::EdgeSpace;
+    if (length > 50) return ValidationError::TooLong;
+    return ValidationError::None;
+}
+
+// Checks a vehicle model: letters, digits and spaces, at most 50 characters
+ValidationError validateVehicleModel(const char* text, size_t length) {
+    if (length == 0) return ValidationError::Empty;
+    if (!allInClass(text, length, CHAR_ALPHA | CHAR_DIGIT | CHAR_SPACE)) return ValidationError::InvalidCharacter;
+    if (hasEdgeSpace(text, length)) return ValidationError::EdgeSpace;
+    if (length > 50) return ValidationError::TooLong;
+    return ValidationError::None;
+}
+
+// Checks a vehicle color: letters and spaces, at most 30 characters
+ValidationError validateVehicleColor(const char* text, size_t length) {
+    if (length == 0) return ValidationError::Empty;
+    if (!allInClass(text, length, CHAR_ALPHA | CHAR_SPACE)) return ValidationError::InvalidCharacter;
+    if (hasEdgeSpace(text, length)) return ValidationError::EdgeSpace;
+    if (length > 30) return ValidationError::TooLong;
+    return ValidationError::None;
+}
+
+// Checks an owner contact: 10-15 digits
+ValidationError validateOwnerContact(const char* text, size_t length) {
+    if (length == 0) return ValidationError::Empty;
+    if (length < 10) return ValidationError::TooShort;
+    if (length > 15) return ValidationError::TooLong;
+    if (!allInClass(text, length, CHAR_DIGIT)) return ValidationError::InvalidCharacter;
+    return ValidationError::None;
+}
+
+// Validates one field of a vehicle record
+ValidationError validateField(VehicleField field, const string& value) {
+    switch (field) {
+    case VehicleField::RegNumber: return validateRegNumber(value.data(), value.size());
+    case VehicleField::OwnerName: return validateOwnerName(value.data(), value.size());
+    case VehicleField::Make: return validateVehicleMake(value.data(), value.size());
+    case VehicleField::Model: return validateVehicleModel(value.data(), value.size());
+    case VehicleField::Color: return validateVehicleColor(value.data(), value.size());
+    default: return validateOwnerContact(value.data(), value.size());
+    }
+}
+
+// Validates every field of a vehicle record
+ValidationResult validateVehicle(const Vehicle& vehicle) {
+    ValidationResult result;
+    const string* values[] = { &vehicle.regNumber, &vehicle.ownerName, &vehicle.vehicleMake,
+        &vehicle.vehicleModel, &vehicle.vehicleColor, &vehicle.ownerContact };
+    for (int field = 0; field < 6; ++field) {
+        result.field = static_cast<VehicleField>(field);
+        result.error = validateField(result.field, *values[field]);
+        if (result.error != ValidationError::None) break;
+    }
+    return result;
+}
+
+// Validates a batch of records in one pass
+size_t validateVehicles(const vector<Vehicle>& vehicles, vector<ValidationResult>& results) {
+    results.resize(vehicles.size());
+    size_t valid = 0;
+    for (size_t i = 0; i < vehicles.size(); ++i) {
+        results[i] = validateVehicle(vehicles[i]);
+        valid += results[i].error == ValidationError::None;
+    }
+    return valid;
+}
+
+// Validates a batch of registration numbers
+size_t validateRegNumbers(const vector<string>& plates, vector<ValidationError>& errors) {
+    errors.resize(plates.size());
+    size_t valid = 0;
+    for (size_t i = 0; i < plates.size(); ++i) {
+        errors[i] = validateRegNumber(plates[i].data(), plates[i].size());
+        valid += errors[i] == ValidationError::None;
+    }
+    return valid;
+}
+
+// Returns the user-facing message for a rejected field
+const char* validationMessage(VehicleField field, ValidationError error) {
+    switch (field) {
+    case VehicleField::RegNumber:
+        switch (error) {
+        case ValidationError::TooShort: return "Registration number must be at least 3 characters long.";
+        case ValidationError::TooLong: return "Registration number must not exceed 10 characters.";
+        case ValidationError::LeadingZero: return "Registration number cannot start with '0'.";
+        default: return "Registration number must be alphanumeric.";
+        }
+    case VehicleField::OwnerName:
+        switch (error) {
+        case ValidationError::Empty: return "Owner name cannot be empty.";
+        case ValidationError::EdgeSpace: return "Owner name cannot start or end with a space.";
+        case ValidationError::ConsecutiveSpaces: return "Owner name cannot have consecutive spaces.";
+        case ValidationError::TooLong: return "Owner name must not exceed 100 characters.";
+        default: return "Owner name can only contain letters and spaces.";
+        }
+    case VehicleField::Make:
+        switch (error) {
+        case ValidationError::Empty: return "Vehicle make cannot be empty.";
+        case ValidationError::InvalidCharacter: return "Vehicle make can only contain letters and spaces.";
+        default: return "Vehicle make format is invalid.";
+        }
+    case VehicleField::Model:
+        switch (error) {
+        case ValidationError::Empty: return "Vehicle model cannot be empty.";
+        case ValidationError::InvalidCharacter: return "Vehicle model can only contain letters, numbers, and spaces.";
+        default: return "Vehicle model format is invalid.";
+        }
+    case VehicleField::Color:
+        switch (error) {
+        case ValidationError::Empty: return "Vehicle color cannot be empty.";
+        case ValidationError::InvalidCharacter: return "Vehicle color can only contain letters and spaces.";
+        default: return "Vehicle color format is invalid.";
+        }
+    default:
+        return error == ValidationError::Empty ? "Owner contact cannot be empty." : "Owner contact must be 10-15 digits.";
+    }
+}
+
+// Prints the message of a rejected field; returns true if the field is valid
+static bool reportValidation(VehicleField field, const string& value) {
+    ValidationError error = validateField(field, value);
+    if (error != ValidationError::None) {
+        cout << RED << "Error: " << validationMessage(field, error) << RESET << endl;
+        return false;
+    }
+    return true;
+}
+
+// Error checks for registration number
+bool isValidRegNumber(const string& regNumber) {
+    return reportValidation(VehicleField::RegNumber, regNumber);
+}
+
+// Error checks for owner name
+bool isValidOwnerName(const string& ownerName) {
+    return reportValidation(VehicleField::OwnerName, ownerName);
+}
+
+// Validates the vehicle make input
+bool isValidVehicleMake(const string& make) {
+    return reportValidation(VehicleField::Make, make);
+}
+
+// Validates the vehicle model input
+bool isValidVehicleModel(const string& model) {
+    return reportValidation(VehicleField::Model, model);
+}
+
+// Validates the vehicle color input
+bool isValidVehicleColor(const string& color) {
+    return reportValidation(VehicleField::Color, color);
+}
+
+// Validates the owner's contact number
+bool isValidOwnerContact(const string& contact) {
+    return reportValidation(VehicleField::Contact, contact);
+}
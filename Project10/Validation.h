@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Vehicle.h"
+
+using namespace std;
+
+// Reasons a field can be rejected
+enum class ValidationError : uint8_t {
+    None = 0,            // Field is valid
+    Empty,               // Field is empty
+    TooShort,            // Fewer characters than allowed
+    TooLong,             // More characters than allowed
+    LeadingZero,         // Registration number starts with '0'
+    InvalidCharacter,    // A character outside the field's character class
+    EdgeSpace,           // Starts or ends with a space
+    ConsecutiveSpaces    // Two spaces in a row
+};
+
+// Fields of a vehicle record
+enum class VehicleField : uint8_t {
+    RegNumber,
+    OwnerName,
+    Make,
+    Model,
+    Color,
+    Contact
+};
+
+// Outcome of validating a vehicle record
+struct ValidationResult {
+    ValidationError error = ValidationError::None;   // First problem found (None if valid)
+    VehicleField field = VehicleField::RegNumber;    // Field the problem was found in
+};
+
+// Field validators; none of them allocate or print
+// Characters are classified through a 256-entry table, so every field is checked in
+// one pass without locale lookups. Only ASCII letters, digits and spaces are accepted.
+ValidationError validateRegNumber(const char* text, size_t length);
+ValidationError validateOwnerName(const char* text, size_t length);
+ValidationError validateVehicleMake(const char* text, size_t length);
+ValidationError validateVehicleModel(const char* text, size_t length);
+ValidationError validateVehicleColor(const char* text, size_t length);
+ValidationError validateOwnerContact(const char* text, size_t length);
+
+// Validates one field of a vehicle record
+ValidationError validateField(VehicleField field, const string& value);
+
+// Validates every field of a vehicle record; reports the first failing field
+ValidationResult validateVehicle(const Vehicle& vehicle);
+
+// Validates a batch of records in one pass; results[i] belongs to vehicles[i]
+// Returns the number of valid records.
+size_t validateVehicles(const vector<Vehicle>& vehicles, vector<ValidationResult>& results);
+
+// Validates a batch of registration numbers (e.g. plate reads from a camera feed)
+// Returns the number of valid plates.
+size_t validateRegNumbers(const vector<string>& plates, vector<ValidationError>& errors);
+
+// Returns the user-facing message for a rejected field (without the "Error: " prefix)
+const char* validationMessage(VehicleField field, ValidationError error);
+
+// Validates the format of a registration number (prints the reason if it is rejected)
+bool isValidRegNumber(const string& regNumber);
+
+// Validates the format of an owner's name (prints the reason if it is rejected)
+bool isValidOwnerName(const string& ownerName);
+
+// Validates the vehicle make input (prints the reason if it is rejected)
+bool isValidVehicleMake(const string& make);
+
+// Validates the vehicle model input (prints the reason if it is rejected)
+bool isValidVehicleModel(const string& model);
+
+// Validates the vehicle color input (prints the reason if it is rejected)
+bool isValidVehicleColor(const string& color);
+
+// Validates the owner's contact number (prints the reason if it is rejected)
+bool isValidOwnerContact(const string& contact);
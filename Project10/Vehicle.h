@@ -0,0 +1,37 @@
+#pragma once
+
+#include <string>
+#include <ctime>
+#include <cstdint>
+
+using namespace std;
+
+// Kinds of parking bays; a vehicle asks for one when it arrives
+enum class BayType : uint8_t {
+    Standard = 0,   // Regular bay
+    Compact = 1,    // Narrow bay for small cars
+    EV = 2,         // Bay with a charging point
+    Disabled = 3    // Wide bay reserved for disabled permit holders
+};
+
+// Number of bay types
+const int BAY_TYPE_COUNT = 4;
+
+// Structure to represent a vehicle in the parking system
+struct Vehicle {
+    string regNumber;        // Vehicle registration number
+    string ownerName;        // Name of the vehicle owner
+    string vehicleMake;      // Make of the vehicle (e.g., Toyota, Honda)
+    string vehicleModel;     // Model of the vehicle (e.g., Corolla, Civic)
+    string vehicleColor;     // Color of the vehicle
+    string ownerContact;     // Contact number of the owner
+    time_t entryTime;        // Timestamp when the vehicle was parked (0 until the parking system stamps it)
+    BayType bayType;         // Kind of bay the vehicle needs
+    int bay;                 // Bay the vehicle is parked in (-1 until the parking system assigns one)
+
+    // Constructor for an empty vehicle record
+    Vehicle();
+
+    // Constructor to initialize a Vehicle instance
+    Vehicle(string reg, string owner, string make, string model, string color, string contact);
+};
@@ -0,0 +1,167 @@
+#include "VehicleStore.h"
+#include "Vehicle.h"
+
+// Heap bytes owned by a string beyond its inline (small string) buffer
+static size_t heapBytes(const string& value) {
+    return value.capacity() > string().capacity() ? value.capacity() + 1 : 0;
+}
+
+// Returns the id of a value, adding it on first sight
+uint32_t StringDictionary::intern(const string& value) {
+    auto it = ids.find(value);
+    if (it != ids.end()) {
+        return it->second;
+    }
+    uint32_t id = static_cast<uint32_t>(values.size());
+    ids.emplace(value, id);
+    values.push_back(value);
+    return id;
+}
+
+// Returns the id of a value
+int StringDictionary::lookup(const string& value) const {
+    auto it = ids.find(value);
+    return it != ids.end() ? static_cast<int>(it->second) : -1;
+}
+
+// Returns the value of an id
+const string& StringDictionary::valueOf(uint32_t id) const {
+    return values[id];
+}
+
+// Returns the number of distinct values
+size_t StringDictionary::size() const {
+    return values.size();
+}
+
+// Returns the approximate number of bytes used by the dictionary
+size_t StringDictionary::memoryUsage() const {
+    size_t bytes = values.capacity() * sizeof(string) + ids.bucket_count() * sizeof(void*);
+    for (const string& value : values) {
+        // One copy in the value table and one in the hash node (key, id, next pointer)
+        bytes += 2 * heapBytes(value) + sizeof(string) + sizeof(uint32_t) + sizeof(void*);
+    }
+    return bytes;
+}
+
+// Sizes every column for a number of rows
+void VehicleStore::resize(int rowCount) {
+    regNumbers.resize(rowCount);
+    ownerNames.resize(rowCount);
+    contactDigits.resize(rowCount, 0);
+    contactLengths.resize(rowCount, 0);
+    makeIds.resize(rowCount, 0);
+    modelIds.resize(rowCount, 0);
+    colorIds.resize(rowCount, 0);
+    entryTimes.resize(rowCount, 0);
+    bayTypes.resize(rowCount, 0);
+}
+
+// Stores a vehicle in a row
+void VehicleStore::put(int row, const Vehicle& vehicle, time_t entryTime) {
+    regNumbers[row] = vehicle.regNumber;
+    ownerNames[row] = vehicle.ownerName;
+    makeIds[row] = makes.intern(vehicle.vehicleMake);
+    modelIds[row] = models.intern(vehicle.vehicleModel);
+    colorIds[row] = colors.intern(vehicle.vehicleColor);
+    entryTimes[row] = entryTime;
+    bayTypes[row] = static_cast<uint8_t>(vehicle.bayType);
+
+    // Contacts are digit strings, so they pack into one integer plus a length
+    const string& contact = vehicle.ownerContact;
+    bool packable = !contact.empty() && contact.size() <= 19;
+    uint64_t digits = 0;
+    for (size_t i = 0; packable && i < contact.size(); ++i) {
+        if (contact[i] < '0' || contact[i] > '9') packable = false;
+        digits = digits * 10 + (contact[i] - '0');
+    }
+    if (packable) {
+        contactDigits[row] = digits;
+        contactLengths[row] = static_cast<uint8_t>(contact.size());
+    }
+    else {
+        contactDigits[row] = 0;
+        contactLengths[row] = 0;
+        contactOverflow[row] = contact;
+    }
+}
+
+// Releases the per-row data of a row
+void VehicleStore::clear(int row) {
+    regNumbers[row].clear();
+    ownerNames[row].clear();
+    if (contactLengths[row] == 0) {
+        contactOverflow.erase(row);
+    }
+    contactDigits[row] = 0;
+    contactLengths[row] = 0;
+    entryTimes[row] = 0;
+}
+
+// Returns the owner contact of a row
+string VehicleStore::ownerContact(int row) const {
+    int length = contactLengths[row];
+    if (length == 0) {
+        auto it = contactOverflow.find(row);
+        return it != contactOverflow.end() ? it->second : string();
+    }
+
+    // Unpack the digits right to left, restoring leading zeros
+    string contact(length, '0');
+    uint64_t digits = contactDigits[row];
+    for (int i = length - 1; i >= 0; --i) {
+        contact[i] = static_cast<char>('0' + digits % 10);
+        digits /= 10;
+    }
+    return contact;
+}
+
+// Appends the owner contact of a row to 'out'
+void VehicleStore::appendOwnerContact(int row, string& out) const {
+    int length = contactLengths[row];
+    if (length == 0) {
+        auto it = contactOverflow.find(row);
+        if (it != contactOverflow.end()) out += it->second;
+        return;
+    }
+
+    // Unpack the digits right to left in place
+    size_t start = out.size();
+    out.resize(start + length);
+    uint64_t digits = contactDigits[row];
+    for (int i = length - 1; i >= 0; --i) {
+        out[start + i] = static_cast<char>('0' + digits % 10);
+        digits /= 10;
+    }
+}
+
+// Materializes the vehicle stored in a row
+void VehicleStore::get(int row, Vehicle& vehicle) const {
+    vehicle.regNumber = regNumbers[row];
+    vehicle.ownerName = ownerNames[row];
+    vehicle.vehicleMake = vehicleMake(row);
+    vehicle.vehicleModel = vehicleModel(row);
+    vehicle.vehicleColor = vehicleColor(row);
+    vehicle.ownerContact = ownerContact(row);
+    vehicle.entryTime = entryTimes[row];
+    vehicle.bayType = static_cast<BayType>(bayTypes[row]);
+    vehicle.bay = row;
+}
+
+// Returns the approximate number of bytes used by the store
+size_t VehicleStore::memoryUsage() const {
+    size_t bytes = regNumbers.capacity() * sizeof(string)
+        + ownerNames.capacity() * sizeof(string)
+        + contactDigits.capacity() * sizeof(uint64_t)
+        + contactLengths.capacity() * sizeof(uint8_t)
+        + (makeIds.capacity() + modelIds.capacity() + colorIds.capacity()) * sizeof(uint32_t)
+        + entryTimes.capacity() * sizeof(time_t)
+        + bayTypes.capacity() * sizeof(uint8_t);
+    for (size_t row = 0; row < regNumbers.size(); ++row) {
+        bytes += heapBytes(regNumbers[row]) + heapBytes(ownerNames[row]);
+    }
+    for (const auto& entry : contactOverflow) {
+        bytes += sizeof(entry) + heapBytes(entry.second) + 2 * sizeof(void*);
+    }
+    return bytes + makes.memoryUsage() + models.memoryUsage() + colors.memoryUsage();
+}
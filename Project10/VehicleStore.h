@@ -0,0 +1,95 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <ctime>
+
+using namespace std;
+
+struct Vehicle;
+
+// Interns repeated strings (makes, models, colors) as small integer ids
+class StringDictionary {
+private:
+    unordered_map<string, uint32_t> ids;  // Value -> id
+    vector<string> values;                // Id -> value
+
+public:
+    // Returns the id of a value, adding it on first sight
+    uint32_t intern(const string& value);
+
+    // Returns the id of a value, or -1 if it was never interned
+    int lookup(const string& value) const;
+
+    // Returns the value of an id
+    const string& valueOf(uint32_t id) const;
+
+    // Returns the number of distinct values
+    size_t size() const;
+
+    // Returns the approximate number of bytes used by the dictionary
+    size_t memoryUsage() const;
+};
+
+// Struct-of-arrays storage for parked vehicles, one row per parking slot
+// This is the single canonical copy of each vehicle; every index refers to a row.
+class VehicleStore {
+private:
+    vector<string> regNumbers;          // Registration number per row
+    vector<string> ownerNames;          // Owner name per row
+    vector<uint64_t> contactDigits;     // Owner contact packed as a number per row
+    vector<uint8_t> contactLengths;     // Digit count of the contact (keeps leading zeros)
+    unordered_map<int, string> contactOverflow; // Contacts that cannot be packed as digits
+    vector<uint32_t> makeIds;           // Interned vehicle make per row
+    vector<uint32_t> modelIds;          // Interned vehicle model per row
+    vector<uint32_t> colorIds;          // Interned vehicle color per row
+    vector<time_t> entryTimes;          // Entry timestamp per row
+    vector<uint8_t> bayTypes;           // Kind of bay the row's vehicle asked for (its bay is the row)
+    StringDictionary makes;             // Dictionary of vehicle makes
+    StringDictionary models;            // Dictionary of vehicle models
+    StringDictionary colors;            // Dictionary of vehicle colors
+
+public:
+    // Sizes every column for a number of rows
+    void resize(int rowCount);
+
+    // Stores a vehicle in a row
+    void put(int row, const Vehicle& vehicle, time_t entryTime);
+
+    // Releases the per-row data of a row
+    void clear(int row);
+
+    // Materializes the vehicle stored in a row (its bay is the row)
+    void get(int row, Vehicle& vehicle) const;
+
+    // Column accessors
+    const string& regNumber(int row) const { return regNumbers[row]; }
+    const string& ownerName(int row) const { return ownerNames[row]; }
+    time_t entryTime(int row) const { return entryTimes[row]; }
+    uint8_t bayType(int row) const { return bayTypes[row]; }
+    uint32_t makeId(int row) const { return makeIds[row]; }
+    uint32_t modelId(int row) const { return modelIds[row]; }
+    uint32_t colorId(int row) const { return colorIds[row]; }
+    const string& vehicleMake(int row) const { return makes.valueOf(makeIds[row]); }
+    const string& vehicleModel(int row) const { return models.valueOf(modelIds[row]); }
+    const string& vehicleColor(int row) const { return colors.valueOf(colorIds[row]); }
+
+    // Entry time column, one value per row (0 for empty rows)
+    const time_t* entryTimeColumn() const { return entryTimes.data(); }
+
+    // Returns the owner contact of a row
+    string ownerContact(int row) const;
+
+    // Appends the owner contact of a row to 'out' (no temporary string)
+    void appendOwnerContact(int row, string& out) const;
+
+    // Dictionary accessors
+    const StringDictionary& makeDictionary() const { return makes; }
+    const StringDictionary& modelDictionary() const { return models; }
+    const StringDictionary& colorDictionary() const { return colors; }
+
+    // Returns the approximate number of bytes used by the store
+    size_t memoryUsage() const;
+};
@@ -0,0 +1,229 @@
+#include "WaitingList.h"
+#include <algorithm>
+#include <cctype>
+
+// Returns the display name of a priority
+const char* waitingPriorityName(WaitingPriority priority) {
+    switch (priority) {
+    case WaitingPriority::Permit: return "Permit";
+    case WaitingPriority::Electric: return "EV";
+    case WaitingPriority::Disabled: return "Disabled";
+    default: return "Standard";
+    }
+}
+
+// Parses a priority name
+bool parseWaitingPriority(const string& text, WaitingPriority& priority) {
+    string name = text;
+    transform(name.begin(), name.end(), name.begin(), [](unsigned char c) { return static_cast<char>(tolower(c)); });
+    if (name == "standard" || name == "0") priority = WaitingPriority::Standard;
+    else if (name == "permit" || name == "1") priority = WaitingPriority::Permit;
+    else if (name == "ev" || name == "electric" || name == "2") priority = WaitingPriority::Electric;
+    else if (name == "disabled" || name == "3") priority = WaitingPriority::Disabled;
+    else return false;
+    return true;
+}
+
+// Creates an empty waiting list
+WaitingList::WaitingList() : nextSequence(0) {
+    fill(begin(bayTypeCounts), end(bayTypeCounts), static_cast<size_t>(0));
+}
+
+// Builds the heap key of an entry
+uint64_t WaitingList::makeKey(WaitingPriority priority, uint64_t sequence) {
+    // Higher priorities get smaller keys; arrivals keep FIFO order within a priority
+    return (static_cast<uint64_t>(255 - static_cast<uint8_t>(priority)) << 56) | (sequence & ((1ULL << 56) - 1));
+}
+
+// Swaps two heap nodes and updates their entries' heap positions
+void WaitingList::swapNodes(size_t a, size_t b) {
+    swap(heap[a], heap[b]);
+    heapIndex[heap[a].entry] = a;
+    heapIndex[heap[b].entry] = b;
+}
+
+// Moves a node towards the root while it beats its parent
+size_t WaitingList::siftUp(size_t index) {
+    while (index > 0) {
+        size_t parent = (index - 1) / 2;
+        if (heap[parent].key <= heap[index].key) break;
+        swapNodes(index, parent);
+        index = parent;
+    }
+    return index;
+}
+
+// Moves a node towards the leaves while a child beats it
+size_t WaitingList::siftDown(size_t index) {
+    while (true) {
+        size_t best = index;
+        size_t left = 2 * index + 1;
+        size_t right = left + 1;
+        if (left < heap.size() && heap[left].key < heap[best].key) best = left;
+        if (right < heap.size() && heap[right].key < heap[best].key) best = right;
+        if (best == index) return index;
+        swapNodes(index, best);
+        index = best;
+    }
+}
+
+// Removes the node at heap position 'index'
+void WaitingList::removeAt(size_t index, WaitingEntry& removed) {
+    uint32_t entry = heap[index].entry;
+
+    // Move the last node into the hole, then restore the heap order around it
+    size_t last = heap.size() - 1;
+    if (index != last) {
+        swapNodes(index, last);
+    }
+    heap.pop_back();
+    if (index < heap.size()) {
+        siftDown(siftUp(index));
+    }
+
+    plates.erase(entries[entry].vehicle.regNumber);
+    bayTypeCounts[static_cast<int>(entries[entry].vehicle.bayType)]--;
+    removed = move(entries[entry]);
+    freeEntries.push_back(entry);
+}
+
+// Adds a vehicle
+bool WaitingList::push(const Vehicle& vehicle, WaitingPriority priority) {
+    // Reuse a free entry slot or grow the pool
+    uint32_t entry = freeEntries.empty() ? static_cast<uint32_t>(entries.size()) : freeEntries.back();
+    if (!plates.emplace(vehicle.regNumber, entry).second) {
+        return false; // Already waiting
+    }
+    if (freeEntries.empty()) {
+        entries.emplace_back();
+        heapIndex.push_back(0);
+    }
+    else {
+        freeEntries.pop_back();
+    }
+
+    uint64_t sequence = nextSequence++;
+    entries[entry] = WaitingEntry{ vehicle, priority, sequence };
+    bayTypeCounts[static_cast<int>(vehicle.bayType)]++;
+    heapIndex[entry] = heap.size();
+    heap.push_back(HeapNode{ makeKey(priority, sequence), entry });
+    siftUp(heap.size() - 1);
+    return true;
+}
+
+// Returns the vehicle that will be admitted next
+const WaitingEntry& WaitingList::front() const {
+    return entries[heap.front().entry];
+}
+
+// Removes the next vehicle
+bool WaitingList::pop(WaitingEntry& entry) {
+    if (heap.empty()) return false;
+    removeAt(0, entry);
+    return true;
+}
+
+// Removes a waiting vehicle by plate
+bool WaitingList::remove(const string& regNumber, WaitingEntry& entry) {
+    auto it = plates.find(regNumber);
+    if (it == plates.end()) return false;
+    removeAt(heapIndex[it->second], entry);
+    return true;
+}
+
+// Changes the priority of a waiting vehicle
+bool WaitingList::setPriority(const string& regNumber, WaitingPriority priority) {
+    auto it = plates.find(regNumber);
+    if (it == plates.end()) return false;
+    WaitingEntry& entry = entries[it->second];
+    entry.priority = priority;
+    size_t index = heapIndex[it->second];
+    heap[index].key = makeKey(priority, entry.sequence);
+    siftDown(siftUp(index));
+    return true;
+}
+
+// Returns the entry of a waiting plate
+const WaitingEntry* WaitingList::find(const string& regNumber) const {
+    auto it = plates.find(regNumber);
+    return it == plates.end() ? nullptr : &entries[it->second];
+}
+
+// Returns the 1-based admission position of a waiting plate
+size_t WaitingList::positionOf(const string& regNumber) const {
+    auto it = plates.find(regNumber);
+    if (it == plates.end()) return 0;
+
+    // Count the nodes admitted before it (a heap has no cheaper rank query)
+    uint64_t key = heap[heapIndex[it->second]].key;
+    size_t ahead = 0;
+    for (const HeapNode& node : heap) {
+        if (node.key < key) ahead++;
+    }
+    return ahead + 1;
+}
+
+// Returns up to 'limit' entries in admission order
+vector<const WaitingEntry*> WaitingList::firstEntries(size_t limit) const {
+    // Walk the heap best-first with a small frontier heap of positions: O(limit log limit)
+    vector<const WaitingEntry*> result;
+    auto worse = [this](size_t a, size_t b) { return heap[a].key > heap[b].key; };
+    vector<size_t> frontier;
+    if (!heap.empty()) frontier.push_back(0);
+    while (!frontier.empty() && result.size() < limit) {
+        pop_heap(frontier.begin(), frontier.end(), worse);
+        size_t index = frontier.back();
+        frontier.pop_back();
+        result.push_back(&entries[heap[index].entry]);
+        for (size_t child = 2 * index + 1; child <= 2 * index + 2 && child < heap.size(); ++child) {
+            frontier.push_back(child);
+            push_heap(frontier.begin(), frontier.end(), worse);
+        }
+    }
+    return result;
+}
+
+// Returns the first entry in admission order that 'match' accepts
+const WaitingEntry* WaitingList::findFirst(const function<bool(const WaitingEntry&)>& match) const {
+    // Same best-first walk as firstEntries, stopping at the first match
+    auto worse = [this](size_t a, size_t b) { return heap[a].key > heap[b].key; };
+    vector<size_t> frontier;
+    if (!heap.empty()) frontier.push_back(0);
+    while (!frontier.empty()) {
+        pop_heap(frontier.begin(), frontier.end(), worse);
+        size_t index = frontier.back();
+        frontier.pop_back();
+        const WaitingEntry& entry = entries[heap[index].entry];
+        if (match(entry)) return &entry;
+        for (size_t child = 2 * index + 1; child <= 2 * index + 2 && child < heap.size(); ++child) {
+            frontier.push_back(child);
+            push_heap(frontier.begin(), frontier.end(), worse);
+        }
+    }
+    return nullptr;
+}
+
+// Returns the number of waiting vehicles that need a bay of 'type'
+size_t WaitingList::countNeeding(BayType type) const {
+    return bayTypeCounts[static_cast<int>(type)];
+}
+
+// Returns the number of waiting vehicles
+size_t WaitingList::size() const {
+    return heap.size();
+}
+
+// Returns true if no vehicle is waiting
+bool WaitingList::empty() const {
+    return heap.empty();
+}
+
+// Removes every waiting vehicle
+void WaitingList::clear() {
+    entries.clear();
+    freeEntries.clear();
+    heapIndex.clear();
+    heap.clear();
+    plates.clear();
+    fill(begin(bayTypeCounts), end(bayTypeCounts), static_cast<size_t>(0));
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Vehicle.h"
+
+using namespace std;
+
+// Admission priority of a waiting vehicle; higher values are admitted first
+enum class WaitingPriority : uint8_t {
+    Standard = 0,   // Regular customer
+    Permit = 1,     // Permit holder
+    Electric = 2,   // Electric vehicle waiting for a charging bay
+    Disabled = 3    // Disabled badge holder
+};
+
+// Returns the display name of a priority
+const char* waitingPriorityName(WaitingPriority priority);
+
+// Parses a priority name (standard, permit, ev, disabled); returns false if unknown
+bool parseWaitingPriority(const string& text, WaitingPriority& priority);
+
+// A vehicle in the waiting list
+struct WaitingEntry {
+    Vehicle vehicle;            // Vehicle waiting for a slot
+    WaitingPriority priority;   // Admission priority
+    uint64_t sequence;          // Arrival order; breaks ties within a priority
+};
+
+// Waiting list ordered by priority, then arrival
+// A binary heap of small (key, entry) pairs with a plate -> entry map, so joining,
+// cancelling and promoting a vehicle are all O(log n) and a plate can only wait once.
+// Vehicles stay put in an entry pool; sifting only moves the 16-byte heap nodes.
+class WaitingList {
+private:
+    // A heap node; a smaller key is admitted first
+    struct HeapNode {
+        uint64_t key;      // Inverted priority in the top byte, arrival sequence below
+        uint32_t entry;    // Index into the entry pool
+    };
+
+    vector<WaitingEntry> entries;               // Entry pool (slots listed in freeEntries are unused)
+    vector<uint32_t> freeEntries;               // Unused entry slots
+    vector<size_t> heapIndex;                   // Heap position of each entry
+    vector<HeapNode> heap;                      // Binary heap, best node at index 0
+    unordered_map<string, uint32_t> plates;     // Registration number -> entry index
+    uint64_t nextSequence;                      // Sequence number given to the next arrival
+    size_t bayTypeCounts[BAY_TYPE_COUNT];       // Waiting vehicles per kind of bay they need
+
+    // Builds the heap key of an entry
+    static uint64_t makeKey(WaitingPriority priority, uint64_t sequence);
+
+    // Moves the node at 'index' up/down until the heap order holds; returns its new index
+    size_t siftUp(size_t index);
+    size_t siftDown(size_t index);
+
+    // Swaps two heap nodes and updates their entries' heap positions
+    void swapNodes(size_t a, size_t b);
+
+    // Removes the node at heap position 'index' and moves its entry into 'removed'
+    void removeAt(size_t index, WaitingEntry& removed);
+
+public:
+    // Creates an empty waiting list
+    WaitingList();
+
+    // Adds a vehicle; returns false if its plate is already waiting
+    bool push(const Vehicle& vehicle, WaitingPriority priority);
+
+    // Returns the vehicle that will be admitted next (the list must not be empty)
+    const WaitingEntry& front() const;
+
+    // Removes the next vehicle into 'entry'; returns false if the list is empty
+    bool pop(WaitingEntry& entry);
+
+    // Removes a waiting vehicle by plate into 'entry'; returns false if it is not waiting
+    bool remove(const string& regNumber, WaitingEntry& entry);
+
+    // Changes the priority of a waiting vehicle; returns false if it is not waiting
+    bool setPriority(const string& regNumber, WaitingPriority priority);
+
+    // Returns the entry of a waiting plate, or nullptr
+    const WaitingEntry* find(const string& regNumber) const;
+
+    // Returns the 1-based admission position of a waiting plate (0 if not waiting)
+    size_t positionOf(const string& regNumber) const;
+
+    // Returns up to 'limit' entries in admission order without copying the vehicles
+    vector<const WaitingEntry*> firstEntries(size_t limit) const;
+
+    // Returns the first entry in admission order that 'match' accepts, or nullptr
+    const WaitingEntry* findFirst(const function<bool(const WaitingEntry&)>& match) const;
+
+    // Returns the number of waiting vehicles that need a bay of 'type'
+    size_t countNeeding(BayType type) const;
+
+    // Returns the number of waiting vehicles
+    size_t size() const;
+
+    // Returns true if no vehicle is waiting
+    bool empty() const;
+
+    // Removes every waiting vehicle
+    void clear();
+};